@@ -65,13 +65,20 @@
 
 #define FL_BYTE_ORDER                 FL_BYTE_ORDER_LITTLE_ENDIAN
 
-#define FL_ENABLE_DEBUG_PRINT
+// printf output(blocking ITM port 0 writes), the firmware logs with fl_log.h.
+//#define FL_ENABLE_DEBUG_PRINT
 #if defined(FL_ENABLE_DEBUG_PRINT)
 #define FL_DEBUG_PRINT(x)       do { printf x; } while (0)
 #else
 #define FL_DEBUG_PRINT(x)
 #endif
 
+// Latency statistics(fl_perf.h), remove this to compile out all measurement points.
+#define FL_ENABLE_PERF
+
+// Deferred binary log(fl_log.h), remove this to compile out all log points.
+#define FL_ENABLE_LOG
+
 typedef unsigned char fl_status_t;
 typedef unsigned char fl_bool_t;
 
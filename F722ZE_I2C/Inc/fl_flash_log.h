@@ -0,0 +1,78 @@
+// Firmware library flash log
+// fl_flash_log.h
+//
+// Append-only key/value records in two flash sectors(STM32F7 HAL flash driver).
+// A write appends a record to the active sector, the latest record of a key is its value.
+// A full sector is compacted into the other sector(latest records only) and the sectors swap roles,
+// so each sector is erased once for a sector full of appended records(wear leveling).
+// A record or a compaction cut by a reset is ignored at the next fl_flash_log_init().
+// The code runs from the same flash bank : program and erase stall the CPU(a 128KB sector erase
+// takes 1 ~ 2 seconds).
+
+#ifndef FL_FLASH_LOG_H
+#define FL_FLASH_LOG_H
+
+#include "stm32f7xx_hal.h"
+#include "fl_def.h"
+
+#define FL_FLASH_LOG_ERR_NOT_FOUND    (FL_ERROR + 1)  // No record of the key, or the key is deleted.
+#define FL_FLASH_LOG_ERR_FULL         (FL_ERROR + 2)  // The latest records leave no room for the record.
+#define FL_FLASH_LOG_ERR_FLASH        (FL_ERROR + 3)  // Flash erase or program failed.
+
+// Keys : 0 ~ FL_FLASH_LOG_MAX_KEYS - 1.
+#define FL_FLASH_LOG_MAX_KEYS         (32)
+
+// Sector header magic("FLOG").
+#define FL_FLASH_LOG_MAGIC            (0x474F4C46)
+
+FL_BEGIN_PACK1
+
+// Sector header, the magic is programmed after the compacted records.
+typedef struct _fl_flash_log_sector
+{
+  // Incremented for each compaction, the valid sector with the higher sequence number is active.
+  uint32_t    seq;
+  uint32_t    magic;
+} fl_flash_log_sector_t;
+
+// Record header, followed by the data padded to a word(0xFF).
+typedef struct _fl_flash_log_record
+{
+  uint16_t    key;        // 0xFFFF(erased) : end of the records
+  uint16_t    length;     // Data length, 0 : the key is deleted
+  uint16_t    crc;        // fl_crc_16() of the data
+  uint16_t    check;      // ~(key ^ length)
+} fl_flash_log_record_t;
+
+typedef struct _fl_flash_log
+{
+  // Sector numbers(FLASH_SECTOR_x) and addresses, both sectors are sector_size bytes.
+  uint32_t    sectors[2];
+  uint32_t    addrs[2];
+  uint32_t    sector_size;
+
+  // Sequence number of the active sector.
+  uint32_t    seq;
+
+  // Next record address in the active sector.
+  uint32_t    write_addr;
+
+  // Latest record address of each key(0 : none).
+  uint32_t    index[FL_FLASH_LOG_MAX_KEYS];
+
+  // Active sector(0, 1).
+  uint8_t     active;
+} fl_flash_log_t;
+
+FL_END_PACK
+
+FL_BEGIN_DECLS
+
+FL_DECLARE(fl_status_t) fl_flash_log_init(fl_flash_log_t *handle);
+FL_DECLARE(fl_status_t) fl_flash_log_read(fl_flash_log_t *handle, uint16_t key, void *buf, uint16_t buf_len, uint16_t *length);
+FL_DECLARE(fl_status_t) fl_flash_log_write(fl_flash_log_t *handle, uint16_t key, const void *data, uint16_t length);
+FL_DECLARE(fl_status_t) fl_flash_log_delete(fl_flash_log_t *handle, uint16_t key);
+
+FL_END_DECLS
+
+#endif
@@ -11,25 +11,101 @@
 #include "stm32f7xx_hal.h"
 #include "fl_def.h"
 
-#define FL_I2C_BUF_LEN    (8)
+#define FL_I2C_BUF_LEN              (8)
+
+// Error codes of I2C transfers(fl_status_t, sent in the error field of a response).
+#define FL_I2C_ERR_ADDR_NACK        (FL_ERROR + 1)  // No acknowledge on the slave address.
+#define FL_I2C_ERR_DATA_NACK        (FL_ERROR + 2)  // No acknowledge on a data byte(register address or value).
+#define FL_I2C_ERR_TIMEOUT          (FL_ERROR + 3)  // Transfer budget expired(clock stretching, stuck bus).
+#define FL_I2C_ERR_ARB_LOST         (FL_ERROR + 4)  // Arbitration lost.
+#define FL_I2C_ERR_BUS              (FL_ERROR + 5)  // Misplaced START/STOP or the peripheral is busy.
+
+// SCL frequency(Hz).
+#define FL_I2C_SPEED_STANDARD       (100000)
+#define FL_I2C_SPEED_FAST           (400000)
+#define FL_I2C_SPEED_FAST_PLUS      (1000000)
+#define FL_I2C_SPEED_MIN            (10000)
+
+#define FL_I2C_DEFAULT_BUS_SPEED    (FL_I2C_SPEED_FAST)
+#define FL_I2C_DEFAULT_STRETCH      (1000)          // us
+
+// SCL pulses to release a slave holding SDA low(8 data bits + ACK).
+#define FL_I2C_RECOVERY_PULSES      (9)
+
+// Phase of an interrupt mode transfer(fl_i2c_t.phase), a NACK is mapped from the phase of its frame.
+#define FL_I2C_PHASE_IDLE           (0)
+#define FL_I2C_PHASE_REG_ADDR       (1)   // START, slave address, register address(2 bytes).
+#define FL_I2C_PHASE_DATA           (2)   // Register bytes(a read starts with a repeated START and the slave address).
 
 typedef struct _fl_i2c
 {
   I2C_HandleTypeDef*  i2c;
-  uint32_t            timeout;
+
+  // SCL frequency(Hz) for the transfer timeout.
+  uint32_t            bus_speed;
+
+  // Clock stretching allowance per transfer(us).
+  uint32_t            stretch;
+
+  // SCL/SDA rise and fall time(ns) for the timing calculation(fl_i2c_set_speed()).
+  uint32_t            rise_time;
+  uint32_t            fall_time;
+
+  // SCL/SDA pins for bus recovery(I2C alternate function pins).
+  GPIO_TypeDef*       scl_port;
+  uint16_t            scl_pin;
+  GPIO_TypeDef*       sda_port;
+  uint16_t            sda_pin;
+
+  // The number of bus recoveries.
+  uint32_t            recovery_count;
+
   uint8_t             buf[FL_I2C_BUF_LEN];
   uint8_t             buf_len;
+
+  // Destination of an interrupt mode block read, NULL : the register value is read into buf.
+  uint8_t*            block;
+
+  // Interrupt mode transfer : slave address, register address(big endian) and direction of the data frame.
+  uint8_t             it_addr;
+  uint8_t             it_reg[2];
+  fl_bool_t           it_read;
+
+  // FL_I2C_PHASE_xxx, advanced by fl_i2c_it_next() from the completion callback of the register address frame.
+  uint8_t             phase;
 } fl_i2c_t;
 
 FL_BEGIN_DECLS
 
 FL_DECLARE(void) fl_i2c_init(fl_i2c_t *handle);
+FL_DECLARE(uint32_t) fl_i2c_timeout(fl_i2c_t *handle, uint8_t size);
+FL_DECLARE(void) fl_i2c_recover(fl_i2c_t *handle);
+FL_DECLARE(fl_status_t) fl_i2c_calc_timing(uint32_t clock_freq, uint32_t speed, uint32_t rise_time, uint32_t fall_time, uint32_t *timing);
+FL_DECLARE(fl_status_t) fl_i2c_set_speed(fl_i2c_t *handle, uint32_t speed);
 FL_DECLARE(fl_status_t) fl_i2c_read_byte(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t *data);
 FL_DECLARE(fl_status_t) fl_i2c_read_word(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint16_t *data);
 FL_DECLARE(fl_status_t) fl_i2c_read_dword(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint32_t *data);
 FL_DECLARE(fl_status_t) fl_i2c_write_byte(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t data);
 FL_DECLARE(fl_status_t) fl_i2c_write_word(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint16_t data);
 FL_DECLARE(fl_status_t) fl_i2c_write_dword(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint32_t data);
+FL_DECLARE(fl_status_t) fl_i2c_read_block(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t *data, uint8_t size);
+
+// Interrupt mode register access(size : 1, 2, 4 bytes).
+// The register address and the register bytes are sent in two frames(HAL sequential transfer),
+// HAL_I2C_MasterTxCpltCallback of the register address frame calls fl_i2c_it_next() to start the register bytes.
+// The HAL callbacks report the completion(HAL_I2C_MasterRxCpltCallback, HAL_I2C_MasterTxCpltCallback, HAL_I2C_ErrorCallback),
+// then fl_i2c_it_complete() returns the register value of a read, fl_i2c_it_error() returns the error code of a failure.
+FL_DECLARE(fl_status_t) fl_i2c_read_it(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t size);
+FL_DECLARE(fl_status_t) fl_i2c_write_it(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint32_t data, uint8_t size);
+// Consecutive registers(size bytes, the device increments the register address) into data,
+// data must be kept until the completion(fl_i2c_it_complete() returns 0).
+FL_DECLARE(fl_status_t) fl_i2c_read_block_it(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t *data, uint8_t size);
+// Returns FL_TRUE if the register bytes were started(their callback completes the transfer),
+// FL_FALSE if the transfer ended(*status : FL_I2C_ERR_BUS if the register bytes could not start).
+FL_DECLARE(fl_bool_t) fl_i2c_it_next(fl_i2c_t *handle, fl_status_t *status);
+FL_DECLARE(uint32_t) fl_i2c_it_complete(fl_i2c_t *handle);
+FL_DECLARE(fl_status_t) fl_i2c_it_error(fl_i2c_t *handle);
+FL_DECLARE(void) fl_i2c_abort(fl_i2c_t *handle);
 
 FL_END_DECLS
 
@@ -0,0 +1,97 @@
+// Firmware library deferred log
+// fl_log.h
+//
+// Binary log records(format ID, millisecond tick, up to FL_LOG_MAX_ARGS 32-bit arguments) are written
+// into a RAM ring from any context(interrupt handlers included) and sent to an ITM stimulus port(SWO)
+// when the main loop is idle(fl_log_drain()). A write copies a few words with interrupts masked,
+// the format strings(fl_log_fmt.h) are formatted on the host(Fl.Net FlLogDecoder, FlLogDecode).
+// Remove FL_ENABLE_LOG(fl_def.h) to compile out all log points.
+// Define FL_LOG_HOST to build it on a PC, the records are sent to fl_log_host_port_xxx() of the test.
+//
+// Record on the ITM port(32-bit writes) :
+//   word 0 : FL_LOG_SYNC(bit 24 ~ 31), argument count(bit 16 ~ 23), format ID(bit 0 ~ 15)
+//   word 1 : tick(ms)
+//   word 2 ~ : arguments
+
+#ifndef FL_LOG_H
+#define FL_LOG_H
+
+#include "stm32f7xx_hal.h"
+#include "fl_def.h"
+
+// Number of records in the ring(power of 2), a full ring drops new records(FL_LOG_DROPPED).
+#define FL_LOG_RING_SIZE            (64)
+
+#define FL_LOG_MAX_ARGS             (3)
+
+// ITM stimulus port of the records, port 0 is printf(_write()).
+#define FL_LOG_ITM_PORT             (1)
+
+#define FL_LOG_SYNC                 (0xA5)
+
+// Critical section of the ring(records are written from interrupt handlers) and the output port.
+#if defined(FL_LOG_HOST)
+#define FL_LOG_LOCK()
+#define FL_LOG_UNLOCK()
+#define FL_LOG_PORT_ENABLED()       (FL_TRUE)
+#define FL_LOG_PORT_READY()         fl_log_host_port_ready()
+#define FL_LOG_PORT_WRITE(word)     fl_log_host_port_write(word)
+#else
+#define FL_LOG_LOCK()               uint32_t _primask = __get_PRIMASK(); __disable_irq()
+#define FL_LOG_UNLOCK()             __set_PRIMASK(_primask)
+#define FL_LOG_PORT_ENABLED()       ((((ITM->TCR & ITM_TCR_ITMENA_Msk) != 0) && \
+                                      ((ITM->TER & (1UL << FL_LOG_ITM_PORT)) != 0)) ? FL_TRUE : FL_FALSE)
+#define FL_LOG_PORT_READY()         ((ITM->PORT[FL_LOG_ITM_PORT].u32 != 0) ? FL_TRUE : FL_FALSE)
+#define FL_LOG_PORT_WRITE(word)     (ITM->PORT[FL_LOG_ITM_PORT].u32 = (word))
+#endif
+
+// Format IDs.
+typedef enum _fl_log_fmt_id
+{
+#define FL_LOG_FMT(id, fmt)         id,
+#include "fl_log_fmt.h"
+#undef FL_LOG_FMT
+  FL_LOG_FMT_COUNT
+} fl_log_fmt_id_t;
+
+FL_BEGIN_PACK1
+
+typedef struct _fl_log_record
+{
+  uint32_t    header;
+  uint32_t    tick;
+  uint32_t    args[FL_LOG_MAX_ARGS];
+} fl_log_record_t;
+
+FL_END_PACK
+
+#if defined(FL_ENABLE_LOG)
+#define FL_LOG0(id)                 fl_log_write(id, 0, 0, 0, 0)
+#define FL_LOG1(id, a0)             fl_log_write(id, 1, (uint32_t)(a0), 0, 0)
+#define FL_LOG2(id, a0, a1)         fl_log_write(id, 2, (uint32_t)(a0), (uint32_t)(a1), 0)
+#define FL_LOG3(id, a0, a1, a2)     fl_log_write(id, 3, (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2))
+#define FL_LOG_DRAIN()              fl_log_drain()
+#else
+#define FL_LOG0(id)
+#define FL_LOG1(id, a0)
+#define FL_LOG2(id, a0, a1)
+#define FL_LOG3(id, a0, a1, a2)
+#define FL_LOG_DRAIN()
+#endif
+
+FL_BEGIN_DECLS
+
+#if defined(FL_ENABLE_LOG)
+FL_DECLARE(void) fl_log_write(uint16_t fmt_id, uint8_t arg_count, uint32_t a0, uint32_t a1, uint32_t a2);
+FL_DECLARE(void) fl_log_drain(void);
+#endif
+
+#if defined(FL_LOG_HOST)
+// Output port of a host test : FL_FALSE while its FIFO is full.
+fl_bool_t fl_log_host_port_ready(void);
+void fl_log_host_port_write(uint32_t word);
+#endif
+
+FL_END_DECLS
+
+#endif
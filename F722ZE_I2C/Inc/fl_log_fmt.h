@@ -0,0 +1,17 @@
+// Firmware library deferred log formats
+// fl_log_fmt.h
+//
+// FL_LOG_FMT(format ID, format string), included by fl_log.h for the format IDs(no include guard).
+// The format strings are not compiled into the firmware : the host decoder(Fl.Net FlLogDecoder)
+// reads this file and numbers the formats in order, so new formats are added at the end.
+// Conversions : %u, %d, %x, %X with an optional 0 flag and width, %%.
+
+FL_LOG_FMT(FL_LOG_DROPPED,              "%u log records dropped")
+FL_LOG_FMT(FL_LOG_BOOT_READY,           "Boot done : sensors 0x%x, %u ms")
+FL_LOG_FMT(FL_LOG_PROFILE_APPLIED,      "Profile %u : %u registers, %u failed")
+FL_LOG_FMT(FL_LOG_CONFIG_MOUNT_FAILED,  "Configuration log mount failed : %u")
+FL_LOG_FMT(FL_LOG_I2C_ERROR,            "I2C%u transfer error")
+FL_LOG_FMT(FL_LOG_I2C_TIMEOUT,          "I2C%u transfer timeout, device 0x%02x")
+FL_LOG_FMT(FL_LOG_EVENT_QUEUE_FULL,     "Event queue full")
+FL_LOG_FMT(FL_LOG_BCAST_NO_SLOT,        "No broadcast slot for device ID %u")
+FL_LOG_FMT(FL_LOG_BCAST_LATE,           "Broadcast response of device ID %u dropped : %u ms late")
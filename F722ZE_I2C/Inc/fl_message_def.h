@@ -24,6 +24,52 @@ FL_BEGIN_DECLS
 // I2C read/write
 #define FL_MSG_ID_READ_WRITE_I2C            (FL_MSG_ID_BASE + 11)
 
+// Capture mode start/stop(periodic sampling into the on-device ring buffer).
+#define FL_MSG_ID_CAPTURE_CONTROL           (FL_MSG_ID_BASE + 12)
+
+// Read(drain) captured samples.
+#define FL_MSG_ID_READ_CAPTURE              (FL_MSG_ID_BASE + 13)
+
+// Captured samples reached the watermark.
+#define FL_MSG_ID_CAPTURE_EVENT             (FL_MSG_ID_BASE + 14)
+
+// Read latency statistics(fl_perf.h).
+#define FL_MSG_ID_READ_PERF                 (FL_MSG_ID_BASE + 15)
+
+// I2C bus speed(SCL frequency).
+#define FL_MSG_ID_WRITE_I2C_SPEED           (FL_MSG_ID_BASE + 16)
+
+// Read(enumerate) VL6180X sensors.
+#define FL_MSG_ID_READ_SENSORS              (FL_MSG_ID_BASE + 17)
+
+// Ranging mode of a sensor(fl_vl6180x, results in range events).
+#define FL_MSG_ID_WRITE_RANGING             (FL_MSG_ID_BASE + 18)
+
+// Range result of a sensor in a ranging mode.
+#define FL_MSG_ID_RANGE_EVENT               (FL_MSG_ID_BASE + 19)
+
+// Range and lux(fixed-point) of a sensor in the interleaved ranging mode.
+#define FL_MSG_ID_MEASUREMENT_EVENT         (FL_MSG_ID_BASE + 20)
+
+// Device configuration in flash(applied at boot).
+#define FL_MSG_ID_WRITE_CONFIG              (FL_MSG_ID_BASE + 21)
+#define FL_MSG_ID_READ_CONFIG               (FL_MSG_ID_BASE + 22)
+
+// Register init profile in flash(written at boot after the sensor enumeration).
+#define FL_MSG_ID_WRITE_PROFILE             (FL_MSG_ID_BASE + 23)
+
+// Boot sensor enumeration done, commands using the I2C buses are accepted.
+#define FL_MSG_ID_READY_EVENT               (FL_MSG_ID_BASE + 24)
+
+// I2C burst read(consecutive registers in one transfer).
+#define FL_MSG_ID_READ_BURST                (FL_MSG_ID_BASE + 25)
+
+// I2C register bits update(read-modify-write on the device).
+#define FL_MSG_ID_UPDATE_BITS               (FL_MSG_ID_BASE + 26)
+
+// Number of message IDs(size of a command table indexed by message ID).
+#define FL_MSG_ID_COUNT                     (FL_MSG_ID_BASE + 27)
+
 ///////////////////////////////////////////////////////////////////////////////
 // Defines for general messages.
 ///////////////////////////////////////////////////////////////////////////////
@@ -68,6 +114,46 @@ FL_BEGIN_DECLS
 #define FL_MSG_I2C_READ                     (0)
 #define FL_MSG_I2C_WRITE                    (1)
 
+// Maximum number of bytes of a RBURS command(base64 encoded in the response).
+#define FL_MSG_I2C_MAX_BURST_LEN            (64)
+
+#define FL_MSG_CAPTURE_STOP                 (0)
+#define FL_MSG_CAPTURE_START                (1)
+
+// dev_addr of a capture start : all enumerated sensors(interleaved single-shot ranging).
+#define FL_MSG_CAPTURE_ALL_SENSORS          (0)
+
+// range_status of a captured sample : range error code(bit 0 ~ 3), sensor index(bit 4 ~ 7).
+#define FL_MSG_CAPTURE_SENSOR_SHIFT         (4)
+#define FL_MSG_CAPTURE_ERROR_MASK           (0x0F)
+
+// Number of sensor address slots in a RSENS response.
+#define FL_MSG_SENSOR_MAX_COUNT             (3)
+
+// mode of a WRANG command(FL_VL6180X_MODE_XXX).
+#define FL_MSG_RANGE_STOP                   (0) // Software standby.
+#define FL_MSG_RANGE_SINGLE                 (1) // One range measurement.
+#define FL_MSG_RANGE_CONTINUOUS             (2) // Range measurement every period.
+#define FL_MSG_RANGE_INTERLEAVED            (3) // ALS then range measurement every period.
+
+// item of a WCONF, RCONF command, a WCONF value 0 deletes the item(default value at boot).
+#define FL_MSG_CONFIG_DEVICE_ID             (0)
+#define FL_MSG_CONFIG_BAUD_RATE             (1) // Message UART(bps)
+#define FL_MSG_CONFIG_I2C1_SPEED            (2) // SCL frequency(Hz) of I2C1
+#define FL_MSG_CONFIG_I2C2_SPEED            (3) // SCL frequency(Hz) of I2C2
+#define FL_MSG_CONFIG_PROFILES              (4) // Mask of the stored profiles(read only)
+#define FL_MSG_CONFIG_ITEM_COUNT            (5)
+
+// op of a WPROF command.
+#define FL_MSG_PROFILE_BEGIN                (0) // WPROF devid,0,profile,name : clear the profile being built
+#define FL_MSG_PROFILE_ADD                  (1) // WPROF devid,1,i2c_num,dev_addr,reg_addr,value : add a register write
+#define FL_MSG_PROFILE_SAVE                 (2) // WPROF devid,2 : store the profile being built
+#define FL_MSG_PROFILE_DELETE               (3) // WPROF devid,3,profile : delete a stored profile
+
+#define FL_MSG_PROFILE_COUNT                (4)   // Profile slots(0 ~ 3)
+#define FL_MSG_PROFILE_MAX_ENTRIES          (32)  // Register writes in a profile
+#define FL_MSG_PROFILE_NAME_LEN             (12)  // Including the terminating null
+
 FL_BEGIN_PACK1
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -109,6 +195,93 @@ typedef struct _fl_i2c_read_resp
   uint32_t    reg_value;    // Register value
 } fl_i2c_read_resp_t;
 
+typedef struct _fl_i2c_burst
+{
+  uint8_t     i2c_num;      // I2C number
+  uint16_t    dev_addr;     // Target device address
+  uint16_t    reg_addr;     // First register address
+  uint8_t     count;        // Number of bytes(1 ~ FL_MSG_I2C_MAX_BURST_LEN)
+} fl_i2c_burst_t;
+
+typedef struct _fl_i2c_update
+{
+  uint8_t     i2c_num;      // I2C number
+  uint16_t    dev_addr;     // Target device address
+  uint16_t    reg_addr;     // Register address
+  uint32_t    mask;         // Bits to update
+  uint32_t    value;        // New value of the bits(bits out of the mask are ignored)
+} fl_i2c_update_t;
+
+typedef struct _fl_capture_ctrl
+{
+  uint8_t     start;        // FL_MSG_CAPTURE_STOP, FL_MSG_CAPTURE_START
+  uint8_t     i2c_num;      // I2C number
+  uint16_t    dev_addr;     // Target device address
+  uint16_t    period;       // Sampling period(millisecond)
+  uint16_t    watermark;    // Number of samples for a capture event(0 : no event)
+} fl_capture_ctrl_t;
+
+typedef struct _fl_capture_read
+{
+  uint16_t    max_count;    // Maximum number of samples in a response
+} fl_capture_read_t;
+
+// A captured sample(little endian, base64 encoded in a RCAPT response).
+typedef struct _fl_capture_sample
+{
+  uint32_t    timestamp;    // Sampling time(millisecond tick)
+  uint8_t     range;        // Range(mm)
+  uint8_t     range_status; // Range error code, sensor index(FL_MSG_CAPTURE_SENSOR_SHIFT)
+  uint16_t    als;          // ALS count
+} fl_capture_sample_t;
+
+typedef struct _fl_perf_read
+{
+  uint8_t     stage;        // FL_PERF_STAGE_XXX
+  uint8_t     clear;        // 1 : Clear the statistics after reading.
+} fl_perf_read_t;
+
+typedef struct _fl_i2c_speed
+{
+  uint8_t     i2c_num;      // I2C number
+  uint32_t    speed;        // SCL frequency(Hz, 10000 ~ 1000000)
+} fl_i2c_speed_t;
+
+typedef struct _fl_sensor_read
+{
+  uint8_t     enumerate;    // 1 : Enumerate the sensors again(capture must be stopped).
+} fl_sensor_read_t;
+
+typedef struct _fl_range_ctrl
+{
+  uint8_t     sensor;       // Sensor index(RSENS)
+  uint8_t     mode;         // FL_MSG_RANGE_XXX
+  uint16_t    period;       // Intermeasurement period(millisecond, continuous and interleaved modes)
+} fl_range_ctrl_t;
+
+typedef struct _fl_config_write
+{
+  uint8_t     item;         // FL_MSG_CONFIG_XXX
+  uint32_t    value;        // 0 : delete
+} fl_config_write_t;
+
+typedef struct _fl_config_read
+{
+  uint8_t     item;         // FL_MSG_CONFIG_XXX
+} fl_config_read_t;
+
+// Argument order depends on op(FL_MSG_PROFILE_XXX).
+typedef struct _fl_profile_write
+{
+  uint8_t     op;           // FL_MSG_PROFILE_XXX
+  uint8_t     i2c_num;      // I2C number
+  uint16_t    dev_addr;     // Target device address
+  uint16_t    reg_addr;     // Register address
+  uint32_t    value;        // Register value
+  uint8_t     profile;      // Profile slot(begin, delete)
+  char        name[FL_MSG_PROFILE_NAME_LEN];  // Profile name(begin)
+} fl_profile_write_t;
+
 FL_END_PACK
 
 typedef void(*fl_msg_cb_on_parsed_t)(const void* parser_handle, void* context);
@@ -0,0 +1,67 @@
+// Firmware library performance counter
+// fl_perf.h
+//
+// Per-stage latency statistics measured with the DWT cycle counter(SystemCoreClock).
+// Remove FL_ENABLE_PERF(fl_def.h) to compile out all measurement points.
+// Boot stages are measured once from fl_perf_init() at the start of main(), the cycles before
+// SystemClock_Config() are counted at the reset clock(HSI 16MHz).
+
+#ifndef FL_PERF_H
+#define FL_PERF_H
+
+#include "stm32f7xx_hal.h"
+#include "fl_def.h"
+
+// Measurement stages.
+#define FL_PERF_STAGE_PARSE         (0) // First byte of a command to a parsed message.
+#define FL_PERF_STAGE_HANDLER       (1) // Parsed message to the end of the command handler.
+#define FL_PERF_STAGE_I2C           (2) // One I2C register transaction.
+#define FL_PERF_STAGE_TX            (3) // UART transmit of a response/event.
+#define FL_PERF_STAGE_RX_TO_I2C     (4) // Last byte of a RWI2C command to the start of its I2C transfer.
+#define FL_PERF_STAGE_BOOT_TO_RX    (5) // Reset to the message receive start(the first command is accepted).
+#define FL_PERF_STAGE_BOOT_TO_READY (6) // Reset to the end of the boot sensor enumeration(ready event).
+#define FL_PERF_STAGE_COUNT         (7)
+
+// Histogram bucket n counts durations in [2^(n + FL_PERF_HIST_SHIFT), 2^(n + FL_PERF_HIST_SHIFT + 1)) cycles.
+// Bucket 0 also counts shorter durations, the last bucket also counts longer durations.
+// 216MHz : bucket 0 < 2.4us, bucket 15 >= 38.8ms
+#define FL_PERF_HIST_BUCKETS        (16)
+#define FL_PERF_HIST_SHIFT          (9)
+
+FL_BEGIN_PACK1
+
+typedef struct _fl_perf_stat
+{
+  uint32_t    count;
+  uint32_t    min;      // cycles
+  uint32_t    max;      // cycles
+  uint64_t    sum;      // cycles
+  uint32_t    hist[FL_PERF_HIST_BUCKETS];
+
+  // Cycle count at the stage start.
+  uint32_t    start;
+} fl_perf_stat_t;
+
+FL_END_PACK
+
+#if defined(FL_ENABLE_PERF)
+#define FL_PERF_BEGIN(stage)        fl_perf_begin(stage)
+#define FL_PERF_END(stage)          fl_perf_end(stage)
+#else
+#define FL_PERF_BEGIN(stage)
+#define FL_PERF_END(stage)
+#endif
+
+FL_BEGIN_DECLS
+
+#if defined(FL_ENABLE_PERF)
+FL_DECLARE(void) fl_perf_init(void);
+FL_DECLARE(void) fl_perf_begin(uint8_t stage);
+FL_DECLARE(void) fl_perf_end(uint8_t stage);
+FL_DECLARE(const fl_perf_stat_t*) fl_perf_get(uint8_t stage);
+FL_DECLARE(void) fl_perf_reset(uint8_t stage);
+#endif
+
+FL_END_DECLS
+
+#endif
@@ -0,0 +1,42 @@
+// Firmware library ring buffer
+// fl_ring.h
+//
+// Fixed size element ring buffer on a caller supplied memory.
+// One producer(timer/ISR context) and one consumer(main loop) can use it without locking.
+
+#ifndef FL_RING_H
+#define FL_RING_H
+
+#include "fl_def.h"
+
+typedef struct _fl_ring
+{
+  // Element buffer(elem_size * capacity bytes).
+  uint8_t*            buf;
+
+  // Size of an element.
+  uint16_t            elem_size;
+
+  // Number of elements, it must be a power of 2.
+  uint32_t            capacity;
+
+  // Free running write/read index.
+  volatile uint32_t   head;
+  volatile uint32_t   tail;
+
+  // The number of elements dropped because the ring was full.
+  volatile uint32_t   overrun;
+} fl_ring_t;
+
+FL_BEGIN_DECLS
+
+FL_DECLARE(void) fl_ring_init(fl_ring_t* ring, void* buf, uint16_t elem_size, uint32_t capacity);
+FL_DECLARE(void) fl_ring_clear(fl_ring_t* ring);
+FL_DECLARE(uint32_t) fl_ring_count(fl_ring_t* ring);
+FL_DECLARE(fl_status_t) fl_ring_push(fl_ring_t* ring, const void* elem);
+FL_DECLARE(fl_status_t) fl_ring_pop(fl_ring_t* ring, void* elem);
+FL_DECLARE(uint32_t) fl_ring_pop_n(fl_ring_t* ring, void* elems, uint32_t max_count);
+
+FL_END_DECLS
+
+#endif
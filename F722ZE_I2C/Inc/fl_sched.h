@@ -0,0 +1,95 @@
+// Firmware library scheduler
+// fl_sched.h
+//
+// Run-to-completion event scheduler : an event queue, soft timers driven by a tick source
+// and deferred work items. Handlers run one at a time in the main loop(fl_sched_run()).
+// Define FL_SCHED_HOST to build it on a PC with a simulated tick(fl_sched_tick()).
+
+#ifndef FL_SCHED_H
+#define FL_SCHED_H
+
+#include "fl_def.h"
+
+#if !defined(FL_SCHED_HOST)
+#include "stm32f7xx_hal.h"
+#endif
+
+// Event queue size(power of 2).
+#define FL_SCHED_EVENT_QUEUE_SIZE     (32)
+
+// Number of soft timers.
+#define FL_SCHED_TIMER_COUNT          (8)
+
+// Critical section for the event queue(events are posted from interrupt handlers).
+#if defined(FL_SCHED_HOST)
+#define FL_SCHED_LOCK()
+#define FL_SCHED_UNLOCK()
+#define FL_SCHED_WAIT_FOR_INTERRUPT()
+#else
+#define FL_SCHED_LOCK()               uint32_t _primask = __get_PRIMASK(); __disable_irq()
+#define FL_SCHED_UNLOCK()             __set_PRIMASK(_primask)
+#define FL_SCHED_WAIT_FOR_INTERRUPT() __WFI()
+#endif
+
+// Event/timer handler.
+typedef void(*fl_sched_handler_t)(uint32_t param, void* context);
+
+FL_BEGIN_PACK1
+
+typedef struct _fl_sched_event
+{
+  fl_sched_handler_t  handler;
+  uint32_t            param;
+  void*               context;
+} fl_sched_event_t;
+
+typedef struct _fl_sched_timer
+{
+  fl_sched_handler_t  handler;
+  uint32_t            param;
+  void*               context;
+
+  // Expiration tick.
+  uint32_t            expire;
+
+  // 0 : one-shot timer.
+  uint32_t            period;
+
+  volatile fl_bool_t  active;
+} fl_sched_timer_t;
+
+typedef struct _fl_sched
+{
+  fl_sched_event_t    events[FL_SCHED_EVENT_QUEUE_SIZE];
+
+  // Free running write/read index.
+  volatile uint32_t   head;
+  volatile uint32_t   tail;
+
+  // The number of events dropped because the queue was full.
+  volatile uint32_t   dropped;
+
+  fl_sched_timer_t    timers[FL_SCHED_TIMER_COUNT];
+
+  // Scheduler tick(millisecond).
+  volatile uint32_t   tick;
+} fl_sched_t;
+
+FL_END_PACK
+
+FL_BEGIN_DECLS
+
+FL_DECLARE(void) fl_sched_init(fl_sched_t* sched);
+FL_DECLARE(void) fl_sched_tick(fl_sched_t* sched);
+FL_DECLARE(uint32_t) fl_sched_get_tick(fl_sched_t* sched);
+FL_DECLARE(fl_status_t) fl_sched_post(fl_sched_t* sched, fl_sched_handler_t handler, uint32_t param, void* context);
+FL_DECLARE(uint32_t) fl_sched_pending(fl_sched_t* sched);
+FL_DECLARE(fl_status_t) fl_sched_timer_start(fl_sched_t* sched, uint8_t timer_id, fl_sched_handler_t handler, uint32_t param, void* context, uint32_t delay, uint32_t period);
+FL_DECLARE(void) fl_sched_timer_stop(fl_sched_t* sched, uint8_t timer_id);
+FL_DECLARE(fl_bool_t) fl_sched_timer_is_active(fl_sched_t* sched, uint8_t timer_id);
+FL_DECLARE(uint32_t) fl_sched_run(fl_sched_t* sched);
+FL_DECLARE(void) fl_sched_idle(fl_sched_t* sched);
+
+FL_END_DECLS
+
+#endif
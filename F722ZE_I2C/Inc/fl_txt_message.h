@@ -10,9 +10,13 @@ FL_BEGIN_DECLS
 
 #define FL_TXT_MSG_MAX_LENGTH           (64)
 
+// Maximum length of a batch response(RCAPT, RBURS).
+#define FL_TXT_MSG_MAX_BATCH_LENGTH     (512)
+
 #define FL_TXT_MSG_ID_MAX_LEN           (5)
 
-#define FL_TXT_MSG_DEVICE_ID_MAX_LEN    (2)
+// Device ID is an uint32_t(FL_DEVICE_ID_ALL : 4294967295).
+#define FL_TXT_MSG_DEVICE_ID_MAX_LEN    (10)
 
 #define FL_TXT_MSG_ERROR_MAX_LEN        (3)
 
@@ -29,6 +33,110 @@ FL_BEGIN_DECLS
 //   |   |----------> device id
 //   |--------------> response
 //
+// RCAPT 1,0,10,0,2,AAAAAAAAAAAAAAAAAAAAAA==\n
+//   |   | |  | | |   |----> base64 encoded samples(fl_capture_sample_t)
+//   |   | |  | | |--------> number of samples in this response
+//   |   | |  | |----------> number of dropped samples(ring full)
+//   |   | |  |------------> number of samples remaining on the device
+//   |   | |---------------> result(ok, fail)
+//   |   |-----------------> device id
+//   |---------------------> response
+//
+// RBURS 1,0,1,82,0,5,tAEDAQI=\n
+//   |   | | | |  | |   |----> base64 encoded register bytes(register address order)
+//   |   | | | |  | |--------> number of bytes
+//   |   | | | |  |----------> first register address
+//   |   | | | |-------------> 8-bit device address
+//   |   | | |---------------> I2C number
+//   |   | |-----------------> result(ok, fail)
+//   |   |-------------------> device id
+//   |-----------------------> response
+//
+// WBITS 1,1,82,20,7,4\n
+//   |   | | |  |  | |----> new value of the bits
+//   |   | | |  |  |------> mask of the bits
+//   |   | | |  |---------> register address
+//   |   | | |------------> 8-bit device address
+//   |   | |--------------> I2C number
+//   |   |----------------> device id
+//   |--------------------> command(register read-modify-write)
+//
+// WBITS 1,0,36\n
+//   |   | | |----> register value written
+//   |   | |------> result(ok, fail)
+//   |   |--------> device id
+//   |------------> response
+//
+// RSENS 1,0,5,96,0,100\n
+//   |   | | | |  | |------> 8-bit address of sensor 2(0 : not found)
+//   |   | | | |  |--------> 8-bit address of sensor 1
+//   |   | | | |-----------> 8-bit address of sensor 0
+//   |   | | |-------------> mask of the sensors found
+//   |   | |---------------> result(ok, fail)
+//   |   |-----------------> device id
+//   |---------------------> response
+//
+// WRANG 1,0,2,20\n
+//   |   | | | |------> intermeasurement period(ms, continuous and interleaved modes)
+//   |   | | |--------> mode(stop, single-shot, continuous, interleaved range + ALS)
+//   |   | |----------> sensor index
+//   |   |------------> device id
+//   |----------------> command
+//
+// ERANG 1,0,112,0,0\n
+//   |   | | |   | |------> ALS count(always 0, interleaved mode results are EMEAS events)
+//   |   | | |   |--------> range error code(RESULT__RANGE_STATUS[7:4])
+//   |   | | |------------> range(mm)
+//   |   | |--------------> sensor index
+//   |   |----------------> device id
+//   |--------------------> event
+//
+// EMEAS 1,0,112,0,1363148\n
+//   |   | | |   | |------> lux(Q16.16, 1363148 / 65536 = 20.8 lux)
+//   |   | | |   |--------> range error code(RESULT__RANGE_STATUS[7:4])
+//   |   | | |------------> range(mm)
+//   |   | |--------------> sensor index
+//   |   |----------------> device id
+//   |--------------------> event
+//
+// EREDY 1,7,42\n
+//   |   | | |------> boot time(ms)
+//   |   | |--------> sensor mask(bit n : sensor n found)
+//   |   |----------> device id
+//   |--------------> event
+//
+// WCONF 1,1,460800\n
+//   |   | | |------> value
+//   |   | |--------> item(device id, baud rate, I2C1 speed, I2C2 speed, 0 value : delete)
+//   |   |----------> device id
+//   |--------------> command
+//
+// RCONF 1,0,2,1000000\n
+//   |   | | | |------> value
+//   |   | | |--------> item
+//   |   | |----------> result(ok, fail, not stored)
+//   |   |------------> device id
+//   |----------------> response
+//
+// WPROF 1,1,1,96,17,16\n
+//   |   | | | |  |  |------> register value(add)
+//   |   | | | |  |---------> register address(add)
+//   |   | | | |------------> 8-bit device address(add), profile name(begin)
+//   |   | | |--------------> I2C number(add), profile slot(begin, delete)
+//   |   | |----------------> op(begin, add, save, delete)
+//   |   |------------------> device id
+//   |----------------------> command
+//
+// RPERF 1,0,2,10,20000,32000,25000,AAAA...\n
+//   |   | | |  |     |     |     |----> base64 encoded histogram(uint32_t x FL_PERF_HIST_BUCKETS)
+//   |   | | |  |     |     |----------> mean(cycles)
+//   |   | | |  |     |----------------> max(cycles)
+//   |   | | |  |----------------------> min(cycles)
+//   |   | | |-------------------------> count
+//   |   | |---------------------------> stage
+//   |   |-----------------------------> result(ok, fail)
+//   |---------------------------------> response
+//
 // WGPIO 1,1,1\n
 //    |  | | |---> GPIO output value
 //    |  | |-----> GPIO id
@@ -37,6 +145,21 @@ FL_BEGIN_DECLS
 #define FL_TXT_RHVER_STR                ("RHVER")   // Read hardware version.
 #define FL_TXT_RFVER_STR                ("RFVER")   // Read firmware version.
 #define FL_TXT_RwI2C_STR                ("RWI2C")   // Read/write I2C.
+#define FL_TXT_WCAPT_STR                ("WCAPT")   // Capture mode start/stop.
+#define FL_TXT_RCAPT_STR                ("RCAPT")   // Read captured samples.
+#define FL_TXT_ECAPT_STR                ("ECAPT")   // Capture watermark event.
+#define FL_TXT_RPERF_STR                ("RPERF")   // Read latency statistics.
+#define FL_TXT_WI2CS_STR                ("WI2CS")   // Write I2C bus speed.
+#define FL_TXT_RSENS_STR                ("RSENS")   // Read(enumerate) sensors.
+#define FL_TXT_WRANG_STR                ("WRANG")   // Write ranging mode of a sensor.
+#define FL_TXT_ERANG_STR                ("ERANG")   // Range result event.
+#define FL_TXT_EMEAS_STR                ("EMEAS")   // Range and lux event.
+#define FL_TXT_WCONF_STR                ("WCONF")   // Write a configuration item.
+#define FL_TXT_RCONF_STR                ("RCONF")   // Read a configuration item.
+#define FL_TXT_WPROF_STR                ("WPROF")   // Write a register init profile.
+#define FL_TXT_EREDY_STR                ("EREDY")   // Device ready event.
+#define FL_TXT_RBURS_STR                ("RBURS")   // Read consecutive I2C registers.
+#define FL_TXT_WBITS_STR                ("WBITS")   // Update I2C register bits.
 
 FL_BEGIN_PACK1
 
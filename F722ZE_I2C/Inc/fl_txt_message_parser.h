@@ -2,6 +2,7 @@
 #ifndef FL_TXT_MSG_PARSER_H
 #define FL_TXT_MSG_PARSER_H
 
+#include <stddef.h>
 #include "fl_txt_message.h"
 
 #define FL_TXT_MSG_PARSER_PARSING             (FL_ERROR + 1)
@@ -12,6 +13,45 @@
 #define FL_TXT_MSG_PARSER_RCV_STS_DATA        (3)
 #define FL_TXT_MSG_PARSER_RCV_STS_TAIL        (4)
 
+// Command flags.
+#define FL_TXT_MSG_CMD_FLAG_BCAST             (0x01)  // Answered for a broadcast command(FL_DEVICE_ID_ALL).
+#define FL_TXT_MSG_CMD_FLAG_I2C               (0x02)  // Uses the I2C buses(refused until the device is ready).
+
+// Argument field of a command payload.
+#define FL_TXT_MSG_ARG(type, field)           { offsetof(type, field), sizeof(((type*)0)->field) }
+
+typedef struct _fl_txt_msg_arg_def
+{
+  // Field offset in the payload.
+  uint8_t               offset;
+
+  // Field size(1, 2, 4 bytes).
+  uint8_t               size;
+} fl_txt_msg_arg_def_t;
+
+typedef struct _fl_txt_msg_cmd_def fl_txt_msg_cmd_def_t;
+
+// Decode an argument string into the payload.
+typedef fl_bool_t(*fl_txt_msg_decode_t)(const fl_txt_msg_cmd_def_t* cmd, void* payload, uint8_t arg_index, const char* arg);
+
+// Command table entry(indexed by message ID).
+struct _fl_txt_msg_cmd_def
+{
+  // Argument schema(max_arg_count fields).
+  const fl_txt_msg_arg_def_t* args;
+  uint8_t                     min_arg_count;
+  uint8_t                     max_arg_count;
+
+  // NULL : fl_txt_msg_decode_arg()
+  fl_txt_msg_decode_t         decode;
+
+  // Command handler(NULL : the command is not supported).
+  fl_msg_cb_on_parsed_t       handler;
+
+  // FL_TXT_MSG_CMD_FLAG_XXX
+  uint8_t                     flags;
+};
+
 FL_BEGIN_PACK1
 
 typedef struct _fl_txt_msg_parser
@@ -43,6 +83,10 @@ typedef struct _fl_txt_msg_parser
   fl_msg_cb_on_parsed_t             on_parsed_callback;
   fl_msg_dbg_cb_on_parse_started_t  on_parse_started_callback;
   fl_msg_dbg_cb_on_parse_ended_t    on_parse_ended_callback;
+
+  // Command table for argument decoding(fl_txt_msg_parser_parse_command()).
+  const fl_txt_msg_cmd_def_t*       cmd_table;
+  uint8_t                           cmd_count;
 } fl_txt_msg_parser_t;
 
 FL_END_PACK
@@ -54,6 +98,8 @@ FL_DECLARE(void) fl_txt_msg_parser_clear(fl_txt_msg_parser_t* parser_handle);
 FL_DECLARE(fl_status_t) fl_txt_msg_parser_parse_command(fl_txt_msg_parser_t* parser_handle, uint8_t data, fl_txt_msg_t* msg_handle);
 FL_DECLARE(fl_status_t) fl_txt_msg_parser_parse_response_event(fl_txt_msg_parser_t* parser_handle, uint8_t data, fl_txt_msg_t* msg_handle);
 FL_DECLARE(uint8_t) fl_txt_msg_parser_get_msg_id(uint8_t* buf, uint8_t buf_size);
+FL_DECLARE(const fl_txt_msg_cmd_def_t*) fl_txt_msg_parser_get_cmd(fl_txt_msg_parser_t* parser_handle, uint8_t msg_id);
+FL_DECLARE(fl_bool_t) fl_txt_msg_decode_arg(const fl_txt_msg_cmd_def_t* cmd, void* payload, uint8_t arg_index, const char* arg);
 
 FL_END_DECLS
 
@@ -0,0 +1,119 @@
+// Firmware library VL6180X
+// fl_vl6180x.h
+//
+// ST VL6180X proximity(range) and ambient light sensor on fl_i2c(blocking mode transfers).
+// Registers and settings : VL6180X datasheet(DocID026171), AN4545(VL6180X basic ranging).
+
+#ifndef FL_VL6180X_H
+#define FL_VL6180X_H
+
+#include "fl_def.h"
+#include "fl_i2c.h"
+
+// Registers.
+#define FL_VL6180X_IDENTIFICATION_MODEL_ID          (0x0000)
+#define FL_VL6180X_SYSTEM_MODE_GPIO1                (0x0011)
+#define FL_VL6180X_SYSTEM_INTERRUPT_CONFIG_GPIO     (0x0014)
+#define FL_VL6180X_SYSTEM_INTERRUPT_CLEAR           (0x0015)
+#define FL_VL6180X_SYSTEM_FRESH_OUT_OF_RESET        (0x0016)
+#define FL_VL6180X_SYSRANGE_START                   (0x0018)
+#define FL_VL6180X_SYSRANGE_INTERMEASUREMENT_PERIOD (0x001B)
+#define FL_VL6180X_SYSRANGE_VHV_RECALIBRATE         (0x002E)
+#define FL_VL6180X_SYSRANGE_VHV_REPEAT_RATE         (0x0031)
+#define FL_VL6180X_SYSALS_START                     (0x0038)
+#define FL_VL6180X_SYSALS_INTERMEASUREMENT_PERIOD   (0x003E)
+#define FL_VL6180X_SYSALS_ANALOGUE_GAIN             (0x003F)
+#define FL_VL6180X_SYSALS_INTEGRATION_PERIOD        (0x0040)
+#define FL_VL6180X_RESULT_RANGE_STATUS              (0x004D)
+#define FL_VL6180X_RESULT_INTERRUPT_STATUS_GPIO     (0x004F)
+#define FL_VL6180X_RESULT_ALS_VAL                   (0x0050)
+#define FL_VL6180X_RESULT_RANGE_VAL                 (0x0062)
+#define FL_VL6180X_READOUT_AVERAGING_SAMPLE_PERIOD  (0x010A)
+#define FL_VL6180X_I2C_SLAVE_DEVICE_ADDRESS         (0x0212)
+#define FL_VL6180X_INTERLEAVED_MODE_ENABLE          (0x02A3)
+
+// IDENTIFICATION__MODEL_ID
+#define FL_VL6180X_MODEL_ID                         (0xB4)
+
+// SYSRANGE__START, SYSALS__START
+#define FL_VL6180X_START_SINGLE                     (0x01)  // Single-shot, stops a continuous mode.
+#define FL_VL6180X_START_CONTINUOUS                 (0x03)
+
+// RESULT__INTERRUPT_STATUS_GPIO : range(bit 0 ~ 2), ALS(bit 3 ~ 5).
+#define FL_VL6180X_INT_NEW_SAMPLE                   (0x04)
+#define FL_VL6180X_INT_RANGE_READY(status)          (((status) & 0x07) == FL_VL6180X_INT_NEW_SAMPLE)
+#define FL_VL6180X_INT_ALS_READY(status)            ((((status) >> 3) & 0x07) == FL_VL6180X_INT_NEW_SAMPLE)
+
+// SYSTEM__INTERRUPT_CLEAR
+#define FL_VL6180X_CLEAR_RANGE                      (0x01)
+#define FL_VL6180X_CLEAR_ALS                        (0x02)
+#define FL_VL6180X_CLEAR_ERROR                      (0x04)
+#define FL_VL6180X_CLEAR_ALL                        (0x07)
+
+// Range error code : RESULT__RANGE_STATUS[7:4].
+#define FL_VL6180X_RANGE_ERROR(range_status)        (((range_status) >> 4) & 0x0F)
+
+// Intermeasurement period(ms) : (register value + 1) x 10ms.
+#define FL_VL6180X_PERIOD_UNIT                      (10)
+#define FL_VL6180X_PERIOD_MAX                       (2550)
+
+// Interleaved mode : ALS integration(100ms, fl_vl6180x_init()) and a range measurement in one period.
+#define FL_VL6180X_INTERLEAVED_PERIOD_MIN           (150)
+
+// SYSALS__ANALOGUE_GAIN[2:0], SYSALS__INTEGRATION_PERIOD[8:0] : (register value + 1)ms.
+#define FL_VL6180X_ALS_GAIN_MASK                    (0x07)
+#define FL_VL6180X_ALS_INTEGRATION_MASK             (0x01FF)
+
+// Lux : 0.32 x ALS count / gain x (100ms / integration period)(datasheet), Q16.16 fixed-point.
+#define FL_VL6180X_LUX_FRAC_BITS                    (16)
+#define FL_VL6180X_LUX_MAX                          (0xFFFFFFFF)  // Saturated lux.
+
+// Measurement modes.
+#define FL_VL6180X_MODE_STOP                        (0) // Software standby.
+#define FL_VL6180X_MODE_SINGLE                      (1) // One range measurement.
+#define FL_VL6180X_MODE_CONTINUOUS                  (2) // Range measurement every period.
+#define FL_VL6180X_MODE_INTERLEAVED                 (3) // ALS then range measurement every period.
+
+FL_BEGIN_PACK1
+
+typedef struct _fl_vl6180x
+{
+  fl_i2c_t*   i2c;
+
+  // 8-bit address.
+  uint8_t     dev_addr;
+
+  // FL_VL6180X_MODE_XXX
+  uint8_t     mode;
+
+  // ALS settings for the lux conversion(fl_vl6180x_init(), interleaved mode start).
+  uint8_t     als_gain;         // SYSALS__ANALOGUE_GAIN[2:0]
+  uint16_t    als_int_time;     // Integration period(ms)
+} fl_vl6180x_t;
+
+typedef struct _fl_vl6180x_result
+{
+  // RESULT__INTERRUPT_STATUS_GPIO(FL_VL6180X_INT_RANGE_READY(), FL_VL6180X_INT_ALS_READY()).
+  uint8_t     int_status;
+
+  uint8_t     range;          // mm
+  uint8_t     range_error;    // FL_VL6180X_RANGE_ERROR()
+  uint16_t    als;            // ALS count
+  uint32_t    lux;            // Q16.16(fl_vl6180x_als_to_lux())
+} fl_vl6180x_result_t;
+
+FL_END_PACK
+
+FL_BEGIN_DECLS
+
+FL_DECLARE(fl_status_t) fl_vl6180x_init(fl_vl6180x_t *handle);
+FL_DECLARE(fl_status_t) fl_vl6180x_start(fl_vl6180x_t *handle, uint8_t mode, uint16_t period);
+FL_DECLARE(fl_status_t) fl_vl6180x_stop(fl_vl6180x_t *handle);
+FL_DECLARE(fl_status_t) fl_vl6180x_read_result(fl_vl6180x_t *handle, fl_vl6180x_result_t *result);
+FL_DECLARE(fl_status_t) fl_vl6180x_check_period(uint8_t mode, uint16_t period);
+FL_DECLARE(uint32_t) fl_vl6180x_als_to_lux(const fl_vl6180x_t *handle, uint16_t als);
+FL_DECLARE(uint8_t) fl_vl6180x_reg_size(uint16_t reg_addr);
+
+FL_END_DECLS
+
+#endif
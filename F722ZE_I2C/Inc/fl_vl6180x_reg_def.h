@@ -0,0 +1,67 @@
+// Firmware library VL6180X register sizes
+// fl_vl6180x_reg_def.h
+//
+// Generated by RegisterCatalogGen from vl6180x.json, do not edit.
+// FL_VL6180X_REG(register address, size(bytes)) in address order(no include guard).
+
+FL_VL6180X_REG(0x0000, 1)  // IDENTIFICATION__MODEL_ID
+FL_VL6180X_REG(0x0001, 1)  // IDENTIFICATION__MODEL_REV_MAJOR
+FL_VL6180X_REG(0x0002, 1)  // IDENTIFICATION__MODEL_REV_MINOR
+FL_VL6180X_REG(0x0003, 1)  // IDENTIFICATION__MODULE_REV_MAJOR
+FL_VL6180X_REG(0x0004, 1)  // IDENTIFICATION__MODULE_REV_MINOR
+FL_VL6180X_REG(0x0006, 1)  // IDENTIFICATION__DATE_HI
+FL_VL6180X_REG(0x0007, 1)  // IDENTIFICATION__DATE_LO
+FL_VL6180X_REG(0x0008, 2)  // IDENTIFICATION__TIME
+FL_VL6180X_REG(0x0010, 1)  // SYSTEM__MODE_GPIO0
+FL_VL6180X_REG(0x0011, 1)  // SYSTEM__MODE_GPIO1
+FL_VL6180X_REG(0x0012, 1)  // SYSTEM__HISTORY_CTRL
+FL_VL6180X_REG(0x0014, 1)  // SYSTEM__INTERRUPT_CONFIG_GPIO
+FL_VL6180X_REG(0x0015, 1)  // SYSTEM__INTERRUPT_CLEAR
+FL_VL6180X_REG(0x0016, 1)  // SYSTEM__FRESH_OUT_OF_RESET
+FL_VL6180X_REG(0x0017, 1)  // SYSTEM__GROUPED_PARAMETER_HOLD
+FL_VL6180X_REG(0x0018, 1)  // SYSRANGE__START
+FL_VL6180X_REG(0x0019, 1)  // SYSRANGE__THRESH_HIGH
+FL_VL6180X_REG(0x001A, 1)  // SYSRANGE__THRESH_LOW
+FL_VL6180X_REG(0x001B, 1)  // SYSRANGE__INTERMEASUREMENT_PERIOD
+FL_VL6180X_REG(0x001C, 1)  // SYSRANGE__MAX_CONVERGENCE_TIME
+FL_VL6180X_REG(0x001E, 2)  // SYSRANGE__CROSSTALK_COMPENSATION_RATE
+FL_VL6180X_REG(0x0021, 1)  // SYSRANGE__CROSSTALK_VALID_HEIGHT
+FL_VL6180X_REG(0x0022, 2)  // SYSRANGE__EARLY_CONVERGENCE_ESTIMATE
+FL_VL6180X_REG(0x0024, 1)  // SYSRANGE__PART_TO_PART_RANGE_OFFSET
+FL_VL6180X_REG(0x0025, 1)  // SYSRANGE__RANGE_IGNORE_VALID_HEIGHT
+FL_VL6180X_REG(0x0026, 2)  // SYSRANGE__RANGE_IGNORE_THRESHOLD
+FL_VL6180X_REG(0x002C, 1)  // SYSRANGE__MAX_AMBIENT_LEVEL_MULT
+FL_VL6180X_REG(0x002D, 1)  // SYSRANGE__RANGE_CHECK_ENABLES
+FL_VL6180X_REG(0x002E, 1)  // SYSRANGE__VHV_RECALIBRATE
+FL_VL6180X_REG(0x0031, 1)  // SYSRANGE__VHV_REPEAT_RATE
+FL_VL6180X_REG(0x0038, 1)  // SYSALS__START
+FL_VL6180X_REG(0x003A, 2)  // SYSALS__THRESH_HIGH
+FL_VL6180X_REG(0x003C, 2)  // SYSALS__THRESH_LOW
+FL_VL6180X_REG(0x003E, 1)  // SYSALS__INTERMEASUREMENT_PERIOD
+FL_VL6180X_REG(0x003F, 1)  // SYSALS__ANALOGUE_GAIN
+FL_VL6180X_REG(0x0040, 2)  // SYSALS__INTEGRATION_PERIOD
+FL_VL6180X_REG(0x004D, 1)  // RESULT__RANGE_STATUS
+FL_VL6180X_REG(0x004E, 1)  // RESULT__ALS_STATUS
+FL_VL6180X_REG(0x004F, 1)  // RESULT__INTERRUPT_STATUS_GPIO
+FL_VL6180X_REG(0x0050, 2)  // RESULT__ALS_VAL
+FL_VL6180X_REG(0x0052, 2)  // RESULT__HISTORY_BUFFER_0
+FL_VL6180X_REG(0x0054, 2)  // RESULT__HISTORY_BUFFER_1
+FL_VL6180X_REG(0x0056, 2)  // RESULT__HISTORY_BUFFER_2
+FL_VL6180X_REG(0x0058, 2)  // RESULT__HISTORY_BUFFER_3
+FL_VL6180X_REG(0x005A, 2)  // RESULT__HISTORY_BUFFER_4
+FL_VL6180X_REG(0x005C, 2)  // RESULT__HISTORY_BUFFER_5
+FL_VL6180X_REG(0x005E, 2)  // RESULT__HISTORY_BUFFER_6
+FL_VL6180X_REG(0x0060, 2)  // RESULT__HISTORY_BUFFER_7
+FL_VL6180X_REG(0x0062, 1)  // RESULT__RANGE_VAL
+FL_VL6180X_REG(0x0066, 2)  // RESULT__RANGE_RETURN_RATE
+FL_VL6180X_REG(0x0068, 2)  // RESULT__RANGE_REFERENCE_RATE
+FL_VL6180X_REG(0x006C, 4)  // RESULT__RANGE_RETURN_SIGNAL_COUNT
+FL_VL6180X_REG(0x0070, 4)  // RESULT__RANGE_REFERENCE_SIGNAL_COUNT
+FL_VL6180X_REG(0x0074, 4)  // RESULT__RANGE_RETURN_AMB_COUNT
+FL_VL6180X_REG(0x0078, 4)  // RESULT__RANGE_REFERENCE_AMB_COUNT
+FL_VL6180X_REG(0x007C, 4)  // RESULT__RANGE_RETURN_CONV_TIME
+FL_VL6180X_REG(0x010A, 1)  // READOUT__AVERAGING_SAMPLE_PERIOD
+FL_VL6180X_REG(0x0119, 1)  // FIRMWARE__BOOTUP
+FL_VL6180X_REG(0x0120, 1)  // FIRMWARE__RESULT_SCALER
+FL_VL6180X_REG(0x0212, 1)  // I2C_SLAVE__DEVICE_ADDRESS
+FL_VL6180X_REG(0x02A3, 1)  // INTERLEAVED_MODE__ENABLE
@@ -14,6 +14,12 @@
 #include "fl_stm32.h"
 #include "fl_util.h"
 #include "fl_i2c.h"
+#include "fl_vl6180x.h"
+#include "fl_ring.h"
+#include "fl_perf.h"
+#include "fl_log.h"
+#include "fl_sched.h"
+#include "fl_flash_log.h"
 
 // Parser defines
 #define FW_APP_TXT_PARSER           (0)
@@ -40,20 +46,94 @@
 #define FW_APP_UART_RCV_IT(handle, buf, count)            HAL_UART_Receive_IT(handle, buf, count)
 #define FW_APP_UART_TRANSMIT(handle, buf, count, timeout) HAL_GPIO_Transmit(handle, buf, count, timeout)
 
-#define FW_APP_DEBUG_PACKET_LENGTH  (128)
-
-#define FW_APP_ONE_SEC_INTERVAL     (999) // 1 second
+#define FW_APP_ONE_SEC_INTERVAL     (1000) // 1 second
 
 #define FW_APP_PROTO_TX_TIMEOUT     (500)
 
-FL_BEGIN_PACK1
+// Response time slot for a broadcast command(FL_DEVICE_ID_ALL).
+// A node answers (device_id - 1) slot times after it received the command, so device IDs on a multi-drop link
+// should start from 1 without gaps(1 ~ FW_APP_MAX_NODE_COUNT). Handler times differ between nodes
+// (I2C queues, flash erase), a response not ready at the start of its slot(+ FW_APP_BCAST_LATE_MAX) is dropped.
+// Slot time : a full text message(FL_TXT_MSG_MAX_LENGTH, 10 bits a byte) at the message UART baud rate
+// in milliseconds(rounded up) + FW_APP_BCAST_SLOT_GUARD for the transceiver turnaround.
+// 115200bps : 6 + 2ms, 9600bps : 67 + 2ms.
+#define FW_APP_BCAST_SLOT_GUARD     (2)
 
-typedef struct _fw_app_debug_manager
-{
-  FW_APP_UART_HANDLE    uart_handle;
-  uint8_t               buf[FW_APP_DEBUG_PACKET_LENGTH];
-  uint8_t               length;
-} fw_app_debug_manager_t;
+// Tick resolution of the command receipt, covered by the slot guard.
+#define FW_APP_BCAST_LATE_MAX       (1)
+
+// Nodes on a multi-drop link(32 unit loads of RS-485), the device ID of a node is 1 ~ FW_APP_MAX_NODE_COUNT.
+#define FW_APP_MAX_NODE_COUNT       (32)
+
+// Capture ring size(number of fl_capture_sample_t, power of 2).
+// 16384 samples(128KB) : about 16 seconds at 1ms sampling period without host reads.
+#define FW_APP_CAPTURE_RING_SIZE    (16384)
+
+// Maximum number of samples in a RCAPT response(FL_TXT_MSG_MAX_BATCH_LENGTH).
+#define FW_APP_CAPTURE_BATCH_SIZE   (32)
+
+// I2C buses(i2c_num of RWI2C, WCAPT and WI2CS : 1 ~ FW_APP_I2C_BUS_COUNT).
+// I2C1 : PB6(SCL), PB9(SDA)
+// I2C2 : PF1(SCL), PF0(SDA)
+// I2C3 pins are used by USB SOF(PA8) and DIN2(PC9) on this board.
+#define FW_APP_I2C_BUS_COUNT        (2)
+
+// SCL/SDA rise and fall time(ns) of the board for fl_i2c_set_speed().
+// 30% ~ 70% edges of the sensor board pull-ups(4.7kohm) with about 25pF of the bus and the pins.
+#define FW_APP_I2C_RISE_TIME        (100)
+#define FW_APP_I2C_FALL_TIME        (10)
+
+// Number of queued transfers of a bus(a capture sample takes 5 transfers at most, a RWI2C command 1,
+// a range result 5 for each sensor).
+#define FW_APP_I2C_QUEUE_SIZE       (16)
+
+// VL6180X sensors, enabled one at a time by their CE pins(fw_app_sensor_enum()).
+// All sensors boot at FW_APP_SENSOR_DEFAULT_ADDR, sensor n is moved to FW_APP_SENSOR_BASE_ADDR + n.
+#define FW_APP_SENSOR_COUNT         (FL_MSG_SENSOR_MAX_COUNT)
+#define FW_APP_SENSOR_DEFAULT_ADDR  (0x29)  // 7-bit address
+#define FW_APP_SENSOR_BASE_ADDR     (0x30)  // 7-bit address
+
+// Sensor power up : every CE low for FW_APP_SENSOR_STANDBY_TIME, then the CE of one sensor high
+// for FW_APP_SENSOR_BOOT_TIME(boot time : 400us max) before it is identified.
+#define FW_APP_SENSOR_STANDBY_TIME  (10)    // ms
+#define FW_APP_SENSOR_BOOT_TIME     (1)     // ms
+
+// Result polling period of the sensors in a ranging mode(WRANG).
+// A result is read within 2ms of the measurement : 10ms continuous ranging(100Hz) on every sensor.
+#define FW_APP_RANGE_POLL_PERIOD    (2)
+
+// Number of event messages waiting for the UART(range events of all sensors, capture event).
+#define FW_APP_EVENT_QUEUE_SIZE     (8)
+
+// Configuration store(fl_flash_log) : flash sectors 6 and 7, the CONFIG region of STM32F722ZETX_FLASH.ld.
+#define FW_APP_CONFIG_SECTOR_A      (FLASH_SECTOR_6)
+#define FW_APP_CONFIG_ADDR_A        (0x08040000)
+#define FW_APP_CONFIG_SECTOR_B      (FLASH_SECTOR_7)
+#define FW_APP_CONFIG_ADDR_B        (0x08060000)
+#define FW_APP_CONFIG_SECTOR_SIZE   (0x20000)   // 128KB
+
+// Configuration keys.
+#define FW_APP_CONFIG_KEY_DEVICE_ID (0)
+#define FW_APP_CONFIG_KEY_BAUD_RATE (1)
+#define FW_APP_CONFIG_KEY_I2C_SPEED (2)         // + bus index
+#define FW_APP_CONFIG_KEY_PROFILE   (8)         // + profile slot
+
+// Device ID without a stored configuration.
+#define FW_APP_DEFAULT_DEVICE_ID    (1)
+
+// Message UART baud rate(USART3, 16x oversampling at 54MHz).
+#define FW_APP_BAUD_RATE_MIN        (9600)
+#define FW_APP_BAUD_RATE_MAX        (3000000)
+
+// Scheduler timers.
+#define FW_APP_TIMER_LED            (0) // LED1 toggle
+#define FW_APP_TIMER_BCAST_TX       (1) // Broadcast response time slot
+#define FW_APP_TIMER_CAPTURE        (2) // Capture sampling period
+#define FW_APP_TIMER_I2C_TIMEOUT    (3) // Interrupt mode I2C transfer timeout, one timer for each bus
+#define FW_APP_TIMER_RANGE_POLL     (FW_APP_TIMER_I2C_TIMEOUT + FW_APP_I2C_BUS_COUNT) // Ranging result polling
+#define FW_APP_TIMER_BOOT           (FW_APP_TIMER_RANGE_POLL + 1) // Boot sensor enumeration steps
+
+FL_BEGIN_PACK1
 
 // Protocol manager
 typedef struct _fw_app_proto_manager
@@ -64,22 +144,226 @@ typedef struct _fw_app_proto_manager
   // Buffer for received bytes.
   fl_queue_t            q;
   fl_txt_msg_parser_t   parser_handle;
-  uint8_t               out_buf[FL_TXT_MSG_MAX_LENGTH];
-  uint8_t               out_length;
+  uint8_t               out_buf[FL_TXT_MSG_MAX_BATCH_LENGTH];
+  uint16_t              out_length;
   uint8_t               rx_buf[1];
+
+  // Event messages(sent without a command) in order, a full queue drops new events.
+  uint8_t               evt_buf[FW_APP_EVENT_QUEUE_SIZE][FL_TXT_MSG_MAX_LENGTH];
+  uint8_t               evt_length[FW_APP_EVENT_QUEUE_SIZE];
+  uint8_t               evt_head;
+  uint8_t               evt_count;
+
+  // The head event is being transmitted.
+  fl_bool_t             evt_sending;
+
+  // A RX event is queued(received bytes are parsed in the event handler).
+  volatile fl_bool_t    rx_evt_pending;
+
+  // Interrupt mode transmit is in progress.
+  volatile fl_bool_t    tx_busy;
+
+  // The response of the current command is not ready(waiting for an I2C transfer).
+  fl_bool_t             cmd_pending;
+
+  // The current command is a broadcast command.
+  fl_bool_t             is_broadcast;
+
+  // Scheduler tick of the broadcast command receipt(start of the response slots).
+  uint32_t              bcast_rx_tick;
+
+  // Pending response for a broadcast command(FW_APP_TIMER_BCAST_TX).
+  fl_bool_t             tx_pending;
+
+  // The response is ready while an event is transmitted(sent in on_tx_done_event()).
+  fl_bool_t             resp_pending;
 } fw_app_proto_manager_t;
 
+// Interrupt mode I2C request of a RWI2C, RBURS or WBITS command.
+typedef struct _fw_app_i2c_request
+{
+  uint8_t               msg_id;
+  uint8_t               arg_count;
+  fl_i2c_write_t        i2c_wr;
+
+  // Bits updated by a WBITS command(i2c_wr.reg_value : new value of the bits).
+  uint32_t              mask;
+
+  // Register size(fl_vl6180x_reg_size()), number of bytes of a RBURS command.
+  uint16_t              byte_count;
+
+  // Register value read.
+  uint32_t              data;
+
+  // Bytes read by a RBURS command.
+  uint8_t               block[FL_MSG_I2C_MAX_BURST_LEN];
+} fw_app_i2c_request_t;
+
+struct _fw_app;
+struct _fw_app_i2c_xfer;
+
+// Called from the scheduler when a queued transfer is done(xfer->status : FL_OK or FL_I2C_ERR_XXX).
+typedef void (*fw_app_i2c_done_t)(struct _fw_app* app, const struct _fw_app_i2c_xfer* xfer);
+
+// Interrupt mode register transfer.
+typedef struct _fw_app_i2c_xfer
+{
+  fl_bool_t             write;
+  uint8_t               dev_addr;
+  uint16_t              reg_addr;
+
+  // Register size(1, 2, 4), number of bytes of a block read.
+  uint8_t               size;
+
+  // Value to write, or the value read.
+  uint32_t              data;
+
+  // Block read(size bytes) into the buffer, NULL : register transfer.
+  uint8_t*              block;
+
+  fl_status_t           status;
+  fw_app_i2c_done_t     on_done;
+} fw_app_i2c_xfer_t;
+
+// I2C bus : controller and its transfer queue.
+// Transfers of a bus run in queued order, transfers on different buses run concurrently.
+typedef struct _fw_app_i2c_bus
+{
+  fl_i2c_t              i2c;
+  uint8_t               index;
+
+  // Queued transfers, the head transfer owns the bus while active is FL_TRUE.
+  fw_app_i2c_xfer_t     xfers[FW_APP_I2C_QUEUE_SIZE];
+  uint8_t               head;
+  uint8_t               count;
+  fl_bool_t             active;
+
+  // Incremented for each transfer, a completion of an aborted transfer is ignored.
+  volatile uint8_t      seq;
+} fw_app_i2c_bus_t;
+
+// VL6180X sensor.
+typedef struct _fw_app_sensor
+{
+  GPIO_TypeDef*         ce_port;
+  uint16_t              ce_pin;
+  uint8_t               i2c_num;
+
+  // Driver handle(vl6180x.dev_addr 0 : not found).
+  fl_vl6180x_t          vl6180x;
+} fw_app_sensor_t;
+
+// Capture manager
+typedef struct _fw_app_capture_manager
+{
+  fl_bool_t             started;
+  uint8_t               i2c_num;
+  uint16_t              dev_addr;
+  uint16_t              period;
+  uint16_t              watermark;
+
+  // Watermark event is sent once until the host reads samples.
+  fl_bool_t             event_sent;
+
+  // FL_TRUE : interleaved single-shot ranging on all enumerated sensors(FL_MSG_CAPTURE_ALL_SENSORS).
+  fl_bool_t             all_sensors;
+
+  // Sensor with a range measurement started, FW_APP_SENSOR_COUNT : none.
+  uint8_t               ranging;
+
+  // Transfers of the current sample are queued(interrupt mode).
+  fl_bool_t             sampling;
+  fl_bool_t             sample_error;
+  uint8_t               xfer_pending;
+
+  // Sensor of the current sample, FW_APP_SENSOR_COUNT : no result is read.
+  uint8_t               sample_sensor;
+  fl_capture_sample_t   sample;
+
+  // Captured samples(fl_capture_sample_t).
+  fl_ring_t             ring;
+} fw_app_capture_manager_t;
+
+// A register write of a profile.
+typedef struct _fw_app_profile_entry
+{
+  uint8_t               i2c_num;
+  uint8_t               dev_addr;
+  uint16_t              reg_addr;
+
+  // Register size(fl_vl6180x_reg_size()).
+  uint8_t               size;
+  uint32_t              value;
+} fw_app_profile_entry_t;
+
+// Register init profile(flash record : name, count and count entries).
+typedef struct _fw_app_profile
+{
+  char                  name[FL_MSG_PROFILE_NAME_LEN];
+  uint8_t               count;
+  fw_app_profile_entry_t entries[FL_MSG_PROFILE_MAX_ENTRIES];
+} fw_app_profile_t;
+
+// Configuration manager : device settings and register init profiles in flash(fw_app_config.c).
+typedef struct _fw_app_config_manager
+{
+  fl_flash_log_t        log;
+
+  // fl_flash_log_init() result, the defaults are used without the log.
+  fl_status_t           log_status;
+
+  // Profile slot being built(WPROF), FL_MSG_PROFILE_COUNT : none.
+  uint8_t               building;
+  fw_app_profile_t      profile;
+} fw_app_config_manager_t;
+
+// Ranging manager : sensors in a ranging mode(WRANG) report their results in range events.
+typedef struct _fw_app_range_manager
+{
+  // Sensors in a ranging mode(bit n : sensor n).
+  uint8_t               active_mask;
+
+  // A WRANG command waits for the result reads queued on the bus of its sensor(interrupt mode).
+  fl_bool_t             ctrl_pending;
+  fl_range_ctrl_t       ctrl;
+
+  // Result reads of each sensor(interrupt mode transfers), queued after the status read.
+  uint8_t               xfer_pending[FW_APP_SENSOR_COUNT];
+  fl_bool_t             read_error[FW_APP_SENSOR_COUNT];
+  fl_vl6180x_result_t   results[FW_APP_SENSOR_COUNT];
+} fw_app_range_manager_t;
+
 
 // Firmware application manager.
 typedef struct _fw_app
 {
   uint32_t                device_id;
-  // Current tick count.
-  volatile uint32_t       tick;
+
+  // Event scheduler(SysTick).
+  fl_sched_t              sched;
 
   // Protocol manager.
   fw_app_proto_manager_t  proto_mgr;
-  fl_i2c_t                i2c;
+  fw_app_i2c_request_t    i2c_req;
+
+  // I2C buses(i2c_num - 1).
+  fw_app_i2c_bus_t        i2c_bus[FW_APP_I2C_BUS_COUNT];
+
+  // Sensors and the mask of the sensors found.
+  fw_app_sensor_t         sensors[FW_APP_SENSOR_COUNT];
+  uint8_t                 sensor_mask;
+
+  // Boot sensor enumeration is done(ready event), commands with FL_TXT_MSG_CMD_FLAG_I2C are refused before.
+  fl_bool_t               ready;
+
+  // Capture manager.
+  fw_app_capture_manager_t capture;
+
+  // Ranging manager.
+  fw_app_range_manager_t  range;
+
+  // Configuration manager.
+  fw_app_config_manager_t config;
 } fw_app_t;
 
 FL_END_PACK
@@ -91,6 +375,23 @@ FL_DECLARE_DATA extern fw_app_t g_app;
 FL_DECLARE(void) fw_app_init(void);
 FL_DECLARE(void) fw_app_hw_init(void);
 FL_DECLARE(void) fw_app_systick(void);
+FL_DECLARE(void) fw_app_process(void);
+FL_DECLARE(fw_app_i2c_bus_t*) fw_app_get_i2c_bus(uint8_t i2c_num);
+FL_DECLARE(void) fw_app_boot_start(void);
+FL_DECLARE(uint8_t) fw_app_sensor_enum(void);
+
+// fw_app_config.c
+FL_DECLARE(void) fw_app_config_load(void);
+FL_DECLARE(void) fw_app_config_apply_profiles(void);
+FL_DECLARE(fl_status_t) fw_app_config_write(uint8_t item, uint32_t value);
+FL_DECLARE(fl_status_t) fw_app_config_read(uint8_t item, uint32_t* value);
+FL_DECLARE(fl_status_t) fw_app_config_profile(const fl_profile_write_t* prof_wr, uint8_t arg_count);
+
+// Called from interrupt handlers(HAL callbacks).
+FL_DECLARE(void) fw_app_uart_rx_complete(void);
+FL_DECLARE(void) fw_app_uart_tx_complete(void);
+FL_DECLARE(void) fw_app_i2c_complete(I2C_HandleTypeDef* hi2c, fl_status_t status);
+
 FL_END_DECLS
 
 #endif
@@ -5,7 +5,7 @@
 
 fl_bool_t is_msg_id_char(uint8_t data);
 fl_bool_t is_device_id_char(uint8_t data);
-uint8_t get_device_id(uint8_t* buf, uint16_t buf_size);
+uint32_t get_device_id(uint8_t* buf, uint16_t buf_size);
 fl_bool_t is_tail(uint8_t data);
 
 #endif
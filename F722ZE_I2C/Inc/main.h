@@ -62,6 +62,10 @@ void Error_Handler(void);
 #define USER_Btn_GPIO_Port GPIOC
 #define MCO_Pin GPIO_PIN_0
 #define MCO_GPIO_Port GPIOH
+#define VL6180X_CE2_Pin GPIO_PIN_0
+#define VL6180X_CE2_GPIO_Port GPIOC
+#define VL6180X_CE3_Pin GPIO_PIN_3
+#define VL6180X_CE3_GPIO_Port GPIOC
 #define VL6180X_CE_Pin GPIO_PIN_2
 #define VL6180X_CE_GPIO_Port GPIOA
 #define LD1_Pin GPIO_PIN_0
@@ -0,0 +1,304 @@
+// Firmware library flash log
+// fl_flash_log.c
+
+#include <string.h>
+#include "fl_flash_log.h"
+#include "fl_util.h"
+
+#define FL_FLASH_LOG_KEY_ERASED       (0xFFFF)
+
+// Flash programming unit(FLASH_TYPEPROGRAM_WORD).
+#define FL_FLASH_LOG_WORD_SIZE        (4)
+
+static uint32_t record_size(uint16_t length);
+static void scan(fl_flash_log_t *handle);
+static fl_status_t append(fl_flash_log_t *handle, uint16_t key, const void *data, uint16_t length);
+static fl_status_t compact(fl_flash_log_t *handle, uint16_t skip_key);
+static fl_status_t erase_sector(fl_flash_log_t *handle, uint8_t index);
+static fl_status_t program(uint32_t addr, const void *data, uint32_t length);
+
+// Select the active sector and index its records, blank sectors are formatted.
+// The caller sets sectors, addrs and sector_size.
+FL_DECLARE(fl_status_t) fl_flash_log_init(fl_flash_log_t *handle)
+{
+  const fl_flash_log_sector_t*  hdrs[2];
+  fl_bool_t                     valid[2];
+  uint8_t                       i;
+
+  memset(handle->index, 0, sizeof(handle->index));
+
+  for (i = 0; i < 2; i++)
+  {
+    hdrs[i] = (const fl_flash_log_sector_t*)handle->addrs[i];
+    valid[i] = (hdrs[i]->magic == FL_FLASH_LOG_MAGIC) ? FL_TRUE : FL_FALSE;
+  }
+
+  if ((valid[0] == FL_FALSE) && (valid[1] == FL_FALSE))
+  {
+    // First use : an empty compaction into sector 0.
+    handle->active = 1;
+    handle->seq = 0;
+    return compact(handle, FL_FLASH_LOG_MAX_KEYS);
+  }
+
+  // Both sectors are valid when the old sector was not erased after a compaction.
+  if ((valid[0] == FL_TRUE) && (valid[1] == FL_TRUE))
+  {
+    handle->active = (hdrs[1]->seq > hdrs[0]->seq) ? 1 : 0;
+  }
+  else
+  {
+    handle->active = (valid[1] == FL_TRUE) ? 1 : 0;
+  }
+  handle->seq = hdrs[handle->active]->seq;
+
+  scan(handle);
+
+  return FL_OK;
+}
+
+// Copy the latest data of a key(at most buf_len bytes), length : data length of the record.
+FL_DECLARE(fl_status_t) fl_flash_log_read(fl_flash_log_t *handle, uint16_t key, void *buf, uint16_t buf_len, uint16_t *length)
+{
+  const fl_flash_log_record_t* rec;
+
+  if ((key >= FL_FLASH_LOG_MAX_KEYS) || (handle->index[key] == 0))
+  {
+    return FL_FLASH_LOG_ERR_NOT_FOUND;
+  }
+
+  rec = (const fl_flash_log_record_t*)handle->index[key];
+  if (rec->length == 0)
+  {
+    return FL_FLASH_LOG_ERR_NOT_FOUND;
+  }
+
+  memcpy(buf, rec + 1, (rec->length < buf_len) ? rec->length : buf_len);
+  if (length != NULL)
+  {
+    *length = rec->length;
+  }
+
+  return FL_OK;
+}
+
+// Append a record, a full sector is compacted first(the previous record of the key is not copied).
+FL_DECLARE(fl_status_t) fl_flash_log_write(fl_flash_log_t *handle, uint16_t key, const void *data, uint16_t length)
+{
+  const fl_flash_log_record_t*  rec;
+  uint32_t                      size = record_size(length);
+  uint32_t                      used = sizeof(fl_flash_log_sector_t);
+  uint16_t                      i;
+  fl_status_t                   ret;
+
+  if (key >= FL_FLASH_LOG_MAX_KEYS)
+  {
+    return FL_ERROR;
+  }
+
+  if ((handle->write_addr + size) > (handle->addrs[handle->active] + handle->sector_size))
+  {
+    // The current value is kept if the new record does not fit after a compaction.
+    for (i = 0; i < FL_FLASH_LOG_MAX_KEYS; i++)
+    {
+      if ((i != key) && (handle->index[i] != 0))
+      {
+        rec = (const fl_flash_log_record_t*)handle->index[i];
+        used += (rec->length > 0) ? record_size(rec->length) : 0;
+      }
+    }
+
+    if ((used + size) > handle->sector_size)
+    {
+      return FL_FLASH_LOG_ERR_FULL;
+    }
+
+    if ((ret = compact(handle, key)) != FL_OK)
+    {
+      return ret;
+    }
+  }
+
+  return append(handle, key, data, length);
+}
+
+// A deleted key is not copied by the next compaction.
+FL_DECLARE(fl_status_t) fl_flash_log_delete(fl_flash_log_t *handle, uint16_t key)
+{
+  if ((key >= FL_FLASH_LOG_MAX_KEYS) ||
+      (handle->index[key] == 0) ||
+      (((const fl_flash_log_record_t*)handle->index[key])->length == 0))
+  {
+    return FL_OK;
+  }
+
+  return fl_flash_log_write(handle, key, NULL, 0);
+}
+
+static uint32_t record_size(uint16_t length)
+{
+  return sizeof(fl_flash_log_record_t) +
+         ((length + FL_FLASH_LOG_WORD_SIZE - 1) & ~(FL_FLASH_LOG_WORD_SIZE - 1));
+}
+
+// Index the records of the active sector and find the end of the records.
+// A record with a bad CRC is skipped, a bad header ends the records(the next write compacts).
+static void scan(fl_flash_log_t *handle)
+{
+  const fl_flash_log_record_t*  rec;
+  uint32_t                      addr = handle->addrs[handle->active] + sizeof(fl_flash_log_sector_t);
+  uint32_t                      end = handle->addrs[handle->active] + handle->sector_size;
+
+  while ((addr + sizeof(fl_flash_log_record_t)) <= end)
+  {
+    rec = (const fl_flash_log_record_t*)addr;
+    if (rec->key == FL_FLASH_LOG_KEY_ERASED)
+    {
+      break;
+    }
+
+    if ((rec->check != (uint16_t)~(rec->key ^ rec->length)) ||
+        ((addr + record_size(rec->length)) > end))
+    {
+      addr = end;
+      break;
+    }
+
+    if ((rec->key < FL_FLASH_LOG_MAX_KEYS) &&
+        (fl_crc_16((const unsigned char*)(rec + 1), rec->length) == rec->crc))
+    {
+      handle->index[rec->key] = addr;
+    }
+
+    addr += record_size(rec->length);
+  }
+
+  handle->write_addr = addr;
+}
+
+// The header is programmed first, a record cut by a reset fails its CRC.
+static fl_status_t append(fl_flash_log_t *handle, uint16_t key, const void *data, uint16_t length)
+{
+  fl_flash_log_record_t rec;
+  uint32_t              addr = handle->write_addr;
+  fl_status_t           ret;
+
+  rec.key = key;
+  rec.length = length;
+  rec.crc = fl_crc_16((const unsigned char*)data, length);
+  rec.check = (uint16_t)~(key ^ length);
+
+  if (((ret = program(addr, &rec, sizeof(rec))) != FL_OK) ||
+      ((length > 0) && ((ret = program(addr + sizeof(rec), data, length)) != FL_OK)))
+  {
+    // No record is appended after a failed one.
+    handle->write_addr = handle->addrs[handle->active] + handle->sector_size;
+    return ret;
+  }
+
+  handle->index[key] = addr;
+  handle->write_addr = addr + record_size(length);
+
+  return FL_OK;
+}
+
+// Copy the latest records(except skip_key and deleted keys) into the other sector, then make it active.
+static fl_status_t compact(fl_flash_log_t *handle, uint16_t skip_key)
+{
+  const fl_flash_log_record_t*  rec;
+  uint32_t                      index[FL_FLASH_LOG_MAX_KEYS];
+  fl_flash_log_sector_t         hdr;
+  uint8_t                       target = handle->active ^ 1;
+  uint32_t                      addr = handle->addrs[target] + sizeof(fl_flash_log_sector_t);
+  uint16_t                      i;
+  fl_status_t                   ret;
+
+  if ((ret = erase_sector(handle, target)) != FL_OK)
+  {
+    return ret;
+  }
+
+  memset(index, 0, sizeof(index));
+  for (i = 0; i < FL_FLASH_LOG_MAX_KEYS; i++)
+  {
+    if ((i == skip_key) || (handle->index[i] == 0))
+    {
+      continue;
+    }
+
+    rec = (const fl_flash_log_record_t*)handle->index[i];
+    if (rec->length == 0)
+    {
+      continue;
+    }
+
+    if ((ret = program(addr, rec, record_size(rec->length))) != FL_OK)
+    {
+      return ret;
+    }
+    index[i] = addr;
+    addr += record_size(rec->length);
+  }
+
+  // The magic makes the sector valid.
+  hdr.seq = handle->seq + 1;
+  hdr.magic = FL_FLASH_LOG_MAGIC;
+  if (((ret = program(handle->addrs[target], &hdr.seq, sizeof(hdr.seq))) != FL_OK) ||
+      ((ret = program(handle->addrs[target] + sizeof(hdr.seq), &hdr.magic, sizeof(hdr.magic))) != FL_OK))
+  {
+    return ret;
+  }
+
+  handle->active = target;
+  handle->seq = hdr.seq;
+  handle->write_addr = addr;
+  memcpy(handle->index, index, sizeof(index));
+
+  return FL_OK;
+}
+
+static fl_status_t erase_sector(fl_flash_log_t *handle, uint8_t index)
+{
+  FLASH_EraseInitTypeDef  erase;
+  uint32_t                sector_error = 0;
+  HAL_StatusTypeDef       status;
+
+  erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+  erase.Sector = handle->sectors[index];
+  erase.NbSectors = 1;
+  erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+  HAL_FLASH_Unlock();
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_ALL_ERRORS);
+  status = HAL_FLASHEx_Erase(&erase, &sector_error);
+  HAL_FLASH_Lock();
+
+  return (status == HAL_OK) ? FL_OK : FL_FLASH_LOG_ERR_FLASH;
+}
+
+// Program words, the last word is padded with 0xFF.
+static fl_status_t program(uint32_t addr, const void *data, uint32_t length)
+{
+  const uint8_t*  src = (const uint8_t*)data;
+  uint32_t        word;
+  uint32_t        i;
+  fl_status_t     ret = FL_OK;
+
+  HAL_FLASH_Unlock();
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_ALL_ERRORS);
+
+  for (i = 0; i < length; i += FL_FLASH_LOG_WORD_SIZE)
+  {
+    word = 0xFFFFFFFF;
+    memcpy(&word, &src[i], ((length - i) < FL_FLASH_LOG_WORD_SIZE) ? (length - i) : FL_FLASH_LOG_WORD_SIZE);
+    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr + i, word) != HAL_OK)
+    {
+      ret = FL_FLASH_LOG_ERR_FLASH;
+      break;
+    }
+  }
+
+  HAL_FLASH_Lock();
+
+  return ret;
+}
@@ -6,33 +6,271 @@
  */
 #include <string.h>
 #include "fl_i2c.h"
+#include "fl_perf.h"
+
+// Half period of SCL pulses for bus recovery(us, 100kHz).
+#define FL_I2C_RECOVERY_HALF_PERIOD (5)
+
+// Analog filter delay(ns, enabled by HAL_I2C_Init()).
+#define FL_I2C_AF_DELAY_MIN         (50)
+#define FL_I2C_AF_DELAY_MAX         (260)
+
+#define FL_I2C_PSEC_PER_SEC         (1000000000000ULL)
+
+// I2C specification limits of a speed mode(ns).
+typedef struct _fl_i2c_spec
+{
+  uint32_t    max_speed;
+  uint32_t    low_min;      // tLOW
+  uint32_t    high_min;     // tHIGH
+  uint32_t    sudat_min;    // tSU;DAT
+  uint32_t    vddat_max;    // tVD;DAT
+} fl_i2c_spec_t;
+
+static const fl_i2c_spec_t _i2c_specs[] = {
+  { FL_I2C_SPEED_STANDARD,  4700, 4000, 250, 3450 },
+  { FL_I2C_SPEED_FAST,      1300,  600, 100,  900 },
+  { FL_I2C_SPEED_FAST_PLUS,  500,  260,  50,  450 },
+};
+
+static fl_status_t read_reg(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t size, uint32_t *data);
+static fl_status_t write_reg(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint32_t data, uint8_t size);
+static fl_status_t read_block(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t *data, uint8_t size);
+static fl_status_t start_it(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, fl_bool_t read);
+static fl_status_t get_error(fl_i2c_t *handle, HAL_StatusTypeDef hal_ret, uint16_t size);
+static void delay_us(uint32_t us);
+static uint32_t get_fast_mode_plus(I2C_TypeDef *instance);
 
 FL_DECLARE(void) fl_i2c_init(fl_i2c_t *handle)
 {
   memset(handle, 0, sizeof(fl_i2c_t));
+
+  handle->bus_speed = FL_I2C_DEFAULT_BUS_SPEED;
+  handle->stretch = FL_I2C_DEFAULT_STRETCH;
 }
 
-FL_DECLARE(fl_status_t) fl_i2c_read_byte(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t *data)
+// Timeout(ms) of a register access with size data bytes.
+// Slave address, register address(2 bytes), repeated start slave address and data bytes,
+// 9 clocks per byte plus START/STOP at bus_speed, then the clock stretching allowance.
+FL_DECLARE(uint32_t) fl_i2c_timeout(fl_i2c_t *handle, uint8_t size)
 {
-  fl_status_t ret = FL_OK;
+  uint32_t clocks = ((4 + size) * 9) + 3;
+  uint32_t us = ((clocks * 1000000) / handle->bus_speed) + handle->stretch;
 
-  handle->buf[0] = (reg_addr >> 8);
-  handle->buf[1] = (reg_addr & 0xFF);
+  // HAL timeouts count 1ms ticks, the first tick may come right after the transfer starts.
+  return ((us + 999) / 1000) + 1;
+}
+
+// Release a slave holding SDA low(stopped in the middle of a byte) with SCL pulses,
+// generate a STOP condition, then reinitialize the peripheral.
+FL_DECLARE(void) fl_i2c_recover(fl_i2c_t *handle)
+{
+  GPIO_InitTypeDef  gpio = {0};
+  uint8_t           i;
+
+  handle->recovery_count++;
+
+  // Pins are released from the peripheral(HAL_I2C_MspDeInit()).
+  HAL_I2C_DeInit(handle->i2c);
+
+  if ((handle->scl_port != NULL) && (handle->sda_port != NULL))
+  {
+    HAL_GPIO_WritePin(handle->scl_port, handle->scl_pin, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(handle->sda_port, handle->sda_pin, GPIO_PIN_SET);
+
+    gpio.Mode = GPIO_MODE_OUTPUT_OD;
+    gpio.Pull = GPIO_PULLUP;
+    gpio.Speed = GPIO_SPEED_FREQ_LOW;
+    gpio.Pin = handle->scl_pin;
+    HAL_GPIO_Init(handle->scl_port, &gpio);
+    gpio.Pin = handle->sda_pin;
+    HAL_GPIO_Init(handle->sda_port, &gpio);
+    delay_us(FL_I2C_RECOVERY_HALF_PERIOD);
+
+    for (i = 0; i < FL_I2C_RECOVERY_PULSES; i++)
+    {
+      if (HAL_GPIO_ReadPin(handle->sda_port, handle->sda_pin) == GPIO_PIN_SET)
+      {
+        break;
+      }
+
+      HAL_GPIO_WritePin(handle->scl_port, handle->scl_pin, GPIO_PIN_RESET);
+      delay_us(FL_I2C_RECOVERY_HALF_PERIOD);
+      HAL_GPIO_WritePin(handle->scl_port, handle->scl_pin, GPIO_PIN_SET);
+      delay_us(FL_I2C_RECOVERY_HALF_PERIOD);
+    }
+
+    // STOP : SDA low to high while SCL is high.
+    HAL_GPIO_WritePin(handle->scl_port, handle->scl_pin, GPIO_PIN_RESET);
+    delay_us(FL_I2C_RECOVERY_HALF_PERIOD);
+    HAL_GPIO_WritePin(handle->sda_port, handle->sda_pin, GPIO_PIN_RESET);
+    delay_us(FL_I2C_RECOVERY_HALF_PERIOD);
+    HAL_GPIO_WritePin(handle->scl_port, handle->scl_pin, GPIO_PIN_SET);
+    delay_us(FL_I2C_RECOVERY_HALF_PERIOD);
+    HAL_GPIO_WritePin(handle->sda_port, handle->sda_pin, GPIO_PIN_SET);
+    delay_us(FL_I2C_RECOVERY_HALF_PERIOD);
+  }
+
+  // Pins are configured for the peripheral again(HAL_I2C_MspInit()).
+  HAL_I2C_Init(handle->i2c);
+}
+
+// TIMINGR value for the SCL frequency(speed, Hz) with the I2C kernel clock(clock_freq, Hz),
+// the analog filter on and the digital filter off(RM0431 I2C timings, AN4235).
+// The SCL period is the closest to the requested one without being shorter.
+FL_DECLARE(fl_status_t) fl_i2c_calc_timing(uint32_t clock_freq, uint32_t speed, uint32_t rise_time, uint32_t fall_time, uint32_t *timing)
+{
+  const fl_i2c_spec_t*  spec = NULL;
+  uint32_t              t_clk;
+  uint32_t              t_scl;
+  uint32_t              t_sync;
+  uint32_t              t_edges;
+  uint32_t              scldel_min;
+  int32_t               sdadel_min;
+  int32_t               sdadel_max;
+  uint32_t              best_error = 0xFFFFFFFF;
+  uint32_t              presc;
+  uint32_t              i;
 
-  if (HAL_I2C_Master_Transmit(handle->i2c, i2c_addr, handle->buf, 2, handle->timeout) == HAL_OK)
+  if ((clock_freq == 0) || (speed < FL_I2C_SPEED_MIN) || (speed > FL_I2C_SPEED_FAST_PLUS))
   {
-    if (HAL_I2C_Master_Receive(handle->i2c, i2c_addr, handle->buf, 1, handle->timeout) == HAL_OK)
+    return FL_ERROR;
+  }
+
+  for (i = 0; i < sizeof(_i2c_specs) / sizeof(_i2c_specs[0]); i++)
+  {
+    if (speed <= _i2c_specs[i].max_speed)
     {
-      *data = handle->buf[0];
+      spec = &_i2c_specs[i];
+      break;
     }
-    else
+  }
+
+  // Picoseconds.
+  t_clk = (uint32_t)(FL_I2C_PSEC_PER_SEC / clock_freq);
+  t_scl = (uint32_t)(FL_I2C_PSEC_PER_SEC / speed);
+  t_edges = (rise_time + fall_time) * 1000;
+
+  // SCL low/high detection delay of the peripheral.
+  t_sync = (FL_I2C_AF_DELAY_MIN * 1000) + (2 * t_clk);
+
+  // Data setup time after SDA changes, data hold time before SCL falls.
+  scldel_min = (rise_time + spec->sudat_min) * 1000;
+  sdadel_min = (int32_t)(fall_time * 1000) - (FL_I2C_AF_DELAY_MIN * 1000) - (int32_t)(3 * t_clk);
+  sdadel_max = (((int32_t)spec->vddat_max - (int32_t)rise_time - FL_I2C_AF_DELAY_MAX) * 1000) - (int32_t)(4 * t_clk);
+
+  for (presc = 0; presc < 16; presc++)
+  {
+    uint32_t t_presc = (presc + 1) * t_clk;
+    uint32_t scldel;
+    uint32_t sdadel;
+    uint32_t scll;
+
+    for (scldel = 0; (scldel < 16) && (((scldel + 1) * t_presc) < scldel_min); scldel++)
+    {
+    }
+    for (sdadel = 0; (sdadel < 16) && ((int32_t)(sdadel * t_presc) < sdadel_min); sdadel++)
     {
-      ret = FL_ERROR; // Register read error.
     }
+    if ((scldel == 16) || (sdadel == 16) || ((int32_t)(sdadel * t_presc) > sdadel_max))
+    {
+      continue;
+    }
+
+    for (scll = 0; scll < 256; scll++)
+    {
+      uint32_t  t_low = ((scll + 1) * t_presc) + t_sync;
+      int32_t   t_high_rem;
+      uint32_t  sclh;
+      uint32_t  t_high;
+      uint32_t  error;
+
+      if (t_low < (spec->low_min * 1000))
+      {
+        continue;
+      }
+
+      // SCLH for the rest of the period.
+      t_high_rem = (int32_t)t_scl - (int32_t)(t_low + t_edges + t_sync);
+      if (t_high_rem <= 0)
+      {
+        break;
+      }
+
+      sclh = ((uint32_t)t_high_rem + (t_presc / 2)) / t_presc;
+      if ((sclh == 0) || (sclh > 256))
+      {
+        continue;
+      }
+      sclh--;
+
+      t_high = ((sclh + 1) * t_presc) + t_sync;
+      if ((t_high < (spec->high_min * 1000)) ||
+          ((t_low + t_high + t_edges) < t_scl))
+      {
+        continue;
+      }
+
+      error = t_low + t_high + t_edges - t_scl;
+      if (error < best_error)
+      {
+        best_error = error;
+        *timing = (presc << I2C_TIMINGR_PRESC_Pos) |
+                  (scldel << I2C_TIMINGR_SCLDEL_Pos) |
+                  (sdadel << I2C_TIMINGR_SDADEL_Pos) |
+                  (sclh << I2C_TIMINGR_SCLH_Pos) |
+                  (scll << I2C_TIMINGR_SCLL_Pos);
+      }
+    }
+  }
+
+  return (best_error == 0xFFFFFFFF) ? FL_ERROR : FL_OK;
+}
+
+// Change the SCL frequency, it must be called between transfers.
+// Fast-mode Plus(above 400kHz) enables the 20mA drive of the pins.
+FL_DECLARE(fl_status_t) fl_i2c_set_speed(fl_i2c_t *handle, uint32_t speed)
+{
+  uint32_t timing;
+  uint32_t fast_mode_plus;
+
+  // I2C1/2/3 kernel clock : PCLK1(SystemClock_Config()).
+  if (fl_i2c_calc_timing(HAL_RCC_GetPCLK1Freq(), speed, handle->rise_time, handle->fall_time, &timing) != FL_OK)
+  {
+    return FL_ERROR;
+  }
+
+  HAL_I2C_DeInit(handle->i2c);
+
+  fast_mode_plus = get_fast_mode_plus(handle->i2c->Instance);
+  if (speed > FL_I2C_SPEED_FAST)
+  {
+    HAL_I2CEx_EnableFastModePlus(fast_mode_plus);
   }
   else
   {
-    ret = FL_ERROR; // Address write error.
+    HAL_I2CEx_DisableFastModePlus(fast_mode_plus);
+  }
+
+  handle->i2c->Init.Timing = timing;
+  if (HAL_I2C_Init(handle->i2c) != HAL_OK)
+  {
+    return FL_ERROR;
+  }
+
+  handle->bus_speed = speed;
+
+  return FL_OK;
+}
+
+FL_DECLARE(fl_status_t) fl_i2c_read_byte(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t *data)
+{
+  uint32_t    value;
+  fl_status_t ret = read_reg(handle, i2c_addr, reg_addr, 1, &value);
+
+  if (ret == FL_OK)
+  {
+    *data = (uint8_t)value;
   }
 
   return ret;
@@ -40,107 +278,384 @@ FL_DECLARE(fl_status_t) fl_i2c_read_byte(fl_i2c_t *handle, uint8_t i2c_addr, uin
 
 FL_DECLARE(fl_status_t) fl_i2c_read_word(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint16_t *data)
 {
-  fl_status_t ret = FL_OK;
+  uint32_t    value;
+  fl_status_t ret = read_reg(handle, i2c_addr, reg_addr, 2, &value);
 
-  handle->buf[0] = (reg_addr >> 8);
-  handle->buf[1] = (reg_addr & 0xFF);
+  if (ret == FL_OK)
+  {
+    *data = (uint16_t)value;
+  }
+
+  return ret;
+}
+
+FL_DECLARE(fl_status_t) fl_i2c_read_dword(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint32_t *data)
+{
+  return read_reg(handle, i2c_addr, reg_addr, 4, data);
+}
+
+FL_DECLARE(fl_status_t) fl_i2c_write_byte(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t data)
+{
+  return write_reg(handle, i2c_addr, reg_addr, data, 1);
+}
+
+FL_DECLARE(fl_status_t) fl_i2c_write_word(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint16_t data)
+{
+  return write_reg(handle, i2c_addr, reg_addr, data, 2);
+}
 
-  if (HAL_I2C_Master_Transmit(handle->i2c, i2c_addr, handle->buf, 2, handle->timeout) == HAL_OK)
+FL_DECLARE(fl_status_t) fl_i2c_write_dword(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint32_t data)
+{
+  return write_reg(handle, i2c_addr, reg_addr, data, 4);
+}
+
+// Consecutive registers(size bytes) in one transfer.
+FL_DECLARE(fl_status_t) fl_i2c_read_block(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t *data, uint8_t size)
+{
+  if (size == 0)
   {
-    if (HAL_I2C_Master_Receive(handle->i2c, i2c_addr, handle->buf, 2, handle->timeout) == HAL_OK)
-    {
-      *data = ((uint16_t)handle->buf[0] << 8) | (uint16_t)handle->buf[1];
-    }
-    else
-    {
-      ret = FL_ERROR; // Register read error.
-    }
+    return FL_ERROR;
+  }
+
+  return read_block(handle, i2c_addr, reg_addr, data, size);
+}
+
+FL_DECLARE(fl_status_t) fl_i2c_read_it(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t size)
+{
+  if ((size == 0) || (size > 4))
+  {
+    return FL_ERROR;
+  }
+
+  FL_PERF_BEGIN(FL_PERF_STAGE_I2C);
+
+  handle->buf_len = size;
+  handle->block = NULL;
+
+  return start_it(handle, i2c_addr, reg_addr, FL_TRUE);
+}
+
+FL_DECLARE(fl_status_t) fl_i2c_write_it(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint32_t data, uint8_t size)
+{
+  uint8_t i;
+
+  if ((size == 0) || (size > 4))
+  {
+    return FL_ERROR;
+  }
+
+  FL_PERF_BEGIN(FL_PERF_STAGE_I2C);
+
+  // Big endian register value.
+  for (i = 0; i < size; i++)
+  {
+    handle->buf[i] = (uint8_t)(data >> (8 * (size - 1 - i)));
+  }
+  handle->buf_len = size;
+  handle->block = NULL;
+
+  return start_it(handle, i2c_addr, reg_addr, FL_FALSE);
+}
+
+FL_DECLARE(fl_status_t) fl_i2c_read_block_it(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t *data, uint8_t size)
+{
+  if (size == 0)
+  {
+    return FL_ERROR;
+  }
+
+  FL_PERF_BEGIN(FL_PERF_STAGE_I2C);
+
+  handle->buf_len = size;
+  handle->block = data;
+
+  return start_it(handle, i2c_addr, reg_addr, FL_TRUE);
+}
+
+// Register address frame completed(HAL_I2C_MasterTxCpltCallback()), start the register bytes.
+// A read turns the bus around with a repeated START, a write continues the frame without START.
+FL_DECLARE(fl_bool_t) fl_i2c_it_next(fl_i2c_t *handle, fl_status_t *status)
+{
+  HAL_StatusTypeDef hal_ret;
+  uint8_t*          data = (handle->block != NULL) ? handle->block : handle->buf;
+
+  if (handle->phase != FL_I2C_PHASE_REG_ADDR)
+  {
+    return FL_FALSE;
+  }
+
+  handle->phase = FL_I2C_PHASE_DATA;
+  if (handle->it_read == FL_TRUE)
+  {
+    hal_ret = HAL_I2C_Master_Seq_Receive_IT(handle->i2c, handle->it_addr, data, handle->buf_len, I2C_LAST_FRAME);
   }
   else
   {
-    ret = FL_ERROR; // Address write error.
+    hal_ret = HAL_I2C_Master_Seq_Transmit_IT(handle->i2c, handle->it_addr, data, handle->buf_len, I2C_LAST_FRAME);
   }
 
-  return ret;
+  if (hal_ret != HAL_OK)
+  {
+    handle->phase = FL_I2C_PHASE_IDLE;
+    FL_PERF_END(FL_PERF_STAGE_I2C);
+    *status = FL_I2C_ERR_BUS;
+    return FL_FALSE;
+  }
+
+  return FL_TRUE;
 }
 
-FL_DECLARE(fl_status_t) fl_i2c_read_dword(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint32_t *data)
+FL_DECLARE(uint32_t) fl_i2c_it_complete(fl_i2c_t *handle)
 {
-  fl_status_t ret = FL_OK;
+  uint32_t  data = 0;
+  uint8_t   i;
 
-  handle->buf[0] = (reg_addr >> 8);
-  handle->buf[1] = (reg_addr & 0xFF);
+  FL_PERF_END(FL_PERF_STAGE_I2C);
+
+  handle->phase = FL_I2C_PHASE_IDLE;
+
+  // The bytes of a block read are in the caller buffer.
+  if (handle->block != NULL)
+  {
+    return 0;
+  }
 
-  if (HAL_I2C_Master_Transmit(handle->i2c, i2c_addr, handle->buf, 2, handle->timeout) == HAL_OK)
+  for (i = 0; i < handle->buf_len; i++)
   {
-    if (HAL_I2C_Master_Receive(handle->i2c, i2c_addr, handle->buf, 4, handle->timeout) == HAL_OK)
+    data = (data << 8) | handle->buf[i];
+  }
+
+  return data;
+}
+
+// Error code of a failed interrupt mode transfer(HAL_I2C_ErrorCallback()), a NACK is mapped from the phase.
+//   Register address frame : the slave address(no byte loaded) or a register address byte.
+//   Register bytes         : a written byte, or the slave address after the repeated START of a read
+//                            (the master acknowledges the bytes of a read).
+FL_DECLARE(fl_status_t) fl_i2c_it_error(fl_i2c_t *handle)
+{
+  uint8_t phase = handle->phase;
+
+  FL_PERF_END(FL_PERF_STAGE_I2C);
+
+  handle->phase = FL_I2C_PHASE_IDLE;
+
+  // The peripheral generated STOP, the bus is free.
+  if ((HAL_I2C_GetError(handle->i2c) & HAL_I2C_ERROR_AF) != 0)
+  {
+    // The HAL ISR loads the first register address byte after the slave acknowledged its address(TXIS).
+    if ((phase == FL_I2C_PHASE_REG_ADDR) && (handle->i2c->XferCount == sizeof(handle->it_reg)))
     {
-      *data = ((uint32_t)handle->buf[0] << 24) |
-              ((uint32_t)handle->buf[1] << 16) |
-              ((uint32_t)handle->buf[2] << 8)  |
-              (uint32_t)handle->buf[3];
+      return FL_I2C_ERR_ADDR_NACK;
     }
-    else
+    if ((phase == FL_I2C_PHASE_DATA) && (handle->it_read == FL_TRUE))
     {
-      ret = FL_ERROR; // Register read error.
+      return FL_I2C_ERR_ADDR_NACK;
     }
+    return FL_I2C_ERR_DATA_NACK;
   }
-  else
+
+  return get_error(handle, HAL_ERROR, 0);
+}
+
+// Stop an interrupt mode transfer(no completion callback) and release the bus.
+FL_DECLARE(void) fl_i2c_abort(fl_i2c_t *handle)
+{
+  FL_PERF_END(FL_PERF_STAGE_I2C);
+
+  handle->phase = FL_I2C_PHASE_IDLE;
+  fl_i2c_recover(handle);
+}
+
+// Register address frame of an interrupt mode transfer, fl_i2c_it_next() sends the register bytes(buf_len).
+static fl_status_t start_it(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, fl_bool_t read)
+{
+  HAL_StatusTypeDef hal_ret;
+
+  handle->it_addr = i2c_addr;
+  handle->it_reg[0] = (reg_addr >> 8);
+  handle->it_reg[1] = (reg_addr & 0xFF);
+  handle->it_read = read;
+  handle->phase = FL_I2C_PHASE_REG_ADDR;
+
+  // SOFTEND before the repeated START of a read, RELOAD to continue a write.
+  hal_ret = HAL_I2C_Master_Seq_Transmit_IT(handle->i2c, i2c_addr, handle->it_reg, sizeof(handle->it_reg),
+                                           (read == FL_TRUE) ? I2C_FIRST_FRAME : I2C_FIRST_AND_NEXT_FRAME);
+  if (hal_ret != HAL_OK)
   {
-    ret = FL_ERROR; // Address write error.
+    handle->phase = FL_I2C_PHASE_IDLE;
+    FL_PERF_END(FL_PERF_STAGE_I2C);
+    return get_error(handle, hal_ret, sizeof(handle->it_reg));
   }
 
-  return ret;
+  return FL_OK;
 }
 
-FL_DECLARE(fl_status_t) fl_i2c_write_byte(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t data)
+// Register address(big endian) write, then size bytes(big endian) read.
+static fl_status_t read_reg(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t size, uint32_t *data)
 {
-  fl_status_t ret = FL_OK;
+  HAL_StatusTypeDef hal_ret;
+  uint32_t          timeout = fl_i2c_timeout(handle, size);
+  uint32_t          value = 0;
+  uint8_t           i;
+
+  FL_PERF_BEGIN(FL_PERF_STAGE_I2C);
 
   handle->buf[0] = (reg_addr >> 8);
   handle->buf[1] = (reg_addr & 0xFF);
-  handle->buf[2] = data;
 
-  if (HAL_I2C_Master_Transmit(handle->i2c, i2c_addr, handle->buf, 3, handle->timeout) != HAL_OK)
+  hal_ret = HAL_I2C_Master_Transmit(handle->i2c, i2c_addr, handle->buf, 2, timeout);
+  if (hal_ret != HAL_OK)
   {
-    ret = FL_ERROR; // Write error.
+    FL_PERF_END(FL_PERF_STAGE_I2C);
+    return get_error(handle, hal_ret, 2);
   }
 
-  return ret;
+  hal_ret = HAL_I2C_Master_Receive(handle->i2c, i2c_addr, handle->buf, size, timeout);
+  if (hal_ret != HAL_OK)
+  {
+    FL_PERF_END(FL_PERF_STAGE_I2C);
+    return get_error(handle, hal_ret, size);
+  }
+
+  for (i = 0; i < size; i++)
+  {
+    value = (value << 8) | handle->buf[i];
+  }
+  *data = value;
+
+  FL_PERF_END(FL_PERF_STAGE_I2C);
+
+  return FL_OK;
 }
 
-FL_DECLARE(fl_status_t) fl_i2c_write_word(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint16_t data)
+// Register address(big endian) write, then size bytes read into data.
+static fl_status_t read_block(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint8_t *data, uint8_t size)
 {
-  fl_status_t ret = FL_OK;
+  HAL_StatusTypeDef hal_ret;
+  uint32_t          timeout = fl_i2c_timeout(handle, size);
+
+  FL_PERF_BEGIN(FL_PERF_STAGE_I2C);
 
   handle->buf[0] = (reg_addr >> 8);
   handle->buf[1] = (reg_addr & 0xFF);
-  handle->buf[2] = (data >> 8);
-  handle->buf[3] = data & 0xFF;
 
-  if (HAL_I2C_Master_Transmit(handle->i2c, i2c_addr, handle->buf, 4, handle->timeout) != HAL_OK)
+  hal_ret = HAL_I2C_Master_Transmit(handle->i2c, i2c_addr, handle->buf, 2, timeout);
+  if (hal_ret != HAL_OK)
   {
-    ret = FL_ERROR; // Write error.
+    FL_PERF_END(FL_PERF_STAGE_I2C);
+    return get_error(handle, hal_ret, 2);
   }
 
-  return ret;
+  hal_ret = HAL_I2C_Master_Receive(handle->i2c, i2c_addr, data, size, timeout);
+  if (hal_ret != HAL_OK)
+  {
+    FL_PERF_END(FL_PERF_STAGE_I2C);
+    return get_error(handle, hal_ret, size);
+  }
+
+  FL_PERF_END(FL_PERF_STAGE_I2C);
+
+  return FL_OK;
 }
 
-FL_DECLARE(fl_status_t) fl_i2c_write_dword(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint32_t data)
+// Register address and size bytes of the value(big endian) in one write.
+static fl_status_t write_reg(fl_i2c_t *handle, uint8_t i2c_addr, uint16_t reg_addr, uint32_t data, uint8_t size)
 {
-  fl_status_t ret = FL_OK;
+  HAL_StatusTypeDef hal_ret;
+  fl_status_t       ret = FL_OK;
+  uint8_t           i;
+
+  FL_PERF_BEGIN(FL_PERF_STAGE_I2C);
 
   handle->buf[0] = (reg_addr >> 8);
   handle->buf[1] = (reg_addr & 0xFF);
-  handle->buf[2] = (data >> 24);
-  handle->buf[3] = ((data >> 16) & 0xFF);
-  handle->buf[4] = ((data >> 8) & 0xFF);
-  handle->buf[5] = (data & 0xFF);
+  for (i = 0; i < size; i++)
+  {
+    handle->buf[2 + i] = (uint8_t)(data >> (8 * (size - 1 - i)));
+  }
 
-  if (HAL_I2C_Master_Transmit(handle->i2c, i2c_addr, handle->buf, 6, handle->timeout) != HAL_OK)
+  hal_ret = HAL_I2C_Master_Transmit(handle->i2c, i2c_addr, handle->buf, 2 + size, fl_i2c_timeout(handle, size));
+  if (hal_ret != HAL_OK)
   {
-    ret = FL_ERROR; // Write error.
+    ret = get_error(handle, hal_ret, 2 + size);
   }
 
+  FL_PERF_END(FL_PERF_STAGE_I2C);
+
   return ret;
 }
+
+// Map a failed transfer(size bytes) to an error code, the bus is recovered if the peripheral could not finish it.
+static fl_status_t get_error(fl_i2c_t *handle, HAL_StatusTypeDef hal_ret, uint16_t size)
+{
+  uint32_t    error;
+  fl_status_t ret;
+
+  // Another transfer(interrupt mode) owns the peripheral.
+  if (hal_ret == HAL_BUSY)
+  {
+    return FL_I2C_ERR_BUS;
+  }
+
+  error = HAL_I2C_GetError(handle->i2c);
+
+  // The peripheral generated STOP, the bus is free.
+  if ((error & HAL_I2C_ERROR_AF) != 0)
+  {
+    // No byte was sent after the slave address.
+    if (handle->i2c->XferCount == size)
+    {
+      return FL_I2C_ERR_ADDR_NACK;
+    }
+    return FL_I2C_ERR_DATA_NACK;
+  }
+
+  if ((error & HAL_I2C_ERROR_ARLO) != 0)
+  {
+    ret = FL_I2C_ERR_ARB_LOST;
+  }
+  else if ((error & HAL_I2C_ERROR_BERR) != 0)
+  {
+    ret = FL_I2C_ERR_BUS;
+  }
+  else
+  {
+    // HAL_I2C_ERROR_TIMEOUT(bus busy, clock stretching, SDA held low).
+    ret = FL_I2C_ERR_TIMEOUT;
+  }
+
+  fl_i2c_recover(handle);
+
+  return ret;
+}
+
+static uint32_t get_fast_mode_plus(I2C_TypeDef *instance)
+{
+  if (instance == I2C2)
+  {
+    return I2C_FASTMODEPLUS_I2C2;
+  }
+  else if (instance == I2C3)
+  {
+    return I2C_FASTMODEPLUS_I2C3;
+  }
+
+  return I2C_FASTMODEPLUS_I2C1;
+}
+
+static void delay_us(uint32_t us)
+{
+  uint32_t start;
+  uint32_t cycles = us * (SystemCoreClock / 1000000);
+
+  // The DWT cycle counter is also used by fl_perf.
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = 0xC5ACCE55;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  start = DWT->CYCCNT;
+  while ((DWT->CYCCNT - start) < cycles)
+  {
+  }
+}
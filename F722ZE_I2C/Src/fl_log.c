@@ -0,0 +1,111 @@
+// Firmware library deferred log
+// fl_log.c
+
+#include "fl_log.h"
+
+#if defined(FL_ENABLE_LOG)
+
+typedef struct _fl_log
+{
+  fl_log_record_t     ring[FL_LOG_RING_SIZE];
+
+  // Free running write/read index.
+  volatile uint32_t   head;
+  volatile uint32_t   tail;
+
+  // Records dropped since the last FL_LOG_DROPPED record.
+  volatile uint32_t   dropped;
+
+  // Record being sent and its next word.
+  fl_log_record_t     out;
+  uint8_t             out_words;
+  uint8_t             out_index;
+} fl_log_t;
+
+static fl_log_t _log;
+
+static fl_bool_t next_record(void);
+
+// Callable from interrupt handlers.
+FL_DECLARE(void) fl_log_write(uint16_t fmt_id, uint8_t arg_count, uint32_t a0, uint32_t a1, uint32_t a2)
+{
+  fl_log_record_t* rec;
+
+  FL_LOG_LOCK();
+
+  if ((_log.head - _log.tail) >= FL_LOG_RING_SIZE)
+  {
+    _log.dropped++;
+  }
+  else
+  {
+    rec = &_log.ring[_log.head & (FL_LOG_RING_SIZE - 1)];
+    rec->header = ((uint32_t)FL_LOG_SYNC << 24) | ((uint32_t)arg_count << 16) | fmt_id;
+    rec->tick = HAL_GetTick();
+    rec->args[0] = a0;
+    rec->args[1] = a1;
+    rec->args[2] = a2;
+    _log.head++;
+  }
+
+  FL_LOG_UNLOCK();
+}
+
+// Send records while the ITM FIFO accepts a word, a full FIFO continues at the next call.
+// Records are kept while no trace probe enables the ITM port.
+FL_DECLARE(void) fl_log_drain(void)
+{
+  if (FL_LOG_PORT_ENABLED() == FL_FALSE)
+  {
+    return;
+  }
+
+  for (;;)
+  {
+    if ((_log.out_index >= _log.out_words) &&
+        (next_record() == FL_FALSE))
+    {
+      return;
+    }
+
+    if (FL_LOG_PORT_READY() == FL_FALSE)
+    {
+      return;
+    }
+
+    FL_LOG_PORT_WRITE(((const uint32_t*)&_log.out)[_log.out_index++]);
+  }
+}
+
+// The number of dropped records is sent after the records in the ring.
+static fl_bool_t next_record(void)
+{
+  FL_LOG_LOCK();
+
+  if (_log.tail != _log.head)
+  {
+    _log.out = _log.ring[_log.tail & (FL_LOG_RING_SIZE - 1)];
+    _log.tail++;
+  }
+  else if (_log.dropped != 0)
+  {
+    _log.out.header = ((uint32_t)FL_LOG_SYNC << 24) | (1UL << 16) | FL_LOG_DROPPED;
+    _log.out.tick = HAL_GetTick();
+    _log.out.args[0] = _log.dropped;
+    _log.dropped = 0;
+  }
+  else
+  {
+    FL_LOG_UNLOCK();
+    return FL_FALSE;
+  }
+
+  FL_LOG_UNLOCK();
+
+  _log.out_words = 2 + ((_log.out.header >> 16) & 0xFF);
+  _log.out_index = 0;
+
+  return FL_TRUE;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#include <string.h>
+#include "fl_perf.h"
+
+#if defined(FL_ENABLE_PERF)
+
+static fl_perf_stat_t _perf_stats[FL_PERF_STAGE_COUNT];
+
+FL_DECLARE(void) fl_perf_init(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < FL_PERF_STAGE_COUNT; i++)
+  {
+    fl_perf_reset(i);
+  }
+
+  // Enable the DWT cycle counter(Cortex-M7 needs the DWT unlocked).
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = 0xC5ACCE55;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+FL_DECLARE(void) fl_perf_begin(uint8_t stage)
+{
+  _perf_stats[stage].start = DWT->CYCCNT;
+}
+
+FL_DECLARE(void) fl_perf_end(uint8_t stage)
+{
+  fl_perf_stat_t* stat = &_perf_stats[stage];
+  // Unsigned subtraction handles a counter wrap(about 19.8 seconds at 216MHz).
+  uint32_t        cycles = DWT->CYCCNT - stat->start;
+  int32_t         bucket;
+
+  stat->count++;
+  stat->sum += cycles;
+  if (cycles < stat->min)
+  {
+    stat->min = cycles;
+  }
+  if (cycles > stat->max)
+  {
+    stat->max = cycles;
+  }
+
+  // floor(log2(cycles)) - FL_PERF_HIST_SHIFT
+  bucket = (cycles > 0) ? (31 - (int32_t)__CLZ(cycles)) - FL_PERF_HIST_SHIFT : 0;
+  if (bucket < 0)
+  {
+    bucket = 0;
+  }
+  else if (bucket >= FL_PERF_HIST_BUCKETS)
+  {
+    bucket = FL_PERF_HIST_BUCKETS - 1;
+  }
+  stat->hist[bucket]++;
+}
+
+FL_DECLARE(const fl_perf_stat_t*) fl_perf_get(uint8_t stage)
+{
+  return &_perf_stats[stage];
+}
+
+FL_DECLARE(void) fl_perf_reset(uint8_t stage)
+{
+  memset(&_perf_stats[stage], 0, sizeof(fl_perf_stat_t));
+  _perf_stats[stage].min = 0xFFFFFFFF;
+}
+
+#endif
@@ -0,0 +1,70 @@
+#include <string.h>
+#include "fl_ring.h"
+
+FL_DECLARE(void) fl_ring_init(fl_ring_t* ring, void* buf, uint16_t elem_size, uint32_t capacity)
+{
+  memset(ring, 0, sizeof(fl_ring_t));
+
+  ring->buf = (uint8_t*)buf;
+  ring->elem_size = elem_size;
+  ring->capacity = capacity;
+}
+
+FL_DECLARE(void) fl_ring_clear(fl_ring_t* ring)
+{
+  ring->tail = ring->head;
+  ring->overrun = 0;
+}
+
+FL_DECLARE(uint32_t) fl_ring_count(fl_ring_t* ring)
+{
+  return ring->head - ring->tail;
+}
+
+FL_DECLARE(fl_status_t) fl_ring_push(fl_ring_t* ring, const void* elem)
+{
+  uint32_t head = ring->head;
+
+  // Ring is full, keep the oldest elements(host has not read them yet).
+  if ((head - ring->tail) >= ring->capacity)
+  {
+    ring->overrun++;
+    return FL_ERROR;
+  }
+
+  memcpy(&ring->buf[(head & (ring->capacity - 1)) * ring->elem_size], elem, ring->elem_size);
+  ring->head = head + 1;
+
+  return FL_OK;
+}
+
+FL_DECLARE(fl_status_t) fl_ring_pop(fl_ring_t* ring, void* elem)
+{
+  uint32_t tail = ring->tail;
+
+  // Ring is empty.
+  if (ring->head == tail)
+  {
+    return FL_ERROR;
+  }
+
+  memcpy(elem, &ring->buf[(tail & (ring->capacity - 1)) * ring->elem_size], ring->elem_size);
+  ring->tail = tail + 1;
+
+  return FL_OK;
+}
+
+FL_DECLARE(uint32_t) fl_ring_pop_n(fl_ring_t* ring, void* elems, uint32_t max_count)
+{
+  uint8_t*  dst = (uint8_t*)elems;
+  uint32_t  count = 0;
+
+  while ((count < max_count) &&
+         (fl_ring_pop(ring, dst) == FL_OK))
+  {
+    dst += ring->elem_size;
+    count++;
+  }
+
+  return count;
+}
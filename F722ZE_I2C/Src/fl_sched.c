@@ -0,0 +1,157 @@
+#include <string.h>
+#include "fl_sched.h"
+
+static uint32_t process_timers(fl_sched_t* sched);
+
+FL_DECLARE(void) fl_sched_init(fl_sched_t* sched)
+{
+  memset(sched, 0, sizeof(fl_sched_t));
+}
+
+// Called from the tick interrupt(SysTick).
+FL_DECLARE(void) fl_sched_tick(fl_sched_t* sched)
+{
+  sched->tick++;
+}
+
+FL_DECLARE(uint32_t) fl_sched_get_tick(fl_sched_t* sched)
+{
+  return sched->tick;
+}
+
+// It can be called from interrupt handlers.
+FL_DECLARE(fl_status_t) fl_sched_post(fl_sched_t* sched, fl_sched_handler_t handler, uint32_t param, void* context)
+{
+  fl_status_t       ret = FL_OK;
+  fl_sched_event_t* evt;
+
+  FL_SCHED_LOCK();
+  if ((sched->head - sched->tail) >= FL_SCHED_EVENT_QUEUE_SIZE)
+  {
+    sched->dropped++;
+    ret = FL_ERROR;
+  }
+  else
+  {
+    evt = &sched->events[sched->head & (FL_SCHED_EVENT_QUEUE_SIZE - 1)];
+    evt->handler = handler;
+    evt->param = param;
+    evt->context = context;
+    sched->head++;
+  }
+  FL_SCHED_UNLOCK();
+
+  return ret;
+}
+
+FL_DECLARE(uint32_t) fl_sched_pending(fl_sched_t* sched)
+{
+  return sched->head - sched->tail;
+}
+
+// delay : ticks to the first expiration, period : 0 for a one-shot timer.
+// Starting an active timer restarts it.
+FL_DECLARE(fl_status_t) fl_sched_timer_start(fl_sched_t* sched, uint8_t timer_id, fl_sched_handler_t handler, uint32_t param, void* context, uint32_t delay, uint32_t period)
+{
+  fl_sched_timer_t* timer;
+
+  if ((timer_id >= FL_SCHED_TIMER_COUNT) || (handler == NULL))
+  {
+    return FL_ERROR;
+  }
+
+  timer = &sched->timers[timer_id];
+  timer->active = FL_FALSE;
+  timer->handler = handler;
+  timer->param = param;
+  timer->context = context;
+  timer->expire = sched->tick + delay;
+  timer->period = period;
+  timer->active = FL_TRUE;
+
+  return FL_OK;
+}
+
+FL_DECLARE(void) fl_sched_timer_stop(fl_sched_t* sched, uint8_t timer_id)
+{
+  if (timer_id < FL_SCHED_TIMER_COUNT)
+  {
+    sched->timers[timer_id].active = FL_FALSE;
+  }
+}
+
+FL_DECLARE(fl_bool_t) fl_sched_timer_is_active(fl_sched_t* sched, uint8_t timer_id)
+{
+  if (timer_id < FL_SCHED_TIMER_COUNT)
+  {
+    return sched->timers[timer_id].active;
+  }
+  return FL_FALSE;
+}
+
+// Dispatch expired timers and queued events(run to completion).
+// Returns the number of handlers called.
+FL_DECLARE(uint32_t) fl_sched_run(fl_sched_t* sched)
+{
+  uint32_t          count;
+  fl_sched_event_t  evt;
+
+  count = process_timers(sched);
+
+  // Events posted by handlers are dispatched in this call too.
+  while (sched->tail != sched->head)
+  {
+    evt = sched->events[sched->tail & (FL_SCHED_EVENT_QUEUE_SIZE - 1)];
+    sched->tail++;
+
+    evt.handler(evt.param, evt.context);
+    count++;
+  }
+
+  return count;
+}
+
+// Sleep until an interrupt(tick, UART, I2C, ...) when there is nothing to do.
+FL_DECLARE(void) fl_sched_idle(fl_sched_t* sched)
+{
+  FL_SCHED_LOCK();
+  // WFI wakes up on a pending interrupt even with interrupts masked,
+  // so an event posted after the check is not missed.
+  if (sched->head == sched->tail)
+  {
+    FL_SCHED_WAIT_FOR_INTERRUPT();
+  }
+  FL_SCHED_UNLOCK();
+}
+
+// Returns the number of expired timers.
+static uint32_t process_timers(fl_sched_t* sched)
+{
+  uint32_t          count = 0;
+  uint32_t          tick = sched->tick;
+  uint8_t           i;
+  fl_sched_timer_t* timer;
+
+  for (i = 0; i < FL_SCHED_TIMER_COUNT; i++)
+  {
+    timer = &sched->timers[i];
+
+    if ((timer->active == FL_TRUE) &&
+        ((int32_t)(tick - timer->expire) >= 0))
+    {
+      if (timer->period > 0)
+      {
+        timer->expire += timer->period;
+      }
+      else
+      {
+        timer->active = FL_FALSE;
+      }
+
+      timer->handler(timer->param, timer->context);
+      count++;
+    }
+  }
+
+  return count;
+}
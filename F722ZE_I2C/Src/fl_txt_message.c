@@ -44,7 +44,7 @@ FL_DECLARE(uint8_t) fl_txt_msg_build_command(
   {
     // RHVER device_id\n
     // ex) RHVER 1\n
-    len = sprintf((char*)packet_buf, "%s %ld%c", fl_txt_msg_get_message_name(message_id), device_id, FL_TXT_MSG_TAIL);
+    len = sprintf((char*)packet_buf, "%s %lu%c", fl_txt_msg_get_message_name(message_id), device_id, FL_TXT_MSG_TAIL);
     break;
   }
 
@@ -52,7 +52,7 @@ FL_DECLARE(uint8_t) fl_txt_msg_build_command(
   {
     // RFVER device_id\n
     // ex) RFVER 1\n
-    len = sprintf((char*)packet_buf, "%s %ld%c", fl_txt_msg_get_message_name(message_id), device_id, FL_TXT_MSG_TAIL);
+    len = sprintf((char*)packet_buf, "%s %lu%c", fl_txt_msg_get_message_name(message_id), device_id, FL_TXT_MSG_TAIL);
     break;
   }
   }
@@ -113,7 +113,7 @@ FL_DECLARE(uint8_t) fl_txt_msg_build_response(
         if ((arg_buf_len <= sizeof(fl_hw_ver_t)) &&
             (strlen(hw_ver->version) > 0))
         {
-          len = sprintf((char*)packet_buf, "%s %ld,%d,%s%c", fl_txt_msg_get_message_name(message_id), device_id, error, hw_ver->version, FL_TXT_MSG_TAIL);
+          len = sprintf((char*)packet_buf, "%s %lu,%d,%s%c", fl_txt_msg_get_message_name(message_id), device_id, error, hw_ver->version, FL_TXT_MSG_TAIL);
         }
         break;
       }
@@ -126,7 +126,7 @@ FL_DECLARE(uint8_t) fl_txt_msg_build_response(
         if ((arg_buf_len <= sizeof(fl_fw_ver_t)) &&
           (strlen(fw_ver->version) > 0))
         {
-          len = sprintf((char*)packet_buf, "%s %ld,%d,%s%c", fl_txt_msg_get_message_name(message_id), device_id, error, fw_ver->version, FL_TXT_MSG_TAIL);
+          len = sprintf((char*)packet_buf, "%s %lu,%d,%s%c", fl_txt_msg_get_message_name(message_id), device_id, error, fw_ver->version, FL_TXT_MSG_TAIL);
         }
         break;
       }
@@ -134,7 +134,7 @@ FL_DECLARE(uint8_t) fl_txt_msg_build_response(
   }
   else
   {
-    len = sprintf((char*)packet_buf, "%s %ld,%d%c", fl_txt_msg_get_message_name(message_id), device_id, error, FL_TXT_MSG_TAIL);
+    len = sprintf((char*)packet_buf, "%s %lu,%d%c", fl_txt_msg_get_message_name(message_id), device_id, error, FL_TXT_MSG_TAIL);
   }
 
   if (len > packet_buf_len)
@@ -145,19 +145,35 @@ FL_DECLARE(uint8_t) fl_txt_msg_build_response(
   return len;
 }
 
+// Text message names indexed by message ID(NULL : no text message).
+// A new message is added here, fl_txt_msg_parser_get_msg_id() looks names up in this table.
+static char* const _msg_names[FL_MSG_ID_COUNT] = {
+  [FL_MSG_ID_READ_HW_VERSION]   = FL_TXT_RHVER_STR,
+  [FL_MSG_ID_READ_FW_VERSION]   = FL_TXT_RFVER_STR,
+  [FL_MSG_ID_READ_WRITE_I2C]    = FL_TXT_RwI2C_STR,
+  [FL_MSG_ID_CAPTURE_CONTROL]   = FL_TXT_WCAPT_STR,
+  [FL_MSG_ID_READ_CAPTURE]      = FL_TXT_RCAPT_STR,
+  [FL_MSG_ID_CAPTURE_EVENT]     = FL_TXT_ECAPT_STR,
+  [FL_MSG_ID_READ_PERF]         = FL_TXT_RPERF_STR,
+  [FL_MSG_ID_WRITE_I2C_SPEED]   = FL_TXT_WI2CS_STR,
+  [FL_MSG_ID_READ_SENSORS]      = FL_TXT_RSENS_STR,
+  [FL_MSG_ID_WRITE_RANGING]     = FL_TXT_WRANG_STR,
+  [FL_MSG_ID_RANGE_EVENT]       = FL_TXT_ERANG_STR,
+  [FL_MSG_ID_MEASUREMENT_EVENT] = FL_TXT_EMEAS_STR,
+  [FL_MSG_ID_WRITE_CONFIG]      = FL_TXT_WCONF_STR,
+  [FL_MSG_ID_READ_CONFIG]       = FL_TXT_RCONF_STR,
+  [FL_MSG_ID_WRITE_PROFILE]     = FL_TXT_WPROF_STR,
+  [FL_MSG_ID_READY_EVENT]       = FL_TXT_EREDY_STR,
+  [FL_MSG_ID_READ_BURST]        = FL_TXT_RBURS_STR,
+  [FL_MSG_ID_UPDATE_BITS]       = FL_TXT_WBITS_STR,
+};
+
 FL_DECLARE(char*) fl_txt_msg_get_message_name(const uint8_t message_id)
 {
-  switch (message_id)
+  if (message_id >= FL_MSG_ID_COUNT)
   {
-  case FL_MSG_ID_READ_HW_VERSION:
-    return FL_TXT_RHVER_STR;
-
-  case FL_MSG_ID_READ_FW_VERSION:
-    return FL_TXT_RFVER_STR;
-
-  case FL_MSG_ID_READ_WRITE_I2C:
-    return FL_TXT_RwI2C_STR;
+    return NULL;
   }
 
-  return NULL;
+  return _msg_names[message_id];
 }
@@ -3,11 +3,17 @@
 #include "fl_txt_message_parser.h"
 #include "internal_util.h"
 
-static fl_bool_t is_command_with_arguments(uint8_t msg_id);
+static fl_bool_t is_command_with_arguments(fl_txt_msg_parser_t* parser_handle);
 static void clear_receive_buffer(fl_txt_msg_parser_t* parser_handle);
 static fl_bool_t process_command_data(fl_txt_msg_parser_t* parser_handle);
 static fl_bool_t process_response_event_data(fl_txt_msg_parser_t* parser_handle);
 static fl_bool_t is_evnet_msg(fl_txt_msg_parser_t* parser_handle);
+static void build_name_index(void);
+static int compare_name(const char* name, const uint8_t* buf, uint8_t buf_size);
+
+// Message IDs in message name order(fl_txt_msg_parser_get_msg_id()).
+static uint8_t _name_index[FL_MSG_ID_COUNT];
+static uint8_t _name_count = 0;
 
 FL_DECLARE(void) fl_txt_msg_parser_init(fl_txt_msg_parser_t* parser_handle)
 {
@@ -80,7 +86,7 @@ FL_DECLARE(fl_status_t) fl_txt_msg_parser_parse_command(fl_txt_msg_parser_t* par
     else if (data == FL_TXT_MSG_ARG_DELIMITER)
     {
       parser_handle->device_id = get_device_id(parser_handle->buf, parser_handle->buf_pos);
-      if (is_command_with_arguments(parser_handle->msg_id) == FL_TRUE)
+      if (is_command_with_arguments(parser_handle) == FL_TRUE)
       {
         parser_handle->receive_state = FL_TXT_MSG_PARSER_RCV_STS_DATA;
         clear_receive_buffer(parser_handle);
@@ -342,32 +348,92 @@ FL_DECLARE(fl_status_t) fl_txt_msg_parser_parse_response_event(fl_txt_msg_parser
   return ret;
 }
 
+// Binary search of the message names(fl_txt_msg_get_message_name()).
 FL_DECLARE(uint8_t) fl_txt_msg_parser_get_msg_id(uint8_t* buf, uint8_t buf_size)
 {
-  if (buf_size == 5)
+  uint8_t low = 0;
+  uint8_t high;
+  uint8_t mid;
+  int     cmp;
+
+  if ((buf_size == 0) ||
+      (buf_size > FL_TXT_MSG_ID_MAX_LEN))
+  {
+    return FL_MSG_ID_UNKNOWN;
+  }
+
+  if (_name_count == 0)
   {
-    if (strcmp(FL_TXT_RHVER_STR, (const char*)buf) == 0)
+    build_name_index();
+  }
+
+  high = _name_count;
+  while (low < high)
+  {
+    mid = (low + high) / 2;
+    cmp = compare_name(fl_txt_msg_get_message_name(_name_index[mid]), buf, buf_size);
+    if (cmp == 0)
     {
-      return FL_MSG_ID_READ_HW_VERSION;
+      return _name_index[mid];
     }
-    else if (strcmp(FL_TXT_RFVER_STR, (const char*)buf) == 0)
+    else if (cmp < 0)
     {
-      return FL_MSG_ID_READ_FW_VERSION;
+      low = mid + 1;
     }
-    else if (strcmp(FL_TXT_RwI2C_STR, (const char*)buf) == 0)
+    else
     {
-      return FL_MSG_ID_READ_WRITE_I2C;
+      high = mid;
     }
   }
 
   return FL_MSG_ID_UNKNOWN;
 }
 
-static fl_bool_t is_command_with_arguments(uint8_t msg_id)
+FL_DECLARE(const fl_txt_msg_cmd_def_t*) fl_txt_msg_parser_get_cmd(fl_txt_msg_parser_t* parser_handle, uint8_t msg_id)
+{
+  if ((parser_handle->cmd_table == NULL) ||
+      (msg_id >= parser_handle->cmd_count))
+  {
+    return NULL;
+  }
+
+  return &parser_handle->cmd_table[msg_id];
+}
+
+FL_DECLARE(fl_bool_t) fl_txt_msg_decode_arg(const fl_txt_msg_cmd_def_t* cmd, void* payload, uint8_t arg_index, const char* arg)
+{
+  const fl_txt_msg_arg_def_t* arg_def = &cmd->args[arg_index];
+  uint8_t*                    field = (uint8_t*)payload + arg_def->offset;
+  uint32_t                    value = strtoul(arg, NULL, 10);
+
+  // Payload fields are not aligned(packed structs).
+  if (arg_def->size == 1)
+  {
+    *field = (uint8_t)value;
+  }
+  else if (arg_def->size == 2)
+  {
+    uint16_t value16 = (uint16_t)value;
+    memcpy(field, &value16, sizeof(value16));
+  }
+  else if (arg_def->size == 4)
+  {
+    memcpy(field, &value, sizeof(value));
+  }
+  else
+  {
+    return FL_FALSE;
+  }
+
+  return FL_TRUE;
+}
+
+static fl_bool_t is_command_with_arguments(fl_txt_msg_parser_t* parser_handle)
 {
-  switch (msg_id)
+  const fl_txt_msg_cmd_def_t* cmd = fl_txt_msg_parser_get_cmd(parser_handle, parser_handle->msg_id);
+
+  if ((cmd != NULL) && (cmd->max_arg_count > 0))
   {
-  case FL_MSG_ID_READ_WRITE_I2C:
     return FL_TRUE;
   }
   return FL_FALSE;
@@ -381,54 +447,24 @@ static void clear_receive_buffer(fl_txt_msg_parser_t* parser_handle)
 
 static fl_bool_t process_command_data(fl_txt_msg_parser_t* parser_handle)
 {
-  fl_bool_t ret = FL_FALSE;
+  const fl_txt_msg_cmd_def_t* cmd = fl_txt_msg_parser_get_cmd(parser_handle, parser_handle->msg_id);
+  fl_txt_msg_decode_t         decode;
 
-  if (parser_handle->arg_count >= FL_TXT_MSG_MAX_ARG_COUNT)
+  if ((cmd == NULL) ||
+      (parser_handle->arg_count >= FL_TXT_MSG_MAX_ARG_COUNT) ||
+      (parser_handle->arg_count >= cmd->max_arg_count))
   {
-    return ret;
+    return FL_FALSE;
   }
 
-  if (parser_handle->msg_id == FL_MSG_ID_READ_WRITE_I2C)
+  decode = (cmd->decode != NULL) ? cmd->decode : fl_txt_msg_decode_arg;
+  if (decode(cmd, &parser_handle->payload, parser_handle->arg_count, (const char*)parser_handle->buf) == FL_TRUE)
   {
-    fl_i2c_read_t* i2c_rd = (fl_i2c_read_t*)&parser_handle->payload;
-    if (parser_handle->arg_count == 0)
-    {
-      i2c_rd->rw_mode = (uint8_t)atoi((const char*)parser_handle->buf);
-      parser_handle->arg_count++;
-      ret = FL_TRUE;
-    }
-    else if (parser_handle->arg_count == 1)
-    {
-      i2c_rd->i2c_num = (uint8_t)atoi((const char*)parser_handle->buf);
-      parser_handle->arg_count++;
-      ret = FL_TRUE;
-    }
-    else if (parser_handle->arg_count == 2)
-    {
-      i2c_rd->dev_addr = (uint16_t)atoi((const char*)parser_handle->buf);
-      parser_handle->arg_count++;
-      ret = FL_TRUE;
-    }
-    else if (parser_handle->arg_count == 3)
-    {
-      i2c_rd->reg_addr = (uint16_t)atoi((const char*)parser_handle->buf);
-      parser_handle->arg_count++;
-      ret = FL_TRUE;
-    }
-    else if (parser_handle->arg_count == 4)
-    {
-      if (i2c_rd->rw_mode == 1)
-      {
-        fl_i2c_write_t* i2c_wr = (fl_i2c_write_t*)&parser_handle->payload;
-
-        i2c_wr->reg_value = (uint8_t)atoi((const char*)parser_handle->buf);
-        parser_handle->arg_count++;
-        ret = FL_TRUE;
-      }
-    }
+    parser_handle->arg_count++;
+    return FL_TRUE;
   }
 
-  return ret;
+  return FL_FALSE;
 }
 
 static fl_bool_t process_response_event_data(fl_txt_msg_parser_t* parser_handle)
@@ -468,3 +504,41 @@ static fl_bool_t is_evnet_msg(fl_txt_msg_parser_t* parser_handle)
 {
   return FL_FALSE;
 }
+
+// Insertion sort of the message IDs with a name.
+static void build_name_index(void)
+{
+  const char* name;
+  uint8_t     id;
+  uint8_t     i;
+
+  for (id = 0; id < FL_MSG_ID_COUNT; id++)
+  {
+    name = fl_txt_msg_get_message_name(id);
+    if (name == NULL)
+    {
+      continue;
+    }
+
+    for (i = _name_count; (i > 0) && (strcmp(fl_txt_msg_get_message_name(_name_index[i - 1]), name) > 0); i--)
+    {
+      _name_index[i] = _name_index[i - 1];
+    }
+    _name_index[i] = id;
+    _name_count++;
+  }
+}
+
+// strcmp() of a name and the received characters(not NULL terminated).
+static int compare_name(const char* name, const uint8_t* buf, uint8_t buf_size)
+{
+  int cmp = strncmp(name, (const char*)buf, buf_size);
+
+  if ((cmp == 0) && (name[buf_size] != '\0'))
+  {
+    // The name is longer.
+    return 1;
+  }
+
+  return cmp;
+}
@@ -0,0 +1,330 @@
+// Firmware library VL6180X
+// fl_vl6180x.c
+
+#include "fl_vl6180x.h"
+
+typedef struct _fl_vl6180x_setting
+{
+  uint16_t  reg_addr;
+  uint8_t   value;
+} fl_vl6180x_setting_t;
+
+typedef struct _fl_vl6180x_reg_info
+{
+  uint16_t  reg_addr;
+  uint8_t   size;
+} fl_vl6180x_reg_info_t;
+
+// Mandatory private registers after a reset(AN4545 SR03 settings).
+static const fl_vl6180x_setting_t _private_settings[] = {
+  { 0x0207, 0x01 }, { 0x0208, 0x01 }, { 0x0096, 0x00 }, { 0x0097, 0xFD },
+  { 0x00E3, 0x00 }, { 0x00E4, 0x04 }, { 0x00E5, 0x02 }, { 0x00E6, 0x01 },
+  { 0x00E7, 0x03 }, { 0x00F5, 0x02 }, { 0x00D9, 0x05 }, { 0x00DB, 0xCE },
+  { 0x00DC, 0x03 }, { 0x00DD, 0xF8 }, { 0x009F, 0x00 }, { 0x00A3, 0x3C },
+  { 0x00B7, 0x00 }, { 0x00BB, 0x3C }, { 0x00B2, 0x09 }, { 0x00CA, 0x09 },
+  { 0x0198, 0x01 }, { 0x01B0, 0x17 }, { 0x01AD, 0x00 }, { 0x00FF, 0x05 },
+  { 0x0100, 0x05 }, { 0x0199, 0x05 }, { 0x01A6, 0x1B }, { 0x01AC, 0x3E },
+  { 0x01A7, 0x1F }, { 0x0030, 0x00 }
+};
+
+// Recommended public registers(AN4545).
+static const fl_vl6180x_setting_t _public_settings[] = {
+  { FL_VL6180X_SYSTEM_MODE_GPIO1,                0x10 },  // GPIO1 : interrupt output(active low)
+  { FL_VL6180X_READOUT_AVERAGING_SAMPLE_PERIOD,  0x30 },  // 4.3ms
+  { FL_VL6180X_SYSALS_ANALOGUE_GAIN,             0x46 },  // ALS gain 1.01
+  { FL_VL6180X_SYSRANGE_VHV_REPEAT_RATE,         0xFF },  // Temperature recalibration every 255 measurements
+  { FL_VL6180X_SYSRANGE_VHV_RECALIBRATE,         0x01 },  // Temperature recalibration now
+  { FL_VL6180X_SYSRANGE_INTERMEASUREMENT_PERIOD, 0x09 },  // 100ms
+  { FL_VL6180X_SYSALS_INTERMEASUREMENT_PERIOD,   0x31 },  // 500ms
+  { FL_VL6180X_SYSTEM_INTERRUPT_CONFIG_GPIO,     0x24 },  // New sample ready interrupt for range and ALS
+  { FL_VL6180X_INTERLEAVED_MODE_ENABLE,          0x00 }
+};
+
+// ALS gains x 100 by SYSALS__ANALOGUE_GAIN[2:0].
+static const uint16_t _als_gains[] = { 2000, 1032, 521, 260, 172, 128, 101, 4000 };
+
+// Register sizes(bytes) for register access by address(RWI2C), address order.
+// fl_vl6180x_reg_def.h is generated from the host register catalog(RegisterCatalogGen).
+static const fl_vl6180x_reg_info_t _reg_infos[] = {
+#define FL_VL6180X_REG(addr, size)  { addr, size },
+#include "fl_vl6180x_reg_def.h"
+#undef FL_VL6180X_REG
+};
+
+static fl_status_t write_settings(fl_vl6180x_t *handle, const fl_vl6180x_setting_t *settings, uint16_t count);
+static uint8_t get_period_reg(uint16_t period);
+static fl_status_t read_als_settings(fl_vl6180x_t *handle);
+
+// Settings are written once after a reset(hardware standby, power on).
+FL_DECLARE(fl_status_t) fl_vl6180x_init(fl_vl6180x_t *handle)
+{
+  uint8_t     fresh = 0;
+  fl_status_t ret;
+
+  handle->mode = FL_VL6180X_MODE_STOP;
+
+  ret = fl_i2c_read_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSTEM_FRESH_OUT_OF_RESET, &fresh);
+  if (ret != FL_OK)
+  {
+    return ret;
+  }
+
+  if (fresh == 0)
+  {
+    return read_als_settings(handle);
+  }
+
+  if (((ret = write_settings(handle, _private_settings, sizeof(_private_settings) / sizeof(_private_settings[0]))) != FL_OK) ||
+      ((ret = write_settings(handle, _public_settings, sizeof(_public_settings) / sizeof(_public_settings[0]))) != FL_OK) ||
+      // 100ms
+      ((ret = fl_i2c_write_word(handle->i2c, handle->dev_addr, FL_VL6180X_SYSALS_INTEGRATION_PERIOD, 0x0063)) != FL_OK))
+  {
+    return ret;
+  }
+
+  if ((ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSTEM_FRESH_OUT_OF_RESET, 0x00)) != FL_OK)
+  {
+    return ret;
+  }
+
+  return read_als_settings(handle);
+}
+
+// Stop the current mode and start a new one.
+// period : intermeasurement period(ms) of the continuous and interleaved modes(fl_vl6180x_check_period()).
+FL_DECLARE(fl_status_t) fl_vl6180x_start(fl_vl6180x_t *handle, uint8_t mode, uint16_t period)
+{
+  fl_status_t ret;
+
+  if (fl_vl6180x_check_period(mode, period) != FL_OK)
+  {
+    return FL_ERROR;
+  }
+
+  if ((ret = fl_vl6180x_stop(handle)) != FL_OK)
+  {
+    return ret;
+  }
+
+  switch (mode)
+  {
+  case FL_VL6180X_MODE_SINGLE:
+    ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSRANGE_START, FL_VL6180X_START_SINGLE);
+    break;
+
+  case FL_VL6180X_MODE_CONTINUOUS:
+    if ((ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSRANGE_INTERMEASUREMENT_PERIOD,
+                                 get_period_reg(period))) == FL_OK)
+    {
+      ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSRANGE_START, FL_VL6180X_START_CONTINUOUS);
+    }
+    break;
+
+  case FL_VL6180X_MODE_INTERLEAVED:
+    // The ALS start runs a range measurement after each ALS measurement.
+    // ALS settings may have been changed by register writes(RWI2C) since fl_vl6180x_init().
+    if (((ret = read_als_settings(handle)) == FL_OK) &&
+        ((ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_INTERLEAVED_MODE_ENABLE, 0x01)) == FL_OK) &&
+        ((ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSALS_INTERMEASUREMENT_PERIOD,
+                                  get_period_reg(period))) == FL_OK))
+    {
+      ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSALS_START, FL_VL6180X_START_CONTINUOUS);
+    }
+    break;
+  }
+
+  if ((ret == FL_OK) && (mode != FL_VL6180X_MODE_STOP))
+  {
+    handle->mode = mode;
+  }
+
+  return ret;
+}
+
+// A start in a continuous mode halts the measurements.
+FL_DECLARE(fl_status_t) fl_vl6180x_stop(fl_vl6180x_t *handle)
+{
+  fl_status_t ret = FL_OK;
+
+  if (handle->mode == FL_VL6180X_MODE_CONTINUOUS)
+  {
+    ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSRANGE_START, FL_VL6180X_START_SINGLE);
+  }
+  else if (handle->mode == FL_VL6180X_MODE_INTERLEAVED)
+  {
+    if ((ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSALS_START, FL_VL6180X_START_SINGLE)) == FL_OK)
+    {
+      ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_INTERLEAVED_MODE_ENABLE, 0x00);
+    }
+  }
+
+  if (ret != FL_OK)
+  {
+    return ret;
+  }
+
+  handle->mode = FL_VL6180X_MODE_STOP;
+
+  // Results of the previous mode.
+  return fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSTEM_INTERRUPT_CLEAR, FL_VL6180X_CLEAR_ALL);
+}
+
+// Read the new range and ALS samples(result->int_status), then clear their interrupts.
+// A sample not ready keeps the previous value in result.
+FL_DECLARE(fl_status_t) fl_vl6180x_read_result(fl_vl6180x_t *handle, fl_vl6180x_result_t *result)
+{
+  uint8_t     range_status = 0;
+  uint16_t    als = 0;
+  uint8_t     clear = FL_VL6180X_CLEAR_ERROR;
+  fl_status_t ret;
+
+  ret = fl_i2c_read_byte(handle->i2c, handle->dev_addr, FL_VL6180X_RESULT_INTERRUPT_STATUS_GPIO, &result->int_status);
+  if (ret != FL_OK)
+  {
+    return ret;
+  }
+
+  if (FL_VL6180X_INT_RANGE_READY(result->int_status))
+  {
+    if (((ret = fl_i2c_read_byte(handle->i2c, handle->dev_addr, FL_VL6180X_RESULT_RANGE_VAL, &result->range)) != FL_OK) ||
+        ((ret = fl_i2c_read_byte(handle->i2c, handle->dev_addr, FL_VL6180X_RESULT_RANGE_STATUS, &range_status)) != FL_OK))
+    {
+      return ret;
+    }
+    result->range_error = FL_VL6180X_RANGE_ERROR(range_status);
+    clear |= FL_VL6180X_CLEAR_RANGE;
+  }
+
+  if (FL_VL6180X_INT_ALS_READY(result->int_status))
+  {
+    if ((ret = fl_i2c_read_word(handle->i2c, handle->dev_addr, FL_VL6180X_RESULT_ALS_VAL, &als)) != FL_OK)
+    {
+      return ret;
+    }
+    result->als = als;
+    result->lux = fl_vl6180x_als_to_lux(handle, als);
+    clear |= FL_VL6180X_CLEAR_ALS;
+  }
+
+  // A single-shot measurement ends the mode.
+  if ((handle->mode == FL_VL6180X_MODE_SINGLE) &&
+      (FL_VL6180X_INT_RANGE_READY(result->int_status)))
+  {
+    handle->mode = FL_VL6180X_MODE_STOP;
+  }
+
+  return fl_i2c_write_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSTEM_INTERRUPT_CLEAR, clear);
+}
+
+// Continuous : 10 ~ 2550ms, interleaved : 150 ~ 2550ms(10ms resolution).
+FL_DECLARE(fl_status_t) fl_vl6180x_check_period(uint8_t mode, uint16_t period)
+{
+  switch (mode)
+  {
+  case FL_VL6180X_MODE_STOP:
+  case FL_VL6180X_MODE_SINGLE:
+    return FL_OK;
+
+  case FL_VL6180X_MODE_CONTINUOUS:
+    if ((period >= FL_VL6180X_PERIOD_UNIT) && (period <= FL_VL6180X_PERIOD_MAX))
+    {
+      return FL_OK;
+    }
+    break;
+
+  case FL_VL6180X_MODE_INTERLEAVED:
+    if ((period >= FL_VL6180X_INTERLEAVED_PERIOD_MIN) && (period <= FL_VL6180X_PERIOD_MAX))
+    {
+      return FL_OK;
+    }
+    break;
+  }
+
+  return FL_ERROR;
+}
+
+// Lux(Q16.16) of an ALS count with the ALS settings of the sensor, integer arithmetic only.
+FL_DECLARE(uint32_t) fl_vl6180x_als_to_lux(const fl_vl6180x_t *handle, uint16_t als)
+{
+  // 0.32 x als x 100 / (gain x int_time) = als x 3200 / (gain x 100 x int_time)
+  uint64_t lux = ((uint64_t)als * 3200) << FL_VL6180X_LUX_FRAC_BITS;
+
+  // ALS settings not read yet.
+  if (handle->als_int_time == 0)
+  {
+    return 0;
+  }
+
+  lux /= (uint32_t)_als_gains[handle->als_gain] * handle->als_int_time;
+
+  return (lux > FL_VL6180X_LUX_MAX) ? FL_VL6180X_LUX_MAX : (uint32_t)lux;
+}
+
+// 0 : not a VL6180X register.
+FL_DECLARE(uint8_t) fl_vl6180x_reg_size(uint16_t reg_addr)
+{
+  uint16_t low = 0;
+  uint16_t high = sizeof(_reg_infos) / sizeof(_reg_infos[0]);
+  uint16_t mid;
+
+  // Binary search(_reg_infos is in address order).
+  while (low < high)
+  {
+    mid = (low + high) / 2;
+    if (_reg_infos[mid].reg_addr == reg_addr)
+    {
+      return _reg_infos[mid].size;
+    }
+    else if (_reg_infos[mid].reg_addr < reg_addr)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+
+  return 0;
+}
+
+static fl_status_t write_settings(fl_vl6180x_t *handle, const fl_vl6180x_setting_t *settings, uint16_t count)
+{
+  fl_status_t ret;
+  uint16_t    i;
+
+  for (i = 0; i < count; i++)
+  {
+    ret = fl_i2c_write_byte(handle->i2c, handle->dev_addr, settings[i].reg_addr, settings[i].value);
+    if (ret != FL_OK)
+    {
+      return ret;
+    }
+  }
+
+  return FL_OK;
+}
+
+// Period(ms) checked by fl_vl6180x_check_period().
+static uint8_t get_period_reg(uint16_t period)
+{
+  return (uint8_t)((period / FL_VL6180X_PERIOD_UNIT) - 1);
+}
+
+static fl_status_t read_als_settings(fl_vl6180x_t *handle)
+{
+  uint8_t     gain = 0;
+  uint16_t    int_period = 0;
+  fl_status_t ret;
+
+  if (((ret = fl_i2c_read_byte(handle->i2c, handle->dev_addr, FL_VL6180X_SYSALS_ANALOGUE_GAIN, &gain)) != FL_OK) ||
+      ((ret = fl_i2c_read_word(handle->i2c, handle->dev_addr, FL_VL6180X_SYSALS_INTEGRATION_PERIOD, &int_period)) != FL_OK))
+  {
+    return ret;
+  }
+
+  handle->als_gain = gain & FL_VL6180X_ALS_GAIN_MASK;
+  handle->als_int_time = (int_period & FL_VL6180X_ALS_INTEGRATION_MASK) + 1;
+
+  return FL_OK;
+}
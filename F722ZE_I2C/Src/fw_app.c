@@ -1,252 +1,2045 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "i2c.h"
 #include "fw_app.h"
 
-typedef struct _vl6180x_addr_info
-{
-  uint16_t  addr;
-  uint16_t  reg_bytes;
-} vl6180x_addr_info_t;
-
 extern TIM_HandleTypeDef htim2;
 
 FL_DECLARE_DATA fw_app_t g_app;
 
-vl6180x_addr_info_t      g_addrs[] = {
-    {0x0000, 1},
-    {0x002E, 1},
-    {0x0031, 1},
-    {0x0038, 1},
-    {0x003A, 2},
-    {0x003C, 2},
-    {0x003E, 1},
-    {0x003F, 1},
-    {0x0040, 2},
-    {0x004D, 1},
-    {0x004E, 1},
-    {0x004F, 1},
-    {0x0050, 2},
-    {0x0062, 1},
-    {0x0066, 2},
-    {0x0068, 2},
-    {0x006C, 4},
-    {0x0070, 4},
-    {0x0074, 4},
-    {0x0078, 4},
-    {0x007C, 4},
-    {0x010A, 1},
-    {0x0119, 1},
-    {0x0120, 1},
-    {0x002D, 1},
-    {0x0212, 1},
-    {0x002C, 1},
-    {0x0025, 1},
-    {0x0001, 1},
-    {0x0002, 1},
-    {0x0003, 1},
-    {0x0004, 1},
-    {0x0006, 1},
-    {0x0007, 1},
-    {0x0008, 2},
-    {0x0010, 1},
-    {0x0011, 1},
-    {0x0012, 1},
-    {0x0014, 1},
-    {0x0015, 1},
-    {0x0016, 1},
-    {0x0017, 1},
-    {0x0018, 1},
-    {0x0019, 1},
-    {0x001A, 1},
-    {0x001B, 1},
-    {0x001C, 1},
-    {0x001E, 2},
-    {0x0021, 1},
-    {0x0022, 2},
-    {0x0024, 1},
-    {0x0026, 2},
-    {0x02A3, 1}
-};
+// Capture sample storage.
+static fl_capture_sample_t _capture_buf[FW_APP_CAPTURE_RING_SIZE];
 
 #if FW_APP_PARSER_CALLBACK == 1
 static void on_message_parsed(const void* parser_handle, void* context);
 #endif
 
-static uint16_t vl6180x_reg_byte_count(uint16_t reg_addr);
+static fl_status_t capture_control(fw_app_t* app, fl_capture_ctrl_t* cap_ctrl);
+static void capture_build_batch(fw_app_t* app, fl_capture_read_t* cap_read);
+static void proto_transmit(fw_app_proto_manager_t* proto_mgr, uint8_t* buf, uint16_t length);
+static void proto_send_response(fw_app_t* app);
+static fl_status_t bcast_slot_delay(fw_app_t* app, uint32_t* delay);
+static uint8_t* proto_alloc_event(fw_app_t* app);
+static void proto_queue_event(fw_app_t* app, uint16_t length);
+static void proto_send_event(fw_app_t* app);
+static void build_result_response(fw_app_t* app, uint8_t msg_id, fl_status_t result);
+
+// Scheduler event/timer handlers.
+static void on_rx_event(uint32_t param, void* context);
+static void on_tx_done_event(uint32_t param, void* context);
+static void on_led_timer(uint32_t param, void* context);
+static void on_bcast_tx_timer(uint32_t param, void* context);
+static void on_i2c_done_event(uint32_t param, void* context);
+static void on_i2c_start_failed(uint32_t param, void* context);
+static void on_i2c_timeout(uint32_t param, void* context);
+static void on_capture_timer(uint32_t param, void* context);
+static void on_capture_watermark(uint32_t param, void* context);
+static void resume_rx(fw_app_t* app);
+static void capture_push(fw_app_t* app, fl_capture_sample_t* sample);
+static uint8_t sensor_next(fw_app_t* app, uint8_t index);
+static void sensor_init(fw_app_sensor_t* sensor, GPIO_TypeDef* ce_port, uint16_t ce_pin, uint8_t i2c_num);
+static void sensor_standby(fw_app_t* app);
+static void sensor_identify(fw_app_t* app, uint8_t index);
+static void on_boot_timer(uint32_t param, void* context);
+static void boot_done(fw_app_t* app);
+static fl_status_t range_control(fw_app_t* app, fl_range_ctrl_t* range_ctrl);
+static void range_result_done(fw_app_t* app, uint8_t index);
+static void on_range_poll_timer(uint32_t param, void* context);
+
+// I2C bus transfer queues.
+static void i2c_bus_init(fw_app_i2c_bus_t* bus, uint8_t index, I2C_HandleTypeDef* hi2c,
+                         GPIO_TypeDef* scl_port, uint16_t scl_pin, GPIO_TypeDef* sda_port, uint16_t sda_pin);
+static fl_status_t i2c_bus_submit(fw_app_t* app, fw_app_i2c_bus_t* bus, const fw_app_i2c_xfer_t* xfer);
+static fl_status_t i2c_bus_submit_next(fw_app_t* app, fw_app_i2c_bus_t* bus, const fw_app_i2c_xfer_t* xfer);
+static void i2c_bus_start(fw_app_t* app, fw_app_i2c_bus_t* bus);
+static void i2c_bus_finish(fw_app_t* app, fw_app_i2c_bus_t* bus, fl_status_t status);
+static void on_rwi2c_xfer_done(fw_app_t* app, const fw_app_i2c_xfer_t* xfer);
+static void on_wbits_read_done(fw_app_t* app, const fw_app_i2c_xfer_t* xfer);
+static void on_capture_xfer_done(fw_app_t* app, const fw_app_i2c_xfer_t* xfer);
+static void capture_queue(fw_app_t* app, uint8_t i2c_num, fw_app_i2c_xfer_t* xfer);
+static void capture_queue_results(fw_app_t* app, uint8_t i2c_num, uint8_t dev_addr);
+static void range_ctrl_resume(fw_app_t* app);
+static void range_queue(fw_app_t* app, uint8_t index, fw_app_i2c_xfer_t* xfer);
+static void on_range_xfer_done(fw_app_t* app, const fw_app_i2c_xfer_t* xfer);
+static uint8_t sensor_find(fw_app_t* app, uint8_t dev_addr);
+#if defined(FL_ENABLE_PERF)
+static void on_parse_started(const void* parser_handle);
+static void on_parse_ended(const void* parser_handle);
+static void perf_build_stat(fw_app_t* app, fl_perf_read_t* perf_read);
+#endif
+
+// Command handlers.
+static void cmd_read_hw_version(const void* parser_handle, void* context);
+static void cmd_read_fw_version(const void* parser_handle, void* context);
+static fl_bool_t decode_read_write_i2c(const fl_txt_msg_cmd_def_t* cmd, void* payload, uint8_t arg_index, const char* arg);
+static void cmd_read_write_i2c(const void* parser_handle, void* context);
+static void build_read_write_i2c_response(fw_app_t* app, fl_status_t status, uint32_t data);
+static void rwi2c_finish(fw_app_t* app, fl_status_t status, uint32_t data);
+static fl_bool_t decode_read_burst(const fl_txt_msg_cmd_def_t* cmd, void* payload, uint8_t arg_index, const char* arg);
+static void cmd_read_burst(const void* parser_handle, void* context);
+static void build_read_burst_response(fw_app_t* app, fl_status_t status);
+static void cmd_update_bits(const void* parser_handle, void* context);
+static void build_update_bits_response(fw_app_t* app, fl_status_t status, uint32_t data);
+static uint32_t update_bits(const fw_app_i2c_request_t* i2c_req, uint32_t data);
+static void cmd_capture_control(const void* parser_handle, void* context);
+static void cmd_read_capture(const void* parser_handle, void* context);
+static void cmd_read_perf(const void* parser_handle, void* context);
+static void cmd_write_i2c_speed(const void* parser_handle, void* context);
+static void cmd_read_sensors(const void* parser_handle, void* context);
+static void cmd_write_ranging(const void* parser_handle, void* context);
+static void cmd_write_config(const void* parser_handle, void* context);
+static void cmd_read_config(const void* parser_handle, void* context);
+static fl_bool_t decode_write_profile(const fl_txt_msg_cmd_def_t* cmd, void* payload, uint8_t arg_index, const char* arg);
+static void cmd_write_profile(const void* parser_handle, void* context);
+
+// Command argument schemas.
+static const fl_txt_msg_arg_def_t _rwi2c_args[] = {
+    FL_TXT_MSG_ARG(fl_i2c_write_t, rw_mode),
+    FL_TXT_MSG_ARG(fl_i2c_write_t, i2c_num),
+    FL_TXT_MSG_ARG(fl_i2c_write_t, dev_addr),
+    FL_TXT_MSG_ARG(fl_i2c_write_t, reg_addr),
+    FL_TXT_MSG_ARG(fl_i2c_write_t, reg_value)   // Write mode only
+};
+
+static const fl_txt_msg_arg_def_t _rburs_args[] = {
+    FL_TXT_MSG_ARG(fl_i2c_burst_t, i2c_num),
+    FL_TXT_MSG_ARG(fl_i2c_burst_t, dev_addr),
+    FL_TXT_MSG_ARG(fl_i2c_burst_t, reg_addr),
+    FL_TXT_MSG_ARG(fl_i2c_burst_t, count)
+};
+
+static const fl_txt_msg_arg_def_t _wbits_args[] = {
+    FL_TXT_MSG_ARG(fl_i2c_update_t, i2c_num),
+    FL_TXT_MSG_ARG(fl_i2c_update_t, dev_addr),
+    FL_TXT_MSG_ARG(fl_i2c_update_t, reg_addr),
+    FL_TXT_MSG_ARG(fl_i2c_update_t, mask),
+    FL_TXT_MSG_ARG(fl_i2c_update_t, value)
+};
+
+static const fl_txt_msg_arg_def_t _wcapt_args[] = {
+    FL_TXT_MSG_ARG(fl_capture_ctrl_t, start),
+    FL_TXT_MSG_ARG(fl_capture_ctrl_t, i2c_num),
+    FL_TXT_MSG_ARG(fl_capture_ctrl_t, dev_addr),
+    FL_TXT_MSG_ARG(fl_capture_ctrl_t, period),
+    FL_TXT_MSG_ARG(fl_capture_ctrl_t, watermark)
+};
+
+static const fl_txt_msg_arg_def_t _rcapt_args[] = {
+    FL_TXT_MSG_ARG(fl_capture_read_t, max_count)
+};
+
+static const fl_txt_msg_arg_def_t _rperf_args[] = {
+    FL_TXT_MSG_ARG(fl_perf_read_t, stage),
+    FL_TXT_MSG_ARG(fl_perf_read_t, clear)
+};
+
+static const fl_txt_msg_arg_def_t _wi2cs_args[] = {
+    FL_TXT_MSG_ARG(fl_i2c_speed_t, i2c_num),
+    FL_TXT_MSG_ARG(fl_i2c_speed_t, speed)
+};
+
+static const fl_txt_msg_arg_def_t _rsens_args[] = {
+    FL_TXT_MSG_ARG(fl_sensor_read_t, enumerate)
+};
+
+static const fl_txt_msg_arg_def_t _wrang_args[] = {
+    FL_TXT_MSG_ARG(fl_range_ctrl_t, sensor),
+    FL_TXT_MSG_ARG(fl_range_ctrl_t, mode),
+    FL_TXT_MSG_ARG(fl_range_ctrl_t, period)     // Continuous and interleaved modes only
+};
+
+static const fl_txt_msg_arg_def_t _wconf_args[] = {
+    FL_TXT_MSG_ARG(fl_config_write_t, item),
+    FL_TXT_MSG_ARG(fl_config_write_t, value)
+};
+
+static const fl_txt_msg_arg_def_t _rconf_args[] = {
+    FL_TXT_MSG_ARG(fl_config_read_t, item)
+};
+
+// Add op arguments, decode_write_profile() for the other ops.
+static const fl_txt_msg_arg_def_t _wprof_args[] = {
+    FL_TXT_MSG_ARG(fl_profile_write_t, op),
+    FL_TXT_MSG_ARG(fl_profile_write_t, i2c_num),
+    FL_TXT_MSG_ARG(fl_profile_write_t, dev_addr),
+    FL_TXT_MSG_ARG(fl_profile_write_t, reg_addr),
+    FL_TXT_MSG_ARG(fl_profile_write_t, value)
+};
+
+// Command table(flash), indexed by message ID.
+// { args, min_arg_count, max_arg_count, decode, handler, flags }
+static const fl_txt_msg_cmd_def_t _cmd_table[FL_MSG_ID_COUNT] = {
+    [FL_MSG_ID_READ_HW_VERSION]   = { NULL, 0, 0, NULL, cmd_read_hw_version, FL_TXT_MSG_CMD_FLAG_BCAST },
+    [FL_MSG_ID_READ_FW_VERSION]   = { NULL, 0, 0, NULL, cmd_read_fw_version, FL_TXT_MSG_CMD_FLAG_BCAST },
+    [FL_MSG_ID_READ_WRITE_I2C]    = { _rwi2c_args, 4, 5, decode_read_write_i2c, cmd_read_write_i2c, FL_TXT_MSG_CMD_FLAG_BCAST | FL_TXT_MSG_CMD_FLAG_I2C },
+    [FL_MSG_ID_CAPTURE_CONTROL]   = { _wcapt_args, 5, 5, NULL, cmd_capture_control, FL_TXT_MSG_CMD_FLAG_BCAST | FL_TXT_MSG_CMD_FLAG_I2C },
+    [FL_MSG_ID_READ_CAPTURE]      = { _rcapt_args, 1, 1, NULL, cmd_read_capture, 0 },
+    [FL_MSG_ID_READ_PERF]         = { _rperf_args, 2, 2, NULL, cmd_read_perf, 0 },
+    [FL_MSG_ID_WRITE_I2C_SPEED]   = { _wi2cs_args, 2, 2, NULL, cmd_write_i2c_speed, FL_TXT_MSG_CMD_FLAG_BCAST | FL_TXT_MSG_CMD_FLAG_I2C },
+    [FL_MSG_ID_READ_SENSORS]      = { _rsens_args, 1, 1, NULL, cmd_read_sensors, FL_TXT_MSG_CMD_FLAG_BCAST | FL_TXT_MSG_CMD_FLAG_I2C },
+    [FL_MSG_ID_WRITE_RANGING]     = { _wrang_args, 2, 3, NULL, cmd_write_ranging, FL_TXT_MSG_CMD_FLAG_BCAST | FL_TXT_MSG_CMD_FLAG_I2C },
+    [FL_MSG_ID_WRITE_CONFIG]      = { _wconf_args, 2, 2, NULL, cmd_write_config, 0 },
+    [FL_MSG_ID_READ_CONFIG]       = { _rconf_args, 1, 1, NULL, cmd_read_config, 0 },
+    [FL_MSG_ID_WRITE_PROFILE]     = { _wprof_args, 1, 5, decode_write_profile, cmd_write_profile, FL_TXT_MSG_CMD_FLAG_BCAST },
+    [FL_MSG_ID_READ_BURST]        = { _rburs_args, 4, 4, decode_read_burst, cmd_read_burst, FL_TXT_MSG_CMD_FLAG_I2C },
+    [FL_MSG_ID_UPDATE_BITS]       = { _wbits_args, 5, 5, NULL, cmd_update_bits, FL_TXT_MSG_CMD_FLAG_I2C },
+};
 
 FL_DECLARE(void) fw_app_init(void)
 {
   memset(&g_app, 0, sizeof(g_app));
 
+#if defined(FL_ENABLE_PERF)
+  // First code of main() : the boot stages start at reset.
+  fl_perf_init();
+#endif
+  FL_PERF_BEGIN(FL_PERF_STAGE_BOOT_TO_RX);
+  FL_PERF_BEGIN(FL_PERF_STAGE_BOOT_TO_READY);
+
+  fl_sched_init(&g_app.sched);
+
   // Serial port for message communication.
   g_app.proto_mgr.uart_handle = &huart3;
   g_app.proto_mgr.parser_handle.on_parsed_callback = on_message_parsed;
   g_app.proto_mgr.parser_handle.context = (void*)&g_app;
+  g_app.proto_mgr.parser_handle.cmd_table = _cmd_table;
+  g_app.proto_mgr.parser_handle.cmd_count = FL_MSG_ID_COUNT;
+#if defined(FL_ENABLE_PERF)
+  g_app.proto_mgr.parser_handle.on_parse_started_callback = on_parse_started;
+  g_app.proto_mgr.parser_handle.on_parse_ended_callback = on_parse_ended;
+#endif
+
+  i2c_bus_init(&g_app.i2c_bus[0], 0, &hi2c1, GPIOB, GPIO_PIN_6, GPIOB, GPIO_PIN_9);
+  i2c_bus_init(&g_app.i2c_bus[1], 1, &hi2c2, GPIOF, GPIO_PIN_1, GPIOF, GPIO_PIN_0);
 
-  g_app.i2c.i2c = &hi2c1;
-  g_app.i2c.timeout = 1000;
+  // Sensors on I2C1.
+  sensor_init(&g_app.sensors[0], VL6180X_CE_GPIO_Port, VL6180X_CE_Pin, 1);
+  sensor_init(&g_app.sensors[1], VL6180X_CE2_GPIO_Port, VL6180X_CE2_Pin, 1);
+  sensor_init(&g_app.sensors[2], VL6180X_CE3_GPIO_Port, VL6180X_CE3_Pin, 1);
+
+  fl_ring_init(&g_app.capture.ring, _capture_buf, sizeof(fl_capture_sample_t), FW_APP_CAPTURE_RING_SIZE);
 }
 
 FL_DECLARE(void) fw_app_hw_init(void)
 {
-  // TODO : Device id setting(DIP switch, flash storage, ...).
-  g_app.device_id = 1;
+  // Device ID, baud rate and I2C bus speeds stored in flash.
+  fw_app_config_load();
 
   // GPIO output pin for debugging.
   HAL_GPIO_WritePin(DBG_OUT1_GPIO_Port, DBG_OUT1_Pin, GPIO_PIN_RESET);
   HAL_GPIO_WritePin(DBG_OUT2_GPIO_Port, DBG_OUT2_Pin, GPIO_PIN_RESET);
 
+  // LED1 toggle every 1 second.
+  fl_sched_timer_start(&g_app.sched, FW_APP_TIMER_LED, on_led_timer, 0, &g_app,
+                       FW_APP_ONE_SEC_INTERVAL, FW_APP_ONE_SEC_INTERVAL);
+
   // Message receive in interrupt mode.
   FW_APP_UART_RCV_IT(g_app.proto_mgr.uart_handle, g_app.proto_mgr.rx_buf, 1);
+  FL_PERF_END(FL_PERF_STAGE_BOOT_TO_RX);
 }
 
 FL_DECLARE(void) fw_app_systick(void)
 {
-  g_app.tick++;
-  // Do some work every 1 second.
-  if (g_app.tick >= FW_APP_ONE_SEC_INTERVAL)
+  fl_sched_tick(&g_app.sched);
+}
+
+// Main loop : dispatch timers and events, send log records, then sleep until the next interrupt.
+FL_DECLARE(void) fw_app_process(void)
+{
+  fl_sched_run(&g_app.sched);
+  FL_LOG_DRAIN();
+  fl_sched_idle(&g_app.sched);
+}
+
+// i2c_num : 1 ~ FW_APP_I2C_BUS_COUNT, NULL for an invalid bus number.
+FL_DECLARE(fw_app_i2c_bus_t*) fw_app_get_i2c_bus(uint8_t i2c_num)
+{
+  if ((i2c_num == 0) || (i2c_num > FW_APP_I2C_BUS_COUNT))
   {
-    // LED1 toggle.
-    HAL_GPIO_TogglePin(LD1_GPIO_Port, LD1_Pin);
-    g_app.tick = 0;
+    return NULL;
   }
+
+  return &g_app.i2c_bus[i2c_num - 1];
 }
 
-#if FW_APP_PARSER_CALLBACK == 1
-static void on_message_parsed(const void* parser_handle, void* context)
+// Enable the sensors one at a time, move each one from the default address to its own address
+// and write the sensor settings(fl_vl6180x_init()).
+// Blocking mode transfers : called from RSENS while no transfer is queued(the boot enumeration is
+// fw_app_boot_start()).
+// The sensors restart in the software standby, ranging modes are stopped.
+// The stored register init profiles are written after the sensors are at their own addresses.
+FL_DECLARE(uint8_t) fw_app_sensor_enum(void)
 {
-  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
-  fw_app_proto_manager_t* proto_mgr = &((fw_app_t*)context)->proto_mgr;
-//  fl_bool_t           cmd_processed = FL_FALSE;
-  fl_status_t         ret = FL_ERROR;
+  uint8_t i;
 
-  // Ignore the parsed message.
-  if (txt_parser->device_id != ((fw_app_t*)context)->device_id)
+  sensor_standby(&g_app);
+  HAL_Delay(FW_APP_SENSOR_STANDBY_TIME);
+
+  for (i = 0; i < FW_APP_SENSOR_COUNT; i++)
   {
-    return;
+    HAL_GPIO_WritePin(g_app.sensors[i].ce_port, g_app.sensors[i].ce_pin, GPIO_PIN_SET);
+    HAL_Delay(FW_APP_SENSOR_BOOT_TIME);
+    sensor_identify(&g_app, i);
   }
 
-  switch (txt_parser->msg_id)
-  {
-  case FL_MSG_ID_READ_HW_VERSION:
+  fw_app_config_apply_profiles();
+
+  return g_app.sensor_mask;
+}
+
+// Staged boot : the message receive is already running(fw_app_hw_init()), the sensors are
+// enumerated in scheduler timer steps(on_boot_timer()) instead of delays, then a ready event is sent.
+// Commands using the I2C buses are refused(FL_I2C_ERR_BUS) until the ready event.
+FL_DECLARE(void) fw_app_boot_start(void)
+{
+  sensor_standby(&g_app);
+  fl_sched_timer_start(&g_app.sched, FW_APP_TIMER_BOOT, on_boot_timer, FW_APP_SENSOR_COUNT, &g_app,
+                       FW_APP_SENSOR_STANDBY_TIME, 0);
+}
+
+FL_DECLARE(void) fw_app_uart_rx_complete(void)
+{
+  fw_app_proto_manager_t* proto_mgr = &g_app.proto_mgr;
+
+  fl_q_push(&proto_mgr->q, proto_mgr->rx_buf[0]);
+  if (proto_mgr->rx_buf[0] == FL_TXT_MSG_TAIL)
   {
-    proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %ld,%d,%d.%d.%d%c",
-        fl_txt_msg_get_message_name(txt_parser->msg_id),
-        txt_parser->device_id,
-        FL_OK,
-        FW_APP_HW_MAJOR, FW_APP_HW_MINOR, FW_APP_HW_REVISION,
-        FL_TXT_MSG_TAIL);
-    break;
+    FL_PERF_BEGIN(FL_PERF_STAGE_RX_TO_I2C);
   }
 
-  case FL_MSG_ID_READ_FW_VERSION:
+  // One RX event parses all received bytes.
+  if (proto_mgr->rx_evt_pending == FL_FALSE)
   {
-    proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %ld,%d,%d.%d.%d%c",
-        fl_txt_msg_get_message_name(txt_parser->msg_id),
-        txt_parser->device_id,
-        FL_OK,
-        FW_APP_FW_MAJOR, FW_APP_FW_MINOR, FW_APP_FW_REVISION,
-        FL_TXT_MSG_TAIL);
-    break;
+    proto_mgr->rx_evt_pending = FL_TRUE;
+    fl_sched_post(&g_app.sched, on_rx_event, 0, &g_app);
   }
+}
 
-  case FL_MSG_ID_READ_WRITE_I2C:
+FL_DECLARE(void) fw_app_uart_tx_complete(void)
+{
+  fl_sched_post(&g_app.sched, on_tx_done_event, 0, &g_app);
+}
+
+FL_DECLARE(void) fw_app_i2c_complete(I2C_HandleTypeDef* hi2c, fl_status_t status)
+{
+  fw_app_i2c_bus_t* bus;
+  uint8_t           i;
+
+  for (i = 0; i < FW_APP_I2C_BUS_COUNT; i++)
   {
-    // I2C read
-    if (txt_parser->arg_count == 4)
+    bus = &g_app.i2c_bus[i];
+    if (hi2c == bus->i2c.i2c)
     {
-      fl_i2c_read_t* i2c_read = (fl_i2c_read_t*)&(proto_mgr->parser_handle.payload);
-      uint32_t data = 0;
-      uint16_t byte_count = vl6180x_reg_byte_count(i2c_read->reg_addr);
-
-      if (byte_count == 1)
-      {
-        ret = fl_i2c_read_byte(&g_app.i2c, i2c_read->dev_addr, i2c_read->reg_addr, (uint8_t*)&data);
-      }
-      else if (byte_count == 2)
+      // The register address frame completed, the register bytes follow.
+      if ((status == FL_OK) && (fl_i2c_it_next(&bus->i2c, &status) == FL_TRUE))
       {
-        ret = fl_i2c_read_word(&g_app.i2c, i2c_read->dev_addr, i2c_read->reg_addr, (uint16_t*)&data);
-      }
-      else if (byte_count == 4)
-      {
-        ret = fl_i2c_read_dword(&g_app.i2c, i2c_read->dev_addr, i2c_read->reg_addr, &data);
+        return;
       }
 
-      if (ret == FL_OK)
+      if (status != FL_OK)
       {
-        proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %ld,%d,%d,%d,%d,%d,%ld%c",
-                fl_txt_msg_get_message_name(txt_parser->msg_id),
-                txt_parser->device_id,
-                FL_OK,
-                i2c_read->rw_mode,
-                i2c_read->i2c_num,
-                i2c_read->dev_addr,
-                i2c_read->reg_addr,
-                data,
-                FL_TXT_MSG_TAIL);
+        FL_LOG1(FL_LOG_I2C_ERROR, i + 1);
       }
+
+      // param : sequence(bit 16 ~ 23), bus index(bit 8 ~ 15), status(bit 0 ~ 7).
+      fl_sched_post(&g_app.sched, on_i2c_done_event,
+                    ((uint32_t)bus->seq << 16) | ((uint32_t)i << 8) | status, &g_app);
+      return;
     }
-    // I2C write
-    else if (txt_parser->arg_count == 5)
-    {
-      fl_i2c_write_t* i2c_wr = (fl_i2c_write_t*)&(proto_mgr->parser_handle.payload);
-      uint16_t byte_count = vl6180x_reg_byte_count(i2c_wr->reg_addr);
+  }
+}
 
-      if (byte_count == 1)
-      {
-        ret = fl_i2c_write_byte(&g_app.i2c, i2c_wr->dev_addr, i2c_wr->reg_addr, (uint8_t)i2c_wr->reg_value);
-      }
-      else if (byte_count == 2)
-      {
-        ret = fl_i2c_write_word(&g_app.i2c, i2c_wr->dev_addr, i2c_wr->reg_addr, (uint16_t)i2c_wr->reg_value);
-      }
-      else if (byte_count == 4)
-      {
-        ret = fl_i2c_write_dword(&g_app.i2c, i2c_wr->dev_addr, i2c_wr->reg_addr, i2c_wr->reg_value);
-      }
+#if FW_APP_PARSER_CALLBACK == 1
+static void on_message_parsed(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*        txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*                   app = (fw_app_t*)context;
+  fw_app_proto_manager_t*     proto_mgr = &app->proto_mgr;
+  const fl_txt_msg_cmd_def_t* cmd;
+  fl_bool_t                   is_broadcast = FL_FALSE;
 
-      if (ret == FL_OK)
-      {
-        proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %ld,%d%c",
-                          fl_txt_msg_get_message_name(txt_parser->msg_id),
-                          txt_parser->device_id,
-                          FL_OK,
-                          FL_TXT_MSG_TAIL);
-      }
-    }
+  if (txt_parser->device_id == FL_DEVICE_ID_ALL)
+  {
+    is_broadcast = FL_TRUE;
+    proto_mgr->bcast_rx_tick = fl_sched_get_tick(&app->sched);
+  }
+  else if (txt_parser->device_id != app->device_id)
+  {
+    // Ignore the parsed message.
+    return;
+  }
 
-    if (proto_mgr->out_length == 0)
-    {
-      proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %ld,%d%c",
-                fl_txt_msg_get_message_name(txt_parser->msg_id),
-                txt_parser->device_id,
-                FL_ERROR,
-                FL_TXT_MSG_TAIL);
-    }
-    break;
+  // A new command cancels the broadcast response not sent yet.
+  fl_sched_timer_stop(&app->sched, FW_APP_TIMER_BCAST_TX);
+  proto_mgr->tx_pending = FL_FALSE;
+  proto_mgr->out_length = 0;
+
+  cmd = fl_txt_msg_parser_get_cmd(txt_parser, txt_parser->msg_id);
+  if ((cmd == NULL) || (cmd->handler == NULL))
+  {
+    // Not supported command.
+    return;
   }
+
+  if ((is_broadcast == FL_TRUE) &&
+      ((cmd->flags & FL_TXT_MSG_CMD_FLAG_BCAST) == 0))
+  {
+    // The response does not fit into a broadcast time slot.
+    return;
   }
 
-  if (proto_mgr->out_length > 0)
+  FL_PERF_BEGIN(FL_PERF_STAGE_HANDLER);
+
+  proto_mgr->is_broadcast = is_broadcast;
+  if (txt_parser->arg_count < cmd->min_arg_count)
   {
-    HAL_UART_Transmit(proto_mgr->uart_handle, proto_mgr->out_buf, proto_mgr->out_length, FW_APP_PROTO_TX_TIMEOUT);
+    build_result_response(app, txt_parser->msg_id, FL_ERROR);
   }
-  proto_mgr->out_length = 0;
+  else if ((app->ready == FL_FALSE) &&
+           ((cmd->flags & FL_TXT_MSG_CMD_FLAG_I2C) != 0))
+  {
+    // The boot sensor enumeration owns the buses until the ready event(the host retries).
+    build_result_response(app, txt_parser->msg_id, FL_I2C_ERR_BUS);
+  }
+  else
+  {
+    cmd->handler(parser_handle, context);
+  }
+
+  // A handler waiting for an I2C transfer sends the response in on_i2c_done_event().
+  if (proto_mgr->cmd_pending == FL_FALSE)
+  {
+    proto_send_response(app);
+  }
+
+  FL_PERF_END(FL_PERF_STAGE_HANDLER);
 }
 #endif
 
-static uint16_t vl6180x_reg_byte_count(uint16_t reg_addr)
+static void proto_send_response(fw_app_t* app)
 {
-  int i = 0;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+  uint32_t                delay;
+  uint32_t                elapsed;
+
+  if (proto_mgr->out_length == 0)
+  {
+    return;
+  }
 
-  for (i = 0; i < sizeof(g_addrs)/sizeof(g_addrs[0]); i++)
+  if (proto_mgr->is_broadcast == FL_TRUE)
   {
-    if (g_addrs[i].addr == reg_addr)
+    // Every node answers a broadcast command in its own time slot(ordered by device ID),
+    // so responses do not collide on a multi-drop link.
+    if (bcast_slot_delay(app, &delay) != FL_OK)
+    {
+      FL_LOG1(FL_LOG_BCAST_NO_SLOT, app->device_id);
+      return;
+    }
+
+    // The slot is counted from the command receipt, not from the end of the handler.
+    elapsed = fl_sched_get_tick(&app->sched) - proto_mgr->bcast_rx_tick;
+    if (elapsed > (delay + FW_APP_BCAST_LATE_MAX))
     {
-      return g_addrs[i].reg_bytes;
+      // The slot of the next node has started.
+      FL_LOG2(FL_LOG_BCAST_LATE, app->device_id, elapsed - delay);
+      return;
     }
+    proto_mgr->tx_pending = FL_TRUE;
+    fl_sched_timer_start(&app->sched, FW_APP_TIMER_BCAST_TX, on_bcast_tx_timer, 0, app,
+                         (elapsed < delay) ? (delay - elapsed) : 0, 0);
+  }
+  else if (proto_mgr->tx_busy == FL_TRUE)
+  {
+    // An event is being sent(the response of an I2C transfer completed later).
+    proto_mgr->resp_pending = FL_TRUE;
+  }
+  else
+  {
+    proto_transmit(proto_mgr, proto_mgr->out_buf, proto_mgr->out_length);
+  }
+}
+
+// Delay(ms) of the broadcast response slot of this node(slot time : FW_APP_BCAST_SLOT_GUARD).
+// A device ID stored out of 1 ~ FW_APP_MAX_NODE_COUNT has no slot, the node does not answer broadcasts.
+static fl_status_t bcast_slot_delay(fw_app_t* app, uint32_t* delay)
+{
+  uint32_t baud_rate = app->proto_mgr.uart_handle->Init.BaudRate;
+  uint32_t slot_time;
+
+  if ((app->device_id == 0) || (app->device_id > FW_APP_MAX_NODE_COUNT) || (baud_rate == 0))
+  {
+    return FL_ERROR;
+  }
+
+  slot_time = (((FL_TXT_MSG_MAX_LENGTH * 10 * 1000) + baud_rate - 1) / baud_rate) + FW_APP_BCAST_SLOT_GUARD;
+
+  // Scheduler timer delays are below 2^31 ticks.
+  if ((app->device_id - 1) > (INT32_MAX / slot_time))
+  {
+    return FL_ERROR;
+  }
+
+  *delay = (app->device_id - 1) * slot_time;
+
+  return FL_OK;
+}
+
+// Buffer for a new event message, NULL if the event queue is full(the event is dropped).
+static uint8_t* proto_alloc_event(fw_app_t* app)
+{
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  if (proto_mgr->evt_count >= FW_APP_EVENT_QUEUE_SIZE)
+  {
+    FL_LOG0(FL_LOG_EVENT_QUEUE_FULL);
+    return NULL;
+  }
+
+  return proto_mgr->evt_buf[(proto_mgr->evt_head + proto_mgr->evt_count) % FW_APP_EVENT_QUEUE_SIZE];
+}
+
+// Queue the event message built in the buffer of proto_alloc_event().
+static void proto_queue_event(fw_app_t* app, uint16_t length)
+{
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  proto_mgr->evt_length[(proto_mgr->evt_head + proto_mgr->evt_count) % FW_APP_EVENT_QUEUE_SIZE] = (uint8_t)length;
+  proto_mgr->evt_count++;
+
+  proto_send_event(app);
+}
+
+// Send the head event message, it waits for the current transmit if any.
+// The event is removed from the queue when its transmit is done(on_tx_done_event()).
+static void proto_send_event(fw_app_t* app)
+{
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  if ((proto_mgr->evt_count == 0) ||
+      (proto_mgr->tx_busy == FL_TRUE))
+  {
+    return;
+  }
+
+  proto_transmit(proto_mgr, proto_mgr->evt_buf[proto_mgr->evt_head], proto_mgr->evt_length[proto_mgr->evt_head]);
+  if (proto_mgr->tx_busy == FL_TRUE)
+  {
+    proto_mgr->evt_sending = FL_TRUE;
+  }
+  else
+  {
+    // Transmit error, the event is dropped.
+    proto_mgr->evt_head = (proto_mgr->evt_head + 1) % FW_APP_EVENT_QUEUE_SIZE;
+    proto_mgr->evt_count--;
+  }
+}
+
+static void build_result_response(fw_app_t* app, uint8_t msg_id, fl_status_t result)
+{
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %lu,%d%c",
+            fl_txt_msg_get_message_name(msg_id),
+            app->device_id,
+            result,
+            FL_TXT_MSG_TAIL);
+}
+
+static void cmd_read_hw_version(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %lu,%d,%d.%d.%d%c",
+      fl_txt_msg_get_message_name(txt_parser->msg_id),
+      app->device_id,
+      FL_OK,
+      FW_APP_HW_MAJOR, FW_APP_HW_MINOR, FW_APP_HW_REVISION,
+      FL_TXT_MSG_TAIL);
+}
+
+static void cmd_read_fw_version(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %lu,%d,%d.%d.%d%c",
+      fl_txt_msg_get_message_name(txt_parser->msg_id),
+      app->device_id,
+      FL_OK,
+      FW_APP_FW_MAJOR, FW_APP_FW_MINOR, FW_APP_FW_REVISION,
+      FL_TXT_MSG_TAIL);
+}
+
+// Register value argument is valid only for the write mode.
+static fl_bool_t decode_read_write_i2c(const fl_txt_msg_cmd_def_t* cmd, void* payload, uint8_t arg_index, const char* arg)
+{
+  if ((arg_index == 4) &&
+      (((fl_i2c_write_t*)payload)->rw_mode != FL_MSG_I2C_WRITE))
+  {
+    return FL_FALSE;
+  }
+
+  return fl_txt_msg_decode_arg(cmd, payload, arg_index, arg);
+}
+
+static void cmd_read_write_i2c(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_i2c_request_t*   i2c_req = &app->i2c_req;
+  fw_app_i2c_bus_t*       bus;
+  fl_status_t             ret = FL_ERROR;
+  fw_app_i2c_xfer_t       xfer;
+
+  // The request is kept until the transfer completes, the parser payload is reused for the next message.
+  i2c_req->msg_id = txt_parser->msg_id;
+  i2c_req->arg_count = txt_parser->arg_count;
+  memcpy(&i2c_req->i2c_wr, &(txt_parser->payload), sizeof(fl_i2c_write_t));
+  i2c_req->byte_count = fl_vl6180x_reg_size(i2c_req->i2c_wr.reg_addr);
+  i2c_req->data = 0;
+  bus = fw_app_get_i2c_bus(i2c_req->i2c_wr.i2c_num);
+
+  if ((bus != NULL) &&
+      (i2c_req->byte_count > 0) &&
+      ((i2c_req->arg_count == 4) || (i2c_req->arg_count == 5)))
+  {
+    FL_PERF_END(FL_PERF_STAGE_RX_TO_I2C);
+
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.write = (i2c_req->arg_count == 5) ? FL_TRUE : FL_FALSE;
+    xfer.dev_addr = (uint8_t)i2c_req->i2c_wr.dev_addr;
+    xfer.reg_addr = i2c_req->i2c_wr.reg_addr;
+    xfer.size = (uint8_t)i2c_req->byte_count;
+    xfer.data = i2c_req->i2c_wr.reg_value;
+    xfer.on_done = on_rwi2c_xfer_done;
+
+    // Waits for the transfers queued before(capture samples on the bus).
+    ret = i2c_bus_submit(app, bus, &xfer);
   }
 
-  return 0;
+  if (ret == FL_OK)
+  {
+    // The response is sent in rwi2c_finish().
+    app->proto_mgr.cmd_pending = FL_TRUE;
+    return;
+  }
+
+  build_result_response(app, i2c_req->msg_id, ret);
+}
+
+static void build_read_write_i2c_response(fw_app_t* app, fl_status_t status, uint32_t data)
+{
+  fw_app_i2c_request_t*   i2c_req = &app->i2c_req;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  if ((i2c_req->arg_count == 4) && (status == FL_OK))
+  {
+    proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %lu,%d,%d,%d,%d,%d,%lu%c",
+            fl_txt_msg_get_message_name(i2c_req->msg_id),
+            app->device_id,
+            FL_OK,
+            i2c_req->i2c_wr.rw_mode,
+            i2c_req->i2c_wr.i2c_num,
+            i2c_req->i2c_wr.dev_addr,
+            i2c_req->i2c_wr.reg_addr,
+            data,
+            FL_TXT_MSG_TAIL);
+    return;
+  }
+
+  build_result_response(app, i2c_req->msg_id, status);
+}
+
+// Send the response of the pending RWI2C, RBURS or WBITS command.
+static void rwi2c_finish(fw_app_t* app, fl_status_t status, uint32_t data)
+{
+  if (app->proto_mgr.cmd_pending == FL_FALSE)
+  {
+    return;
+  }
+
+  app->proto_mgr.cmd_pending = FL_FALSE;
+
+  if (app->i2c_req.msg_id == FL_MSG_ID_READ_BURST)
+  {
+    build_read_burst_response(app, status);
+  }
+  else if (app->i2c_req.msg_id == FL_MSG_ID_UPDATE_BITS)
+  {
+    build_update_bits_response(app, status, data);
+  }
+  else
+  {
+    build_read_write_i2c_response(app, status, data);
+  }
+  proto_send_response(app);
+  resume_rx(app);
+}
+
+// Consecutive registers in one I2C transfer(the sensor increments the register address),
+// the response is sent in rwi2c_finish() like a RWI2C read.
+// The count is checked before it is narrowed to its 8-bit field(257 would read 1 byte),
+// a count out of range is stored as 0 and refused by cmd_read_burst().
+static fl_bool_t decode_read_burst(const fl_txt_msg_cmd_def_t* cmd, void* payload, uint8_t arg_index, const char* arg)
+{
+  unsigned long count;
+
+  if (arg_index != 3)
+  {
+    return fl_txt_msg_decode_arg(cmd, payload, arg_index, arg);
+  }
+
+  count = strtoul(arg, NULL, 10);
+  ((fl_i2c_burst_t*)payload)->count = (count <= FL_MSG_I2C_MAX_BURST_LEN) ? (uint8_t)count : 0;
+
+  return FL_TRUE;
+}
+
+static void cmd_read_burst(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_i2c_request_t*   i2c_req = &app->i2c_req;
+  fl_i2c_burst_t*         burst = (fl_i2c_burst_t*)&(txt_parser->payload);
+  fw_app_i2c_bus_t*       bus = fw_app_get_i2c_bus(burst->i2c_num);
+  fl_status_t             ret = FL_ERROR;
+  fw_app_i2c_xfer_t       xfer;
+
+  i2c_req->msg_id = txt_parser->msg_id;
+  i2c_req->arg_count = txt_parser->arg_count;
+  memset(&i2c_req->i2c_wr, 0, sizeof(fl_i2c_write_t));
+  i2c_req->i2c_wr.i2c_num = burst->i2c_num;
+  i2c_req->i2c_wr.dev_addr = burst->dev_addr;
+  i2c_req->i2c_wr.reg_addr = burst->reg_addr;
+  i2c_req->byte_count = burst->count;
+  i2c_req->data = 0;
+
+  if ((bus != NULL) &&
+      (burst->count > 0) &&
+      (burst->count <= FL_MSG_I2C_MAX_BURST_LEN))
+  {
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.write = FL_FALSE;
+    xfer.dev_addr = (uint8_t)burst->dev_addr;
+    xfer.reg_addr = burst->reg_addr;
+    xfer.size = burst->count;
+    xfer.block = i2c_req->block;
+    xfer.on_done = on_rwi2c_xfer_done;
+
+    ret = i2c_bus_submit(app, bus, &xfer);
+  }
+
+  if (ret == FL_OK)
+  {
+    app->proto_mgr.cmd_pending = FL_TRUE;
+    return;
+  }
+
+  build_result_response(app, i2c_req->msg_id, ret);
 }
+
+static void build_read_burst_response(fw_app_t* app, fl_status_t status)
+{
+  fw_app_i2c_request_t*   i2c_req = &app->i2c_req;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  if (status != FL_OK)
+  {
+    build_result_response(app, i2c_req->msg_id, status);
+    return;
+  }
+
+  proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %lu,%d,%d,%d,%d,%d,",
+            fl_txt_msg_get_message_name(i2c_req->msg_id),
+            app->device_id,
+            FL_OK,
+            i2c_req->i2c_wr.i2c_num,
+            i2c_req->i2c_wr.dev_addr,
+            i2c_req->i2c_wr.reg_addr,
+            i2c_req->byte_count);
+  proto_mgr->out_length += fl_base64_encode((char*)&proto_mgr->out_buf[proto_mgr->out_length],
+                                            (const char*)i2c_req->block,
+                                            i2c_req->byte_count);
+  proto_mgr->out_buf[proto_mgr->out_length++] = FL_TXT_MSG_TAIL;
+}
+
+// Register read-modify-write on the device : the register is read, the masked bits are replaced and
+// the register is written back before any other transfer on the bus. The response carries the value written.
+static void cmd_update_bits(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_i2c_request_t*   i2c_req = &app->i2c_req;
+  fl_i2c_update_t*        update = (fl_i2c_update_t*)&(txt_parser->payload);
+  fw_app_i2c_bus_t*       bus = fw_app_get_i2c_bus(update->i2c_num);
+  fl_status_t             ret = FL_ERROR;
+  fw_app_i2c_xfer_t       xfer;
+
+  i2c_req->msg_id = txt_parser->msg_id;
+  i2c_req->arg_count = txt_parser->arg_count;
+  memset(&i2c_req->i2c_wr, 0, sizeof(fl_i2c_write_t));
+  i2c_req->i2c_wr.i2c_num = update->i2c_num;
+  i2c_req->i2c_wr.dev_addr = update->dev_addr;
+  i2c_req->i2c_wr.reg_addr = update->reg_addr;
+  i2c_req->i2c_wr.reg_value = update->value;
+  i2c_req->mask = update->mask;
+  i2c_req->byte_count = fl_vl6180x_reg_size(update->reg_addr);
+  i2c_req->data = 0;
+
+  // Bits out of the register are not updated.
+  if (i2c_req->byte_count < 4)
+  {
+    i2c_req->mask &= ((uint32_t)1 << (8 * i2c_req->byte_count)) - 1;
+  }
+
+  if ((bus != NULL) &&
+      (i2c_req->byte_count > 0))
+  {
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.write = FL_FALSE;
+    xfer.dev_addr = (uint8_t)i2c_req->i2c_wr.dev_addr;
+    xfer.reg_addr = i2c_req->i2c_wr.reg_addr;
+    xfer.size = (uint8_t)i2c_req->byte_count;
+    xfer.on_done = on_wbits_read_done;
+
+    ret = i2c_bus_submit(app, bus, &xfer);
+  }
+
+  if (ret == FL_OK)
+  {
+    app->proto_mgr.cmd_pending = FL_TRUE;
+    return;
+  }
+
+  build_result_response(app, i2c_req->msg_id, ret);
+}
+
+static void build_update_bits_response(fw_app_t* app, fl_status_t status, uint32_t data)
+{
+  fw_app_i2c_request_t*   i2c_req = &app->i2c_req;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  if (status != FL_OK)
+  {
+    build_result_response(app, i2c_req->msg_id, status);
+    return;
+  }
+
+  proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %lu,%d,%lu%c",
+            fl_txt_msg_get_message_name(i2c_req->msg_id),
+            app->device_id,
+            FL_OK,
+            data,
+            FL_TXT_MSG_TAIL);
+}
+
+// Register value with the masked bits of the request replaced.
+static uint32_t update_bits(const fw_app_i2c_request_t* i2c_req, uint32_t data)
+{
+  return (data & ~i2c_req->mask) | (i2c_req->i2c_wr.reg_value & i2c_req->mask);
+}
+
+static void cmd_capture_control(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+
+  build_result_response(app, txt_parser->msg_id,
+                        capture_control(app, (fl_capture_ctrl_t*)&(txt_parser->payload)));
+}
+
+static void cmd_read_capture(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+
+  capture_build_batch(app, (fl_capture_read_t*)&(txt_parser->payload));
+}
+
+static void cmd_read_perf(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+
+#if defined(FL_ENABLE_PERF)
+  fl_perf_read_t*         perf_read = (fl_perf_read_t*)&(txt_parser->payload);
+
+  if (perf_read->stage < FL_PERF_STAGE_COUNT)
+  {
+    perf_build_stat(app, perf_read);
+    return;
+  }
+#endif
+
+  build_result_response(app, txt_parser->msg_id, FL_ERROR);
+}
+
+// The peripheral is reinitialized between transfers.
+// A bus busy with queued capture transfers is reported as FL_I2C_ERR_BUS(the host retries).
+static void cmd_write_i2c_speed(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fl_i2c_speed_t*         i2c_speed = (fl_i2c_speed_t*)&(txt_parser->payload);
+  fw_app_i2c_bus_t*       bus = fw_app_get_i2c_bus(i2c_speed->i2c_num);
+  fl_status_t             ret = FL_ERROR;
+
+  if (bus != NULL)
+  {
+    if (bus->count > 0)
+    {
+      ret = FL_I2C_ERR_BUS;
+    }
+    else
+    {
+      ret = fl_i2c_set_speed(&bus->i2c, i2c_speed->speed);
+    }
+  }
+
+  build_result_response(app, txt_parser->msg_id, ret);
+}
+
+// Enumeration resets the sensors(hardware standby), the stored profiles configure them again.
+static void cmd_read_sensors(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+  fl_sensor_read_t*       sens_read = (fl_sensor_read_t*)&(txt_parser->payload);
+  uint8_t                 i;
+
+  if (sens_read->enumerate == FL_TRUE)
+  {
+    if (app->capture.started == FL_TRUE)
+    {
+      build_result_response(app, txt_parser->msg_id, FL_I2C_ERR_BUS);
+      return;
+    }
+
+    // Capture transfers are done after a capture stop.
+    for (i = 0; i < FW_APP_I2C_BUS_COUNT; i++)
+    {
+      if (app->i2c_bus[i].count > 0)
+      {
+        build_result_response(app, txt_parser->msg_id, FL_I2C_ERR_BUS);
+        return;
+      }
+    }
+    fw_app_sensor_enum();
+  }
+
+  proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %lu,%d,%d",
+      fl_txt_msg_get_message_name(txt_parser->msg_id),
+      app->device_id,
+      FL_OK,
+      app->sensor_mask);
+  for (i = 0; i < FW_APP_SENSOR_COUNT; i++)
+  {
+    proto_mgr->out_length += sprintf((char*)&proto_mgr->out_buf[proto_mgr->out_length], ",%d",
+        app->sensors[i].vl6180x.dev_addr);
+  }
+  proto_mgr->out_buf[proto_mgr->out_length++] = FL_TXT_MSG_TAIL;
+}
+
+// Results are sent in range events(ERANG).
+static void cmd_write_ranging(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fl_range_ctrl_t*        range_ctrl = (fl_range_ctrl_t*)&(txt_parser->payload);
+  fw_app_i2c_bus_t*       bus;
+
+  if ((range_ctrl->sensor < FW_APP_SENSOR_COUNT) &&
+      (app->capture.started == FL_FALSE))
+  {
+    bus = fw_app_get_i2c_bus(app->sensors[range_ctrl->sensor].i2c_num);
+    if (bus->count > 0)
+    {
+      // The driver uses blocking mode transfers,
+      // the command waits for the result reads of the other sensors(range_ctrl_resume()).
+      memcpy(&app->range.ctrl, range_ctrl, sizeof(fl_range_ctrl_t));
+      app->range.ctrl_pending = FL_TRUE;
+      app->proto_mgr.cmd_pending = FL_TRUE;
+      fl_sched_timer_start(&app->sched, FW_APP_TIMER_RANGE_POLL, on_range_poll_timer, 0, app,
+                           FW_APP_RANGE_POLL_PERIOD, FW_APP_RANGE_POLL_PERIOD);
+      return;
+    }
+  }
+
+  build_result_response(app, txt_parser->msg_id, range_control(app, range_ctrl));
+}
+
+// The item is stored in flash and applied at the next boot.
+static void cmd_write_config(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fl_config_write_t*      conf_write = (fl_config_write_t*)&(txt_parser->payload);
+
+  build_result_response(app, txt_parser->msg_id, fw_app_config_write(conf_write->item, conf_write->value));
+}
+
+static void cmd_read_config(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+  fl_config_read_t*       conf_read = (fl_config_read_t*)&(txt_parser->payload);
+  uint32_t                value;
+  fl_status_t             ret;
+
+  ret = fw_app_config_read(conf_read->item, &value);
+
+  proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %lu,%d,%d,%lu%c",
+      fl_txt_msg_get_message_name(txt_parser->msg_id),
+      app->device_id,
+      ret,
+      conf_read->item,
+      value,
+      FL_TXT_MSG_TAIL);
+}
+
+// Begin : op,profile,name. Delete : op,profile. Add : the argument schema(_wprof_args).
+static fl_bool_t decode_write_profile(const fl_txt_msg_cmd_def_t* cmd, void* payload, uint8_t arg_index, const char* arg)
+{
+  fl_profile_write_t*     prof_wr = (fl_profile_write_t*)payload;
+
+  if ((arg_index == 0) || (prof_wr->op == FL_MSG_PROFILE_ADD))
+  {
+    return fl_txt_msg_decode_arg(cmd, payload, arg_index, arg);
+  }
+
+  if ((arg_index == 1) &&
+      ((prof_wr->op == FL_MSG_PROFILE_BEGIN) || (prof_wr->op == FL_MSG_PROFILE_DELETE)))
+  {
+    prof_wr->profile = (uint8_t)strtoul(arg, NULL, 10);
+    return FL_TRUE;
+  }
+
+  if ((arg_index == 2) &&
+      (prof_wr->op == FL_MSG_PROFILE_BEGIN) &&
+      (strlen(arg) < FL_MSG_PROFILE_NAME_LEN))
+  {
+    strcpy(prof_wr->name, arg);
+    return FL_TRUE;
+  }
+
+  return FL_FALSE;
+}
+
+// A saved profile is written after the next sensor enumeration(boot, RSENS).
+static void cmd_write_profile(const void* parser_handle, void* context)
+{
+  fl_txt_msg_parser_t*    txt_parser = (fl_txt_msg_parser_t*)parser_handle;
+  fw_app_t*               app = (fw_app_t*)context;
+  fl_profile_write_t*     prof_wr = (fl_profile_write_t*)&(txt_parser->payload);
+
+  build_result_response(app, txt_parser->msg_id, fw_app_config_profile(prof_wr, txt_parser->arg_count));
+}
+
+static fl_status_t capture_control(fw_app_t* app, fl_capture_ctrl_t* cap_ctrl)
+{
+  fw_app_capture_manager_t* capture = &app->capture;
+
+  if (cap_ctrl->start == FL_MSG_CAPTURE_STOP)
+  {
+    // Captured samples are kept for the host to read.
+    capture->started = FL_FALSE;
+    fl_sched_timer_stop(&app->sched, FW_APP_TIMER_CAPTURE);
+    return FL_OK;
+  }
+
+  if ((cap_ctrl->start != FL_MSG_CAPTURE_START) ||
+      (fw_app_get_i2c_bus(cap_ctrl->i2c_num) == NULL) ||
+      ((cap_ctrl->dev_addr == FL_MSG_CAPTURE_ALL_SENSORS) && (app->sensor_mask == 0)) ||
+      (cap_ctrl->period == 0) ||
+      (cap_ctrl->watermark > FW_APP_CAPTURE_RING_SIZE))
+  {
+    return FL_ERROR;
+  }
+
+  // Ranging modes read the same result registers.
+  if (app->range.active_mask != 0)
+  {
+    return FL_I2C_ERR_BUS;
+  }
+
+  capture->started = FL_FALSE;
+  fl_sched_timer_stop(&app->sched, FW_APP_TIMER_CAPTURE);
+
+  capture->i2c_num = cap_ctrl->i2c_num;
+  capture->dev_addr = cap_ctrl->dev_addr;
+  capture->period = cap_ctrl->period;
+  capture->watermark = cap_ctrl->watermark;
+  capture->event_sent = FL_FALSE;
+  capture->all_sensors = (cap_ctrl->dev_addr == FL_MSG_CAPTURE_ALL_SENSORS) ? FL_TRUE : FL_FALSE;
+  capture->ranging = FW_APP_SENSOR_COUNT;
+  fl_ring_clear(&capture->ring);
+
+  capture->started = FL_TRUE;
+  fl_sched_timer_start(&app->sched, FW_APP_TIMER_CAPTURE, on_capture_timer, 0, app,
+                       capture->period, capture->period);
+
+  return FL_OK;
+}
+
+// Queue the transfers of a sample, the sample is stored when the last transfer is done.
+// Single sensor : read the latest results(continuous mode is configured by the host).
+// All sensors : read the sensor started in the last period, then start the next one,
+//               one sensor emits at a time and the sample rate is shared by the sensors.
+static void on_capture_timer(uint32_t param, void* context)
+{
+  fw_app_t*                 app = (fw_app_t*)context;
+  fw_app_capture_manager_t* capture = &app->capture;
+  fw_app_sensor_t*          sensor;
+  fw_app_i2c_xfer_t         xfer;
+  uint8_t                   next;
+
+  // The previous sample is not done(the bus is slower than the sampling period), this sample is skipped.
+  if (capture->sampling == FL_TRUE)
+  {
+    return;
+  }
+
+  capture->sampling = FL_TRUE;
+  capture->sample_error = FL_FALSE;
+  capture->xfer_pending = 0;
+  capture->sample_sensor = FW_APP_SENSOR_COUNT;
+  capture->sample.timestamp = HAL_GetTick();
+
+  if (capture->all_sensors == FL_FALSE)
+  {
+    capture->sample_sensor = 0;
+    capture_queue_results(app, capture->i2c_num, capture->dev_addr);
+  }
+  else
+  {
+    if (capture->ranging < FW_APP_SENSOR_COUNT)
+    {
+      sensor = &app->sensors[capture->ranging];
+      capture->sample_sensor = capture->ranging;
+      capture_queue_results(app, sensor->i2c_num, sensor->vl6180x.dev_addr);
+    }
+
+    next = sensor_next(app, capture->ranging);
+    sensor = &app->sensors[next];
+
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.write = FL_TRUE;
+    xfer.dev_addr = sensor->vl6180x.dev_addr;
+    xfer.reg_addr = FL_VL6180X_SYSRANGE_START;
+    xfer.size = 1;
+    xfer.data = FL_VL6180X_START_SINGLE;
+    xfer.on_done = on_capture_xfer_done;
+    capture_queue(app, sensor->i2c_num, &xfer);
+
+    capture->ranging = next;
+  }
+
+  if (capture->xfer_pending == 0)
+  {
+    capture->sampling = FL_FALSE;
+  }
+}
+
+// A queue full drops the sample.
+static void capture_queue(fw_app_t* app, uint8_t i2c_num, fw_app_i2c_xfer_t* xfer)
+{
+  if (i2c_bus_submit(app, fw_app_get_i2c_bus(i2c_num), xfer) == FL_OK)
+  {
+    app->capture.xfer_pending++;
+  }
+  else
+  {
+    app->capture.sample_error = FL_TRUE;
+  }
+}
+
+static void capture_queue_results(fw_app_t* app, uint8_t i2c_num, uint8_t dev_addr)
+{
+  fw_app_i2c_xfer_t xfer;
+
+  memset(&xfer, 0, sizeof(xfer));
+  xfer.dev_addr = dev_addr;
+  xfer.on_done = on_capture_xfer_done;
+
+  xfer.reg_addr = FL_VL6180X_RESULT_RANGE_VAL;
+  xfer.size = 1;
+  capture_queue(app, i2c_num, &xfer);
+
+  xfer.reg_addr = FL_VL6180X_RESULT_RANGE_STATUS;
+  capture_queue(app, i2c_num, &xfer);
+
+  xfer.reg_addr = FL_VL6180X_RESULT_ALS_VAL;
+  xfer.size = 2;
+  capture_queue(app, i2c_num, &xfer);
+
+  // Clear range/ALS/error interrupts.
+  xfer.write = FL_TRUE;
+  xfer.reg_addr = FL_VL6180X_SYSTEM_INTERRUPT_CLEAR;
+  xfer.size = 1;
+  xfer.data = FL_VL6180X_CLEAR_ALL;
+  capture_queue(app, i2c_num, &xfer);
+}
+
+static void on_capture_xfer_done(fw_app_t* app, const fw_app_i2c_xfer_t* xfer)
+{
+  fw_app_capture_manager_t* capture = &app->capture;
+
+  switch (xfer->reg_addr)
+  {
+  case FL_VL6180X_RESULT_RANGE_VAL:
+    capture->sample.range = (uint8_t)xfer->data;
+    break;
+
+  case FL_VL6180X_RESULT_RANGE_STATUS:
+    // Error code : RESULT__RANGE_STATUS[7:4]
+    capture->sample.range_status = ((xfer->data >> 4) & FL_MSG_CAPTURE_ERROR_MASK) |
+                                   (capture->sample_sensor << FL_MSG_CAPTURE_SENSOR_SHIFT);
+    break;
+
+  case FL_VL6180X_RESULT_ALS_VAL:
+    capture->sample.als = (uint16_t)xfer->data;
+    break;
+  }
+
+  // A failed write(interrupt clear, range start) does not drop the sample.
+  if ((xfer->status != FL_OK) && (xfer->write == FL_FALSE))
+  {
+    capture->sample_error = FL_TRUE;
+  }
+
+  if (--capture->xfer_pending > 0)
+  {
+    return;
+  }
+
+  capture->sampling = FL_FALSE;
+  if ((capture->sample_error == FL_FALSE) &&
+      (capture->sample_sensor < FW_APP_SENSOR_COUNT) &&
+      (capture->started == FL_TRUE))
+  {
+    capture_push(app, &capture->sample);
+  }
+}
+
+// Store a sample and tell the host to drain samples at the watermark.
+static void capture_push(fw_app_t* app, fl_capture_sample_t* sample)
+{
+  fw_app_capture_manager_t* capture = &app->capture;
+  uint32_t                  count;
+
+  fl_ring_push(&capture->ring, sample);
+
+  // The event is sent by the protocol side.
+  count = fl_ring_count(&capture->ring);
+  if ((capture->watermark > 0) &&
+      (capture->event_sent == FL_FALSE) &&
+      (count >= capture->watermark))
+  {
+    capture->event_sent = FL_TRUE;
+    fl_sched_post(&app->sched, on_capture_watermark, count, app);
+  }
+}
+
+// Next sensor found after index(FW_APP_SENSOR_COUNT : the first sensor found).
+static uint8_t sensor_next(fw_app_t* app, uint8_t index)
+{
+  uint8_t i;
+
+  for (i = 1; i <= FW_APP_SENSOR_COUNT; i++)
+  {
+    index = (index + 1) % FW_APP_SENSOR_COUNT;
+    if (app->sensor_mask & (1 << index))
+    {
+      break;
+    }
+  }
+
+  return index;
+}
+
+static void sensor_init(fw_app_sensor_t* sensor, GPIO_TypeDef* ce_port, uint16_t ce_pin, uint8_t i2c_num)
+{
+  sensor->ce_port = ce_port;
+  sensor->ce_pin = ce_pin;
+  sensor->i2c_num = i2c_num;
+  sensor->vl6180x.i2c = &fw_app_get_i2c_bus(i2c_num)->i2c;
+  sensor->vl6180x.dev_addr = 0;
+  sensor->vl6180x.mode = FL_VL6180X_MODE_STOP;
+}
+
+// Hardware standby : every sensor releases the default address.
+static void sensor_standby(fw_app_t* app)
+{
+  fw_app_sensor_t*  sensor;
+  uint8_t           i;
+
+  app->sensor_mask = 0;
+  memset(&app->range, 0, sizeof(app->range));
+
+  for (i = 0; i < FW_APP_SENSOR_COUNT; i++)
+  {
+    sensor = &app->sensors[i];
+    sensor->vl6180x.dev_addr = 0;
+    HAL_GPIO_WritePin(sensor->ce_port, sensor->ce_pin, GPIO_PIN_RESET);
+  }
+}
+
+// Move a sensor out of the hardware standby(CE high for FW_APP_SENSOR_BOOT_TIME) to its own address.
+static void sensor_identify(fw_app_t* app, uint8_t index)
+{
+  fw_app_sensor_t*  sensor = &app->sensors[index];
+  fl_i2c_t*         i2c = sensor->vl6180x.i2c;
+  uint8_t           addr = FW_APP_SENSOR_BASE_ADDR + index;
+  uint8_t           model_id = 0;
+
+  if ((fl_i2c_read_byte(i2c, FW_APP_SENSOR_DEFAULT_ADDR << 1, FL_VL6180X_IDENTIFICATION_MODEL_ID, &model_id) == FL_OK) &&
+      (model_id == FL_VL6180X_MODEL_ID) &&
+      (fl_i2c_write_byte(i2c, FW_APP_SENSOR_DEFAULT_ADDR << 1, FL_VL6180X_I2C_SLAVE_DEVICE_ADDRESS, addr) == FL_OK))
+  {
+    sensor->vl6180x.dev_addr = addr << 1;
+  }
+
+  if ((sensor->vl6180x.dev_addr != 0) &&
+      (fl_vl6180x_init(&sensor->vl6180x) == FL_OK))
+  {
+    app->sensor_mask |= (1 << index);
+  }
+  else
+  {
+    // Kept in standby, the next sensor is the only one at the default address.
+    sensor->vl6180x.dev_addr = 0;
+    HAL_GPIO_WritePin(sensor->ce_port, sensor->ce_pin, GPIO_PIN_RESET);
+  }
+}
+
+// One sensor for each step, the main loop parses commands between the steps.
+// param : sensor powered up by the previous step, FW_APP_SENSOR_COUNT : standby time of all sensors.
+static void on_boot_timer(uint32_t param, void* context)
+{
+  fw_app_t* app = (fw_app_t*)context;
+  uint8_t   next = 0;
+
+  if (param < FW_APP_SENSOR_COUNT)
+  {
+    sensor_identify(app, (uint8_t)param);
+    next = (uint8_t)param + 1;
+  }
+
+  if (next < FW_APP_SENSOR_COUNT)
+  {
+    HAL_GPIO_WritePin(app->sensors[next].ce_port, app->sensors[next].ce_pin, GPIO_PIN_SET);
+    fl_sched_timer_start(&app->sched, FW_APP_TIMER_BOOT, on_boot_timer, next, app,
+                         FW_APP_SENSOR_BOOT_TIME, 0);
+    return;
+  }
+
+  boot_done(app);
+}
+
+// Write the stored profiles and report the sensors found(ready event).
+static void boot_done(fw_app_t* app)
+{
+  uint8_t*  buf;
+  fw_app_config_apply_profiles();
+
+  app->ready = FL_TRUE;
+  FL_PERF_END(FL_PERF_STAGE_BOOT_TO_READY);
+  FL_LOG2(FL_LOG_BOOT_READY, app->sensor_mask, fl_sched_get_tick(&app->sched));
+
+  if ((buf = proto_alloc_event(app)) != NULL)
+  {
+    proto_queue_event(app, sprintf((char*)buf, "%s %lu,%d,%lu%c",
+        fl_txt_msg_get_message_name(FL_MSG_ID_READY_EVENT),
+        app->device_id,
+        app->sensor_mask,
+        fl_sched_get_tick(&app->sched),
+        FL_TXT_MSG_TAIL));
+  }
+}
+
+// Start/stop a ranging mode of a sensor.
+// The bus of the sensor is idle for blocking mode transfers of the driver.
+static fl_status_t range_control(fw_app_t* app, fl_range_ctrl_t* range_ctrl)
+{
+  fw_app_range_manager_t* range = &app->range;
+  fw_app_sensor_t*        sensor;
+  fl_status_t             ret;
+
+  if ((range_ctrl->sensor >= FW_APP_SENSOR_COUNT) ||
+      ((app->sensor_mask & (1 << range_ctrl->sensor)) == 0) ||
+      (fl_vl6180x_check_period(range_ctrl->mode, range_ctrl->period) != FL_OK))
+  {
+    return FL_ERROR;
+  }
+
+  // Capture reads the same result registers.
+  if (app->capture.started == FL_TRUE)
+  {
+    return FL_I2C_ERR_BUS;
+  }
+
+  sensor = &app->sensors[range_ctrl->sensor];
+
+  ret = fl_vl6180x_start(&sensor->vl6180x, range_ctrl->mode, range_ctrl->period);
+
+  memset(&range->results[range_ctrl->sensor], 0, sizeof(fl_vl6180x_result_t));
+
+  if (sensor->vl6180x.mode == FL_VL6180X_MODE_STOP)
+  {
+    range->active_mask &= ~(1 << range_ctrl->sensor);
+  }
+  else
+  {
+    range->active_mask |= (1 << range_ctrl->sensor);
+    if (fl_sched_timer_is_active(&app->sched, FW_APP_TIMER_RANGE_POLL) == FL_FALSE)
+    {
+      fl_sched_timer_start(&app->sched, FW_APP_TIMER_RANGE_POLL, on_range_poll_timer, 0, app,
+                           FW_APP_RANGE_POLL_PERIOD, FW_APP_RANGE_POLL_PERIOD);
+    }
+  }
+
+  return ret;
+}
+
+// Queue the interrupt status read of each sensor, the results are read when a sample is ready.
+static void on_range_poll_timer(uint32_t param, void* context)
+{
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_range_manager_t* range = &app->range;
+  fw_app_sensor_t*        sensor;
+  uint8_t                 i;
+  fw_app_i2c_xfer_t       xfer;
+
+  // No new read while a WRANG command waits for the bus.
+  if (range->ctrl_pending == FL_TRUE)
+  {
+    range_ctrl_resume(app);
+    return;
+  }
+
+  if (range->active_mask == 0)
+  {
+    fl_sched_timer_stop(&app->sched, FW_APP_TIMER_RANGE_POLL);
+    return;
+  }
+
+  for (i = 0; i < FW_APP_SENSOR_COUNT; i++)
+  {
+    if ((range->active_mask & (1 << i)) == 0)
+    {
+      continue;
+    }
+
+    sensor = &app->sensors[i];
+
+    // The previous read is not done.
+    if (range->xfer_pending[i] > 0)
+    {
+      continue;
+    }
+
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.dev_addr = sensor->vl6180x.dev_addr;
+    xfer.reg_addr = FL_VL6180X_RESULT_INTERRUPT_STATUS_GPIO;
+    xfer.size = 1;
+    xfer.on_done = on_range_xfer_done;
+    range->read_error[i] = FL_FALSE;
+    range_queue(app, i, &xfer);
+  }
+}
+
+// Send the range event of a new range sample, a single-shot measurement ends the ranging mode.
+// Interleaved mode samples are sent in measurement events with the lux of the last ALS sample.
+static void range_result_done(fw_app_t* app, uint8_t index)
+{
+  fw_app_range_manager_t* range = &app->range;
+  fw_app_sensor_t*        sensor = &app->sensors[index];
+  fl_vl6180x_result_t*    result = &range->results[index];
+  uint8_t*                buf = proto_alloc_event(app);
+
+  if ((buf != NULL) && (sensor->vl6180x.mode == FL_VL6180X_MODE_INTERLEAVED))
+  {
+    proto_queue_event(app, sprintf((char*)buf, "%s %lu,%d,%d,%d,%lu%c",
+        fl_txt_msg_get_message_name(FL_MSG_ID_MEASUREMENT_EVENT),
+        app->device_id,
+        index,
+        result->range,
+        result->range_error,
+        (unsigned long)result->lux,
+        FL_TXT_MSG_TAIL));
+  }
+  else if (buf != NULL)
+  {
+    proto_queue_event(app, sprintf((char*)buf, "%s %lu,%d,%d,%d,%d%c",
+        fl_txt_msg_get_message_name(FL_MSG_ID_RANGE_EVENT),
+        app->device_id,
+        index,
+        result->range,
+        result->range_error,
+        result->als,
+        FL_TXT_MSG_TAIL));
+  }
+
+  // fl_vl6180x_read_result() ends a single-shot measurement in blocking mode.
+  if (sensor->vl6180x.mode == FL_VL6180X_MODE_SINGLE)
+  {
+    sensor->vl6180x.mode = FL_VL6180X_MODE_STOP;
+  }
+
+  if (sensor->vl6180x.mode == FL_VL6180X_MODE_STOP)
+  {
+    range->active_mask &= ~(1 << index);
+  }
+}
+
+// Send the response of the pending WRANG command when the bus of its sensor is idle.
+static void range_ctrl_resume(fw_app_t* app)
+{
+  fw_app_range_manager_t* range = &app->range;
+  fw_app_i2c_bus_t*       bus = fw_app_get_i2c_bus(app->sensors[range->ctrl.sensor].i2c_num);
+
+  if (bus->count > 0)
+  {
+    return;
+  }
+
+  range->ctrl_pending = FL_FALSE;
+  app->proto_mgr.cmd_pending = FL_FALSE;
+
+  build_result_response(app, FL_MSG_ID_WRITE_RANGING, range_control(app, &range->ctrl));
+  proto_send_response(app);
+  resume_rx(app);
+}
+
+// A queue full fails the read, the sample is read again at the next poll(the interrupt is not cleared).
+static void range_queue(fw_app_t* app, uint8_t index, fw_app_i2c_xfer_t* xfer)
+{
+  if (i2c_bus_submit(app, fw_app_get_i2c_bus(app->sensors[index].i2c_num), xfer) == FL_OK)
+  {
+    app->range.xfer_pending[index]++;
+  }
+  else
+  {
+    app->range.read_error[index] = FL_TRUE;
+  }
+}
+
+// The interrupt status read queues the reads of the new samples and the interrupt clear.
+static void on_range_xfer_done(fw_app_t* app, const fw_app_i2c_xfer_t* xfer)
+{
+  fw_app_range_manager_t* range = &app->range;
+  uint8_t                 index = sensor_find(app, xfer->dev_addr);
+  fl_vl6180x_result_t*    result;
+  fw_app_i2c_xfer_t       next;
+  uint8_t                 clear = FL_VL6180X_CLEAR_ERROR;
+
+  if (index >= FW_APP_SENSOR_COUNT)
+  {
+    return;
+  }
+
+  result = &range->results[index];
+
+  if (xfer->status != FL_OK)
+  {
+    range->read_error[index] = FL_TRUE;
+  }
+  else
+  {
+    switch (xfer->reg_addr)
+    {
+    case FL_VL6180X_RESULT_INTERRUPT_STATUS_GPIO:
+      result->int_status = (uint8_t)xfer->data;
+
+      memset(&next, 0, sizeof(next));
+      next.dev_addr = xfer->dev_addr;
+      next.size = 1;
+      next.on_done = on_range_xfer_done;
+
+      if (FL_VL6180X_INT_RANGE_READY(result->int_status))
+      {
+        next.reg_addr = FL_VL6180X_RESULT_RANGE_VAL;
+        range_queue(app, index, &next);
+        next.reg_addr = FL_VL6180X_RESULT_RANGE_STATUS;
+        range_queue(app, index, &next);
+        clear |= FL_VL6180X_CLEAR_RANGE;
+      }
+
+      if (FL_VL6180X_INT_ALS_READY(result->int_status))
+      {
+        next.reg_addr = FL_VL6180X_RESULT_ALS_VAL;
+        next.size = 2;
+        range_queue(app, index, &next);
+        clear |= FL_VL6180X_CLEAR_ALS;
+      }
+
+      if (clear != FL_VL6180X_CLEAR_ERROR)
+      {
+        next.write = FL_TRUE;
+        next.reg_addr = FL_VL6180X_SYSTEM_INTERRUPT_CLEAR;
+        next.size = 1;
+        next.data = clear;
+        range_queue(app, index, &next);
+      }
+      break;
+
+    case FL_VL6180X_RESULT_RANGE_VAL:
+      result->range = (uint8_t)xfer->data;
+      break;
+
+    case FL_VL6180X_RESULT_RANGE_STATUS:
+      result->range_error = FL_VL6180X_RANGE_ERROR(xfer->data);
+      break;
+
+    case FL_VL6180X_RESULT_ALS_VAL:
+      result->als = (uint16_t)xfer->data;
+      result->lux = fl_vl6180x_als_to_lux(&app->sensors[index].vl6180x, result->als);
+      break;
+    }
+  }
+
+  if (--range->xfer_pending[index] > 0)
+  {
+    return;
+  }
+
+  if ((range->read_error[index] == FL_FALSE) &&
+      (FL_VL6180X_INT_RANGE_READY(result->int_status)))
+  {
+    range_result_done(app, index);
+  }
+}
+
+// Sensor index of an address, FW_APP_SENSOR_COUNT : not found.
+static uint8_t sensor_find(fw_app_t* app, uint8_t dev_addr)
+{
+  uint8_t i;
+
+  for (i = 0; i < FW_APP_SENSOR_COUNT; i++)
+  {
+    if ((app->sensors[i].vl6180x.dev_addr == dev_addr) &&
+        (dev_addr != 0))
+    {
+      break;
+    }
+  }
+
+  return i;
+}
+
+// param : number of samples in the ring.
+static void on_capture_watermark(uint32_t param, void* context)
+{
+  fw_app_t* app = (fw_app_t*)context;
+  uint8_t*  buf = proto_alloc_event(app);
+
+  if (buf == NULL)
+  {
+    // Sent again at the next sample(event_sent).
+    app->capture.event_sent = FL_FALSE;
+    return;
+  }
+
+  proto_queue_event(app, sprintf((char*)buf, "%s %lu,%lu%c",
+      fl_txt_msg_get_message_name(FL_MSG_ID_CAPTURE_EVENT),
+      app->device_id,
+      param,
+      FL_TXT_MSG_TAIL));
+}
+
+static void capture_build_batch(fw_app_t* app, fl_capture_read_t* cap_read)
+{
+  fw_app_capture_manager_t* capture = &app->capture;
+  fw_app_proto_manager_t*   proto_mgr = &app->proto_mgr;
+  fl_capture_sample_t       samples[FW_APP_CAPTURE_BATCH_SIZE];
+  uint32_t                  max_count = cap_read->max_count;
+  uint32_t                  count;
+  uint32_t                  remaining;
+  uint32_t                  overrun;
+
+  if ((max_count == 0) || (max_count > FW_APP_CAPTURE_BATCH_SIZE))
+  {
+    max_count = FW_APP_CAPTURE_BATCH_SIZE;
+  }
+
+  count = fl_ring_pop_n(&capture->ring, samples, max_count);
+  remaining = fl_ring_count(&capture->ring);
+
+  // Dropped samples are reported once.
+  overrun = capture->ring.overrun;
+  capture->ring.overrun = 0;
+
+  // Re-arm the watermark event.
+  if (remaining < capture->watermark)
+  {
+    capture->event_sent = FL_FALSE;
+  }
+
+  proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %lu,%d,%lu,%lu,%lu",
+      fl_txt_msg_get_message_name(FL_MSG_ID_READ_CAPTURE),
+      app->device_id,
+      FL_OK,
+      remaining,
+      overrun,
+      count);
+
+  if (count > 0)
+  {
+    proto_mgr->out_buf[proto_mgr->out_length++] = FL_TXT_MSG_ARG_DELIMITER;
+    proto_mgr->out_length += fl_base64_encode((char*)&proto_mgr->out_buf[proto_mgr->out_length],
+                                              (const char*)samples,
+                                              count * sizeof(fl_capture_sample_t));
+  }
+
+  proto_mgr->out_buf[proto_mgr->out_length++] = FL_TXT_MSG_TAIL;
+}
+
+// The transmit completes in on_tx_done_event(), buf must not be changed until then.
+static void proto_transmit(fw_app_proto_manager_t* proto_mgr, uint8_t* buf, uint16_t length)
+{
+  FL_PERF_BEGIN(FL_PERF_STAGE_TX);
+  proto_mgr->tx_busy = FL_TRUE;
+  if (HAL_UART_Transmit_IT(proto_mgr->uart_handle, buf, length) != HAL_OK)
+  {
+    proto_mgr->tx_busy = FL_FALSE;
+  }
+}
+
+// Parse received bytes until a command has to wait for the UART or I2C.
+static void on_rx_event(uint32_t param, void* context)
+{
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+  uint8_t                 data;
+  fl_status_t             ret;
+
+  proto_mgr->rx_evt_pending = FL_FALSE;
+
+  while ((proto_mgr->tx_busy == FL_FALSE) &&
+         (proto_mgr->cmd_pending == FL_FALSE))
+  {
+    // Bytes are pushed from the UART interrupt(same critical section as the scheduler queue).
+    FL_SCHED_LOCK();
+    ret = fl_q_pop(&proto_mgr->q, &data);
+    FL_SCHED_UNLOCK();
+
+    if (ret != FL_OK)
+    {
+      break;
+    }
+
+    // A parsed message is handled in on_message_parsed().
+    fl_txt_msg_parser_parse_command(&proto_mgr->parser_handle, data, NULL);
+  }
+}
+
+// Continue parsing the bytes received while the UART or I2C was busy.
+static void resume_rx(fw_app_t* app)
+{
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  if ((fl_q_count(&proto_mgr->q) > 0) &&
+      (proto_mgr->rx_evt_pending == FL_FALSE))
+  {
+    proto_mgr->rx_evt_pending = FL_TRUE;
+    fl_sched_post(&app->sched, on_rx_event, 0, app);
+  }
+}
+
+static void on_tx_done_event(uint32_t param, void* context)
+{
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  FL_PERF_END(FL_PERF_STAGE_TX);
+  proto_mgr->tx_busy = FL_FALSE;
+
+  if (proto_mgr->evt_sending == FL_TRUE)
+  {
+    proto_mgr->evt_sending = FL_FALSE;
+    proto_mgr->evt_head = (proto_mgr->evt_head + 1) % FW_APP_EVENT_QUEUE_SIZE;
+    proto_mgr->evt_count--;
+  }
+
+  // A response goes before the queued events.
+  if (proto_mgr->resp_pending == FL_TRUE)
+  {
+    proto_mgr->resp_pending = FL_FALSE;
+    proto_transmit(proto_mgr, proto_mgr->out_buf, proto_mgr->out_length);
+  }
+  else
+  {
+    proto_send_event(app);
+  }
+
+  resume_rx(app);
+}
+
+// param : sequence(bit 16 ~ 23), bus index(bit 8 ~ 15), status(bit 0 ~ 7).
+static void on_i2c_done_event(uint32_t param, void* context)
+{
+  fw_app_t*         app = (fw_app_t*)context;
+  fw_app_i2c_bus_t* bus = &app->i2c_bus[(param >> 8) & 0xFF];
+  fl_status_t       status = (fl_status_t)(param & 0xFF);
+
+  // The transfer completed after the timeout.
+  if ((bus->active == FL_FALSE) ||
+      (((param >> 16) & 0xFF) != bus->seq))
+  {
+    return;
+  }
+
+  if (status == FL_ERROR)
+  {
+    // The HAL error callback reports FL_ERROR only.
+    status = fl_i2c_it_error(&bus->i2c);
+  }
+
+  i2c_bus_finish(app, bus, status);
+}
+
+// param : bus index.
+static void on_i2c_start_failed(uint32_t param, void* context)
+{
+  fw_app_t*         app = (fw_app_t*)context;
+  fw_app_i2c_bus_t* bus = &app->i2c_bus[param];
+
+  i2c_bus_finish(app, bus, bus->xfers[bus->head].status);
+}
+
+// param : bus index.
+static void on_i2c_timeout(uint32_t param, void* context)
+{
+  fw_app_t*         app = (fw_app_t*)context;
+  fw_app_i2c_bus_t* bus = &app->i2c_bus[param];
+
+  if (bus->active == FL_FALSE)
+  {
+    return;
+  }
+
+  FL_LOG2(FL_LOG_I2C_TIMEOUT, bus->index + 1, bus->xfers[bus->head].dev_addr);
+  fl_i2c_abort(&bus->i2c);
+  i2c_bus_finish(app, bus, FL_I2C_ERR_TIMEOUT);
+}
+
+static void on_rwi2c_xfer_done(fw_app_t* app, const fw_app_i2c_xfer_t* xfer)
+{
+  rwi2c_finish(app, xfer->status, xfer->data);
+}
+
+// Register read of a WBITS command, the write is queued first so that no other transfer runs in between.
+static void on_wbits_read_done(fw_app_t* app, const fw_app_i2c_xfer_t* xfer)
+{
+  fw_app_i2c_request_t* i2c_req = &app->i2c_req;
+  fw_app_i2c_xfer_t     write_xfer;
+  fl_status_t           ret = xfer->status;
+
+  if (ret == FL_OK)
+  {
+    memcpy(&write_xfer, xfer, sizeof(fw_app_i2c_xfer_t));
+    write_xfer.write = FL_TRUE;
+    write_xfer.data = update_bits(i2c_req, xfer->data);
+    write_xfer.on_done = on_rwi2c_xfer_done;
+
+    ret = i2c_bus_submit_next(app, fw_app_get_i2c_bus(i2c_req->i2c_wr.i2c_num), &write_xfer);
+  }
+
+  if (ret != FL_OK)
+  {
+    rwi2c_finish(app, ret, 0);
+  }
+}
+
+static void i2c_bus_init(fw_app_i2c_bus_t* bus, uint8_t index, I2C_HandleTypeDef* hi2c,
+                         GPIO_TypeDef* scl_port, uint16_t scl_pin, GPIO_TypeDef* sda_port, uint16_t sda_pin)
+{
+  fl_i2c_init(&bus->i2c);
+  bus->i2c.i2c = hi2c;
+  bus->i2c.scl_port = scl_port;
+  bus->i2c.scl_pin = scl_pin;
+  bus->i2c.sda_port = sda_port;
+  bus->i2c.sda_pin = sda_pin;
+  bus->i2c.rise_time = FW_APP_I2C_RISE_TIME;
+  bus->i2c.fall_time = FW_APP_I2C_FALL_TIME;
+  bus->index = index;
+}
+
+// The done callback is always called from the scheduler(never from i2c_bus_submit()).
+static fl_status_t i2c_bus_submit(fw_app_t* app, fw_app_i2c_bus_t* bus, const fw_app_i2c_xfer_t* xfer)
+{
+  if (bus->count >= FW_APP_I2C_QUEUE_SIZE)
+  {
+    return FL_ERROR;
+  }
+
+  memcpy(&bus->xfers[(bus->head + bus->count) % FW_APP_I2C_QUEUE_SIZE], xfer, sizeof(fw_app_i2c_xfer_t));
+  bus->count++;
+
+  i2c_bus_start(app, bus);
+
+  return FL_OK;
+}
+
+// Queue the transfer before the other queued transfers(next transfer of a sequence started by a done callback).
+static fl_status_t i2c_bus_submit_next(fw_app_t* app, fw_app_i2c_bus_t* bus, const fw_app_i2c_xfer_t* xfer)
+{
+  if ((bus->active == FL_TRUE) || (bus->count >= FW_APP_I2C_QUEUE_SIZE))
+  {
+    return FL_ERROR;
+  }
+
+  bus->head = (bus->head + FW_APP_I2C_QUEUE_SIZE - 1) % FW_APP_I2C_QUEUE_SIZE;
+  memcpy(&bus->xfers[bus->head], xfer, sizeof(fw_app_i2c_xfer_t));
+  bus->count++;
+
+  i2c_bus_start(app, bus);
+
+  return FL_OK;
+}
+
+// Start the head transfer if the bus is idle.
+static void i2c_bus_start(fw_app_t* app, fw_app_i2c_bus_t* bus)
+{
+  fw_app_i2c_xfer_t*  xfer = &bus->xfers[bus->head];
+
+  if ((bus->active == FL_TRUE) || (bus->count == 0))
+  {
+    return;
+  }
+
+  bus->active = FL_TRUE;
+  bus->seq++;
+
+  if (xfer->write == FL_TRUE)
+  {
+    xfer->status = fl_i2c_write_it(&bus->i2c, xfer->dev_addr, xfer->reg_addr, xfer->data, xfer->size);
+  }
+  else if (xfer->block != NULL)
+  {
+    xfer->status = fl_i2c_read_block_it(&bus->i2c, xfer->dev_addr, xfer->reg_addr, xfer->block, xfer->size);
+  }
+  else
+  {
+    xfer->status = fl_i2c_read_it(&bus->i2c, xfer->dev_addr, xfer->reg_addr, xfer->size);
+  }
+
+  if (xfer->status != FL_OK)
+  {
+    fl_sched_post(&app->sched, on_i2c_start_failed, bus->index, app);
+    return;
+  }
+
+  fl_sched_timer_start(&app->sched, FW_APP_TIMER_I2C_TIMEOUT + bus->index, on_i2c_timeout, bus->index, app,
+                       fl_i2c_timeout(&bus->i2c, xfer->size), 0);
+}
+
+// Remove the head transfer, call its done callback and start the next transfer.
+static void i2c_bus_finish(fw_app_t* app, fw_app_i2c_bus_t* bus, fl_status_t status)
+{
+  fw_app_i2c_xfer_t xfer;
+  uint32_t          data;
+
+  fl_sched_timer_stop(&app->sched, FW_APP_TIMER_I2C_TIMEOUT + bus->index);
+
+  memcpy(&xfer, &bus->xfers[bus->head], sizeof(fw_app_i2c_xfer_t));
+  xfer.status = status;
+  if (status == FL_OK)
+  {
+    data = fl_i2c_it_complete(&bus->i2c);
+    if (xfer.write == FL_FALSE)
+    {
+      xfer.data = data;
+    }
+  }
+
+  bus->head = (bus->head + 1) % FW_APP_I2C_QUEUE_SIZE;
+  bus->count--;
+  bus->active = FL_FALSE;
+
+  if (xfer.on_done != NULL)
+  {
+    xfer.on_done(app, &xfer);
+  }
+
+  i2c_bus_start(app, bus);
+}
+
+static void on_led_timer(uint32_t param, void* context)
+{
+  // LED1 toggle.
+  HAL_GPIO_TogglePin(LD1_GPIO_Port, LD1_Pin);
+}
+
+static void on_bcast_tx_timer(uint32_t param, void* context)
+{
+  fw_app_t*               app = (fw_app_t*)context;
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+
+  if (proto_mgr->tx_pending == FL_FALSE)
+  {
+    return;
+  }
+
+  // Wait for the event being sent.
+  if (proto_mgr->tx_busy == FL_TRUE)
+  {
+    fl_sched_timer_start(&app->sched, FW_APP_TIMER_BCAST_TX, on_bcast_tx_timer, 0, app, 1, 0);
+    return;
+  }
+
+  proto_mgr->tx_pending = FL_FALSE;
+  proto_transmit(proto_mgr, proto_mgr->out_buf, proto_mgr->out_length);
+}
+
+#if defined(FL_ENABLE_PERF)
+static void on_parse_started(const void* parser_handle)
+{
+  FL_PERF_BEGIN(FL_PERF_STAGE_PARSE);
+}
+
+static void on_parse_ended(const void* parser_handle)
+{
+  FL_PERF_END(FL_PERF_STAGE_PARSE);
+}
+
+static void perf_build_stat(fw_app_t* app, fl_perf_read_t* perf_read)
+{
+  fw_app_proto_manager_t* proto_mgr = &app->proto_mgr;
+  const fl_perf_stat_t*   stat = fl_perf_get(perf_read->stage);
+  uint32_t                mean = 0;
+  uint32_t                min = 0;
+
+  if (stat->count > 0)
+  {
+    mean = (uint32_t)(stat->sum / stat->count);
+    min = stat->min;
+  }
+
+  proto_mgr->out_length = sprintf((char*)proto_mgr->out_buf, "%s %lu,%d,%d,%lu,%lu,%lu,%lu,",
+      fl_txt_msg_get_message_name(FL_MSG_ID_READ_PERF),
+      app->device_id,
+      FL_OK,
+      perf_read->stage,
+      stat->count,
+      min,
+      stat->max,
+      mean);
+  proto_mgr->out_length += fl_base64_encode((char*)&proto_mgr->out_buf[proto_mgr->out_length],
+                                            (const char*)stat->hist,
+                                            sizeof(stat->hist));
+  proto_mgr->out_buf[proto_mgr->out_length++] = FL_TXT_MSG_TAIL;
+
+  if (perf_read->clear == FL_TRUE)
+  {
+    fl_perf_reset(perf_read->stage);
+  }
+}
+#endif
@@ -0,0 +1,315 @@
+// fw_app_config.c
+// Device configuration and register init profiles in flash(fl_flash_log).
+//
+// Device ID, message UART baud rate and I2C bus speeds are applied at boot(fw_app_hw_init()),
+// a changed item takes effect after a reset.
+// Register init profiles are written in one burst after each sensor enumeration(boot, RSENS),
+// so the host does not send the register init sequence after a power cycle.
+
+#include <string.h>
+#include <stddef.h>
+#include "fw_app.h"
+
+// Profile read for fw_app_config_apply_profiles()(the profile being built is kept).
+static fw_app_profile_t _apply_buf;
+
+static fl_status_t item_key(uint8_t item, uint16_t* key);
+static fl_status_t check_value(uint8_t item, uint32_t value);
+static uint32_t read_u32(uint16_t key, uint32_t default_value);
+static uint16_t profile_length(const fw_app_profile_t* profile);
+static fl_status_t profile_write_reg(const fw_app_profile_entry_t* entry);
+
+// Mount the configuration log and apply the device settings(before the message UART receive starts).
+FL_DECLARE(void) fw_app_config_load(void)
+{
+  fw_app_config_manager_t*  config = &g_app.config;
+  UART_HandleTypeDef*       huart = g_app.proto_mgr.uart_handle;
+  uint32_t                  value;
+  uint8_t                   i;
+
+  config->building = FL_MSG_PROFILE_COUNT;
+  config->log.sectors[0] = FW_APP_CONFIG_SECTOR_A;
+  config->log.sectors[1] = FW_APP_CONFIG_SECTOR_B;
+  config->log.addrs[0] = FW_APP_CONFIG_ADDR_A;
+  config->log.addrs[1] = FW_APP_CONFIG_ADDR_B;
+  config->log.sector_size = FW_APP_CONFIG_SECTOR_SIZE;
+  config->log_status = fl_flash_log_init(&config->log);
+  if (config->log_status != FL_OK)
+  {
+    FL_LOG1(FL_LOG_CONFIG_MOUNT_FAILED, config->log_status);
+  }
+
+  g_app.device_id = read_u32(FW_APP_CONFIG_KEY_DEVICE_ID, FW_APP_DEFAULT_DEVICE_ID);
+
+  value = read_u32(FW_APP_CONFIG_KEY_BAUD_RATE, huart->Init.BaudRate);
+  if (value != huart->Init.BaudRate)
+  {
+    huart->Init.BaudRate = value;
+    HAL_UART_Init(huart);
+  }
+
+  for (i = 0; i < FW_APP_I2C_BUS_COUNT; i++)
+  {
+    value = read_u32(FW_APP_CONFIG_KEY_I2C_SPEED + i, 0);
+    if (value != 0)
+    {
+      fl_i2c_set_speed(&g_app.i2c_bus[i].i2c, value);
+    }
+  }
+}
+
+// Write the registers of the stored profiles in slot order(blocking mode transfers, no queued transfer).
+FL_DECLARE(void) fw_app_config_apply_profiles(void)
+{
+  fw_app_config_manager_t*  config = &g_app.config;
+  uint8_t                   slot;
+  uint8_t                   i;
+  uint8_t                   failed;
+
+  if (config->log_status != FL_OK)
+  {
+    return;
+  }
+
+  for (slot = 0; slot < FL_MSG_PROFILE_COUNT; slot++)
+  {
+    memset(&_apply_buf, 0, sizeof(_apply_buf));
+    if (fl_flash_log_read(&config->log, FW_APP_CONFIG_KEY_PROFILE + slot,
+                          &_apply_buf, sizeof(_apply_buf), NULL) != FL_OK)
+    {
+      continue;
+    }
+
+    failed = 0;
+    for (i = 0; (i < _apply_buf.count) && (i < FL_MSG_PROFILE_MAX_ENTRIES); i++)
+    {
+      if (profile_write_reg(&_apply_buf.entries[i]) != FL_OK)
+      {
+        failed++;
+      }
+    }
+
+    FL_LOG3(FL_LOG_PROFILE_APPLIED, slot, _apply_buf.count, failed);
+  }
+}
+
+// value 0 : delete the item.
+FL_DECLARE(fl_status_t) fw_app_config_write(uint8_t item, uint32_t value)
+{
+  fw_app_config_manager_t*  config = &g_app.config;
+  uint16_t                  key;
+
+  if ((item_key(item, &key) != FL_OK) ||
+      ((value != 0) && (check_value(item, value) != FL_OK)))
+  {
+    return FL_ERROR;
+  }
+
+  if (config->log_status != FL_OK)
+  {
+    return config->log_status;
+  }
+
+  if (value == 0)
+  {
+    return fl_flash_log_delete(&config->log, key);
+  }
+
+  return fl_flash_log_write(&config->log, key, &value, sizeof(value));
+}
+
+// Stored value of an item(FL_FLASH_LOG_ERR_NOT_FOUND : the default is used).
+FL_DECLARE(fl_status_t) fw_app_config_read(uint8_t item, uint32_t* value)
+{
+  fw_app_config_manager_t*  config = &g_app.config;
+  uint16_t                  key;
+  uint8_t                   slot;
+  char                      name;
+
+  *value = 0;
+
+  if (config->log_status != FL_OK)
+  {
+    return config->log_status;
+  }
+
+  if (item == FL_MSG_CONFIG_PROFILES)
+  {
+    for (slot = 0; slot < FL_MSG_PROFILE_COUNT; slot++)
+    {
+      if (fl_flash_log_read(&config->log, FW_APP_CONFIG_KEY_PROFILE + slot, &name, sizeof(name), NULL) == FL_OK)
+      {
+        *value |= (1 << slot);
+      }
+    }
+    return FL_OK;
+  }
+
+  if (item_key(item, &key) != FL_OK)
+  {
+    return FL_ERROR;
+  }
+
+  return fl_flash_log_read(&config->log, key, value, sizeof(*value), NULL);
+}
+
+// A profile is built in RAM(begin, add) and stored in one flash record(save).
+FL_DECLARE(fl_status_t) fw_app_config_profile(const fl_profile_write_t* prof_wr, uint8_t arg_count)
+{
+  fw_app_config_manager_t*  config = &g_app.config;
+  fw_app_profile_entry_t*   entry;
+  fl_status_t               ret;
+
+  if (config->log_status != FL_OK)
+  {
+    return config->log_status;
+  }
+
+  switch (prof_wr->op)
+  {
+  case FL_MSG_PROFILE_BEGIN:
+    if ((arg_count != 3) || (prof_wr->profile >= FL_MSG_PROFILE_COUNT))
+    {
+      break;
+    }
+    memset(&config->profile, 0, sizeof(config->profile));
+    strcpy(config->profile.name, prof_wr->name);
+    config->building = prof_wr->profile;
+    return FL_OK;
+
+  case FL_MSG_PROFILE_ADD:
+    if ((arg_count != 5) ||
+        (config->building >= FL_MSG_PROFILE_COUNT) ||
+        (config->profile.count >= FL_MSG_PROFILE_MAX_ENTRIES) ||
+        (fw_app_get_i2c_bus(prof_wr->i2c_num) == NULL) ||
+        (fl_vl6180x_reg_size(prof_wr->reg_addr) == 0))
+    {
+      break;
+    }
+    entry = &config->profile.entries[config->profile.count++];
+    entry->i2c_num = prof_wr->i2c_num;
+    entry->dev_addr = (uint8_t)prof_wr->dev_addr;
+    entry->reg_addr = prof_wr->reg_addr;
+    entry->size = fl_vl6180x_reg_size(prof_wr->reg_addr);
+    entry->value = prof_wr->value;
+    return FL_OK;
+
+  case FL_MSG_PROFILE_SAVE:
+    if ((arg_count != 1) || (config->building >= FL_MSG_PROFILE_COUNT))
+    {
+      break;
+    }
+    ret = fl_flash_log_write(&config->log, FW_APP_CONFIG_KEY_PROFILE + config->building,
+                             &config->profile, profile_length(&config->profile));
+    if (ret == FL_OK)
+    {
+      config->building = FL_MSG_PROFILE_COUNT;
+    }
+    return ret;
+
+  case FL_MSG_PROFILE_DELETE:
+    if ((arg_count != 2) || (prof_wr->profile >= FL_MSG_PROFILE_COUNT))
+    {
+      break;
+    }
+    return fl_flash_log_delete(&config->log, FW_APP_CONFIG_KEY_PROFILE + prof_wr->profile);
+  }
+
+  return FL_ERROR;
+}
+
+static fl_status_t item_key(uint8_t item, uint16_t* key)
+{
+  switch (item)
+  {
+  case FL_MSG_CONFIG_DEVICE_ID:
+    *key = FW_APP_CONFIG_KEY_DEVICE_ID;
+    return FL_OK;
+
+  case FL_MSG_CONFIG_BAUD_RATE:
+    *key = FW_APP_CONFIG_KEY_BAUD_RATE;
+    return FL_OK;
+
+  case FL_MSG_CONFIG_I2C1_SPEED:
+  case FL_MSG_CONFIG_I2C2_SPEED:
+    *key = FW_APP_CONFIG_KEY_I2C_SPEED + (item - FL_MSG_CONFIG_I2C1_SPEED);
+    return FL_OK;
+  }
+
+  return FL_ERROR;
+}
+
+// A stored value must not leave the device unreachable at the next boot.
+static fl_status_t check_value(uint8_t item, uint32_t value)
+{
+  switch (item)
+  {
+  case FL_MSG_CONFIG_DEVICE_ID:
+    // A broadcast response slot for every node.
+    if (value <= FW_APP_MAX_NODE_COUNT)
+    {
+      return FL_OK;
+    }
+    break;
+
+  case FL_MSG_CONFIG_BAUD_RATE:
+    if ((value >= FW_APP_BAUD_RATE_MIN) && (value <= FW_APP_BAUD_RATE_MAX))
+    {
+      return FL_OK;
+    }
+    break;
+
+  case FL_MSG_CONFIG_I2C1_SPEED:
+  case FL_MSG_CONFIG_I2C2_SPEED:
+    if ((value >= FL_I2C_SPEED_MIN) && (value <= FL_I2C_SPEED_FAST_PLUS))
+    {
+      return FL_OK;
+    }
+    break;
+  }
+
+  return FL_ERROR;
+}
+
+static uint32_t read_u32(uint16_t key, uint32_t default_value)
+{
+  uint32_t value;
+
+  if ((g_app.config.log_status != FL_OK) ||
+      (fl_flash_log_read(&g_app.config.log, key, &value, sizeof(value), NULL) != FL_OK))
+  {
+    return default_value;
+  }
+
+  return value;
+}
+
+// Name, count and the entries in use.
+static uint16_t profile_length(const fw_app_profile_t* profile)
+{
+  return (uint16_t)(offsetof(fw_app_profile_t, entries) + profile->count * sizeof(fw_app_profile_entry_t));
+}
+
+static fl_status_t profile_write_reg(const fw_app_profile_entry_t* entry)
+{
+  fw_app_i2c_bus_t* bus = fw_app_get_i2c_bus(entry->i2c_num);
+
+  if (bus == NULL)
+  {
+    return FL_ERROR;
+  }
+
+  switch (entry->size)
+  {
+  case 1:
+    return fl_i2c_write_byte(&bus->i2c, entry->dev_addr, entry->reg_addr, (uint8_t)entry->value);
+
+  case 2:
+    return fl_i2c_write_word(&bus->i2c, entry->dev_addr, entry->reg_addr, (uint16_t)entry->value);
+
+  case 4:
+    return fl_i2c_write_dword(&bus->i2c, entry->dev_addr, entry->reg_addr, entry->value);
+  }
+
+  return FL_ERROR;
+}
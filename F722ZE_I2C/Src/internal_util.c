@@ -29,9 +29,9 @@ fl_bool_t is_device_id_char(uint8_t data)
   }
 }
 
-uint8_t get_device_id(uint8_t* buf, uint16_t buf_size)
+uint32_t get_device_id(uint8_t* buf, uint16_t buf_size)
 {
-  return (uint8_t)atoi((const char*)buf);
+  return (uint32_t)strtoul((const char*)buf, NULL, 10);
 }
 
 fl_bool_t is_tail(uint8_t data)
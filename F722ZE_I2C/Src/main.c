@@ -48,9 +48,6 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
-static uint8_t      _temp = 0;
-static uint8_t      _ch;
-static fl_status_t  _ret;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -71,7 +68,6 @@ void SystemClock_Config(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
-  uint8_t data = 0;
   fw_app_init();
   /* USER CODE END 1 */
 
@@ -97,31 +93,18 @@ int main(void)
   MX_USB_OTG_FS_PCD_Init();
   MX_TIM2_Init();
   MX_I2C1_Init();
+  MX_I2C2_Init();
   /* USER CODE BEGIN 2 */
+  // The message receive starts first, the sensors are enumerated in the main loop(ready event).
   fw_app_hw_init();
-  HAL_GPIO_WritePin(VL6180X_CE_GPIO_Port, VL6180X_CE_Pin, GPIO_PIN_RESET);
-  HAL_Delay(10);
-  HAL_GPIO_WritePin(VL6180X_CE_GPIO_Port, VL6180X_CE_Pin, GPIO_PIN_SET);
-  HAL_Delay(1);
-  printf("Main starting.\r\n");
-
-  fl_i2c_read_byte(&g_app.i2c, 0x52, 0, &data);
-  printf("Data : 0x%x\r\n", data);
+  fw_app_boot_start();
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-    _temp = fl_q_count(&g_app.proto_mgr.q);
-    if (_temp > 0)
-    {
-      for (int i = 0; i < _temp; i++)
-      {
-        fl_q_pop(&g_app.proto_mgr.q, &_ch);
-        _ret = fl_txt_msg_parser_parse_command(&g_app.proto_mgr.parser_handle, _ch, NULL);
-      }
-    }
+    fw_app_process();
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -181,9 +164,10 @@ void SystemClock_Config(void)
     Error_Handler();
   }
   PeriphClkInitStruct.PeriphClockSelection = RCC_PERIPHCLK_USART3|RCC_PERIPHCLK_I2C1
-                              |RCC_PERIPHCLK_CLK48;
+                              |RCC_PERIPHCLK_I2C2|RCC_PERIPHCLK_CLK48;
   PeriphClkInitStruct.Usart3ClockSelection = RCC_USART3CLKSOURCE_PCLK1;
   PeriphClkInitStruct.I2c1ClockSelection = RCC_I2C1CLKSOURCE_PCLK1;
+  PeriphClkInitStruct.I2c2ClockSelection = RCC_I2C2CLKSOURCE_PCLK1;
   PeriphClkInitStruct.Clk48ClockSelection = RCC_CLK48SOURCE_PLL;
   if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInitStruct) != HAL_OK)
   {
@@ -196,11 +180,34 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
   if (huart == g_app.proto_mgr.uart_handle)
   {
-    fl_q_push(&g_app.proto_mgr.q, g_app.proto_mgr.rx_buf[0]);
+    fw_app_uart_rx_complete();
     FW_APP_UART_RCV_IT(g_app.proto_mgr.uart_handle, g_app.proto_mgr.rx_buf, 1);
   }
 }
 
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (huart == g_app.proto_mgr.uart_handle)
+  {
+    fw_app_uart_tx_complete();
+  }
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  fw_app_i2c_complete(hi2c, FL_OK);
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  fw_app_i2c_complete(hi2c, FL_OK);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  fw_app_i2c_complete(hi2c, FL_ERROR);
+}
+
 // Using Printf Debugging, LIVE expressions and SWV Trace in CubeIDE || STM32 || ITM || SWV
 // https://www.youtube.com/watch?v=sPzQ5CniWtw
 int _write(int file, char *ptr, int len)
@@ -0,0 +1,53 @@
+// Firmware library host test
+// fl_test.h
+//
+// Minimal assertion macros for the host tests(Tests/Makefile).
+// A test is a void function, FL_TEST_RUN() calls it and FL_TEST_RESULT() returns the exit code.
+
+#ifndef FL_TEST_H
+#define FL_TEST_H
+
+#include <stdio.h>
+
+static int _fl_test_failed;
+static int _fl_test_count;
+
+#define FL_TEST_ASSERT(cond)                                                  \
+  do                                                                          \
+  {                                                                           \
+    if (!(cond))                                                              \
+    {                                                                         \
+      printf("  %s:%d: assertion failed : %s\n", __FILE__, __LINE__, #cond);  \
+      _fl_test_failed++;                                                      \
+      return;                                                                 \
+    }                                                                         \
+  } while (0)
+
+#define FL_TEST_ASSERT_EQ(expected, actual)                                   \
+  do                                                                          \
+  {                                                                           \
+    unsigned long _e = (unsigned long)(expected);                             \
+    unsigned long _a = (unsigned long)(actual);                               \
+    if (_e != _a)                                                             \
+    {                                                                         \
+      printf("  %s:%d: %s : expected 0x%lX, actual 0x%lX\n",                  \
+             __FILE__, __LINE__, #actual, _e, _a);                            \
+      _fl_test_failed++;                                                      \
+      return;                                                                 \
+    }                                                                         \
+  } while (0)
+
+#define FL_TEST_RUN(test)                                                     \
+  do                                                                          \
+  {                                                                           \
+    int _failed = _fl_test_failed;                                            \
+    _fl_test_count++;                                                         \
+    test();                                                                   \
+    printf("%s %s\n", (_failed == _fl_test_failed) ? "PASS" : "FAIL", #test); \
+  } while (0)
+
+#define FL_TEST_RESULT()                                                      \
+  (printf("%d test(s), %d failed\n", _fl_test_count, _fl_test_failed),        \
+   (_fl_test_failed == 0) ? 0 : 1)
+
+#endif
@@ -0,0 +1,769 @@
+// Firmware library host test
+// hal_stub.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "hal_stub.h"
+#include "fl_perf.h"
+#include "fl_vl6180x.h"
+
+// Page of the flash interface registers(FLASH_R_BASE, __HAL_FLASH_CLEAR_FLAG()).
+#define FLASH_REG_PAGE              (FLASH_R_BASE & ~0xFFFUL)
+#define FLASH_REG_PAGE_SIZE         (0x1000)
+
+hal_stub_t g_hal_stub;
+
+uint32_t SystemCoreClock = 216000000;
+
+static void map_flash(void);
+static void map_fixed(uintptr_t addr, size_t size);
+static hal_stub_i2c_t* find_i2c(I2C_HandleTypeDef* hi2c);
+static void device_power_up(hal_stub_device_t* device);
+static uint8_t device_read(hal_stub_device_t* device, uint16_t reg_addr);
+static void device_write(hal_stub_device_t* device, uint16_t reg_addr, uint8_t data);
+static HAL_StatusTypeDef start_frame(I2C_HandleTypeDef* hi2c, uint16_t dev_addr, uint8_t* data, uint16_t size,
+                                     uint32_t options, fl_bool_t read);
+static HAL_StatusTypeDef nack(I2C_HandleTypeDef* hi2c, uint16_t size);
+static void trace_xfer(hal_stub_i2c_t* bus);
+static uint32_t uart_byte_time(void);
+
+void hal_stub_reset(void)
+{
+  memset(&g_hal_stub, 0, sizeof(g_hal_stub));
+  g_hal_stub.pclk1_freq = 54000000;
+
+  map_flash();
+}
+
+void hal_stub_flash_erase(void)
+{
+  map_flash();
+  memset((void*)HAL_STUB_FLASH_ADDR, 0xFF, HAL_STUB_FLASH_SECTOR_SIZE * HAL_STUB_FLASH_SECTOR_COUNT);
+}
+
+void hal_stub_set_i2c(uint8_t index, I2C_HandleTypeDef* hi2c, uint32_t speed)
+{
+  g_hal_stub.i2c[index].hi2c = hi2c;
+  g_hal_stub.i2c[index].speed = speed;
+}
+
+void hal_stub_set_uart(UART_HandleTypeDef* huart)
+{
+  g_hal_stub.huart = huart;
+}
+
+hal_stub_device_t* hal_stub_add_vl6180x(I2C_HandleTypeDef* hi2c, GPIO_TypeDef* ce_port, uint16_t ce_pin)
+{
+  hal_stub_device_t* device;
+
+  if (g_hal_stub.device_count >= HAL_STUB_DEVICE_COUNT)
+  {
+    return NULL;
+  }
+
+  device = &g_hal_stub.devices[g_hal_stub.device_count++];
+  memset(device, 0, sizeof(hal_stub_device_t));
+  device->hi2c = hi2c;
+  device->ce_port = ce_port;
+  device->ce_pin = ce_pin;
+
+  return device;
+}
+
+hal_stub_device_t* hal_stub_find_device(I2C_HandleTypeDef* hi2c, uint8_t addr)
+{
+  hal_stub_device_t*  device;
+  uint8_t             i;
+
+  for (i = 0; i < g_hal_stub.device_count; i++)
+  {
+    device = &g_hal_stub.devices[i];
+    if ((device->hi2c == hi2c) && (device->powered == FL_TRUE) &&
+        (device->addr == addr) && (device->nack != HAL_STUB_NACK_ADDR))
+    {
+      return device;
+    }
+  }
+
+  return NULL;
+}
+
+void hal_stub_uart_receive(const void* data, uint32_t length)
+{
+  const uint8_t*  bytes = (const uint8_t*)data;
+  uint32_t        i;
+
+  if (g_hal_stub.rx_head == g_hal_stub.rx_tail)
+  {
+    g_hal_stub.rx_time = g_hal_stub.time + uart_byte_time();
+  }
+
+  for (i = 0; i < length; i++)
+  {
+    g_hal_stub.rx_line[g_hal_stub.rx_head % HAL_STUB_UART_RX_SIZE] = bytes[i];
+    g_hal_stub.rx_head++;
+  }
+}
+
+void hal_stub_step(void)
+{
+  uint64_t        next = ((g_hal_stub.time / HAL_STUB_SYSTICK_PERIOD) + 1) * HAL_STUB_SYSTICK_PERIOD;
+  hal_stub_i2c_t* bus;
+  uint8_t         i;
+
+  for (i = 0; i < 2; i++)
+  {
+    bus = &g_hal_stub.i2c[i];
+    if ((bus->busy == FL_TRUE) && (bus->stuck == FL_FALSE) && (bus->done_time < next))
+    {
+      next = bus->done_time;
+    }
+  }
+  if ((g_hal_stub.tx_busy == FL_TRUE) && (g_hal_stub.tx_done_time < next))
+  {
+    next = g_hal_stub.tx_done_time;
+  }
+  if ((g_hal_stub.rx_head != g_hal_stub.rx_tail) && (g_hal_stub.rx_time < next))
+  {
+    next = g_hal_stub.rx_time;
+  }
+
+  g_hal_stub.time = next;
+
+  for (i = 0; i < 2; i++)
+  {
+    bus = &g_hal_stub.i2c[i];
+    if ((bus->busy == FL_TRUE) && (bus->stuck == FL_FALSE) && (bus->done_time == next))
+    {
+      bus->busy = FL_FALSE;
+      if (bus->error == FL_TRUE)
+      {
+        HAL_I2C_ErrorCallback(bus->hi2c);
+      }
+      else if (bus->read == FL_TRUE)
+      {
+        HAL_I2C_MasterRxCpltCallback(bus->hi2c);
+      }
+      else
+      {
+        HAL_I2C_MasterTxCpltCallback(bus->hi2c);
+      }
+    }
+  }
+
+  if ((g_hal_stub.tx_busy == FL_TRUE) && (g_hal_stub.tx_done_time == next))
+  {
+    g_hal_stub.tx_busy = FL_FALSE;
+    g_hal_stub.tx_done_length = g_hal_stub.tx_length;
+    HAL_UART_TxCpltCallback(g_hal_stub.huart);
+  }
+
+  if ((g_hal_stub.rx_head != g_hal_stub.rx_tail) && (g_hal_stub.rx_time == next))
+  {
+    g_hal_stub.rx_time += uart_byte_time();
+    if (g_hal_stub.rx_armed == FL_TRUE)
+    {
+      g_hal_stub.rx_armed = FL_FALSE;
+      *g_hal_stub.rx_buf = g_hal_stub.rx_line[g_hal_stub.rx_tail % HAL_STUB_UART_RX_SIZE];
+      g_hal_stub.rx_tail++;
+      HAL_UART_RxCpltCallback(g_hal_stub.huart);
+    }
+    else
+    {
+      // The receive was not restarted in time.
+      g_hal_stub.rx_tail++;
+      g_hal_stub.rx_overrun++;
+    }
+  }
+
+  if ((next % HAL_STUB_SYSTICK_PERIOD) == 0)
+  {
+    g_hal_stub.tick++;
+    HAL_SYSTICK_Callback();
+  }
+}
+
+// Weak HAL callbacks(the board connects them to the firmware).
+__weak void HAL_SYSTICK_Callback(void)
+{
+}
+
+__weak void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+  (void)huart;
+}
+
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  (void)huart;
+}
+
+__weak void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  (void)hi2c;
+}
+
+__weak void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  (void)hi2c;
+}
+
+__weak void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  (void)hi2c;
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return g_hal_stub.tick;
+}
+
+// Interrupts keep running, the main loop does not.
+void HAL_Delay(uint32_t Delay)
+{
+  uint32_t start = g_hal_stub.tick;
+
+  while ((g_hal_stub.tick - start) < Delay)
+  {
+    hal_stub_step();
+  }
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+  return g_hal_stub.pclk1_freq;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+  (void)GPIOx;
+  (void)GPIO_Init;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+  (void)GPIOx;
+  (void)GPIO_Pin;
+
+  // SDA released.
+  return GPIO_PIN_SET;
+}
+
+// CE pins of the sensors : low is the hardware standby, high boots the sensor at the default address.
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+  hal_stub_device_t*  device;
+  uint8_t             i;
+
+  for (i = 0; i < g_hal_stub.device_count; i++)
+  {
+    device = &g_hal_stub.devices[i];
+    if ((device->ce_port != GPIOx) || (device->ce_pin != GPIO_Pin))
+    {
+      continue;
+    }
+
+    if (PinState == GPIO_PIN_RESET)
+    {
+      device->powered = FL_FALSE;
+    }
+    else if (device->powered == FL_FALSE)
+    {
+      device_power_up(device);
+    }
+  }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+  (void)GPIOx;
+  (void)GPIO_Pin;
+}
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart)
+{
+  (void)huart;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+  (void)huart;
+  (void)Size;
+
+  g_hal_stub.rx_buf = pData;
+  g_hal_stub.rx_armed = FL_TRUE;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+  (void)huart;
+
+  if (g_hal_stub.tx_busy == FL_TRUE)
+  {
+    return HAL_BUSY;
+  }
+
+  if ((g_hal_stub.tx_length + Size) <= HAL_STUB_UART_TX_SIZE)
+  {
+    memcpy(&g_hal_stub.tx[g_hal_stub.tx_length], pData, Size);
+    g_hal_stub.tx_length += Size;
+  }
+
+  g_hal_stub.tx_busy = FL_TRUE;
+  g_hal_stub.tx_start_time = g_hal_stub.time;
+  g_hal_stub.tx_done_time = g_hal_stub.time + (Size * uart_byte_time());
+  g_hal_stub.tx_count++;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c)
+{
+  hi2c->State = HAL_I2C_STATE_READY;
+  hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+  g_hal_stub.i2c_init_count++;
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c)
+{
+  hal_stub_i2c_t* bus = find_i2c(hi2c);
+
+  // Aborts the transfer in progress.
+  if (bus != NULL)
+  {
+    bus->busy = FL_FALSE;
+    bus->started = FL_FALSE;
+    bus->device = NULL;
+  }
+
+  hi2c->State = HAL_I2C_STATE_RESET;
+  g_hal_stub.i2c_deinit_count++;
+
+  return HAL_OK;
+}
+
+void HAL_I2CEx_EnableFastModePlus(uint32_t ConfigFastModePlus)
+{
+  g_hal_stub.fast_mode_plus |= ConfigFastModePlus;
+}
+
+void HAL_I2CEx_DisableFastModePlus(uint32_t ConfigFastModePlus)
+{
+  g_hal_stub.fast_mode_plus &= ~ConfigFastModePlus;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c)
+{
+  return hi2c->ErrorCode;
+}
+
+// Register address(2 bytes, big endian) then the register bytes.
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  hal_stub_i2c_t*     bus = find_i2c(hi2c);
+  hal_stub_device_t*  device = hal_stub_find_device(hi2c, DevAddress >> 1);
+  uint16_t            i;
+
+  (void)Timeout;
+
+  if ((bus != NULL) && (bus->busy == FL_TRUE))
+  {
+    return HAL_BUSY;
+  }
+  if (device == NULL)
+  {
+    return nack(hi2c, Size);
+  }
+
+  hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+  device->reg_ptr = (uint16_t)((pData[0] << 8) | pData[1]);
+  for (i = 2; i < Size; i++)
+  {
+    device_write(device, device->reg_ptr++, pData[i]);
+  }
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  hal_stub_i2c_t*     bus = find_i2c(hi2c);
+  hal_stub_device_t*  device = hal_stub_find_device(hi2c, DevAddress >> 1);
+  uint16_t            i;
+
+  (void)Timeout;
+
+  if ((bus != NULL) && (bus->busy == FL_TRUE))
+  {
+    return HAL_BUSY;
+  }
+  if (device == NULL)
+  {
+    return nack(hi2c, Size);
+  }
+
+  hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+  for (i = 0; i < Size; i++)
+  {
+    pData[i] = device_read(device, device->reg_ptr++);
+  }
+
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t XferOptions)
+{
+  return start_frame(hi2c, DevAddress, pData, Size, XferOptions, FL_FALSE);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t XferOptions)
+{
+  return start_frame(hi2c, DevAddress, pData, Size, XferOptions, FL_TRUE);
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError)
+{
+  uint32_t sector;
+
+  for (sector = pEraseInit->Sector; sector < (pEraseInit->Sector + pEraseInit->NbSectors); sector++)
+  {
+    if ((sector < HAL_STUB_FLASH_SECTOR) || (sector >= (HAL_STUB_FLASH_SECTOR + HAL_STUB_FLASH_SECTOR_COUNT)))
+    {
+      *SectorError = sector;
+      return HAL_ERROR;
+    }
+
+    memset((void*)(uintptr_t)(HAL_STUB_FLASH_ADDR + ((sector - HAL_STUB_FLASH_SECTOR) * HAL_STUB_FLASH_SECTOR_SIZE)),
+           0xFF, HAL_STUB_FLASH_SECTOR_SIZE);
+    g_hal_stub.flash_erase_count++;
+  }
+
+  *SectorError = 0xFFFFFFFF;
+
+  return HAL_OK;
+}
+
+// Programming clears bits only, like the flash cells.
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+  uint8_t*  dst = (uint8_t*)(uintptr_t)Address;
+  uint32_t  size;
+  uint32_t  i;
+
+  switch (TypeProgram)
+  {
+  case FLASH_TYPEPROGRAM_BYTE:
+    size = 1;
+    break;
+
+  case FLASH_TYPEPROGRAM_HALFWORD:
+    size = 2;
+    break;
+
+  case FLASH_TYPEPROGRAM_WORD:
+    size = 4;
+    break;
+
+  default:
+    size = 8;
+    break;
+  }
+
+  if ((Address < HAL_STUB_FLASH_ADDR) ||
+      ((Address + size) > (HAL_STUB_FLASH_ADDR + (HAL_STUB_FLASH_SECTOR_SIZE * HAL_STUB_FLASH_SECTOR_COUNT))))
+  {
+    return HAL_ERROR;
+  }
+
+  if ((g_hal_stub.flash_program_limit != 0) &&
+      (g_hal_stub.flash_program_count >= g_hal_stub.flash_program_limit))
+  {
+    return HAL_ERROR;
+  }
+  g_hal_stub.flash_program_count++;
+
+  for (i = 0; i < size; i++)
+  {
+    dst[i] &= (uint8_t)(Data >> (8 * i));
+  }
+
+  return HAL_OK;
+}
+
+// Measurement points of fl_perf(DWT cycle counter) are not measured on the host.
+FL_DECLARE(void) fl_perf_init(void)
+{
+}
+
+FL_DECLARE(void) fl_perf_begin(uint8_t stage)
+{
+  (void)stage;
+}
+
+FL_DECLARE(void) fl_perf_end(uint8_t stage)
+{
+  (void)stage;
+}
+
+FL_DECLARE(const fl_perf_stat_t*) fl_perf_get(uint8_t stage)
+{
+  static fl_perf_stat_t stat;
+
+  (void)stage;
+
+  return &stat;
+}
+
+FL_DECLARE(void) fl_perf_reset(uint8_t stage)
+{
+  (void)stage;
+}
+
+// Erased flash sectors at the first use.
+static void map_flash(void)
+{
+  static fl_bool_t mapped = FL_FALSE;
+
+  if (mapped == FL_FALSE)
+  {
+    map_fixed(HAL_STUB_FLASH_ADDR, HAL_STUB_FLASH_SECTOR_SIZE * HAL_STUB_FLASH_SECTOR_COUNT);
+    map_fixed(FLASH_REG_PAGE, FLASH_REG_PAGE_SIZE);
+    mapped = FL_TRUE;
+    memset((void*)HAL_STUB_FLASH_ADDR, 0xFF, HAL_STUB_FLASH_SECTOR_SIZE * HAL_STUB_FLASH_SECTOR_COUNT);
+  }
+}
+
+static void map_fixed(uintptr_t addr, size_t size)
+{
+  void* mem = mmap((void*)addr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+  if (mem != (void*)addr)
+  {
+    fprintf(stderr, "hal_stub : cannot map 0x%08lX\n", (unsigned long)addr);
+    exit(2);
+  }
+}
+
+static hal_stub_i2c_t* find_i2c(I2C_HandleTypeDef* hi2c)
+{
+  uint8_t i;
+
+  for (i = 0; i < 2; i++)
+  {
+    if (g_hal_stub.i2c[i].hi2c == hi2c)
+    {
+      return &g_hal_stub.i2c[i];
+    }
+  }
+
+  return NULL;
+}
+
+static void device_power_up(hal_stub_device_t* device)
+{
+  memset(device->regs, 0, sizeof(device->regs));
+  device->regs[FL_VL6180X_IDENTIFICATION_MODEL_ID] = FL_VL6180X_MODEL_ID;
+  device->regs[FL_VL6180X_SYSTEM_FRESH_OUT_OF_RESET] = 1;
+  device->addr = 0x29;
+  device->reg_ptr = 0;
+  device->powered = FL_TRUE;
+}
+
+// RESULT__RANGE_VAL counts the reads, so every sample has its own range.
+static uint8_t device_read(hal_stub_device_t* device, uint16_t reg_addr)
+{
+  uint8_t data;
+
+  if (reg_addr >= HAL_STUB_DEVICE_REG_SIZE)
+  {
+    return 0;
+  }
+
+  data = device->regs[reg_addr];
+  if (reg_addr == FL_VL6180X_RESULT_RANGE_VAL)
+  {
+    device->regs[reg_addr]++;
+  }
+  device->read_count++;
+
+  return data;
+}
+
+static void device_write(hal_stub_device_t* device, uint16_t reg_addr, uint8_t data)
+{
+  if (reg_addr >= HAL_STUB_DEVICE_REG_SIZE)
+  {
+    return;
+  }
+
+  device->regs[reg_addr] = data;
+  if (reg_addr == FL_VL6180X_I2C_SLAVE_DEVICE_ADDRESS)
+  {
+    device->addr = data & 0x7F;
+  }
+  device->write_count++;
+}
+
+// A frame of a sequential transfer, the registers are accessed at the start and the callback comes after
+// the transfer time. A frame in the direction of the previous one continues without START(RELOAD),
+// I2C_LAST_FRAME and a NACK end the transfer with STOP.
+static HAL_StatusTypeDef start_frame(I2C_HandleTypeDef* hi2c, uint16_t dev_addr, uint8_t* data, uint16_t size,
+                                     uint32_t options, fl_bool_t read)
+{
+  hal_stub_i2c_t*     bus = find_i2c(hi2c);
+  hal_stub_device_t*  device;
+  fl_bool_t           stop;
+  uint8_t             refused;
+  uint32_t            clocks = 0;
+  uint16_t            i;
+
+  if ((bus == NULL) || (bus->busy == FL_TRUE))
+  {
+    return HAL_BUSY;
+  }
+
+  bus->busy = FL_TRUE;
+  bus->error = FL_FALSE;
+  hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+  hi2c->XferCount = size;
+
+  // (Repeated) START and the slave address.
+  if ((bus->started == FL_FALSE) || (bus->read != read))
+  {
+    if (bus->started == FL_FALSE)
+    {
+      bus->xfer_count++;
+    }
+    else if ((read == FL_TRUE) && ((bus->trace_count - 1) < HAL_STUB_I2C_TRACE_SIZE))
+    {
+      // The repeated START of a read after the register address.
+      bus->trace[bus->trace_count - 1].read = FL_TRUE;
+    }
+    bus->started = FL_TRUE;
+    bus->write_index = 0;
+    bus->device = hal_stub_find_device(hi2c, dev_addr >> 1);
+    clocks += 10;
+
+    if ((bus->device == NULL) ||
+        ((read == FL_TRUE) && (bus->device->nack == HAL_STUB_NACK_READ_ADDR)))
+    {
+      nack(hi2c, size);
+      bus->error = FL_TRUE;
+    }
+  }
+  bus->read = read;
+  device = bus->device;
+
+  for (i = 0; (i < size) && (bus->error == FL_FALSE); i++)
+  {
+    clocks += 9;
+
+    if (read == FL_TRUE)
+    {
+      data[i] = device_read(device, device->reg_ptr++);
+      continue;
+    }
+
+    refused = (bus->write_index < 2) ? HAL_STUB_NACK_REG_ADDR : HAL_STUB_NACK_DATA;
+    if (device->nack == refused)
+    {
+      // The refused byte was loaded.
+      nack(hi2c, size - (i + 1));
+      bus->error = FL_TRUE;
+      break;
+    }
+
+    if (bus->write_index == 0)
+    {
+      device->reg_ptr = (uint16_t)(data[i] << 8);
+    }
+    else if (bus->write_index == 1)
+    {
+      device->reg_ptr |= data[i];
+      trace_xfer(bus);
+    }
+    else
+    {
+      device_write(device, device->reg_ptr++, data[i]);
+    }
+    bus->write_index++;
+  }
+
+  if (bus->error == FL_FALSE)
+  {
+    hi2c->XferCount = 0;
+  }
+
+  stop = ((bus->error == FL_TRUE) || (options == I2C_LAST_FRAME)) ? FL_TRUE : FL_FALSE;
+  if (stop == FL_TRUE)
+  {
+    bus->started = FL_FALSE;
+    bus->device = NULL;
+    clocks += 1;
+  }
+
+  // The sensor stretches the clock once per transfer.
+  bus->done_time = g_hal_stub.time + ((clocks * 1000000ULL) / bus->speed) + 1;
+  if (stop == FL_TRUE)
+  {
+    bus->done_time += bus->stretch;
+  }
+
+  return HAL_OK;
+}
+
+// No acknowledge, size : bytes of the frame not loaded(XferCount, all of them for the slave address).
+static HAL_StatusTypeDef nack(I2C_HandleTypeDef* hi2c, uint16_t size)
+{
+  hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+  hi2c->XferCount = size;
+
+  return HAL_ERROR;
+}
+
+// A write until the repeated START of a read.
+static void trace_xfer(hal_stub_i2c_t* bus)
+{
+  hal_stub_xfer_t* xfer;
+
+  if (bus->trace_count < HAL_STUB_I2C_TRACE_SIZE)
+  {
+    xfer = &bus->trace[bus->trace_count];
+    xfer->addr = bus->device->addr;
+    xfer->reg_addr = bus->device->reg_ptr;
+    xfer->read = FL_FALSE;
+  }
+  bus->trace_count++;
+}
+
+// 10 bits(start, 8 data bits, stop) at the baud rate, rounded up.
+static uint32_t uart_byte_time(void)
+{
+  uint32_t baud_rate = 115200;
+
+  if ((g_hal_stub.huart != NULL) && (g_hal_stub.huart->Init.BaudRate != 0))
+  {
+    baud_rate = g_hal_stub.huart->Init.BaudRate;
+  }
+
+  return (10000000 + baud_rate - 1) / baud_rate;
+}
@@ -0,0 +1,172 @@
+// Firmware library host test
+// hal_stub.h
+//
+// Host replacements of the HAL functions used by the firmware(hal_stub.c) on a simulated board :
+// a microsecond clock with the SysTick, the message UART, interrupt mode I2C transfers on VL6180X
+// register models and the configuration flash sectors.
+// Interrupts are HAL callbacks called from hal_stub_step(), the weak defaults do nothing
+// (sim_app.c connects them to the firmware like main.c).
+
+#ifndef HAL_STUB_H
+#define HAL_STUB_H
+
+#include "stm32f7xx_hal.h"
+#include "fl_def.h"
+
+#define HAL_STUB_SYSTICK_PERIOD     (1000)      // us
+
+#define HAL_STUB_DEVICE_COUNT       (4)
+#define HAL_STUB_DEVICE_REG_SIZE    (0x400)
+
+// Every byte sent on the message UART since hal_stub_reset().
+#define HAL_STUB_UART_TX_SIZE       (65536)
+#define HAL_STUB_UART_RX_SIZE       (1024)
+
+// Flash sectors of the configuration log(FW_APP_CONFIG_ADDR_A, FW_APP_CONFIG_ADDR_B),
+// mapped at their target addresses.
+#define HAL_STUB_FLASH_ADDR         (0x08040000)
+#define HAL_STUB_FLASH_SECTOR       (FLASH_SECTOR_6)
+#define HAL_STUB_FLASH_SECTOR_SIZE  (0x20000)
+#define HAL_STUB_FLASH_SECTOR_COUNT (2)
+
+// No acknowledge of a sensor(hal_stub_device_t.nack).
+#define HAL_STUB_NACK_NONE          (0)
+#define HAL_STUB_NACK_ADDR          (1)   // Slave address(a broken sensor).
+#define HAL_STUB_NACK_REG_ADDR      (2)   // Register address bytes.
+#define HAL_STUB_NACK_DATA          (3)   // Written register bytes(a read-only register).
+#define HAL_STUB_NACK_READ_ADDR     (4)   // Slave address after the repeated START of a read.
+
+// Interrupt mode transfers recorded on each bus(hal_stub_i2c_t.trace).
+#define HAL_STUB_I2C_TRACE_SIZE     (256)
+
+// VL6180X register model, the sensor answers at its address while its CE pin is high.
+typedef struct _hal_stub_device
+{
+  I2C_HandleTypeDef*  hi2c;
+  GPIO_TypeDef*       ce_port;
+  uint16_t            ce_pin;
+
+  fl_bool_t           powered;
+
+  // 7-bit address(I2C_SLAVE_DEVICE_ADDRESS).
+  uint8_t             addr;
+
+  // HAL_STUB_NACK_xxx.
+  uint8_t             nack;
+
+  uint8_t             regs[HAL_STUB_DEVICE_REG_SIZE];
+
+  // Register address of the next read or write, set by the first 2 bytes written after START.
+  uint16_t            reg_ptr;
+
+  uint32_t            read_count;
+  uint32_t            write_count;
+} hal_stub_device_t;
+
+// Register access of an interrupt mode transfer, in the order of the transfers on the bus.
+typedef struct _hal_stub_xfer
+{
+  // 7-bit address.
+  uint8_t             addr;
+  uint16_t            reg_addr;
+  fl_bool_t           read;
+} hal_stub_xfer_t;
+
+// Interrupt mode transfer in progress on a bus(frames of the HAL sequential transfer).
+typedef struct _hal_stub_i2c
+{
+  I2C_HandleTypeDef*  hi2c;
+
+  // SCL frequency(Hz) and clock stretching(us) of every transfer for the transfer time.
+  uint32_t            speed;
+  uint32_t            stretch;
+
+  // The transfers never complete(SDA held low), the firmware timeout aborts them.
+  fl_bool_t           stuck;
+
+  fl_bool_t           busy;
+  uint64_t            done_time;
+  fl_bool_t           read;
+  fl_bool_t           error;
+
+  // Addressed slave from START to STOP(kept between the frames), bytes written since START.
+  hal_stub_device_t*  device;
+  fl_bool_t           started;
+  uint16_t            write_index;
+
+  uint32_t            xfer_count;
+
+  // Transfers whose register address was acknowledged, the first HAL_STUB_I2C_TRACE_SIZE ones are recorded
+  // (the count goes on). A test clears trace_count to record from now.
+  hal_stub_xfer_t     trace[HAL_STUB_I2C_TRACE_SIZE];
+  uint32_t            trace_count;
+} hal_stub_i2c_t;
+
+typedef struct _hal_stub
+{
+  // Simulated time(us) and the SysTick(HAL_GetTick()).
+  uint64_t            time;
+  uint32_t            tick;
+
+  // HAL_RCC_GetPCLK1Freq()(Hz).
+  uint32_t            pclk1_freq;
+
+  // Fast-mode Plus drive of the pins(I2C_FASTMODEPLUS_I2Cx bits).
+  uint32_t            fast_mode_plus;
+
+  uint32_t            i2c_init_count;
+  uint32_t            i2c_deinit_count;
+
+  hal_stub_i2c_t      i2c[2];
+  hal_stub_device_t   devices[HAL_STUB_DEVICE_COUNT];
+  uint8_t             device_count;
+
+  // Message UART.
+  UART_HandleTypeDef* huart;
+  uint8_t*            rx_buf;
+  fl_bool_t           rx_armed;
+  uint8_t             rx_line[HAL_STUB_UART_RX_SIZE];
+  uint32_t            rx_head;
+  uint32_t            rx_tail;
+  uint64_t            rx_time;
+  uint32_t            rx_overrun;
+
+  uint8_t             tx[HAL_STUB_UART_TX_SIZE];
+  uint32_t            tx_length;
+  // Bytes of the completed transmits(received by the host).
+  uint32_t            tx_done_length;
+  fl_bool_t           tx_busy;
+  uint64_t            tx_start_time;
+  uint64_t            tx_done_time;
+  uint32_t            tx_count;
+
+  uint32_t            flash_erase_count;
+
+  // Words programmed since hal_stub_reset(), a reset cuts the programming after flash_program_limit words
+  // (the following HAL_FLASH_Program() calls fail). 0 : no limit.
+  uint32_t            flash_program_count;
+  uint32_t            flash_program_limit;
+} hal_stub_t;
+
+extern hal_stub_t g_hal_stub;
+
+// Clocks of SystemClock_Config()(216MHz core, 54MHz PCLK1), no device, time 0.
+// The flash sectors keep their contents(a reset), hal_stub_flash_erase() clears them.
+void hal_stub_reset(void);
+void hal_stub_flash_erase(void);
+
+// I2C bus and message UART handles of the board.
+void hal_stub_set_i2c(uint8_t index, I2C_HandleTypeDef* hi2c, uint32_t speed);
+void hal_stub_set_uart(UART_HandleTypeDef* huart);
+
+// A VL6180X out of reset(default address 0x29 while its CE pin is high).
+hal_stub_device_t* hal_stub_add_vl6180x(I2C_HandleTypeDef* hi2c, GPIO_TypeDef* ce_port, uint16_t ce_pin);
+hal_stub_device_t* hal_stub_find_device(I2C_HandleTypeDef* hi2c, uint8_t addr);
+
+// Bytes received on the message UART at its baud rate(starting now or after the queued bytes).
+void hal_stub_uart_receive(const void* data, uint32_t length);
+
+// Advance the time to the next interrupt(SysTick, I2C, UART) and call its HAL callback.
+void hal_stub_step(void);
+
+#endif
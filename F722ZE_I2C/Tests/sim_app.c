@@ -0,0 +1,207 @@
+// Firmware library host test
+// sim_app.c
+
+#include <string.h>
+#include "sim_app.h"
+#include "i2c.h"
+#include "tim.h"
+
+// Board handles of the CubeMX init code(i2c.c, usart.c, tim.c).
+I2C_HandleTypeDef   hi2c1 = { .Instance = I2C1, .Init.Timing = 0x6000030D };
+I2C_HandleTypeDef   hi2c2 = { .Instance = I2C2, .Init.Timing = 0x6000030D };
+UART_HandleTypeDef  huart3 = { .Instance = USART3, .Init.BaudRate = 115200 };
+TIM_HandleTypeDef   htim2 = { .Instance = TIM2 };
+
+uint32_t g_sim_app_log_count[FL_LOG_FMT_COUNT];
+
+// CE pins of the sensors(fw_app_init()).
+static GPIO_TypeDef* const  _ce_ports[] = { VL6180X_CE_GPIO_Port, VL6180X_CE2_GPIO_Port, VL6180X_CE3_GPIO_Port };
+static const uint16_t       _ce_pins[] = { VL6180X_CE_Pin, VL6180X_CE2_Pin, VL6180X_CE3_Pin };
+
+// Host side of the message UART : position of the next line in g_hal_stub.tx.
+static uint32_t _read_pos;
+static char     _line[SIM_APP_LINE_SIZE];
+
+fl_status_t sim_app_boot(uint8_t sensor_count)
+{
+  sim_app_power_up(sensor_count);
+
+  return (sim_app_wait(fl_txt_msg_get_message_name(FL_MSG_ID_READY_EVENT), 1000) != NULL) ? FL_OK : FL_ERROR;
+}
+
+void sim_app_power_up(uint8_t sensor_count)
+{
+  uint8_t i;
+
+  hal_stub_reset();
+  hal_stub_set_i2c(0, &hi2c1, 400000);
+  hal_stub_set_i2c(1, &hi2c2, 400000);
+  hal_stub_set_uart(&huart3);
+  huart3.Init.BaudRate = 115200;
+  for (i = 0; (i < sensor_count) && (i < FW_APP_SENSOR_COUNT); i++)
+  {
+    hal_stub_add_vl6180x(&hi2c1, _ce_ports[i], _ce_pins[i]);
+  }
+
+  memset(g_sim_app_log_count, 0, sizeof(g_sim_app_log_count));
+  _read_pos = 0;
+
+  // main().
+  fw_app_init();
+  fw_app_hw_init();
+  fw_app_boot_start();
+}
+
+void sim_app_run(uint32_t time_ms)
+{
+  uint64_t end = g_hal_stub.time + ((uint64_t)time_ms * 1000);
+
+  while (g_hal_stub.time < end)
+  {
+    fw_app_process();
+
+    // WFI.
+    hal_stub_step();
+  }
+
+  fw_app_process();
+}
+
+void sim_app_send(const char* message)
+{
+  hal_stub_uart_receive(message, (uint32_t)strlen(message));
+}
+
+const char* sim_app_read(void)
+{
+  uint32_t i;
+  uint32_t length;
+
+  for (i = _read_pos; i < g_hal_stub.tx_done_length; i++)
+  {
+    if (g_hal_stub.tx[i] != FL_TXT_MSG_TAIL)
+    {
+      continue;
+    }
+
+    length = i - _read_pos;
+    if (length >= SIM_APP_LINE_SIZE)
+    {
+      length = SIM_APP_LINE_SIZE - 1;
+    }
+    memcpy(_line, &g_hal_stub.tx[_read_pos], length);
+    _line[length] = '\0';
+    _read_pos = i + 1;
+
+    return _line;
+  }
+
+  // Everything was read : the transmit buffer starts over(long captures).
+  if ((_read_pos == g_hal_stub.tx_length) && (g_hal_stub.tx_busy == FL_FALSE))
+  {
+    g_hal_stub.tx_length = 0;
+    g_hal_stub.tx_done_length = 0;
+    _read_pos = 0;
+  }
+
+  return NULL;
+}
+
+const char* sim_app_wait(const char* prefix, uint32_t timeout_ms)
+{
+  const char* line;
+  uint32_t    elapsed;
+
+  for (elapsed = 0; elapsed <= timeout_ms; elapsed++)
+  {
+    while ((line = sim_app_read()) != NULL)
+    {
+      if (strncmp(line, prefix, strlen(prefix)) == 0)
+      {
+        return line;
+      }
+    }
+
+    sim_app_run(1);
+  }
+
+  return NULL;
+}
+
+const char* sim_app_command(const char* message, uint32_t timeout_ms)
+{
+  char        name[FL_TXT_MSG_ID_MAX_LEN + 2];
+  uint32_t    i;
+
+  // Message name and the separator.
+  for (i = 0; (i < (sizeof(name) - 1)) && (message[i] != '\0'); i++)
+  {
+    name[i] = message[i];
+    if (message[i] == ' ')
+    {
+      i++;
+      break;
+    }
+  }
+  name[i] = '\0';
+
+  sim_app_send(message);
+
+  return sim_app_wait(name, timeout_ms);
+}
+
+// HAL callbacks of main.c.
+void HAL_SYSTICK_Callback(void)
+{
+  fw_app_systick();
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (huart == g_app.proto_mgr.uart_handle)
+  {
+    fw_app_uart_rx_complete();
+    FW_APP_UART_RCV_IT(g_app.proto_mgr.uart_handle, g_app.proto_mgr.rx_buf, 1);
+  }
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (huart == g_app.proto_mgr.uart_handle)
+  {
+    fw_app_uart_tx_complete();
+  }
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  fw_app_i2c_complete(hi2c, FL_OK);
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  fw_app_i2c_complete(hi2c, FL_OK);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  fw_app_i2c_complete(hi2c, FL_ERROR);
+}
+
+// Log records are counted instead of the ITM output(fl_log.c).
+FL_DECLARE(void) fl_log_write(uint16_t fmt_id, uint8_t arg_count, uint32_t a0, uint32_t a1, uint32_t a2)
+{
+  (void)arg_count;
+  (void)a0;
+  (void)a1;
+  (void)a2;
+
+  if (fmt_id < FL_LOG_FMT_COUNT)
+  {
+    g_sim_app_log_count[fmt_id]++;
+  }
+}
+
+FL_DECLARE(void) fl_log_drain(void)
+{
+}
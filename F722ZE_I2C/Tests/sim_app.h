@@ -0,0 +1,43 @@
+// Firmware library host test
+// sim_app.h
+//
+// Firmware application(fw_app.c) on the simulated board(hal_stub.c) : the handles and the HAL
+// callbacks of main.c, a main loop and a host on the message UART.
+
+#ifndef SIM_APP_H
+#define SIM_APP_H
+
+#include "fw_app.h"
+#include "hal_stub.h"
+
+// Longest message line read by the host.
+#define SIM_APP_LINE_SIZE           (FL_TXT_MSG_MAX_BATCH_LENGTH + 1)
+
+// Log records written by the firmware(fl_log_write()), by format ID.
+extern uint32_t g_sim_app_log_count[FL_LOG_FMT_COUNT];
+
+// Power up the board with sensor_count VL6180X sensors on I2C1 and run the boot until the ready event.
+// The configuration flash keeps its contents(hal_stub_flash_erase() before the first boot).
+// Returns FL_ERROR if the ready event is not sent within a second.
+fl_status_t sim_app_boot(uint8_t sensor_count);
+
+// Power up like sim_app_boot() and return at the start of the sensor enumeration(fw_app_boot_start()).
+void sim_app_power_up(uint8_t sensor_count);
+
+// Main loop for time_ms milliseconds(interrupts are handled between the loop iterations).
+void sim_app_run(uint32_t time_ms);
+
+// Send a message to the firmware(bytes at the UART baud rate).
+void sim_app_send(const char* message);
+
+// Next message line sent by the firmware(transmit completed), without the tail. NULL : no line.
+const char* sim_app_read(void);
+
+// Run until a message line starting with prefix is received, NULL on timeout.
+// Lines with other prefixes are skipped.
+const char* sim_app_wait(const char* prefix, uint32_t timeout_ms);
+
+// Send a command and wait for its response(same message name).
+const char* sim_app_command(const char* message, uint32_t timeout_ms);
+
+#endif
@@ -0,0 +1,457 @@
+// Firmware library host test
+// test_bcast.c
+//
+// Broadcast response slots on a multi-drop link : each node runs the firmware on its own simulated
+// board(a child process, sim_app.c), the test process is the shared bus and the host.
+// The nodes run in 1ms lockstep, a transmit of a node is received by the other nodes in the next step.
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "sim_app.h"
+#include "fl_test.h"
+
+#define NODE_MAX                (8)
+
+// Transmits of a node in a step.
+#define STEP_FRAME_MAX          (4)
+
+#define FW_VERSION_STR          "0.2.1"
+
+// A transmit on the bus(time in us since the nodes started).
+typedef struct _frame
+{
+  uint32_t    node;
+  uint64_t    start;
+  uint64_t    end;
+  uint32_t    length;
+  uint8_t     data[FL_TXT_MSG_MAX_BATCH_LENGTH];
+} frame_t;
+
+typedef struct _node
+{
+  pid_t       pid;
+  int         to_node;
+  int         from_node;
+} node_t;
+
+static void write_all(int fd, const void* buf, size_t length)
+{
+  const uint8_t*  p = (const uint8_t*)buf;
+  ssize_t         ret;
+
+  while (length > 0)
+  {
+    ret = write(fd, p, length);
+    if (ret <= 0)
+    {
+      _exit(2);
+    }
+    p += ret;
+    length -= ret;
+  }
+}
+
+static fl_bool_t read_all(int fd, void* buf, size_t length)
+{
+  uint8_t*  p = (uint8_t*)buf;
+  ssize_t   ret;
+
+  while (length > 0)
+  {
+    ret = read(fd, p, length);
+    if (ret <= 0)
+    {
+      return FL_FALSE;
+    }
+    p += ret;
+    length -= ret;
+  }
+
+  return FL_TRUE;
+}
+
+// Configure the device ID and the baud rate of a cleared board, then boot again.
+static fl_status_t boot_node(uint32_t device_id, uint32_t baud_rate)
+{
+  char cmd[FL_TXT_MSG_MAX_LENGTH];
+
+  hal_stub_flash_erase();
+  if (sim_app_boot(1) != FL_OK)
+  {
+    return FL_ERROR;
+  }
+
+  sprintf(cmd, "WCONF 1,%d,%u\n", FL_MSG_CONFIG_BAUD_RATE, baud_rate);
+  if (sim_app_command(cmd, 100) == NULL)
+  {
+    return FL_ERROR;
+  }
+  sprintf(cmd, "WCONF 1,%d,%u\n", FL_MSG_CONFIG_DEVICE_ID, device_id);
+  if (sim_app_command(cmd, 100) == NULL)
+  {
+    return FL_ERROR;
+  }
+
+  return sim_app_boot(1);
+}
+
+// Node process : receive the bus bytes of a step, run 1ms, send the transmits of the step.
+// stretch : clock stretching(us) of the sensor on I2C1, the transfers of the node take longer.
+static void node_main(uint32_t index, uint32_t device_id, uint32_t baud_rate, uint32_t stretch, int rx_fd, int tx_fd)
+{
+  frame_t   frames[STEP_FRAME_MAX];
+  uint8_t   rx[NODE_MAX * STEP_FRAME_MAX * FL_TXT_MSG_MAX_BATCH_LENGTH];
+  uint32_t  rx_length;
+  uint32_t  frame_count;
+  uint32_t  tx_count;
+  uint32_t  tx_length;
+  uint64_t  origin;
+  uint64_t  end;
+
+  if (boot_node(device_id, baud_rate) != FL_OK)
+  {
+    _exit(3);
+  }
+  g_hal_stub.i2c[0].stretch = stretch;
+  g_app.i2c_bus[0].i2c.stretch = FL_I2C_DEFAULT_STRETCH + stretch;
+
+  // Start at a SysTick like the other nodes.
+  while ((g_hal_stub.time % HAL_STUB_SYSTICK_PERIOD) != 0)
+  {
+    fw_app_process();
+    hal_stub_step();
+  }
+  origin = g_hal_stub.time;
+  tx_count = g_hal_stub.tx_count;
+  tx_length = g_hal_stub.tx_length;
+
+  while (read_all(rx_fd, &rx_length, sizeof(rx_length)) == FL_TRUE)
+  {
+    if ((rx_length > sizeof(rx)) || (read_all(rx_fd, rx, rx_length) == FL_FALSE))
+    {
+      _exit(4);
+    }
+    if (rx_length > 0)
+    {
+      hal_stub_uart_receive(rx, rx_length);
+    }
+
+    frame_count = 0;
+    end = g_hal_stub.time + HAL_STUB_SYSTICK_PERIOD;
+    while (g_hal_stub.time < end)
+    {
+      fw_app_process();
+      if ((g_hal_stub.tx_count != tx_count) && (frame_count < STEP_FRAME_MAX))
+      {
+        frames[frame_count].node = index;
+        frames[frame_count].start = g_hal_stub.tx_start_time - origin;
+        frames[frame_count].end = g_hal_stub.tx_done_time - origin;
+        frames[frame_count].length = g_hal_stub.tx_length - tx_length;
+        memcpy(frames[frame_count].data, &g_hal_stub.tx[tx_length], frames[frame_count].length);
+        frame_count++;
+      }
+      tx_count = g_hal_stub.tx_count;
+      tx_length = g_hal_stub.tx_length;
+      hal_stub_step();
+    }
+
+    write_all(tx_fd, &frame_count, sizeof(frame_count));
+    write_all(tx_fd, frames, frame_count * sizeof(frame_t));
+  }
+
+  _exit(0);
+}
+
+static fl_bool_t frames_overlap(const frame_t* a, const frame_t* b)
+{
+  return ((a->start < b->end) && (b->start < a->end)) ? FL_TRUE : FL_FALSE;
+}
+
+// Broadcast a command to node_count nodes(device IDs 1 ~ node_count) and collect every transmit
+// on the bus for time_ms. stretch : I2C clock stretching(us) of each node, NULL : none.
+// Returns the number of frames, -1 if a node failed.
+static int run_bus(uint32_t node_count, uint32_t baud_rate, const uint32_t* stretch, const char* command,
+                   uint32_t time_ms, frame_t* bus, int bus_max)
+{
+  static frame_t  step_frames[NODE_MAX][STEP_FRAME_MAX];
+  static uint8_t  rx[NODE_MAX * STEP_FRAME_MAX * FL_TXT_MSG_MAX_BATCH_LENGTH];
+  node_t          nodes[NODE_MAX];
+  uint32_t        step_count[NODE_MAX];
+  uint32_t        rx_length;
+  uint32_t        byte_time = (10000000 + baud_rate - 1) / baud_rate;
+  int             bus_count = 0;
+  int             status;
+  int             ret = 0;
+  int             to_node[2];
+  int             from_node[2];
+  uint32_t        i;
+  uint32_t        j;
+  uint32_t        k;
+  uint32_t        step;
+
+  // The nodes do not print the buffered test output again.
+  fflush(stdout);
+
+  for (i = 0; i < node_count; i++)
+  {
+    if ((pipe(to_node) != 0) || (pipe(from_node) != 0))
+    {
+      return -1;
+    }
+
+    nodes[i].pid = fork();
+    if (nodes[i].pid == 0)
+    {
+      // Only the test process holds the pipes of the other nodes(end of the bus at the close).
+      for (j = 0; j < i; j++)
+      {
+        close(nodes[j].to_node);
+        close(nodes[j].from_node);
+      }
+      close(to_node[1]);
+      close(from_node[0]);
+      node_main(i, i + 1, baud_rate, (stretch != NULL) ? stretch[i] : 0, to_node[0], from_node[1]);
+    }
+    close(to_node[0]);
+    close(from_node[1]);
+    nodes[i].to_node = to_node[1];
+    nodes[i].from_node = from_node[0];
+  }
+
+  // The host command at step 0.
+  bus[bus_count].node = NODE_MAX;
+  bus[bus_count].start = 0;
+  bus[bus_count].length = strlen(command);
+  bus[bus_count].end = bus[bus_count].length * byte_time;
+  memcpy(bus[bus_count].data, command, bus[bus_count].length);
+  bus_count++;
+
+  memset(step_count, 0, sizeof(step_count));
+  for (step = 0; step < time_ms; step++)
+  {
+    for (i = 0; i < node_count; i++)
+    {
+      // The host command, then the transmits of the other nodes in the last step.
+      rx_length = 0;
+      if (step == 0)
+      {
+        memcpy(rx, command, strlen(command));
+        rx_length = strlen(command);
+      }
+      for (j = 0; j < node_count; j++)
+      {
+        for (k = 0; (j != i) && (k < step_count[j]); k++)
+        {
+          memcpy(&rx[rx_length], step_frames[j][k].data, step_frames[j][k].length);
+          rx_length += step_frames[j][k].length;
+        }
+      }
+      write_all(nodes[i].to_node, &rx_length, sizeof(rx_length));
+      write_all(nodes[i].to_node, rx, rx_length);
+    }
+
+    for (i = 0; i < node_count; i++)
+    {
+      if ((read_all(nodes[i].from_node, &step_count[i], sizeof(step_count[i])) == FL_FALSE) ||
+          (step_count[i] > STEP_FRAME_MAX) ||
+          (read_all(nodes[i].from_node, step_frames[i], step_count[i] * sizeof(frame_t)) == FL_FALSE))
+      {
+        ret = -1;
+        step_count[i] = 0;
+      }
+
+      for (k = 0; (k < step_count[i]) && (bus_count < bus_max); k++)
+      {
+        bus[bus_count++] = step_frames[i][k];
+      }
+    }
+
+    if (ret != 0)
+    {
+      break;
+    }
+  }
+
+  for (i = 0; i < node_count; i++)
+  {
+    close(nodes[i].to_node);
+    close(nodes[i].from_node);
+    if ((waitpid(nodes[i].pid, &status, 0) != nodes[i].pid) ||
+        (WIFEXITED(status) == 0) || (WEXITSTATUS(status) != 0))
+    {
+      ret = -1;
+    }
+  }
+
+  return (ret == 0) ? bus_count : -1;
+}
+
+// Every node answers once in device ID order, no two transmits overlap on the bus.
+static void check_bcast(uint32_t node_count, uint32_t baud_rate)
+{
+  static frame_t  bus[64];
+  char            expected[FL_TXT_MSG_MAX_LENGTH];
+  uint32_t        byte_time = (10000000 + baud_rate - 1) / baud_rate;
+  uint32_t        slot_time;
+  int             count;
+  int             i;
+  int             j;
+
+  slot_time = ((FL_TXT_MSG_MAX_LENGTH * 10 * 1000) + baud_rate - 1) / baud_rate + FW_APP_BCAST_SLOT_GUARD;
+
+  sprintf(expected, "RFVER %u\n", FL_DEVICE_ID_ALL);
+  count = run_bus(node_count, baud_rate, NULL, expected, (node_count * slot_time) + 100, bus, 64);
+  FL_TEST_ASSERT_EQ(node_count + 1, count);
+
+  for (i = 0; i < count; i++)
+  {
+    for (j = i + 1; j < count; j++)
+    {
+      FL_TEST_ASSERT(frames_overlap(&bus[i], &bus[j]) == FL_FALSE);
+    }
+  }
+
+  for (i = 1; i < count; i++)
+  {
+    sprintf(expected, "RFVER %d,0," FW_VERSION_STR "\n", i);
+    FL_TEST_ASSERT_EQ(strlen(expected), bus[i].length);
+    FL_TEST_ASSERT_EQ(0, memcmp(expected, bus[i].data, bus[i].length));
+
+    // In its own slot, a full message of the previous node would end before it.
+    FL_TEST_ASSERT_EQ(i - 1, bus[i].node);
+    if (i > 1)
+    {
+      FL_TEST_ASSERT(bus[i].start >= bus[i - 1].start + (FL_TXT_MSG_MAX_LENGTH * byte_time));
+      FL_TEST_ASSERT(bus[i].start - bus[i - 1].start <= (slot_time * 1000) + 1000);
+    }
+  }
+}
+
+static void test_bcast_115200(void)
+{
+  check_bcast(6, 115200);
+}
+
+// One full message takes about 67ms.
+static void test_bcast_9600(void)
+{
+  check_bcast(3, 9600);
+}
+
+// Broadcast I2C read with a different transfer time on each node : the slots start at the command receipt,
+// a response ready after its slot is dropped instead of colliding with the next node.
+//   Node 1 : ready in its slot(no delay).
+//   Node 2 : ready after 7ms, answered at 8ms(a slot after the handler would collide with node 3).
+//   Node 3 : ready in its slot.
+//   Node 4 : ready after 30ms(the slot of node 4 starts at 24ms), no response.
+static void test_bcast_handler_latency(void)
+{
+  static const uint32_t stretch[] = { 0, 7000, 0, 30000 };
+  static frame_t        bus[64];
+  char                  cmd[FL_TXT_MSG_MAX_LENGTH];
+  uint32_t              baud_rate = 115200;
+  uint32_t              byte_time = (10000000 + baud_rate - 1) / baud_rate;
+  uint32_t              slot_time;
+  uint64_t              rx_time;
+  int                   count;
+  int                   i;
+  int                   j;
+
+  slot_time = ((FL_TXT_MSG_MAX_LENGTH * 10 * 1000) + baud_rate - 1) / baud_rate + FW_APP_BCAST_SLOT_GUARD;
+
+  sprintf(cmd, "RWI2C %u,0,1,%d,0\n", FL_DEVICE_ID_ALL, (FW_APP_SENSOR_BASE_ADDR + 0) << 1);
+  count = run_bus(4, baud_rate, stretch, cmd, 100, bus, 64);
+  FL_TEST_ASSERT_EQ(4, count);
+
+  for (i = 0; i < count; i++)
+  {
+    for (j = i + 1; j < count; j++)
+    {
+      FL_TEST_ASSERT(frames_overlap(&bus[i], &bus[j]) == FL_FALSE);
+    }
+  }
+
+  // The receipt is stamped with the tick of the step receiving the last byte of the command.
+  rx_time = (bus[0].end / 1000) * 1000;
+  for (i = 1; i < count; i++)
+  {
+    // IDENTIFICATION__MODEL_ID(0x000) reads 0xB4.
+    sprintf(cmd, "RWI2C %d,0,0,1,%d,0,180\n", (i < 3) ? i : 3, (FW_APP_SENSOR_BASE_ADDR + 0) << 1);
+    FL_TEST_ASSERT_EQ(strlen(cmd), bus[i].length);
+    FL_TEST_ASSERT_EQ(0, memcmp(cmd, bus[i].data, bus[i].length));
+  }
+  FL_TEST_ASSERT_EQ(0, bus[1].node);
+  FL_TEST_ASSERT_EQ(1, bus[2].node);
+  FL_TEST_ASSERT_EQ(2, bus[3].node);
+  for (i = 1; i < count; i++)
+  {
+    uint64_t slot_start = rx_time + (bus[i].node * slot_time * 1000);
+
+    FL_TEST_ASSERT(bus[i].start >= slot_start);
+    FL_TEST_ASSERT(bus[i].start <= slot_start + ((FW_APP_BCAST_LATE_MAX + 1) * 1000));
+  }
+  FL_TEST_ASSERT(bus[2].start < bus[3].start - (FL_TXT_MSG_MAX_LENGTH * byte_time));
+}
+
+// Device IDs are limited to the broadcast slots.
+static void test_device_id_limit(void)
+{
+  char        cmd[FL_TXT_MSG_MAX_LENGTH];
+  const char* resp;
+
+  hal_stub_flash_erase();
+  FL_TEST_ASSERT_EQ(FL_OK, sim_app_boot(1));
+
+  sprintf(cmd, "WCONF 1,%d,%d\n", FL_MSG_CONFIG_DEVICE_ID, FW_APP_MAX_NODE_COUNT + 1);
+  resp = sim_app_command(cmd, 100);
+  FL_TEST_ASSERT(resp != NULL);
+  FL_TEST_ASSERT_EQ(0, strcmp(resp, "WCONF 1,1"));
+
+  sprintf(cmd, "WCONF 1,%d,%u\n", FL_MSG_CONFIG_DEVICE_ID, FL_DEVICE_ID_ALL);
+  resp = sim_app_command(cmd, 100);
+  FL_TEST_ASSERT(resp != NULL);
+  FL_TEST_ASSERT_EQ(0, strcmp(resp, "WCONF 1,1"));
+
+  sprintf(cmd, "WCONF 1,%d,%d\n", FL_MSG_CONFIG_DEVICE_ID, FW_APP_MAX_NODE_COUNT);
+  resp = sim_app_command(cmd, 100);
+  FL_TEST_ASSERT(resp != NULL);
+  FL_TEST_ASSERT_EQ(0, strcmp(resp, "WCONF 1,0"));
+}
+
+// A device ID stored before the limit : no broadcast response, unicast commands still work.
+static void test_stored_id_without_slot(void)
+{
+  uint32_t    device_id = FW_APP_MAX_NODE_COUNT + 8;
+  char        cmd[FL_TXT_MSG_MAX_LENGTH];
+  const char* resp;
+
+  hal_stub_flash_erase();
+  FL_TEST_ASSERT_EQ(FL_OK, sim_app_boot(1));
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_write(&g_app.config.log, FW_APP_CONFIG_KEY_DEVICE_ID,
+                                              &device_id, sizeof(device_id)));
+  FL_TEST_ASSERT_EQ(FL_OK, sim_app_boot(1));
+  FL_TEST_ASSERT_EQ(device_id, g_app.device_id);
+
+  sprintf(cmd, "RFVER %u\n", FL_DEVICE_ID_ALL);
+  FL_TEST_ASSERT(sim_app_command(cmd, 200) == NULL);
+  FL_TEST_ASSERT_EQ(1, g_sim_app_log_count[FL_LOG_BCAST_NO_SLOT]);
+
+  sprintf(cmd, "RFVER %u\n", device_id);
+  resp = sim_app_command(cmd, 100);
+  FL_TEST_ASSERT(resp != NULL);
+  sprintf(cmd, "RFVER %u,0," FW_VERSION_STR, device_id);
+  FL_TEST_ASSERT_EQ(0, strcmp(resp, cmd));
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_bcast_115200);
+  FL_TEST_RUN(test_bcast_9600);
+  FL_TEST_RUN(test_bcast_handler_latency);
+  FL_TEST_RUN(test_device_id_limit);
+  FL_TEST_RUN(test_stored_id_without_slot);
+
+  return FL_TEST_RESULT();
+}
@@ -0,0 +1,126 @@
+// Firmware library host test
+// test_boot.c
+//
+// Staged boot on the simulated board(sim_app.c) : the sensors are enumerated in scheduler timer steps
+// (on_boot_timer()) while the message receive runs, the ready event reports the sensors found and
+// commands using the I2C buses are refused(FL_I2C_ERR_BUS) until then.
+
+#include <string.h>
+#include "sim_app.h"
+#include "i2c.h"
+#include "fl_test.h"
+
+#define COMMAND_TIMEOUT         (5)     // ms
+
+// Last sensor step of the enumeration(standby time, then one boot time per sensor).
+#define READY_TIME              (FW_APP_SENSOR_STANDBY_TIME + (FW_APP_SENSOR_COUNT * FW_APP_SENSOR_BOOT_TIME))
+
+// "EREDY id,sensor_mask,tick"
+typedef struct _eredy
+{
+  uint32_t  device_id;
+  uint32_t  sensor_mask;
+  uint32_t  tick;
+} eredy_t;
+
+static fl_status_t wait_ready(eredy_t* eredy)
+{
+  const char* event = sim_app_wait(fl_txt_msg_get_message_name(FL_MSG_ID_READY_EVENT), 1000);
+
+  memset(eredy, 0, sizeof(eredy_t));
+  if ((event == NULL) ||
+      (sscanf(event, "EREDY %u,%u,%u", &eredy->device_id, &eredy->sensor_mask, &eredy->tick) != 3))
+  {
+    return FL_ERROR;
+  }
+
+  return FL_OK;
+}
+
+// Each sensor is moved to its own address, then the ready event is sent once.
+static void test_enumeration(void)
+{
+  eredy_t eredy;
+  uint8_t i;
+
+  hal_stub_flash_erase();
+  sim_app_power_up(3);
+  FL_TEST_ASSERT_EQ(FL_FALSE, g_app.ready);
+
+  FL_TEST_ASSERT_EQ(FL_OK, wait_ready(&eredy));
+  FL_TEST_ASSERT_EQ(FL_TRUE, g_app.ready);
+  FL_TEST_ASSERT_EQ(1, eredy.device_id);
+  FL_TEST_ASSERT_EQ(0x07, eredy.sensor_mask);
+  FL_TEST_ASSERT_EQ(0x07, g_app.sensor_mask);
+  FL_TEST_ASSERT(eredy.tick >= READY_TIME);
+  FL_TEST_ASSERT(eredy.tick <= READY_TIME + 1);
+  FL_TEST_ASSERT_EQ(1, g_sim_app_log_count[FL_LOG_BOOT_READY]);
+
+  FL_TEST_ASSERT(hal_stub_find_device(&hi2c1, FW_APP_SENSOR_DEFAULT_ADDR) == NULL);
+  for (i = 0; i < 3; i++)
+  {
+    FL_TEST_ASSERT(hal_stub_find_device(&hi2c1, FW_APP_SENSOR_BASE_ADDR + i) != NULL);
+    FL_TEST_ASSERT_EQ((FW_APP_SENSOR_BASE_ADDR + i) << 1, g_app.sensors[i].vl6180x.dev_addr);
+  }
+
+  // No second event.
+  sim_app_run(100);
+  FL_TEST_ASSERT(sim_app_read() == NULL);
+  FL_TEST_ASSERT_EQ(1, g_sim_app_log_count[FL_LOG_BOOT_READY]);
+}
+
+// A missing sensor is left out of the mask, the enumeration goes on to the end.
+static void test_missing_sensor(void)
+{
+  eredy_t eredy;
+
+  hal_stub_flash_erase();
+  sim_app_power_up(2);
+
+  FL_TEST_ASSERT_EQ(FL_OK, wait_ready(&eredy));
+  FL_TEST_ASSERT_EQ(0x03, eredy.sensor_mask);
+  FL_TEST_ASSERT(eredy.tick >= READY_TIME);
+  FL_TEST_ASSERT_EQ(0, g_app.sensors[2].vl6180x.dev_addr);
+}
+
+// The commands are parsed during the enumeration, the I2C ones are refused until the ready event.
+static void test_i2c_refused_before_ready(void)
+{
+  eredy_t     eredy;
+  const char* resp;
+
+  hal_stub_flash_erase();
+  sim_app_power_up(1);
+
+  resp = sim_app_command("RWI2C 1,0,1,96,0\n", COMMAND_TIMEOUT);
+  FL_TEST_ASSERT(resp != NULL);
+  FL_TEST_ASSERT_EQ(0, strcmp(resp, "RWI2C 1,6"));
+  FL_TEST_ASSERT_EQ(FL_FALSE, g_app.ready);
+
+  resp = sim_app_command("WBITS 1,1,96,25,15,1\n", COMMAND_TIMEOUT);
+  FL_TEST_ASSERT(resp != NULL);
+  FL_TEST_ASSERT_EQ(0, strcmp(resp, "WBITS 1,6"));
+
+  // Commands without I2C transfers are answered.
+  resp = sim_app_command("RFVER 1\n", COMMAND_TIMEOUT);
+  FL_TEST_ASSERT(resp != NULL);
+  FL_TEST_ASSERT(strncmp(resp, "RFVER 1,0,", 10) == 0);
+  FL_TEST_ASSERT_EQ(FL_FALSE, g_app.ready);
+
+  FL_TEST_ASSERT_EQ(FL_OK, wait_ready(&eredy));
+  FL_TEST_ASSERT_EQ(0x01, eredy.sensor_mask);
+
+  // Model ID register(0x0000).
+  resp = sim_app_command("RWI2C 1,0,1,96,0\n", COMMAND_TIMEOUT);
+  FL_TEST_ASSERT(resp != NULL);
+  FL_TEST_ASSERT_EQ(0, strcmp(resp, "RWI2C 1,0,0,1,96,0,180"));
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_enumeration);
+  FL_TEST_RUN(test_missing_sensor);
+  FL_TEST_RUN(test_i2c_refused_before_ready);
+
+  return FL_TEST_RESULT();
+}
@@ -0,0 +1,341 @@
+// Firmware library host test
+// test_capture.c
+//
+// Capture mode end to end on the simulated board(sim_app.c) : WCAPT starts the sampling timer
+// (on_capture_timer()), the samples are read by interrupt mode transfers into the capture ring,
+// ECAPT reports the watermark and RCAPT drains the ring in batches(capture_build_batch()).
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim_app.h"
+#include "i2c.h"
+#include "fl_test.h"
+
+// Sensor 0 after the boot enumeration(8-bit address).
+#define SENSOR_ADDR             ((FW_APP_SENSOR_BASE_ADDR + 0) << 1)
+
+#define COMMAND_TIMEOUT         (100)   // ms
+
+// RCAPT response.
+typedef struct _rcapt
+{
+  uint32_t            device_id;
+  int                 result;
+  uint32_t            remaining;
+  uint32_t            overrun;
+  uint32_t            count;
+  fl_capture_sample_t samples[FW_APP_CAPTURE_BATCH_SIZE];
+} rcapt_t;
+
+static fl_status_t start_capture(uint32_t period, uint32_t watermark)
+{
+  char        cmd[FL_TXT_MSG_MAX_LENGTH];
+  const char* resp;
+
+  sprintf(cmd, "WCAPT 1,%d,1,%d,%u,%u\n", FL_MSG_CAPTURE_START, SENSOR_ADDR, period, watermark);
+  resp = sim_app_command(cmd, COMMAND_TIMEOUT);
+
+  return ((resp != NULL) && (strcmp(resp, "WCAPT 1,0") == 0)) ? FL_OK : FL_ERROR;
+}
+
+static fl_status_t stop_capture(void)
+{
+  const char* resp = sim_app_command("WCAPT 1,0,1,0,0,0\n", COMMAND_TIMEOUT);
+
+  return ((resp != NULL) && (strcmp(resp, "WCAPT 1,0") == 0)) ? FL_OK : FL_ERROR;
+}
+
+// "RCAPT id,result,remaining,overrun,count[,base64]"
+static fl_status_t read_capture(uint32_t max_count, rcapt_t* rcapt)
+{
+  char        cmd[FL_TXT_MSG_MAX_LENGTH];
+  char        samples[FL_TXT_MSG_MAX_BATCH_LENGTH];
+  const char* resp;
+  const char* base64;
+  int         length;
+
+  memset(rcapt, 0, sizeof(rcapt_t));
+  sprintf(cmd, "RCAPT 1,%u\n", max_count);
+  resp = sim_app_command(cmd, COMMAND_TIMEOUT);
+  if ((resp == NULL) ||
+      (sscanf(resp, "RCAPT %u,%d,%u,%u,%u", &rcapt->device_id, &rcapt->result,
+              &rcapt->remaining, &rcapt->overrun, &rcapt->count) != 5) ||
+      (rcapt->count > FW_APP_CAPTURE_BATCH_SIZE))
+  {
+    return FL_ERROR;
+  }
+
+  if (rcapt->count == 0)
+  {
+    return FL_OK;
+  }
+
+  base64 = strrchr(resp, FL_TXT_MSG_ARG_DELIMITER);
+  if ((base64 == NULL) || (strlen(base64 + 1) >= sizeof(samples)))
+  {
+    return FL_ERROR;
+  }
+  strcpy(samples, base64 + 1);
+  length = fl_base64_decode((char*)rcapt->samples, samples);
+
+  return (length == (int)(rcapt->count * sizeof(fl_capture_sample_t))) ? FL_OK : FL_ERROR;
+}
+
+// Boot with one sensor and a cleared configuration(device ID 1).
+static fl_status_t boot(void)
+{
+  hal_stub_flash_erase();
+
+  return sim_app_boot(1);
+}
+
+static void test_boot_ready(void)
+{
+  FL_TEST_ASSERT_EQ(FL_OK, boot());
+  FL_TEST_ASSERT_EQ(1, g_app.device_id);
+  FL_TEST_ASSERT_EQ(0x01, g_app.sensor_mask);
+  FL_TEST_ASSERT(hal_stub_find_device(&hi2c1, FW_APP_SENSOR_BASE_ADDR) != NULL);
+}
+
+// Samples are stored in order, one per period while the bus keeps up.
+static void test_samples_in_order(void)
+{
+  rcapt_t   rcapt;
+  uint32_t  total = 0;
+  uint32_t  remaining;
+  uint32_t  last_timestamp = 0;
+  uint8_t   last_range = 0;
+  uint32_t  i;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot());
+  FL_TEST_ASSERT_EQ(FL_OK, start_capture(1, 0));
+  sim_app_run(100);
+  FL_TEST_ASSERT_EQ(FL_OK, stop_capture());
+
+  remaining = fl_ring_count(&g_app.capture.ring);
+  FL_TEST_ASSERT(remaining >= 99);
+
+  do
+  {
+    FL_TEST_ASSERT_EQ(FL_OK, read_capture(0, &rcapt));
+    FL_TEST_ASSERT_EQ(FL_OK, rcapt.result);
+    FL_TEST_ASSERT_EQ(0, rcapt.overrun);
+    FL_TEST_ASSERT_EQ((remaining < FW_APP_CAPTURE_BATCH_SIZE) ? remaining : FW_APP_CAPTURE_BATCH_SIZE, rcapt.count);
+    FL_TEST_ASSERT_EQ(remaining - rcapt.count, rcapt.remaining);
+    remaining = rcapt.remaining;
+
+    for (i = 0; i < rcapt.count; i++, total++)
+    {
+      if (total > 0)
+      {
+        FL_TEST_ASSERT_EQ(last_timestamp + 1, rcapt.samples[i].timestamp);
+        FL_TEST_ASSERT_EQ((uint8_t)(last_range + 1), rcapt.samples[i].range);
+      }
+      FL_TEST_ASSERT_EQ(0, rcapt.samples[i].range_status);
+      last_timestamp = rcapt.samples[i].timestamp;
+      last_range = rcapt.samples[i].range;
+    }
+  } while (remaining > 0);
+
+  FL_TEST_ASSERT(total >= 99);
+
+  // The ring is empty.
+  FL_TEST_ASSERT_EQ(FL_OK, read_capture(0, &rcapt));
+  FL_TEST_ASSERT_EQ(0, rcapt.count);
+  FL_TEST_ASSERT_EQ(0, rcapt.remaining);
+}
+
+// max_count limits a batch, 0 or a larger count is FW_APP_CAPTURE_BATCH_SIZE.
+static void test_batch_size(void)
+{
+  rcapt_t   rcapt;
+  uint32_t  remaining;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot());
+  FL_TEST_ASSERT_EQ(FL_OK, start_capture(1, 0));
+  sim_app_run(200);
+  FL_TEST_ASSERT_EQ(FL_OK, stop_capture());
+  remaining = fl_ring_count(&g_app.capture.ring);
+
+  FL_TEST_ASSERT_EQ(FL_OK, read_capture(5, &rcapt));
+  FL_TEST_ASSERT_EQ(5, rcapt.count);
+  FL_TEST_ASSERT_EQ(remaining - 5, rcapt.remaining);
+
+  FL_TEST_ASSERT_EQ(FL_OK, read_capture(FW_APP_CAPTURE_BATCH_SIZE + 1, &rcapt));
+  FL_TEST_ASSERT_EQ(FW_APP_CAPTURE_BATCH_SIZE, rcapt.count);
+
+  FL_TEST_ASSERT_EQ(FL_OK, read_capture(0, &rcapt));
+  FL_TEST_ASSERT_EQ(FW_APP_CAPTURE_BATCH_SIZE, rcapt.count);
+  FL_TEST_ASSERT_EQ(remaining - 5 - (2 * FW_APP_CAPTURE_BATCH_SIZE), rcapt.remaining);
+
+  // A full batch fits into a response.
+  FL_TEST_ASSERT(g_app.proto_mgr.out_length <= FL_TXT_MSG_MAX_BATCH_LENGTH);
+}
+
+// ECAPT is sent once at the watermark and again after the host has drained below it.
+// 2ms period : a full RCAPT batch takes about 33ms at 115200bps, the host drains about 970 samples/s.
+static void test_watermark_event(void)
+{
+  rcapt_t     rcapt;
+  const char* evt;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot());
+  FL_TEST_ASSERT_EQ(FL_OK, start_capture(2, 40));
+
+  evt = sim_app_wait("ECAPT ", 100);
+  FL_TEST_ASSERT(evt != NULL);
+  FL_TEST_ASSERT_EQ(0, strcmp(evt, "ECAPT 1,40"));
+
+  // Not sent again above the watermark.
+  FL_TEST_ASSERT(sim_app_wait("ECAPT ", 100) == NULL);
+  FL_TEST_ASSERT(fl_ring_count(&g_app.capture.ring) > 80);
+
+  // Still above the watermark after one batch.
+  FL_TEST_ASSERT_EQ(FL_OK, read_capture(0, &rcapt));
+  FL_TEST_ASSERT(rcapt.remaining >= 40);
+  FL_TEST_ASSERT(sim_app_wait("ECAPT ", 5) == NULL);
+
+  // Drained below the watermark : re-armed.
+  do
+  {
+    FL_TEST_ASSERT_EQ(FL_OK, read_capture(0, &rcapt));
+  } while (rcapt.remaining >= 40);
+  evt = sim_app_wait("ECAPT ", 100);
+  FL_TEST_ASSERT(evt != NULL);
+  FL_TEST_ASSERT_EQ(0, strcmp(evt, "ECAPT 1,40"));
+
+  FL_TEST_ASSERT_EQ(FL_OK, stop_capture());
+}
+
+// A host draining at each watermark event receives every sample once, in order.
+static void test_drain_at_watermark(void)
+{
+  rcapt_t   rcapt;
+  uint64_t  end;
+  uint32_t  total = 0;
+  uint32_t  last_timestamp = 0;
+  uint32_t  i;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot());
+  FL_TEST_ASSERT_EQ(FL_OK, start_capture(2, 64));
+
+  end = g_hal_stub.time + 2000000;
+  while (g_hal_stub.time < end)
+  {
+    FL_TEST_ASSERT(sim_app_wait("ECAPT ", 200) != NULL);
+    do
+    {
+      FL_TEST_ASSERT_EQ(FL_OK, read_capture(0, &rcapt));
+      FL_TEST_ASSERT_EQ(0, rcapt.overrun);
+      for (i = 0; i < rcapt.count; i++, total++)
+      {
+        if (total > 0)
+        {
+          FL_TEST_ASSERT_EQ(last_timestamp + 2, rcapt.samples[i].timestamp);
+        }
+        last_timestamp = rcapt.samples[i].timestamp;
+      }
+    } while (rcapt.remaining > 0);
+  }
+
+  FL_TEST_ASSERT_EQ(FL_OK, stop_capture());
+  FL_TEST_ASSERT(total >= 950);
+}
+
+// A full ring keeps the oldest samples, the dropped samples are reported once in a RCAPT response.
+static void test_overflow(void)
+{
+  rcapt_t   rcapt;
+  uint32_t  start_tick;
+  uint32_t  stop_tick;
+  uint32_t  first_timestamp;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot());
+  FL_TEST_ASSERT_EQ(FL_OK, start_capture(1, 0));
+  start_tick = g_hal_stub.tick;
+  sim_app_run(FW_APP_CAPTURE_RING_SIZE + 500);
+  FL_TEST_ASSERT_EQ(FL_OK, stop_capture());
+  stop_tick = g_hal_stub.tick;
+
+  FL_TEST_ASSERT_EQ(FW_APP_CAPTURE_RING_SIZE, fl_ring_count(&g_app.capture.ring));
+
+  FL_TEST_ASSERT_EQ(FL_OK, read_capture(0, &rcapt));
+  FL_TEST_ASSERT_EQ(FW_APP_CAPTURE_BATCH_SIZE, rcapt.count);
+  FL_TEST_ASSERT_EQ(FW_APP_CAPTURE_RING_SIZE - FW_APP_CAPTURE_BATCH_SIZE, rcapt.remaining);
+
+  // One sample for each period between the start and the stop.
+  first_timestamp = rcapt.samples[0].timestamp;
+  FL_TEST_ASSERT(first_timestamp <= (start_tick + 1));
+  FL_TEST_ASSERT(abs((int)(FW_APP_CAPTURE_RING_SIZE + rcapt.overrun) - (int)(stop_tick - first_timestamp)) <= 1);
+
+  // Reported once.
+  FL_TEST_ASSERT_EQ(FL_OK, read_capture(0, &rcapt));
+  FL_TEST_ASSERT_EQ(0, rcapt.overrun);
+  FL_TEST_ASSERT_EQ(FW_APP_CAPTURE_RING_SIZE - (2 * FW_APP_CAPTURE_BATCH_SIZE), rcapt.remaining);
+}
+
+// A bus slower than the sampling period skips samples instead of queueing them.
+static void test_slow_bus_skips_samples(void)
+{
+  rcapt_t   rcapt;
+  uint32_t  transfers;
+  uint32_t  i;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot());
+
+  // 4 transfers of a sample take more than 2ms, a sample every 3ms.
+  g_hal_stub.i2c[0].stretch = 600;
+  transfers = g_hal_stub.i2c[0].xfer_count;
+  FL_TEST_ASSERT_EQ(FL_OK, start_capture(1, 0));
+  sim_app_run(100);
+  FL_TEST_ASSERT_EQ(FL_OK, stop_capture());
+  sim_app_run(10);
+
+  // Transfers of the stored samples and of the sample in progress at the stop, nothing queued.
+  FL_TEST_ASSERT(fl_ring_count(&g_app.capture.ring) <= 34);
+  FL_TEST_ASSERT(g_hal_stub.i2c[0].xfer_count - transfers <= 4 * (fl_ring_count(&g_app.capture.ring) + 1));
+  FL_TEST_ASSERT_EQ(0, g_app.i2c_bus[0].count);
+
+  FL_TEST_ASSERT_EQ(FL_OK, read_capture(0, &rcapt));
+  FL_TEST_ASSERT(rcapt.count > 0);
+  for (i = 1; i < rcapt.count; i++)
+  {
+    FL_TEST_ASSERT_EQ(rcapt.samples[0].timestamp + (i * 3), rcapt.samples[i].timestamp);
+  }
+}
+
+// Samples are kept after a stop, a new start clears them.
+static void test_stop_keeps_samples(void)
+{
+  rcapt_t   rcapt;
+  uint32_t  count;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot());
+  FL_TEST_ASSERT_EQ(FL_OK, start_capture(2, 0));
+  sim_app_run(50);
+  FL_TEST_ASSERT_EQ(FL_OK, stop_capture());
+  count = fl_ring_count(&g_app.capture.ring);
+  FL_TEST_ASSERT(count >= 24);
+
+  sim_app_run(50);
+  FL_TEST_ASSERT_EQ(FL_OK, read_capture(1, &rcapt));
+  FL_TEST_ASSERT_EQ(count - 1, rcapt.remaining);
+
+  FL_TEST_ASSERT_EQ(FL_OK, start_capture(2, 0));
+  FL_TEST_ASSERT(fl_ring_count(&g_app.capture.ring) <= 1);
+  FL_TEST_ASSERT_EQ(FL_OK, stop_capture());
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_boot_ready);
+  FL_TEST_RUN(test_samples_in_order);
+  FL_TEST_RUN(test_batch_size);
+  FL_TEST_RUN(test_watermark_event);
+  FL_TEST_RUN(test_drain_at_watermark);
+  FL_TEST_RUN(test_overflow);
+  FL_TEST_RUN(test_slow_bus_skips_samples);
+  FL_TEST_RUN(test_stop_keeps_samples);
+
+  return FL_TEST_RESULT();
+}
@@ -0,0 +1,394 @@
+// Firmware library host test
+// test_flash_log.c
+//
+// fl_flash_log on the RAM backed configuration sectors(hal_stub.c) : records and compactions cut by a reset
+// (g_hal_stub.flash_program_limit), the sector selection at mount, a full log and delete records.
+// The register init profiles(WPROF begin, add, save) are stored and applied at the next boot(sim_app.c).
+
+#include <stdlib.h>
+#include <string.h>
+#include "sim_app.h"
+#include "i2c.h"
+#include "fl_test.h"
+
+// Sensor 0 after the boot enumeration(8-bit address).
+#define SENSOR_ADDR             ((FW_APP_SENSOR_BASE_ADDR + 0) << 1)
+
+#define COMMAND_TIMEOUT         (100)   // ms
+
+// Record data filling the sector quickly.
+#define FILL_LENGTH             (256)
+
+#define LARGE_LENGTH            (65000)
+
+static fl_flash_log_t _log;
+static uint8_t        _large[LARGE_LENGTH];
+
+// Mount the log on the sectors of the configuration(fw_app_config_load()).
+static fl_status_t mount(void)
+{
+  memset(&_log, 0, sizeof(_log));
+  _log.sectors[0] = FW_APP_CONFIG_SECTOR_A;
+  _log.sectors[1] = FW_APP_CONFIG_SECTOR_B;
+  _log.addrs[0] = FW_APP_CONFIG_ADDR_A;
+  _log.addrs[1] = FW_APP_CONFIG_ADDR_B;
+  _log.sector_size = FW_APP_CONFIG_SECTOR_SIZE;
+
+  return fl_flash_log_init(&_log);
+}
+
+// A reset : the flash keeps its contents and the log is mounted again.
+static fl_status_t reset(void)
+{
+  g_hal_stub.flash_program_limit = 0;
+
+  return mount();
+}
+
+// Erased sectors and a formatted log.
+static fl_status_t setup(void)
+{
+  hal_stub_reset();
+  hal_stub_flash_erase();
+
+  return mount();
+}
+
+// Stop programming after words more flash words.
+static void cut_after(uint32_t words)
+{
+  g_hal_stub.flash_program_limit = g_hal_stub.flash_program_count + words;
+}
+
+static uint32_t read_u32(uint16_t key)
+{
+  uint32_t value = 0;
+
+  if (fl_flash_log_read(&_log, key, &value, sizeof(value), NULL) != FL_OK)
+  {
+    return 0;
+  }
+
+  return value;
+}
+
+static fl_status_t write_u32(uint16_t key, uint32_t value)
+{
+  return fl_flash_log_write(&_log, key, &value, sizeof(value));
+}
+
+// Append FILL_LENGTH records of key until the active sector is compacted.
+static fl_status_t fill_until_compaction(uint16_t key)
+{
+  uint8_t     data[FILL_LENGTH];
+  uint32_t    seq = _log.seq;
+  uint32_t    i;
+  fl_status_t ret;
+
+  for (i = 0; _log.seq == seq; i++)
+  {
+    memset(data, (uint8_t)i, sizeof(data));
+    if ((ret = fl_flash_log_write(&_log, key, data, sizeof(data))) != FL_OK)
+    {
+      return ret;
+    }
+  }
+
+  return FL_OK;
+}
+
+// FILL_LENGTH records the active sector still takes before the next write compacts it.
+static uint32_t fill_room(void)
+{
+  uint32_t end = _log.addrs[_log.active] + _log.sector_size;
+  uint32_t size = sizeof(fl_flash_log_record_t) + FILL_LENGTH;
+
+  return (end - _log.write_addr) / size;
+}
+
+// Records of key in a sector.
+static uint32_t count_records(uint8_t sector, uint16_t key)
+{
+  const fl_flash_log_record_t*  rec;
+  uint32_t                      addr = _log.addrs[sector] + sizeof(fl_flash_log_sector_t);
+  uint32_t                      end = _log.addrs[sector] + _log.sector_size;
+  uint32_t                      count = 0;
+
+  while ((addr + sizeof(fl_flash_log_record_t)) <= end)
+  {
+    rec = (const fl_flash_log_record_t*)addr;
+    if (rec->key == 0xFFFF)
+    {
+      break;
+    }
+    if (rec->key == key)
+    {
+      count++;
+    }
+    addr += sizeof(fl_flash_log_record_t) + ((rec->length + 3) & ~3);
+  }
+
+  return count;
+}
+
+static const fl_flash_log_sector_t* sector_header(uint8_t sector)
+{
+  return (const fl_flash_log_sector_t*)_log.addrs[sector];
+}
+
+// A blank flash is formatted into sector 0, the values survive a reset.
+static void test_format_and_mount(void)
+{
+  FL_TEST_ASSERT_EQ(FL_OK, setup());
+  FL_TEST_ASSERT_EQ(0, _log.active);
+  FL_TEST_ASSERT_EQ(1, _log.seq);
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_MAGIC, sector_header(0)->magic);
+
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(1, 0x11111111));
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(2, 0x22222222));
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(1, 0x33333333));
+
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(0x33333333, read_u32(1));
+  FL_TEST_ASSERT_EQ(0x22222222, read_u32(2));
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_ERR_NOT_FOUND, fl_flash_log_read(&_log, 3, NULL, 0, NULL));
+}
+
+// Reset after the record header : the data fails its CRC, the previous value is kept and
+// the records after it are still found.
+static void test_record_cut_after_header(void)
+{
+  FL_TEST_ASSERT_EQ(FL_OK, setup());
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(1, 0x11111111));
+
+  cut_after(sizeof(fl_flash_log_record_t) / 4);
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_ERR_FLASH, write_u32(1, 0x22222222));
+
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(0x11111111, read_u32(1));
+
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(2, 0x33333333));
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(0x11111111, read_u32(1));
+  FL_TEST_ASSERT_EQ(0x33333333, read_u32(2));
+  FL_TEST_ASSERT_EQ(1, _log.seq);
+}
+
+// Reset in the middle of the record header : the records end there, the next write compacts
+// the sector(latest values only) into the other one.
+static void test_record_cut_in_header(void)
+{
+  FL_TEST_ASSERT_EQ(FL_OK, setup());
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(1, 0x11111111));
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(2, 0x22222222));
+
+  cut_after(1);
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_ERR_FLASH, write_u32(1, 0x33333333));
+
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(0x11111111, read_u32(1));
+  FL_TEST_ASSERT_EQ(0x22222222, read_u32(2));
+  FL_TEST_ASSERT_EQ(_log.addrs[0] + _log.sector_size, _log.write_addr);
+
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(1, 0x44444444));
+  FL_TEST_ASSERT_EQ(1, _log.active);
+  FL_TEST_ASSERT_EQ(2, _log.seq);
+
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(1, _log.active);
+  FL_TEST_ASSERT_EQ(0x44444444, read_u32(1));
+  FL_TEST_ASSERT_EQ(0x22222222, read_u32(2));
+}
+
+// The old sector is not erased after a compaction : both sectors are valid and the higher sequence
+// number is active, in both directions of the swap.
+static void test_both_sectors_valid(void)
+{
+  FL_TEST_ASSERT_EQ(FL_OK, setup());
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(1, 0x11111111));
+
+  FL_TEST_ASSERT_EQ(FL_OK, fill_until_compaction(0));
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_MAGIC, sector_header(0)->magic);
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_MAGIC, sector_header(1)->magic);
+  FL_TEST_ASSERT_EQ(1, sector_header(0)->seq);
+  FL_TEST_ASSERT_EQ(2, sector_header(1)->seq);
+
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(1, _log.active);
+  FL_TEST_ASSERT_EQ(0x11111111, read_u32(1));
+
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(1, 0x22222222));
+  FL_TEST_ASSERT_EQ(FL_OK, fill_until_compaction(0));
+  FL_TEST_ASSERT_EQ(3, sector_header(0)->seq);
+  FL_TEST_ASSERT_EQ(2, sector_header(1)->seq);
+
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(0, _log.active);
+  FL_TEST_ASSERT_EQ(3, _log.seq);
+  FL_TEST_ASSERT_EQ(0x22222222, read_u32(1));
+  FL_TEST_ASSERT_EQ(3, g_hal_stub.flash_erase_count);
+}
+
+// Reset before the magic of the compacted sector : the old sector stays active with every value.
+static void test_compaction_cut(void)
+{
+  uint8_t data[FILL_LENGTH];
+
+  FL_TEST_ASSERT_EQ(FL_OK, setup());
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(1, 0x11111111));
+  memset(data, 0x5A, sizeof(data));
+  while (fill_room() > 0)
+  {
+    FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_write(&_log, 0, data, sizeof(data)));
+  }
+
+  // The copy of the first record is cut.
+  cut_after(2);
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_ERR_FLASH, fl_flash_log_write(&_log, 2, data, sizeof(data)));
+
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(0, _log.active);
+  FL_TEST_ASSERT_EQ(1, _log.seq);
+  FL_TEST_ASSERT_EQ(0x11111111, read_u32(1));
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_read(&_log, 0, data, sizeof(data), NULL));
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_ERR_NOT_FOUND, fl_flash_log_read(&_log, 2, data, sizeof(data), NULL));
+
+  // The next write compacts again.
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_write(&_log, 2, data, sizeof(data)));
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(1, _log.active);
+  FL_TEST_ASSERT_EQ(0x11111111, read_u32(1));
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_read(&_log, 2, data, sizeof(data), NULL));
+}
+
+// A record not fitting with the latest records of the other keys is rejected, the key keeps its value.
+static void test_full_keeps_old_value(void)
+{
+  uint16_t length;
+
+  FL_TEST_ASSERT_EQ(FL_OK, setup());
+  memset(_large, 0xA5, sizeof(_large));
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_write(&_log, 0, _large, LARGE_LENGTH));
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_write(&_log, 2, _large, 10000));
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(1, 0x11111111));
+
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_ERR_FULL, fl_flash_log_write(&_log, 1, _large, LARGE_LENGTH));
+  FL_TEST_ASSERT_EQ(0x11111111, read_u32(1));
+  // No compaction was started(the format erase only).
+  FL_TEST_ASSERT_EQ(1, g_hal_stub.flash_erase_count);
+
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(0x11111111, read_u32(1));
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_read(&_log, 0, _large, sizeof(_large), &length));
+  FL_TEST_ASSERT_EQ(LARGE_LENGTH, length);
+
+  // Room is made by deleting a key(its record is not copied).
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_delete(&_log, 2));
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_write(&_log, 1, _large, LARGE_LENGTH));
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_read(&_log, 1, _large, sizeof(_large), &length));
+  FL_TEST_ASSERT_EQ(LARGE_LENGTH, length);
+}
+
+// A delete appends an empty record, the compaction copies neither the deleted value nor the empty record.
+static void test_delete_dropped_by_compaction(void)
+{
+  FL_TEST_ASSERT_EQ(FL_OK, setup());
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(3, 0x33333333));
+  FL_TEST_ASSERT_EQ(FL_OK, write_u32(4, 0x44444444));
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_delete(&_log, 3));
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_ERR_NOT_FOUND, fl_flash_log_read(&_log, 3, NULL, 0, NULL));
+  FL_TEST_ASSERT_EQ(2, count_records(0, 3));
+
+  // Deleting a deleted key appends nothing.
+  FL_TEST_ASSERT_EQ(FL_OK, fl_flash_log_delete(&_log, 3));
+  FL_TEST_ASSERT_EQ(2, count_records(0, 3));
+
+  FL_TEST_ASSERT_EQ(FL_OK, fill_until_compaction(0));
+  FL_TEST_ASSERT_EQ(1, _log.active);
+  FL_TEST_ASSERT_EQ(0, count_records(1, 3));
+  FL_TEST_ASSERT_EQ(1, count_records(1, 4));
+
+  FL_TEST_ASSERT_EQ(FL_OK, reset());
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_ERR_NOT_FOUND, fl_flash_log_read(&_log, 3, NULL, 0, NULL));
+  FL_TEST_ASSERT_EQ(0x44444444, read_u32(4));
+}
+
+static fl_status_t command_status(const char* message)
+{
+  const char* resp = sim_app_command(message, COMMAND_TIMEOUT);
+  const char* args;
+
+  if ((resp == NULL) || ((args = strchr(resp, ',')) == NULL))
+  {
+    return FL_ERROR + 100;
+  }
+
+  return (fl_status_t)atoi(args + 1);
+}
+
+// WPROF begin, add and save store a profile, the next boot writes its registers.
+// A save cut by a reset keeps the stored profile.
+static void test_profile_sequence(void)
+{
+  hal_stub_device_t*  sensor;
+  char                cmd[FL_TXT_MSG_MAX_LENGTH];
+  const char*         resp;
+
+  hal_stub_flash_erase();
+  FL_TEST_ASSERT_EQ(FL_OK, sim_app_boot(1));
+
+  // Save without begin.
+  FL_TEST_ASSERT_EQ(FL_ERROR, command_status("WPROF 1,2\n"));
+
+  FL_TEST_ASSERT_EQ(FL_OK, command_status("WPROF 1,0,1,init\n"));
+  sprintf(cmd, "WPROF 1,1,1,%d,25,200\n", SENSOR_ADDR);
+  FL_TEST_ASSERT_EQ(FL_OK, command_status(cmd));
+  sprintf(cmd, "WPROF 1,1,1,%d,26,20\n", SENSOR_ADDR);
+  FL_TEST_ASSERT_EQ(FL_OK, command_status(cmd));
+  // Not a register.
+  sprintf(cmd, "WPROF 1,1,1,%d,1023,20\n", SENSOR_ADDR);
+  FL_TEST_ASSERT_EQ(FL_ERROR, command_status(cmd));
+  FL_TEST_ASSERT_EQ(FL_OK, command_status("WPROF 1,2\n"));
+
+  // The profile is cleared after a save.
+  FL_TEST_ASSERT_EQ(FL_ERROR, command_status("WPROF 1,2\n"));
+
+  resp = sim_app_command("RCONF 1,4\n", COMMAND_TIMEOUT);
+  FL_TEST_ASSERT(resp != NULL);
+  FL_TEST_ASSERT(strcmp(resp, "RCONF 1,0,4,2") == 0);
+
+  FL_TEST_ASSERT_EQ(FL_OK, sim_app_boot(1));
+  FL_TEST_ASSERT_EQ(1, g_sim_app_log_count[FL_LOG_PROFILE_APPLIED]);
+  sensor = hal_stub_find_device(&hi2c1, FW_APP_SENSOR_BASE_ADDR);
+  FL_TEST_ASSERT(sensor != NULL);
+  FL_TEST_ASSERT_EQ(200, sensor->regs[0x19]);
+  FL_TEST_ASSERT_EQ(20, sensor->regs[0x1A]);
+
+  // A new profile in the same slot, the reset cuts its record.
+  FL_TEST_ASSERT_EQ(FL_OK, command_status("WPROF 1,0,1,next\n"));
+  sprintf(cmd, "WPROF 1,1,1,%d,25,100\n", SENSOR_ADDR);
+  FL_TEST_ASSERT_EQ(FL_OK, command_status(cmd));
+  cut_after((sizeof(fl_flash_log_record_t) / 4) + 1);
+  FL_TEST_ASSERT_EQ(FL_FLASH_LOG_ERR_FLASH, command_status("WPROF 1,2\n"));
+
+  FL_TEST_ASSERT_EQ(FL_OK, sim_app_boot(1));
+  sensor = hal_stub_find_device(&hi2c1, FW_APP_SENSOR_BASE_ADDR);
+  FL_TEST_ASSERT(sensor != NULL);
+  FL_TEST_ASSERT_EQ(200, sensor->regs[0x19]);
+  FL_TEST_ASSERT_EQ(20, sensor->regs[0x1A]);
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_format_and_mount);
+  FL_TEST_RUN(test_record_cut_after_header);
+  FL_TEST_RUN(test_record_cut_in_header);
+  FL_TEST_RUN(test_both_sectors_valid);
+  FL_TEST_RUN(test_compaction_cut);
+  FL_TEST_RUN(test_full_keeps_old_value);
+  FL_TEST_RUN(test_delete_dropped_by_compaction);
+  FL_TEST_RUN(test_profile_sequence);
+
+  return FL_TEST_RESULT();
+}
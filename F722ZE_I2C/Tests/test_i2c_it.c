@@ -0,0 +1,214 @@
+// Firmware library host test
+// test_i2c_it.c
+//
+// fl_i2c interrupt mode transfers on the hal_stub sensor : the register address frame and the register bytes,
+// and the error code of a NACK in each phase of the transfer.
+
+#include <string.h>
+#include "fl_i2c.h"
+#include "fl_vl6180x.h"
+#include "hal_stub.h"
+#include "fl_test.h"
+
+// VL6180X out of reset(7-bit 0x29).
+#define SENSOR_ADDR             (0x29 << 1)
+#define SENSOR_CE_PIN           (GPIO_PIN_0)
+
+// Read/write register of the sensor model(SYSRANGE__THRESH_HIGH ~ LOW).
+#define TEST_REG                (0x0019)
+
+static I2C_HandleTypeDef  _hi2c;
+static fl_i2c_t           _i2c;
+static hal_stub_device_t* _sensor;
+
+static fl_bool_t          _done;
+static fl_status_t        _status;
+static uint32_t           _data;
+
+// Completion of a frame, as fw_app_i2c_complete() and on_i2c_done_event() handle it.
+static void on_frame_done(fl_status_t status)
+{
+  if ((status == FL_OK) && (fl_i2c_it_next(&_i2c, &status) == FL_TRUE))
+  {
+    return;
+  }
+
+  if (status == FL_OK)
+  {
+    _data = fl_i2c_it_complete(&_i2c);
+  }
+  else if (status == FL_ERROR)
+  {
+    status = fl_i2c_it_error(&_i2c);
+  }
+  _status = status;
+  _done = FL_TRUE;
+}
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  (void)hi2c;
+  on_frame_done(FL_OK);
+}
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  (void)hi2c;
+  on_frame_done(FL_OK);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  (void)hi2c;
+  on_frame_done(FL_ERROR);
+}
+
+static void setup(void)
+{
+  hal_stub_reset();
+
+  memset(&_hi2c, 0, sizeof(_hi2c));
+  _hi2c.Instance = I2C1;
+  HAL_I2C_Init(&_hi2c);
+  hal_stub_set_i2c(0, &_hi2c, FL_I2C_SPEED_FAST);
+
+  fl_i2c_init(&_i2c);
+  _i2c.i2c = &_hi2c;
+
+  _sensor = hal_stub_add_vl6180x(&_hi2c, GPIOA, SENSOR_CE_PIN);
+  HAL_GPIO_WritePin(GPIOA, SENSOR_CE_PIN, GPIO_PIN_SET);
+}
+
+// Run the bus until the transfer completes, returns its status.
+static fl_status_t wait_done(void)
+{
+  uint32_t i;
+
+  for (i = 0; (i < 100) && (_done == FL_FALSE); i++)
+  {
+    hal_stub_step();
+  }
+
+  return (_done == FL_TRUE) ? _status : FL_I2C_ERR_TIMEOUT;
+}
+
+static fl_status_t read_it(uint16_t reg_addr, uint8_t size)
+{
+  fl_status_t ret;
+
+  _done = FL_FALSE;
+  _data = 0;
+  ret = fl_i2c_read_it(&_i2c, SENSOR_ADDR, reg_addr, size);
+  if (ret != FL_OK)
+  {
+    return ret;
+  }
+
+  return wait_done();
+}
+
+static fl_status_t write_it(uint16_t reg_addr, uint32_t data, uint8_t size)
+{
+  fl_status_t ret;
+
+  _done = FL_FALSE;
+  ret = fl_i2c_write_it(&_i2c, SENSOR_ADDR, reg_addr, data, size);
+  if (ret != FL_OK)
+  {
+    return ret;
+  }
+
+  return wait_done();
+}
+
+// A write continues the register address frame, a read turns the bus around(one START per transfer).
+static void test_frames(void)
+{
+  uint8_t block[3];
+
+  setup();
+
+  FL_TEST_ASSERT_EQ(FL_OK, write_it(TEST_REG, 0x1234, 2));
+  FL_TEST_ASSERT_EQ(0x12, _sensor->regs[TEST_REG]);
+  FL_TEST_ASSERT_EQ(0x34, _sensor->regs[TEST_REG + 1]);
+  FL_TEST_ASSERT_EQ(FL_I2C_PHASE_IDLE, _i2c.phase);
+
+  FL_TEST_ASSERT_EQ(FL_OK, read_it(TEST_REG, 2));
+  FL_TEST_ASSERT_EQ(0x1234, _data);
+  FL_TEST_ASSERT_EQ(FL_OK, read_it(FL_VL6180X_IDENTIFICATION_MODEL_ID, 1));
+  FL_TEST_ASSERT_EQ(FL_VL6180X_MODEL_ID, _data);
+
+  _done = FL_FALSE;
+  FL_TEST_ASSERT_EQ(FL_OK, fl_i2c_read_block_it(&_i2c, SENSOR_ADDR, TEST_REG - 1, block, sizeof(block)));
+  FL_TEST_ASSERT_EQ(FL_OK, wait_done());
+  FL_TEST_ASSERT_EQ(0x12, block[1]);
+  FL_TEST_ASSERT_EQ(0x34, block[2]);
+
+  FL_TEST_ASSERT_EQ(4, g_hal_stub.i2c[0].xfer_count);
+  FL_TEST_ASSERT_EQ(2, _sensor->write_count);
+}
+
+// No acknowledge on the slave address : no register address byte was sent.
+static void test_nack_slave_addr(void)
+{
+  setup();
+  _sensor->nack = HAL_STUB_NACK_ADDR;
+
+  FL_TEST_ASSERT_EQ(FL_I2C_ERR_ADDR_NACK, read_it(TEST_REG, 1));
+  FL_TEST_ASSERT_EQ(FL_I2C_PHASE_IDLE, _i2c.phase);
+  FL_TEST_ASSERT_EQ(FL_I2C_ERR_ADDR_NACK, write_it(TEST_REG, 0x55, 1));
+  FL_TEST_ASSERT_EQ(0, _sensor->write_count);
+}
+
+// The slave acknowledged its address and refused the register address.
+static void test_nack_reg_addr(void)
+{
+  setup();
+  _sensor->nack = HAL_STUB_NACK_REG_ADDR;
+
+  FL_TEST_ASSERT_EQ(FL_I2C_ERR_DATA_NACK, read_it(TEST_REG, 1));
+  FL_TEST_ASSERT_EQ(FL_I2C_ERR_DATA_NACK, read_it(TEST_REG, 4));
+  FL_TEST_ASSERT_EQ(FL_I2C_ERR_DATA_NACK, write_it(TEST_REG, 0x55, 1));
+  FL_TEST_ASSERT_EQ(0, _sensor->read_count);
+  FL_TEST_ASSERT_EQ(0, _sensor->write_count);
+}
+
+// The register address was acknowledged, a written register byte was refused.
+static void test_nack_write_data(void)
+{
+  setup();
+  _sensor->nack = HAL_STUB_NACK_DATA;
+
+  FL_TEST_ASSERT_EQ(FL_I2C_ERR_DATA_NACK, write_it(TEST_REG, 0x55, 1));
+  FL_TEST_ASSERT_EQ(0, _sensor->regs[TEST_REG]);
+
+  // Reads send no register byte.
+  FL_TEST_ASSERT_EQ(FL_OK, read_it(FL_VL6180X_IDENTIFICATION_MODEL_ID, 1));
+  FL_TEST_ASSERT_EQ(FL_VL6180X_MODEL_ID, _data);
+}
+
+// The slave refused its address after the repeated START of a read.
+static void test_nack_read_addr(void)
+{
+  setup();
+  _sensor->nack = HAL_STUB_NACK_READ_ADDR;
+
+  FL_TEST_ASSERT_EQ(FL_I2C_ERR_ADDR_NACK, read_it(TEST_REG, 2));
+  FL_TEST_ASSERT_EQ(0, _sensor->read_count);
+  FL_TEST_ASSERT_EQ(FL_I2C_PHASE_IDLE, _i2c.phase);
+
+  // Writes have no repeated START.
+  FL_TEST_ASSERT_EQ(FL_OK, write_it(TEST_REG, 0x55, 1));
+  FL_TEST_ASSERT_EQ(0x55, _sensor->regs[TEST_REG]);
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_frames);
+  FL_TEST_RUN(test_nack_slave_addr);
+  FL_TEST_RUN(test_nack_reg_addr);
+  FL_TEST_RUN(test_nack_write_data);
+  FL_TEST_RUN(test_nack_read_addr);
+
+  return FL_TEST_RESULT();
+}
@@ -0,0 +1,141 @@
+// Firmware library host test
+// test_i2c_queue.c
+//
+// Transfer queue of an I2C bus on the simulated board(sim_app.c) : queued transfers run in their submit
+// order(i2c_bus_submit()), the write of a WBITS command runs right after its read, ahead of the transfers
+// queued in between(i2c_bus_submit_next()). The order is read from the hal_stub bus trace.
+
+#include <string.h>
+#include "sim_app.h"
+#include "i2c.h"
+#include "fl_test.h"
+
+// Sensor 0 after the boot enumeration(8-bit address).
+#define SENSOR_ADDR             ((FW_APP_SENSOR_BASE_ADDR + 0) << 1)
+
+// Read/write register of the sensor model(SYSRANGE__THRESH_HIGH).
+#define TEST_REG                (0x0019)
+
+#define COMMAND_TIMEOUT         (100)   // ms
+
+// Boot with a cleared configuration(device ID 1).
+static fl_status_t boot(uint8_t sensor_count)
+{
+  hal_stub_flash_erase();
+
+  return sim_app_boot(sensor_count);
+}
+
+static fl_status_t command(const char* message, const char* expected)
+{
+  const char* resp = sim_app_command(message, COMMAND_TIMEOUT);
+
+  return ((resp != NULL) && (strcmp(resp, expected) == 0)) ? FL_OK : FL_ERROR;
+}
+
+// Run until the queue of I2C1 is empty.
+static fl_status_t wait_idle(void)
+{
+  uint32_t i;
+
+  for (i = 0; (i < 100) && (g_app.i2c_bus[0].count > 0); i++)
+  {
+    sim_app_run(1);
+  }
+
+  return (g_app.i2c_bus[0].count == 0) ? FL_OK : FL_ERROR;
+}
+
+// The poll of the ranging sensors queues their interrupt status reads at once, they run in the sensor order.
+static void test_fifo_order(void)
+{
+  const hal_stub_i2c_t* bus = &g_hal_stub.i2c[0];
+  char                  cmd[FL_TXT_MSG_MAX_LENGTH];
+  uint8_t               i;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot(3));
+  FL_TEST_ASSERT_EQ(0x07, g_app.sensor_mask);
+
+  for (i = 0; i < 3; i++)
+  {
+    sprintf(cmd, "WRANG 1,%d,%d\n", i, FL_VL6180X_MODE_SINGLE);
+    FL_TEST_ASSERT_EQ(FL_OK, command(cmd, "WRANG 1,0"));
+  }
+  FL_TEST_ASSERT_EQ(0x07, g_app.range.active_mask);
+
+  // From the next poll(no sample is ready, the status reads only).
+  FL_TEST_ASSERT_EQ(FL_OK, wait_idle());
+  g_hal_stub.i2c[0].trace_count = 0;
+  sim_app_run(FW_APP_RANGE_POLL_PERIOD);
+  FL_TEST_ASSERT_EQ(FL_OK, wait_idle());
+
+  FL_TEST_ASSERT(bus->trace_count >= 3);
+  for (i = 0; i < 3; i++)
+  {
+    FL_TEST_ASSERT_EQ(FW_APP_SENSOR_BASE_ADDR + i, bus->trace[i].addr);
+    FL_TEST_ASSERT_EQ(FL_VL6180X_RESULT_INTERRUPT_STATUS_GPIO, bus->trace[i].reg_addr);
+    FL_TEST_ASSERT_EQ(FL_TRUE, bus->trace[i].read);
+  }
+}
+
+// The capture samples of a bus slower than the sampling period are queued while the read of a WBITS
+// command runs, its write still comes next.
+static void test_update_bits_ahead_of_capture(void)
+{
+  const hal_stub_i2c_t* bus = &g_hal_stub.i2c[0];
+  hal_stub_device_t*    sensor;
+  char                  cmd[FL_TXT_MSG_MAX_LENGTH];
+  char                  expected[FL_TXT_MSG_MAX_LENGTH];
+  uint32_t              value = 0;
+  uint32_t              updates = 0;
+  uint32_t              i;
+  uint8_t               n;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot(1));
+  sensor = hal_stub_find_device(&hi2c1, FW_APP_SENSOR_BASE_ADDR);
+  FL_TEST_ASSERT(sensor != NULL);
+
+  // Each transfer takes more than the period, a sample is queued while any other transfer runs.
+  g_hal_stub.i2c[0].stretch = 1500;
+  sprintf(cmd, "WCAPT 1,%d,1,%d,1,0\n", FL_MSG_CAPTURE_START, SENSOR_ADDR);
+  FL_TEST_ASSERT_EQ(FL_OK, command(cmd, "WCAPT 1,0"));
+  sim_app_run(10);
+
+  g_hal_stub.i2c[0].trace_count = 0;
+  for (n = 0; n < 8; n++)
+  {
+    value = (value & ~0x0F) | n;
+    sprintf(cmd, "WBITS 1,1,%d,%d,15,%d\n", SENSOR_ADDR, TEST_REG, n);
+    sprintf(expected, "WBITS 1,0,%u", value);
+    FL_TEST_ASSERT_EQ(FL_OK, command(cmd, expected));
+    FL_TEST_ASSERT_EQ(value, sensor->regs[TEST_REG]);
+  }
+  FL_TEST_ASSERT_EQ(FL_OK, command("WCAPT 1,0,1,0,0,0\n", "WCAPT 1,0"));
+  FL_TEST_ASSERT(bus->trace_count <= HAL_STUB_I2C_TRACE_SIZE);
+
+  for (i = 0; i < bus->trace_count; i++)
+  {
+    if (bus->trace[i].reg_addr != TEST_REG)
+    {
+      continue;
+    }
+
+    // The read then the write of the same register, then the sample queued during the read.
+    FL_TEST_ASSERT_EQ(FL_TRUE, bus->trace[i].read);
+    FL_TEST_ASSERT(i + 2 < bus->trace_count);
+    FL_TEST_ASSERT_EQ(TEST_REG, bus->trace[i + 1].reg_addr);
+    FL_TEST_ASSERT_EQ(FL_FALSE, bus->trace[i + 1].read);
+    FL_TEST_ASSERT(bus->trace[i + 2].reg_addr != TEST_REG);
+    updates++;
+    i++;
+  }
+  FL_TEST_ASSERT_EQ(8, updates);
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_fifo_order);
+  FL_TEST_RUN(test_update_bits_ahead_of_capture);
+
+  return FL_TEST_RESULT();
+}
@@ -0,0 +1,194 @@
+// Firmware library host test
+// test_i2c_timing.c
+//
+// fl_i2c_calc_timing() against the STM32CubeMX TIMINGR values of this board(Src/i2c.c, 54MHz PCLK1)
+// and the I2C specification limits(RM0431 I2C timings).
+// CubeMX and fl_i2c_calc_timing() may split the same SCL period differently between SCLL and SCLH,
+// so TIMINGR values are compared by their decoded timings.
+
+#include "fw_app.h"
+#include "hal_stub.h"
+#include "fl_test.h"
+
+#define I2C_CLOCK_FREQ          (54000000)
+
+// CubeMX 6.2.1, analog filter on, digital filter off, rise/fall time 0ns.
+#define CUBEMX_TIMING_STANDARD  (0x20404768)
+#define CUBEMX_TIMING_FAST      (0x6000030D)
+
+#define AF_DELAY_MIN            (50)    // ns
+#define AF_DELAY_MAX            (260)   // ns
+
+typedef struct _spec
+{
+  uint32_t    speed;
+  uint32_t    low_min;
+  uint32_t    high_min;
+  uint32_t    sudat_min;
+  uint32_t    vddat_max;
+} spec_t;
+
+// I2C specification(UM10204), ns.
+static const spec_t _specs[] = {
+  { FL_I2C_SPEED_STANDARD,  4700, 4000, 250, 3450 },
+  { FL_I2C_SPEED_FAST,      1300,  600, 100,  900 },
+  { FL_I2C_SPEED_FAST_PLUS,  500,  260,  50,  450 },
+};
+
+// Decoded TIMINGR(picoseconds).
+typedef struct _timing
+{
+  double      t_low;
+  double      t_high;
+  double      t_scl;
+  double      t_scldel;
+  double      t_sdadel;
+} timing_t;
+
+static void decode(uint32_t timingr, uint32_t rise_time, uint32_t fall_time, timing_t* t)
+{
+  double t_clk = 1e12 / I2C_CLOCK_FREQ;
+  double t_presc = (((timingr & I2C_TIMINGR_PRESC) >> I2C_TIMINGR_PRESC_Pos) + 1) * t_clk;
+  double t_sync = (AF_DELAY_MIN * 1000.0) + (2 * t_clk);
+
+  t->t_low = ((((timingr & I2C_TIMINGR_SCLL) >> I2C_TIMINGR_SCLL_Pos) + 1) * t_presc) + t_sync;
+  t->t_high = ((((timingr & I2C_TIMINGR_SCLH) >> I2C_TIMINGR_SCLH_Pos) + 1) * t_presc) + t_sync;
+  t->t_scl = t->t_low + t->t_high + ((rise_time + fall_time) * 1000.0);
+  t->t_scldel = (((timingr & I2C_TIMINGR_SCLDEL) >> I2C_TIMINGR_SCLDEL_Pos) + 1) * t_presc;
+  t->t_sdadel = ((timingr & I2C_TIMINGR_SDADEL) >> I2C_TIMINGR_SDADEL_Pos) * t_presc;
+}
+
+// Specification limits of the speed mode and no faster than speed.
+static int meets_spec(uint32_t timingr, uint32_t speed, uint32_t rise_time, uint32_t fall_time)
+{
+  const spec_t* spec = &_specs[0];
+  double        t_clk = 1e12 / I2C_CLOCK_FREQ;
+  timing_t      t;
+  uint32_t      i;
+
+  for (i = 0; i < sizeof(_specs) / sizeof(_specs[0]); i++)
+  {
+    if (speed <= _specs[i].speed)
+    {
+      spec = &_specs[i];
+      break;
+    }
+  }
+
+  decode(timingr, rise_time, fall_time, &t);
+
+  return (t.t_low >= spec->low_min * 1000.0) &&
+         (t.t_high >= spec->high_min * 1000.0) &&
+         (t.t_scl >= 1e12 / speed) &&
+         (t.t_scldel >= (rise_time + spec->sudat_min) * 1000.0) &&
+         (t.t_sdadel >= ((double)fall_time - AF_DELAY_MIN) * 1000.0 - (3 * t_clk)) &&
+         (t.t_sdadel <= ((double)spec->vddat_max - rise_time - AF_DELAY_MAX) * 1000.0 - (4 * t_clk));
+}
+
+static double scl_freq(uint32_t timingr, uint32_t rise_time, uint32_t fall_time)
+{
+  timing_t t;
+
+  decode(timingr, rise_time, fall_time, &t);
+
+  return 1e12 / t.t_scl;
+}
+
+static void test_cubemx_values_meet_spec(void)
+{
+  // Checks the decoder against the generated values first.
+  FL_TEST_ASSERT(meets_spec(CUBEMX_TIMING_STANDARD, FL_I2C_SPEED_STANDARD, 0, 0));
+  FL_TEST_ASSERT(meets_spec(CUBEMX_TIMING_FAST, FL_I2C_SPEED_FAST, 0, 0));
+}
+
+static void test_calc_matches_cubemx(void)
+{
+  uint32_t timing;
+
+  FL_TEST_ASSERT(fl_i2c_calc_timing(I2C_CLOCK_FREQ, FL_I2C_SPEED_STANDARD, 0, 0, &timing) == FL_OK);
+  FL_TEST_ASSERT(meets_spec(timing, FL_I2C_SPEED_STANDARD, 0, 0));
+  // Same prescaler and data delays, same SCL period.
+  FL_TEST_ASSERT_EQ(CUBEMX_TIMING_STANDARD & (I2C_TIMINGR_PRESC | I2C_TIMINGR_SCLDEL | I2C_TIMINGR_SDADEL),
+                    timing & (I2C_TIMINGR_PRESC | I2C_TIMINGR_SCLDEL | I2C_TIMINGR_SDADEL));
+  FL_TEST_ASSERT_EQ((uint32_t)(scl_freq(CUBEMX_TIMING_STANDARD, 0, 0) + 0.5), (uint32_t)(scl_freq(timing, 0, 0) + 0.5));
+
+  FL_TEST_ASSERT(fl_i2c_calc_timing(I2C_CLOCK_FREQ, FL_I2C_SPEED_FAST, 0, 0, &timing) == FL_OK);
+  FL_TEST_ASSERT(meets_spec(timing, FL_I2C_SPEED_FAST, 0, 0));
+  FL_TEST_ASSERT_EQ((uint32_t)(scl_freq(CUBEMX_TIMING_FAST, 0, 0) + 0.5), (uint32_t)(scl_freq(timing, 0, 0) + 0.5));
+}
+
+// Board defaults(fw_app_hw_init()) at the WI2CS speeds.
+static void test_calc_with_edges(void)
+{
+  static const uint32_t speeds[] = { FL_I2C_SPEED_MIN, FL_I2C_SPEED_STANDARD, FL_I2C_SPEED_FAST, FL_I2C_SPEED_FAST_PLUS };
+  uint32_t              timing;
+  uint32_t              i;
+
+  for (i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++)
+  {
+    FL_TEST_ASSERT(fl_i2c_calc_timing(I2C_CLOCK_FREQ, speeds[i], FW_APP_I2C_RISE_TIME, FW_APP_I2C_FALL_TIME, &timing) == FL_OK);
+    FL_TEST_ASSERT(meets_spec(timing, speeds[i], FW_APP_I2C_RISE_TIME, FW_APP_I2C_FALL_TIME));
+    // Within 2% below the requested SCL frequency.
+    FL_TEST_ASSERT(scl_freq(timing, FW_APP_I2C_RISE_TIME, FW_APP_I2C_FALL_TIME) >= speeds[i] * 0.98);
+  }
+
+  // Slower edges : the counters are shortened so the SCL frequency is kept.
+  FL_TEST_ASSERT(fl_i2c_calc_timing(I2C_CLOCK_FREQ, FL_I2C_SPEED_FAST, 300, 100, &timing) == FL_OK);
+  FL_TEST_ASSERT(meets_spec(timing, FL_I2C_SPEED_FAST, 300, 100));
+  FL_TEST_ASSERT(scl_freq(timing, 300, 100) >= FL_I2C_SPEED_FAST * 0.98);
+}
+
+static void test_calc_invalid(void)
+{
+  uint32_t timing;
+
+  FL_TEST_ASSERT(fl_i2c_calc_timing(0, FL_I2C_SPEED_FAST, 0, 0, &timing) == FL_ERROR);
+  FL_TEST_ASSERT(fl_i2c_calc_timing(I2C_CLOCK_FREQ, FL_I2C_SPEED_MIN - 1, 0, 0, &timing) == FL_ERROR);
+  FL_TEST_ASSERT(fl_i2c_calc_timing(I2C_CLOCK_FREQ, FL_I2C_SPEED_FAST_PLUS + 1, 0, 0, &timing) == FL_ERROR);
+
+  // Fast-mode Plus data valid time(450ns) leaves no SDADEL for 300ns edges.
+  FL_TEST_ASSERT(fl_i2c_calc_timing(I2C_CLOCK_FREQ, FL_I2C_SPEED_FAST_PLUS, 300, 10, &timing) == FL_ERROR);
+}
+
+static void test_set_speed_uses_edges(void)
+{
+  I2C_HandleTypeDef hi2c = {0};
+  fl_i2c_t          i2c;
+  uint32_t          expected;
+  uint32_t          ideal;
+
+  hal_stub_reset();
+  hi2c.Instance = I2C1;
+  fl_i2c_init(&i2c);
+  i2c.i2c = &hi2c;
+  i2c.rise_time = FW_APP_I2C_RISE_TIME;
+  i2c.fall_time = FW_APP_I2C_FALL_TIME;
+
+  FL_TEST_ASSERT(fl_i2c_calc_timing(I2C_CLOCK_FREQ, FL_I2C_SPEED_FAST, FW_APP_I2C_RISE_TIME, FW_APP_I2C_FALL_TIME, &expected) == FL_OK);
+  FL_TEST_ASSERT(fl_i2c_calc_timing(I2C_CLOCK_FREQ, FL_I2C_SPEED_FAST, 0, 0, &ideal) == FL_OK);
+  FL_TEST_ASSERT(expected != ideal);
+
+  FL_TEST_ASSERT(fl_i2c_set_speed(&i2c, FL_I2C_SPEED_FAST) == FL_OK);
+  FL_TEST_ASSERT_EQ(expected, hi2c.Init.Timing);
+  FL_TEST_ASSERT_EQ(FL_I2C_SPEED_FAST, i2c.bus_speed);
+  FL_TEST_ASSERT_EQ(0, g_hal_stub.fast_mode_plus);
+
+  FL_TEST_ASSERT(fl_i2c_set_speed(&i2c, FL_I2C_SPEED_FAST_PLUS) == FL_OK);
+  FL_TEST_ASSERT_EQ(I2C_FASTMODEPLUS_I2C1, g_hal_stub.fast_mode_plus);
+
+  // A failed calculation keeps the current setting.
+  i2c.rise_time = 300;
+  FL_TEST_ASSERT(fl_i2c_set_speed(&i2c, FL_I2C_SPEED_FAST_PLUS) == FL_ERROR);
+  FL_TEST_ASSERT_EQ(FL_I2C_SPEED_FAST_PLUS, i2c.bus_speed);
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_cubemx_values_meet_spec);
+  FL_TEST_RUN(test_calc_matches_cubemx);
+  FL_TEST_RUN(test_calc_with_edges);
+  FL_TEST_RUN(test_calc_invalid);
+  FL_TEST_RUN(test_set_speed_uses_edges);
+
+  return FL_TEST_RESULT();
+}
@@ -0,0 +1,160 @@
+// Firmware library host test
+// test_log.c
+//
+// fl_log on the host(FL_LOG_HOST) : records written into the ring are sent word by word while the port
+// accepts them, a full ring drops new records and reports their number in one FL_LOG_DROPPED record.
+
+#include <string.h>
+#include "fl_log.h"
+#include "hal_stub.h"
+#include "fl_test.h"
+
+#define PORT_SIZE               (1024)
+
+// Words sent on the port, the port FIFO accepts port_free more words.
+static uint32_t _port[PORT_SIZE];
+static uint32_t _port_count;
+static uint32_t _port_free;
+
+fl_bool_t fl_log_host_port_ready(void)
+{
+  return ((_port_free > 0) && (_port_count < PORT_SIZE)) ? FL_TRUE : FL_FALSE;
+}
+
+void fl_log_host_port_write(uint32_t word)
+{
+  _port[_port_count++] = word;
+  _port_free--;
+}
+
+// Drain the ring to an empty port.
+static void drain(uint32_t port_free)
+{
+  _port_count = 0;
+  _port_free = port_free;
+  fl_log_drain();
+}
+
+static uint32_t header(uint16_t fmt_id, uint8_t arg_count)
+{
+  return ((uint32_t)FL_LOG_SYNC << 24) | ((uint32_t)arg_count << 16) | fmt_id;
+}
+
+// Header, tick and the arguments of the record only.
+static void test_records(void)
+{
+  hal_stub_reset();
+  g_hal_stub.tick = 100;
+  fl_log_write(FL_LOG_BOOT_READY, 2, 0x07, 100, 0);
+  g_hal_stub.tick = 101;
+  fl_log_write(FL_LOG_I2C_TIMEOUT, 1, 2, 0, 0);
+  fl_log_write(FL_LOG_BOOT_READY, 0, 0, 0, 0);
+
+  drain(PORT_SIZE);
+  FL_TEST_ASSERT_EQ(4 + 3 + 2, _port_count);
+  FL_TEST_ASSERT_EQ(header(FL_LOG_BOOT_READY, 2), _port[0]);
+  FL_TEST_ASSERT_EQ(100, _port[1]);
+  FL_TEST_ASSERT_EQ(0x07, _port[2]);
+  FL_TEST_ASSERT_EQ(100, _port[3]);
+  FL_TEST_ASSERT_EQ(header(FL_LOG_I2C_TIMEOUT, 1), _port[4]);
+  FL_TEST_ASSERT_EQ(101, _port[5]);
+  FL_TEST_ASSERT_EQ(2, _port[6]);
+  FL_TEST_ASSERT_EQ(header(FL_LOG_BOOT_READY, 0), _port[7]);
+  FL_TEST_ASSERT_EQ(101, _port[8]);
+
+  // Nothing left.
+  drain(PORT_SIZE);
+  FL_TEST_ASSERT_EQ(0, _port_count);
+}
+
+// A full FIFO stops the drain within a record, the next drain continues with its next word.
+static void test_port_full(void)
+{
+  uint32_t i;
+
+  hal_stub_reset();
+  for (i = 0; i < 3; i++)
+  {
+    fl_log_write(FL_LOG_I2C_TIMEOUT, 1, i, 0, 0);
+  }
+
+  drain(2);
+  FL_TEST_ASSERT_EQ(2, _port_count);
+  FL_TEST_ASSERT_EQ(header(FL_LOG_I2C_TIMEOUT, 1), _port[0]);
+
+  drain(4);
+  FL_TEST_ASSERT_EQ(4, _port_count);
+  FL_TEST_ASSERT_EQ(0, _port[0]);
+  FL_TEST_ASSERT_EQ(header(FL_LOG_I2C_TIMEOUT, 1), _port[1]);
+  FL_TEST_ASSERT_EQ(1, _port[3]);
+
+  drain(PORT_SIZE);
+  FL_TEST_ASSERT_EQ(3, _port_count);
+  FL_TEST_ASSERT_EQ(2, _port[2]);
+}
+
+// Records written to a full ring are counted, one FL_LOG_DROPPED record follows the kept records.
+static void test_ring_full(void)
+{
+  uint32_t i;
+
+  hal_stub_reset();
+  for (i = 0; i < FL_LOG_RING_SIZE + 5; i++)
+  {
+    fl_log_write(FL_LOG_I2C_TIMEOUT, 1, i, 0, 0);
+  }
+
+  g_hal_stub.tick = 500;
+  drain(PORT_SIZE);
+  FL_TEST_ASSERT_EQ((FL_LOG_RING_SIZE * 3) + 3, _port_count);
+  for (i = 0; i < FL_LOG_RING_SIZE; i++)
+  {
+    FL_TEST_ASSERT_EQ(header(FL_LOG_I2C_TIMEOUT, 1), _port[i * 3]);
+    FL_TEST_ASSERT_EQ(i, _port[(i * 3) + 2]);
+  }
+  FL_TEST_ASSERT_EQ(header(FL_LOG_DROPPED, 1), _port[FL_LOG_RING_SIZE * 3]);
+  FL_TEST_ASSERT_EQ(500, _port[(FL_LOG_RING_SIZE * 3) + 1]);
+  FL_TEST_ASSERT_EQ(5, _port[(FL_LOG_RING_SIZE * 3) + 2]);
+
+  // Reported once, the ring has room again.
+  fl_log_write(FL_LOG_BOOT_READY, 0, 0, 0, 0);
+  drain(PORT_SIZE);
+  FL_TEST_ASSERT_EQ(2, _port_count);
+  FL_TEST_ASSERT_EQ(header(FL_LOG_BOOT_READY, 0), _port[0]);
+}
+
+// Records dropped while the ring drains are reported after the records written after them.
+static void test_dropped_while_draining(void)
+{
+  uint32_t i;
+
+  hal_stub_reset();
+  for (i = 0; i < FL_LOG_RING_SIZE + 1; i++)
+  {
+    fl_log_write(FL_LOG_I2C_TIMEOUT, 1, i, 0, 0);
+  }
+
+  // One record sent and the next one in the output buffer, two records in, then one more dropped.
+  drain(3);
+  for (i = 0; i < 3; i++)
+  {
+    fl_log_write(FL_LOG_BOOT_READY, 0, 0, 0, 0);
+  }
+
+  drain(PORT_SIZE);
+  FL_TEST_ASSERT_EQ(((FL_LOG_RING_SIZE - 1) * 3) + (2 * 2) + 3, _port_count);
+  FL_TEST_ASSERT_EQ(header(FL_LOG_BOOT_READY, 0), _port[(FL_LOG_RING_SIZE - 1) * 3]);
+  FL_TEST_ASSERT_EQ(header(FL_LOG_BOOT_READY, 0), _port[((FL_LOG_RING_SIZE - 1) * 3) + 2]);
+  FL_TEST_ASSERT_EQ(header(FL_LOG_DROPPED, 1), _port[((FL_LOG_RING_SIZE - 1) * 3) + 4]);
+  FL_TEST_ASSERT_EQ(2, _port[((FL_LOG_RING_SIZE - 1) * 3) + 6]);
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_records);
+  FL_TEST_RUN(test_port_full);
+  FL_TEST_RUN(test_ring_full);
+  FL_TEST_RUN(test_dropped_while_draining);
+
+  return FL_TEST_RESULT();
+}
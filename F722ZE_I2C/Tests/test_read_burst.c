@@ -0,0 +1,105 @@
+// Firmware library host test
+// test_read_burst.c
+//
+// RBURS on the simulated board(sim_app.c) : consecutive registers read in one transfer and sent in base64,
+// counts out of 1 ~ FL_MSG_I2C_MAX_BURST_LEN refused before they are narrowed to the 8-bit payload field
+// (decode_read_burst()).
+
+#include <string.h>
+#include "sim_app.h"
+#include "i2c.h"
+#include "fl_test.h"
+
+// Sensor 0 after the boot enumeration(8-bit address).
+#define SENSOR_ADDR             ((FW_APP_SENSOR_BASE_ADDR + 0) << 1)
+
+// First register of the read(SYSRANGE__THRESH_HIGH).
+#define TEST_REG                (0x0019)
+
+#define COMMAND_TIMEOUT         (100)   // ms
+
+static hal_stub_device_t* _sensor;
+
+static fl_status_t boot(void)
+{
+  hal_stub_flash_erase();
+  if (sim_app_boot(1) != FL_OK)
+  {
+    return FL_ERROR;
+  }
+
+  _sensor = hal_stub_find_device(&hi2c1, FW_APP_SENSOR_BASE_ADDR);
+
+  return (_sensor != NULL) ? FL_OK : FL_ERROR;
+}
+
+static const char* read_burst(const char* count)
+{
+  char cmd[FL_TXT_MSG_MAX_LENGTH];
+
+  sprintf(cmd, "RBURS 1,1,%d,%d,%s\n", SENSOR_ADDR, TEST_REG, count);
+
+  return sim_app_command(cmd, COMMAND_TIMEOUT);
+}
+
+// The response carries the bytes of the registers from TEST_REG.
+static void test_read(void)
+{
+  char        expected[FL_TXT_MSG_MAX_BATCH_LENGTH];
+  char        data[FL_MSG_I2C_MAX_BURST_LEN];
+  const char* resp;
+  uint32_t    length;
+  uint32_t    i;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot());
+  for (i = 0; i < FL_MSG_I2C_MAX_BURST_LEN; i++)
+  {
+    _sensor->regs[TEST_REG + i] = (uint8_t)(0xA0 + i);
+  }
+  memcpy(data, &_sensor->regs[TEST_REG], sizeof(data));
+
+  resp = read_burst("4");
+  FL_TEST_ASSERT(resp != NULL);
+  length = sprintf(expected, "RBURS 1,0,1,%d,%d,4,", SENSOR_ADDR, TEST_REG);
+  fl_base64_encode(&expected[length], data, 4);
+  FL_TEST_ASSERT_EQ(0, strcmp(resp, expected));
+
+  resp = read_burst("64");
+  FL_TEST_ASSERT(resp != NULL);
+  length = sprintf(expected, "RBURS 1,0,1,%d,%d,64,", SENSOR_ADDR, TEST_REG);
+  fl_base64_encode(&expected[length], data, FL_MSG_I2C_MAX_BURST_LEN);
+  FL_TEST_ASSERT_EQ(0, strcmp(resp, expected));
+}
+
+// No transfer for a count out of range, 257 and 4294967297 are not read as 1 byte.
+static void test_count_out_of_range(void)
+{
+  static const char* const counts[] = { "0", "65", "256", "257", "4294967297", "-1" };
+  const char*              resp;
+  uint32_t                 transfers;
+  uint32_t                 i;
+
+  FL_TEST_ASSERT_EQ(FL_OK, boot());
+  transfers = g_hal_stub.i2c[0].xfer_count;
+
+  for (i = 0; i < (sizeof(counts) / sizeof(counts[0])); i++)
+  {
+    resp = read_burst(counts[i]);
+    FL_TEST_ASSERT(resp != NULL);
+    FL_TEST_ASSERT_EQ(0, strcmp(resp, "RBURS 1,1"));
+  }
+  FL_TEST_ASSERT_EQ(transfers, g_hal_stub.i2c[0].xfer_count);
+
+  // The next command is parsed as usual.
+  resp = read_burst("1");
+  FL_TEST_ASSERT(resp != NULL);
+  FL_TEST_ASSERT(strncmp(resp, "RBURS 1,0,", 10) == 0);
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_read);
+  FL_TEST_RUN(test_count_out_of_range);
+
+  return FL_TEST_RESULT();
+}
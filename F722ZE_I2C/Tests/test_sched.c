@@ -0,0 +1,289 @@
+// Firmware library host test
+// test_sched.c
+//
+// fl_sched on the host(FL_SCHED_HOST) with a simulated tick.
+
+#include <string.h>
+#include "fl_sched.h"
+#include "fl_test.h"
+
+#define CALL_LOG_SIZE     (64)
+
+// Handler calls in call order(param, tick).
+static uint32_t _call_param[CALL_LOG_SIZE];
+static uint32_t _call_tick[CALL_LOG_SIZE];
+static uint32_t _call_count;
+
+static fl_sched_t _sched;
+
+static void reset(void)
+{
+  fl_sched_init(&_sched);
+  _call_count = 0;
+}
+
+static void on_call(uint32_t param, void* context)
+{
+  fl_sched_t* sched = (fl_sched_t*)context;
+
+  if (_call_count < CALL_LOG_SIZE)
+  {
+    _call_param[_call_count] = param;
+    _call_tick[_call_count] = fl_sched_get_tick(sched);
+  }
+  _call_count++;
+}
+
+static void on_post_event(uint32_t param, void* context)
+{
+  on_call(param, context);
+  fl_sched_post((fl_sched_t*)context, on_call, param + 100, context);
+}
+
+// Advance the simulated tick and run the scheduler after every tick.
+static void run_ticks(uint32_t ticks)
+{
+  uint32_t i;
+
+  for (i = 0; i < ticks; i++)
+  {
+    fl_sched_tick(&_sched);
+    fl_sched_run(&_sched);
+  }
+}
+
+static void test_timer_order(void)
+{
+  reset();
+
+  fl_sched_timer_start(&_sched, 0, on_call, 30, &_sched, 30, 0);
+  fl_sched_timer_start(&_sched, 1, on_call, 10, &_sched, 10, 0);
+  fl_sched_timer_start(&_sched, 2, on_call, 20, &_sched, 20, 0);
+
+  run_ticks(9);
+  FL_TEST_ASSERT_EQ(0, _call_count);
+
+  run_ticks(21);
+  FL_TEST_ASSERT_EQ(3, _call_count);
+  FL_TEST_ASSERT_EQ(10, _call_param[0]);
+  FL_TEST_ASSERT_EQ(10, _call_tick[0]);
+  FL_TEST_ASSERT_EQ(20, _call_param[1]);
+  FL_TEST_ASSERT_EQ(20, _call_tick[1]);
+  FL_TEST_ASSERT_EQ(30, _call_param[2]);
+  FL_TEST_ASSERT_EQ(30, _call_tick[2]);
+}
+
+static void test_timer_same_tick(void)
+{
+  reset();
+
+  // Timers expiring on the same tick are dispatched in timer ID order.
+  fl_sched_timer_start(&_sched, 5, on_call, 5, &_sched, 3, 0);
+  fl_sched_timer_start(&_sched, 2, on_call, 2, &_sched, 3, 0);
+  fl_sched_timer_start(&_sched, 7, on_call, 7, &_sched, 3, 0);
+
+  run_ticks(3);
+  FL_TEST_ASSERT_EQ(3, _call_count);
+  FL_TEST_ASSERT_EQ(2, _call_param[0]);
+  FL_TEST_ASSERT_EQ(5, _call_param[1]);
+  FL_TEST_ASSERT_EQ(7, _call_param[2]);
+}
+
+static void test_timer_one_shot(void)
+{
+  reset();
+
+  fl_sched_timer_start(&_sched, 0, on_call, 1, &_sched, 5, 0);
+  FL_TEST_ASSERT(fl_sched_timer_is_active(&_sched, 0) == FL_TRUE);
+
+  run_ticks(50);
+  FL_TEST_ASSERT_EQ(1, _call_count);
+  FL_TEST_ASSERT(fl_sched_timer_is_active(&_sched, 0) == FL_FALSE);
+}
+
+static void test_timer_periodic(void)
+{
+  uint32_t i;
+
+  reset();
+
+  fl_sched_timer_start(&_sched, 3, on_call, 0, &_sched, 5, 10);
+
+  run_ticks(45);
+  FL_TEST_ASSERT_EQ(5, _call_count);
+  for (i = 0; i < 5; i++)
+  {
+    FL_TEST_ASSERT_EQ(5 + i * 10, _call_tick[i]);
+  }
+  FL_TEST_ASSERT(fl_sched_timer_is_active(&_sched, 3) == FL_TRUE);
+
+  fl_sched_timer_stop(&_sched, 3);
+  run_ticks(50);
+  FL_TEST_ASSERT_EQ(5, _call_count);
+}
+
+static void test_timer_late_run(void)
+{
+  uint32_t i;
+
+  reset();
+
+  // The main loop is late : the period keeps its phase(expire += period),
+  // one call per fl_sched_run() until it catches up.
+  fl_sched_timer_start(&_sched, 0, on_call, 0, &_sched, 10, 10);
+  for (i = 0; i < 35; i++)
+  {
+    fl_sched_tick(&_sched);
+  }
+
+  FL_TEST_ASSERT_EQ(1, fl_sched_run(&_sched));
+  FL_TEST_ASSERT_EQ(1, fl_sched_run(&_sched));
+  FL_TEST_ASSERT_EQ(1, fl_sched_run(&_sched));
+  FL_TEST_ASSERT_EQ(0, fl_sched_run(&_sched));
+  FL_TEST_ASSERT_EQ(40, _sched.timers[0].expire);
+}
+
+static void test_timer_restart(void)
+{
+  reset();
+
+  // Starting an active timer restarts it.
+  fl_sched_timer_start(&_sched, 0, on_call, 1, &_sched, 10, 0);
+  run_ticks(8);
+  fl_sched_timer_start(&_sched, 0, on_call, 2, &_sched, 10, 0);
+  run_ticks(8);
+  FL_TEST_ASSERT_EQ(0, _call_count);
+
+  run_ticks(2);
+  FL_TEST_ASSERT_EQ(1, _call_count);
+  FL_TEST_ASSERT_EQ(2, _call_param[0]);
+  FL_TEST_ASSERT_EQ(18, _call_tick[0]);
+}
+
+static void test_timer_tick_wrap(void)
+{
+  reset();
+
+  _sched.tick = 0xFFFFFFF0;
+  fl_sched_timer_start(&_sched, 0, on_call, 0, &_sched, 0x20, 0);
+
+  run_ticks(0x1F);
+  FL_TEST_ASSERT_EQ(0, _call_count);
+
+  run_ticks(1);
+  FL_TEST_ASSERT_EQ(1, _call_count);
+  FL_TEST_ASSERT_EQ(0x10, _call_tick[0]);
+}
+
+static void test_timer_invalid(void)
+{
+  reset();
+
+  FL_TEST_ASSERT(fl_sched_timer_start(&_sched, FL_SCHED_TIMER_COUNT, on_call, 0, &_sched, 1, 0) == FL_ERROR);
+  FL_TEST_ASSERT(fl_sched_timer_start(&_sched, 0, NULL, 0, &_sched, 1, 0) == FL_ERROR);
+  FL_TEST_ASSERT(fl_sched_timer_is_active(&_sched, FL_SCHED_TIMER_COUNT) == FL_FALSE);
+}
+
+static void test_event_order(void)
+{
+  uint32_t i;
+
+  reset();
+
+  for (i = 0; i < 10; i++)
+  {
+    FL_TEST_ASSERT(fl_sched_post(&_sched, on_call, i, &_sched) == FL_OK);
+  }
+  FL_TEST_ASSERT_EQ(10, fl_sched_pending(&_sched));
+
+  FL_TEST_ASSERT_EQ(10, fl_sched_run(&_sched));
+  FL_TEST_ASSERT_EQ(0, fl_sched_pending(&_sched));
+  for (i = 0; i < 10; i++)
+  {
+    FL_TEST_ASSERT_EQ(i, _call_param[i]);
+  }
+}
+
+static void test_event_posted_by_handler(void)
+{
+  reset();
+
+  // Timers run before events, events posted by handlers run in the same call.
+  fl_sched_post(&_sched, on_post_event, 1, &_sched);
+  fl_sched_timer_start(&_sched, 0, on_post_event, 2, &_sched, 0, 0);
+
+  FL_TEST_ASSERT_EQ(4, fl_sched_run(&_sched));
+  FL_TEST_ASSERT_EQ(4, _call_count);
+  FL_TEST_ASSERT_EQ(2, _call_param[0]);
+  FL_TEST_ASSERT_EQ(1, _call_param[1]);
+  FL_TEST_ASSERT_EQ(102, _call_param[2]);
+  FL_TEST_ASSERT_EQ(101, _call_param[3]);
+  FL_TEST_ASSERT_EQ(0, fl_sched_pending(&_sched));
+}
+
+static void test_event_overflow(void)
+{
+  uint32_t i;
+
+  reset();
+
+  for (i = 0; i < FL_SCHED_EVENT_QUEUE_SIZE; i++)
+  {
+    FL_TEST_ASSERT(fl_sched_post(&_sched, on_call, i, &_sched) == FL_OK);
+  }
+
+  // Queue is full : the new event is dropped and counted, the queued ones are kept.
+  FL_TEST_ASSERT(fl_sched_post(&_sched, on_call, 1000, &_sched) == FL_ERROR);
+  FL_TEST_ASSERT(fl_sched_post(&_sched, on_call, 1001, &_sched) == FL_ERROR);
+  FL_TEST_ASSERT_EQ(2, _sched.dropped);
+  FL_TEST_ASSERT_EQ(FL_SCHED_EVENT_QUEUE_SIZE, fl_sched_pending(&_sched));
+
+  FL_TEST_ASSERT_EQ(FL_SCHED_EVENT_QUEUE_SIZE, fl_sched_run(&_sched));
+  for (i = 0; i < FL_SCHED_EVENT_QUEUE_SIZE; i++)
+  {
+    FL_TEST_ASSERT_EQ(i, _call_param[i]);
+  }
+
+  // Space again after the queue is drained.
+  FL_TEST_ASSERT(fl_sched_post(&_sched, on_call, 2000, &_sched) == FL_OK);
+  FL_TEST_ASSERT_EQ(1, fl_sched_run(&_sched));
+  FL_TEST_ASSERT_EQ(2000, _call_param[FL_SCHED_EVENT_QUEUE_SIZE]);
+  FL_TEST_ASSERT_EQ(2, _sched.dropped);
+}
+
+static void test_event_index_wrap(void)
+{
+  uint32_t i;
+
+  reset();
+
+  // Free running indexes across the 32-bit wrap.
+  _sched.head = 0xFFFFFFF8;
+  _sched.tail = 0xFFFFFFF8;
+  for (i = 0; i < FL_SCHED_EVENT_QUEUE_SIZE; i++)
+  {
+    FL_TEST_ASSERT(fl_sched_post(&_sched, on_call, i, &_sched) == FL_OK);
+  }
+  FL_TEST_ASSERT(fl_sched_post(&_sched, on_call, 0, &_sched) == FL_ERROR);
+
+  FL_TEST_ASSERT_EQ(FL_SCHED_EVENT_QUEUE_SIZE, fl_sched_run(&_sched));
+  FL_TEST_ASSERT_EQ(FL_SCHED_EVENT_QUEUE_SIZE - 1, _call_param[FL_SCHED_EVENT_QUEUE_SIZE - 1]);
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_timer_order);
+  FL_TEST_RUN(test_timer_same_tick);
+  FL_TEST_RUN(test_timer_one_shot);
+  FL_TEST_RUN(test_timer_periodic);
+  FL_TEST_RUN(test_timer_late_run);
+  FL_TEST_RUN(test_timer_restart);
+  FL_TEST_RUN(test_timer_tick_wrap);
+  FL_TEST_RUN(test_timer_invalid);
+  FL_TEST_RUN(test_event_order);
+  FL_TEST_RUN(test_event_posted_by_handler);
+  FL_TEST_RUN(test_event_overflow);
+  FL_TEST_RUN(test_event_index_wrap);
+
+  return FL_TEST_RESULT();
+}
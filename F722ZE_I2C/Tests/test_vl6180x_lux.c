@@ -0,0 +1,132 @@
+// Firmware library host test
+// test_vl6180x_lux.c
+//
+// fl_vl6180x_als_to_lux() against the datasheet formula(lux = 0.32 x ALS count / gain x 100ms / integration
+// period) for every SYSALS__ANALOGUE_GAIN setting and integration periods of the register range,
+// and the ALS settings read from the sensor(fl_vl6180x_init()).
+
+#include <string.h>
+#include "fl_vl6180x.h"
+#include "hal_stub.h"
+#include "fl_test.h"
+
+// VL6180X out of reset(7-bit 0x29).
+#define SENSOR_ADDR             (0x29 << 1)
+#define SENSOR_CE_PIN           (GPIO_PIN_0)
+
+// Actual ALS gains by SYSALS__ANALOGUE_GAIN[2:0](AN4545 ALS gain table).
+static const double _gains[] = { 20.0, 10.32, 5.21, 2.60, 1.72, 1.28, 1.01, 40.0 };
+
+// Integration periods(ms) : 1 ~ 512(SYSALS__INTEGRATION_PERIOD + 1).
+static const uint16_t _int_times[] = { 1, 50, 99, 100, 101, 255, 512 };
+
+static const uint16_t _als_counts[] = { 0, 1, 7, 100, 1000, 12345, 40000, 65535 };
+
+static I2C_HandleTypeDef  _hi2c;
+static fl_i2c_t           _i2c;
+
+// Datasheet lux in Q16.16, saturated.
+static double expected_lux(uint8_t gain, uint16_t int_time, uint16_t als)
+{
+  double lux = (0.32 * als / _gains[gain]) * (100.0 / int_time) * (1 << FL_VL6180X_LUX_FRAC_BITS);
+
+  return (lux > FL_VL6180X_LUX_MAX) ? FL_VL6180X_LUX_MAX : lux;
+}
+
+// The converted lux is the datasheet lux truncated to a Q16.16 step(with a margin for the double rounding).
+static fl_bool_t is_truncated(double expected, uint32_t lux)
+{
+  double diff = expected - lux;
+
+  return ((diff > -0.001) && (diff < 1.0)) ? FL_TRUE : FL_FALSE;
+}
+
+// Truncated to a Q16.16 step(the 2 decimals of the gain table are exact in the integer gains).
+static void test_formula(void)
+{
+  fl_vl6180x_t  sensor;
+  uint8_t       gain;
+  uint32_t      i;
+  uint32_t      j;
+
+  memset(&sensor, 0, sizeof(sensor));
+
+  for (gain = 0; gain < (sizeof(_gains) / sizeof(_gains[0])); gain++)
+  {
+    sensor.als_gain = gain;
+    for (i = 0; i < (sizeof(_int_times) / sizeof(_int_times[0])); i++)
+    {
+      sensor.als_int_time = _int_times[i];
+      for (j = 0; j < (sizeof(_als_counts) / sizeof(_als_counts[0])); j++)
+      {
+        FL_TEST_ASSERT(is_truncated(expected_lux(gain, _int_times[i], _als_counts[j]),
+                                    fl_vl6180x_als_to_lux(&sensor, _als_counts[j])));
+      }
+    }
+  }
+}
+
+// 0.32 lux per count at gain 1.01 over 100ms, the full count over 1ms at the lowest gain saturates.
+static void test_limits(void)
+{
+  fl_vl6180x_t sensor;
+
+  memset(&sensor, 0, sizeof(sensor));
+
+  // ALS settings not read yet.
+  FL_TEST_ASSERT_EQ(0, fl_vl6180x_als_to_lux(&sensor, 1000));
+
+  sensor.als_gain = 6;
+  sensor.als_int_time = 100;
+  FL_TEST_ASSERT_EQ((320 << FL_VL6180X_LUX_FRAC_BITS) / 1010, fl_vl6180x_als_to_lux(&sensor, 1));
+
+  sensor.als_int_time = 1;
+  FL_TEST_ASSERT_EQ(FL_VL6180X_LUX_MAX, fl_vl6180x_als_to_lux(&sensor, 65535));
+  sensor.als_gain = 7;
+  sensor.als_int_time = 512;
+  FL_TEST_ASSERT(fl_vl6180x_als_to_lux(&sensor, 65535) < FL_VL6180X_LUX_MAX);
+}
+
+// The settings written out of reset(gain 1.01, 100ms), then the settings of a restarted firmware.
+static void test_settings_from_sensor(void)
+{
+  hal_stub_device_t*  device;
+  fl_vl6180x_t        sensor;
+
+  hal_stub_reset();
+  memset(&_hi2c, 0, sizeof(_hi2c));
+  _hi2c.Instance = I2C1;
+  HAL_I2C_Init(&_hi2c);
+  hal_stub_set_i2c(0, &_hi2c, FL_I2C_SPEED_FAST);
+  fl_i2c_init(&_i2c);
+  _i2c.i2c = &_hi2c;
+
+  device = hal_stub_add_vl6180x(&_hi2c, GPIOA, SENSOR_CE_PIN);
+  HAL_GPIO_WritePin(GPIOA, SENSOR_CE_PIN, GPIO_PIN_SET);
+
+  memset(&sensor, 0, sizeof(sensor));
+  sensor.i2c = &_i2c;
+  sensor.dev_addr = SENSOR_ADDR;
+
+  FL_TEST_ASSERT_EQ(FL_OK, fl_vl6180x_init(&sensor));
+  FL_TEST_ASSERT_EQ(6, sensor.als_gain);
+  FL_TEST_ASSERT_EQ(100, sensor.als_int_time);
+
+  // Gain 40, 0x0123 + 1ms(the bits above the 9-bit field are ignored).
+  device->regs[FL_VL6180X_SYSALS_ANALOGUE_GAIN] = 0x47;
+  device->regs[FL_VL6180X_SYSALS_INTEGRATION_PERIOD] = 0xFF;
+  device->regs[FL_VL6180X_SYSALS_INTEGRATION_PERIOD + 1] = 0x23;
+  FL_TEST_ASSERT_EQ(FL_OK, fl_vl6180x_init(&sensor));
+  FL_TEST_ASSERT_EQ(7, sensor.als_gain);
+  FL_TEST_ASSERT_EQ(0x0124, sensor.als_int_time);
+  FL_TEST_ASSERT(is_truncated(expected_lux(7, 0x0124, 50000), fl_vl6180x_als_to_lux(&sensor, 50000)));
+}
+
+int main(void)
+{
+  FL_TEST_RUN(test_formula);
+  FL_TEST_RUN(test_limits);
+  FL_TEST_RUN(test_settings_from_sensor);
+
+  return FL_TEST_RESULT();
+}
@@ -0,0 +1,143 @@
+﻿using Fl.Net.Capture;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using Xunit;
+
+namespace Fl.Net.Tests
+{
+    // Sample stores in a temporary directory(deleted after each test).
+    public class FlSampleStoreTests : IDisposable
+    {
+        private const int SEGMENT_CAPACITY = 4;
+
+        private readonly string _directory = Path.Combine(Path.GetTempPath(), $"FlSampleStoreTests_{Guid.NewGuid():N}");
+        private readonly DateTime _start = new DateTime(2021, 5, 1, 0, 0, 0, DateTimeKind.Utc);
+
+        public void Dispose()
+        {
+            if (Directory.Exists(_directory))
+            {
+                Directory.Delete(_directory, true);
+            }
+        }
+
+        private FlSample CreateSample(int index)
+        {
+            return new FlSample()
+            {
+                Ticks = _start.AddMilliseconds(index * 10).Ticks,
+                Kind = FlSampleKind.Range,
+                Sensor = (byte)(index % 3),
+                Range = (byte)index,
+                Value = (UInt32)(index * 100)
+            };
+        }
+
+        private void Append(int first, int count)
+        {
+            using (var store = new FlSampleStore(_directory, SEGMENT_CAPACITY))
+            {
+                store.Append(Enumerable.Range(first, count).Select(CreateSample));
+            }
+        }
+
+        // An empty segment file as left by a store stopped between NewSegment() and its first sample.
+        private void CreateEmptySegment(int index)
+        {
+            Directory.CreateDirectory(_directory);
+            FlSampleSegment.Create(Path.Combine(_directory, $"{index:D6}{FlSampleStore.SEGMENT_FILE_EXT}"), SEGMENT_CAPACITY).Dispose();
+        }
+
+        private List<string> GetSegmentFiles()
+        {
+            return Directory.GetFiles(_directory, "*" + FlSampleStore.SEGMENT_FILE_EXT)
+                .Select(p => Path.GetFileName(p))
+                .OrderBy(p => p, StringComparer.Ordinal)
+                .ToList();
+        }
+
+        private void AssertSamples(int count)
+        {
+            using (var store = new FlSampleStore(_directory, SEGMENT_CAPACITY))
+            {
+                List<FlSample> samples = store.Query(DateTime.MinValue, DateTime.MaxValue).ToList();
+
+                Assert.Equal(count, store.Count);
+                Assert.Equal(Enumerable.Range(0, count).Select(CreateSample), samples);
+            }
+        }
+
+        [Fact]
+        public void ReopenAppendsAfterSegments()
+        {
+            Append(0, 6);
+            Append(6, 1);
+            Append(7, 5);
+
+            Assert.Equal(new[] { "000000.flts", "000001.flts", "000002.flts" }, GetSegmentFiles());
+            AssertSamples(12);
+        }
+
+        [Fact]
+        public void EmptyTrailingSegmentAfterFullSegment()
+        {
+            Append(0, SEGMENT_CAPACITY);
+            CreateEmptySegment(1);
+
+            Append(SEGMENT_CAPACITY, 2);
+
+            Assert.Equal(new[] { "000000.flts", "000001.flts" }, GetSegmentFiles());
+            AssertSamples(SEGMENT_CAPACITY + 2);
+        }
+
+        [Fact]
+        public void EmptyTrailingSegmentAfterPartialSegment()
+        {
+            Append(0, 2);
+            CreateEmptySegment(1);
+
+            // The partial segment is filled first, then 000001 is created again.
+            Append(2, 3);
+
+            Assert.Equal(new[] { "000000.flts", "000001.flts" }, GetSegmentFiles());
+            AssertSamples(5);
+        }
+
+        [Fact]
+        public void OnlyEmptySegments()
+        {
+            CreateEmptySegment(0);
+            CreateEmptySegment(1);
+
+            using (var store = new FlSampleStore(_directory, SEGMENT_CAPACITY))
+            {
+                Assert.Equal(0, store.Count);
+                Assert.False(store.GetTimeRange(out DateTime first, out DateTime last));
+                Assert.Empty(GetSegmentFiles());
+
+                store.Append(CreateSample(0));
+            }
+
+            Assert.Equal(new[] { "000000.flts" }, GetSegmentFiles());
+            AssertSamples(1);
+        }
+
+        [Fact]
+        public void EmptySegmentsRemovedAtOpen()
+        {
+            Append(0, SEGMENT_CAPACITY + 1);
+            CreateEmptySegment(2);
+            CreateEmptySegment(3);
+
+            using (var store = new FlSampleStore(_directory, SEGMENT_CAPACITY))
+            {
+                Assert.Equal(new[] { "000000.flts", "000001.flts" }, GetSegmentFiles());
+                Assert.True(store.GetTimeRange(out DateTime first, out DateTime last));
+                Assert.Equal(CreateSample(0).Time, first);
+                Assert.Equal(CreateSample(SEGMENT_CAPACITY).Time, last);
+            }
+        }
+    }
+}
@@ -0,0 +1,157 @@
+﻿using Fl.Net.Trace;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Fl.Net.Tests
+{
+    // Serial traces written to and read from memory.
+    public class FlSerialTraceTests
+    {
+        private const int LONG_WRITE_LENGTH = (UInt16.MaxValue * 2) + 100;
+
+        private static byte[] CreateData(int length)
+        {
+            return Enumerable.Range(0, length).Select(i => (byte)(i * 7)).ToArray();
+        }
+
+        private static byte[] WriteTrace(Action<FlSerialTraceWriter> write)
+        {
+            MemoryStream stream = new MemoryStream();
+
+            using (var writer = new FlSerialTraceWriter(stream))
+            {
+                write(writer);
+            }
+
+            // Still readable after the writer closed the stream.
+            return stream.ToArray();
+        }
+
+        private static List<FlTraceRecord> ReadTrace(byte[] trace)
+        {
+            List<FlTraceRecord> records = new List<FlTraceRecord>();
+
+            using (var reader = new FlSerialTraceReader(new MemoryStream(trace)))
+            {
+                while (reader.TryRead(out FlTraceRecord record))
+                {
+                    records.Add(record);
+                }
+            }
+
+            return records;
+        }
+
+        [Fact]
+        public void RoundTrip()
+        {
+            byte[] command = Encoding.ASCII.GetBytes("RFVER 1\n");
+            byte[] response = Encoding.ASCII.GetBytes("RFVER 1,0,1.0.0\n");
+            byte[] trace = WriteTrace(writer =>
+            {
+                writer.Write(FlTraceDirection.Tx, command, 0, command.Length);
+                writer.Write(FlTraceDirection.Rx, response, 2, response.Length - 2);
+            });
+            List<FlTraceRecord> records = ReadTrace(trace);
+
+            Assert.Equal(FlSerialTrace.HEADER_SIZE + (11 * 2) + command.Length + response.Length - 2, trace.Length);
+            Assert.Equal(2, records.Count);
+            Assert.Equal(FlTraceDirection.Tx, records[0].Direction);
+            Assert.Equal(command, records[0].Data);
+            Assert.Equal(FlTraceDirection.Rx, records[1].Direction);
+            Assert.Equal(response.Skip(2), records[1].Data);
+            Assert.True(records[0].Ticks <= records[1].Ticks);
+        }
+
+        // Consecutive records of the 16-bit length limit with the time of the write.
+        [Fact]
+        public void LongWriteSplit()
+        {
+            byte[] data = CreateData(LONG_WRITE_LENGTH);
+            byte[] tail = CreateData(3);
+            List<FlTraceRecord> records = ReadTrace(WriteTrace(writer =>
+            {
+                writer.Write(FlTraceDirection.Rx, data, 0, data.Length);
+                writer.Write(FlTraceDirection.Tx, tail, 0, tail.Length);
+            }));
+
+            Assert.Equal(4, records.Count);
+            Assert.Equal(new[] { UInt16.MaxValue, UInt16.MaxValue, 100, 3 }, records.Select(r => r.Data.Length));
+            Assert.All(records.Take(3), r => Assert.Equal(FlTraceDirection.Rx, r.Direction));
+            Assert.All(records.Take(3), r => Assert.Equal(records[0].Ticks, r.Ticks));
+            Assert.Equal(data, records.Take(3).SelectMany(r => r.Data));
+            Assert.Equal(tail, records[3].Data);
+        }
+
+        // A trace cut while its last record was written(in its data or its fields).
+        [Theory]
+        [InlineData(1)]
+        [InlineData(50)]
+        [InlineData(50 + 11)]
+        public void TruncatedLastRecordIgnored(int cut)
+        {
+            byte[] first = CreateData(10);
+            byte[] last = CreateData(50);
+            byte[] trace = WriteTrace(writer =>
+            {
+                writer.Write(FlTraceDirection.Rx, first, 0, first.Length);
+                writer.Write(FlTraceDirection.Rx, last, 0, last.Length);
+            });
+            List<FlTraceRecord> records = ReadTrace(trace.Take(trace.Length - cut).ToArray());
+
+            Assert.Single(records);
+            Assert.Equal(first, records[0].Data);
+        }
+
+        [Fact]
+        public void InvalidHeader()
+        {
+            byte[] trace = WriteTrace(writer => { });
+
+            Assert.Empty(ReadTrace(trace));
+
+            trace[0] ^= 0xFF;
+            Assert.Throws<InvalidDataException>(() => new FlSerialTraceReader(new MemoryStream(trace)));
+            Assert.Throws<InvalidDataException>(() => new FlSerialTraceReader(new MemoryStream(new byte[FlSerialTrace.HEADER_SIZE - 1])));
+        }
+
+        // Long writes of the message thread and the command callers : the split records of a write are
+        // consecutive, the records are in time order.
+        [Fact]
+        public void ConcurrentWritesInTimeOrder()
+        {
+            const int WRITER_COUNT = 4;
+            const int WRITE_COUNT = 50;
+
+            List<FlTraceRecord> records = ReadTrace(WriteTrace(writer =>
+            {
+                Parallel.For(0, WRITER_COUNT, n =>
+                {
+                    byte[] data = Enumerable.Repeat((byte)n, LONG_WRITE_LENGTH).ToArray();
+
+                    for (int i = 0; i < WRITE_COUNT; i++)
+                    {
+                        writer.Write((n == 0) ? FlTraceDirection.Rx : FlTraceDirection.Tx, data, 0, data.Length);
+                    }
+                });
+            }));
+
+            Assert.Equal(WRITER_COUNT * WRITE_COUNT * 3, records.Count);
+            for (int i = 0; i < records.Count; i += 3)
+            {
+                Assert.Equal(new[] { UInt16.MaxValue, UInt16.MaxValue, 100 }, records.Skip(i).Take(3).Select(r => r.Data.Length));
+                Assert.Equal(records[i].Data[0], records[i + 1].Data[0]);
+                Assert.Equal(records[i].Data[0], records[i + 2].Data[0]);
+            }
+            for (int i = 1; i < records.Count; i++)
+            {
+                Assert.True(records[i - 1].Ticks <= records[i].Ticks, $"Record {i} before the previous record");
+            }
+        }
+    }
+}
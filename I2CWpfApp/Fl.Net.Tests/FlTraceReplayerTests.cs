@@ -0,0 +1,87 @@
+﻿using Fl.Net.Message;
+using Fl.Net.Parser;
+using Fl.Net.Trace;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using Xunit;
+
+namespace Fl.Net.Tests
+{
+    // Replays through the message parser(the receive pipeline of FlTraceReplay).
+    public class FlTraceReplayerTests
+    {
+        private static FlTraceRecord CreateRecord(double seconds, FlTraceDirection direction, string data)
+        {
+            return new FlTraceRecord()
+            {
+                Ticks = TimeSpan.FromSeconds(seconds).Ticks,
+                Direction = direction,
+                Data = Encoding.ASCII.GetBytes(data)
+            };
+        }
+
+        private static FlReplayStats Replay(IList<FlTraceRecord> records, double speed)
+        {
+            FlTraceReplayer replayer = new FlTraceReplayer(records) { Speed = speed };
+            FlTxtParser parser = new FlTxtParser();
+
+            return replayer.Run((buf, length) =>
+            {
+                for (int i = 0; i < length; i++)
+                {
+                    FlParseState ret = parser.ParseResponseEvent(buf[i], out IFlMessage message);
+
+                    if (ret == FlParseState.ParseOk)
+                    {
+                        replayer.MessageDecoded();
+                    }
+                    else if (ret == FlParseState.ParseFail)
+                    {
+                        replayer.ParseFailed();
+                    }
+                }
+            });
+        }
+
+        // Sent bytes skipped, a message split across two reads decoded once, an unknown message counted as a failure.
+        [Fact]
+        public void FastReplayCounts()
+        {
+            List<FlTraceRecord> records = new List<FlTraceRecord>()
+            {
+                CreateRecord(0, FlTraceDirection.Rx, "EREDY 1,7,13\n"),
+                CreateRecord(10, FlTraceDirection.Tx, "RFVER 1\n"),
+                CreateRecord(20, FlTraceDirection.Rx, "RFVER 1,0,"),
+                CreateRecord(30, FlTraceDirection.Rx, "1.0.0\nABCDE\nEREDY 1,7,20\n"),
+                CreateRecord(600, FlTraceDirection.Tx, "RFVER 1\n")
+            };
+            FlReplayStats stats = Replay(records, FlTraceReplayer.SPEED_FAST);
+
+            Assert.Equal(3, stats.Records);
+            Assert.Equal(records.Where(r => r.Direction == FlTraceDirection.Rx).Sum(r => r.Data.Length), stats.Bytes);
+            Assert.Equal(3, stats.Messages);
+            Assert.Equal(1, stats.ParseFailures);
+            Assert.Equal(TimeSpan.FromSeconds(30), stats.TraceDuration);
+
+            // No waits for the 30s of the trace.
+            Assert.True(stats.Elapsed < TimeSpan.FromSeconds(10));
+        }
+
+        [Fact]
+        public void ScaledReplayWaits()
+        {
+            List<FlTraceRecord> records = new List<FlTraceRecord>()
+            {
+                CreateRecord(0, FlTraceDirection.Rx, "EREDY 1,7,13\n"),
+                CreateRecord(0.2, FlTraceDirection.Rx, "EREDY 1,7,20\n")
+            };
+            FlReplayStats stats = Replay(records, 2);
+
+            Assert.Equal(2, stats.Messages);
+            Assert.Equal(0, stats.ParseFailures);
+            Assert.True(stats.Elapsed >= TimeSpan.FromSeconds(0.1));
+        }
+    }
+}
@@ -0,0 +1,77 @@
+﻿using Fl.Net.Message;
+using System;
+
+namespace Fl.Net.Capture
+{
+    public enum FlSampleKind : byte
+    {
+        Range,          // ERANG : Value is the ALS count
+        Measurement,    // EMEAS : Value is the lux(Q16.16)
+        Capture         // RCAPT : Value is the ALS count
+    }
+
+    // A sample of the sample store(FlSampleStore).
+    public struct FlSample
+    {
+        public Int64 Ticks { get; set; }        // UTC DateTime ticks
+        public FlSampleKind Kind { get; set; }
+        public byte Sensor { get; set; }
+        public byte Range { get; set; }         // mm
+        public byte RangeStatus { get; set; }
+        public UInt32 Value { get; set; }
+
+        public DateTime Time => new DateTime(Ticks, DateTimeKind.Utc);
+
+        public static FlSample FromRangeResult(FlRangeResult result)
+        {
+            return new FlSample()
+            {
+                Ticks = result.ReceiveTime.ToUniversalTime().Ticks,
+                Kind = FlSampleKind.Range,
+                Sensor = result.Sensor,
+                Range = result.Range,
+                RangeStatus = result.RangeStatus,
+                Value = result.Als
+            };
+        }
+
+        public static FlSample FromMeasurement(FlMeasurement measurement)
+        {
+            return new FlSample()
+            {
+                Ticks = measurement.ReceiveTime.ToUniversalTime().Ticks,
+                Kind = FlSampleKind.Measurement,
+                Sensor = measurement.Sensor,
+                Range = measurement.Range,
+                RangeStatus = measurement.RangeStatus,
+                Value = measurement.LuxQ16
+            };
+        }
+
+        // time : host time of the capture sample(the device tick is not a wall clock).
+        public static FlSample FromCaptureSample(FlCaptureSample sample, DateTime time)
+        {
+            return new FlSample()
+            {
+                Ticks = time.ToUniversalTime().Ticks,
+                Kind = FlSampleKind.Capture,
+                Sensor = sample.Sensor,
+                Range = sample.Range,
+                RangeStatus = sample.RangeStatus,
+                Value = sample.Als
+            };
+        }
+    }
+
+    // Samples of a downsampling interval(FlSampleStore.Downsample()).
+    public class FlSampleBucket
+    {
+        public DateTime Start { get; set; }
+        public int Count { get; set; }
+        public byte MinRange { get; set; }
+        public byte MaxRange { get; set; }
+        public double MeanRange { get; set; }
+        public double MeanValue { get; set; }
+        public int ErrorCount { get; set; }     // Samples with a range error code
+    }
+}
@@ -0,0 +1,234 @@
+﻿using System;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Threading;
+
+namespace Fl.Net.Capture
+{
+    // A memory mapped segment file of the sample store, columns of a fixed capacity.
+    //   Header(64 bytes) : magic("FLTS", 4), version(2), reserved(2), capacity(4), count(4),
+    //                      first ticks(8), last ticks(8), reserved
+    //   Ticks(8 x capacity), values(4 x capacity), sensors, kinds, ranges, range status(1 x capacity)
+    // The count is written after the columns of a sample, a reader of the same file sees complete samples.
+    internal sealed unsafe class FlSampleSegment : IDisposable
+    {
+        public const UInt32 MAGIC = 0x53544C46;     // "FLTS"
+        public const UInt16 VERSION = 1;
+        public const int HEADER_SIZE = 64;
+        public const int SAMPLE_SIZE = 16;
+
+        private const int CAPACITY_OFFSET = 8;
+        private const int COUNT_OFFSET = 12;
+        private const int FIRST_TICKS_OFFSET = 16;
+        private const int LAST_TICKS_OFFSET = 24;
+
+        private readonly MemoryMappedFile _file;
+        private readonly MemoryMappedViewAccessor _view;
+        private readonly byte* _base;
+        private readonly Int64* _ticks;
+        private readonly UInt32* _values;
+        private readonly byte* _sensors;
+        private readonly byte* _kinds;
+        private readonly byte* _ranges;
+        private readonly byte* _rangeStatus;
+
+        public string Path { get; }
+        public int Capacity { get; }
+        public int Count => *(int*)(_base + COUNT_OFFSET);
+        public Int64 FirstTicks => *(Int64*)(_base + FIRST_TICKS_OFFSET);
+        public Int64 LastTicks => *(Int64*)(_base + LAST_TICKS_OFFSET);
+        public bool IsFull => Count >= Capacity;
+
+        private FlSampleSegment(string path, FileStream stream, int capacity, bool writable)
+        {
+            long size = GetFileSize(capacity);
+
+            Path = path;
+            Capacity = capacity;
+
+            _file = MemoryMappedFile.CreateFromFile(stream, null, size,
+                writable ? MemoryMappedFileAccess.ReadWrite : MemoryMappedFileAccess.Read,
+                HandleInheritability.None, false);
+            _view = _file.CreateViewAccessor(0, size, writable ? MemoryMappedFileAccess.ReadWrite : MemoryMappedFileAccess.Read);
+
+            byte* ptr = null;
+            _view.SafeMemoryMappedViewHandle.AcquirePointer(ref ptr);
+            _base = ptr + _view.PointerOffset;
+
+            _ticks = (Int64*)(_base + HEADER_SIZE);
+            _values = (UInt32*)(_base + HEADER_SIZE + 8L * capacity);
+            _sensors = _base + HEADER_SIZE + 12L * capacity;
+            _kinds = _sensors + capacity;
+            _ranges = _kinds + capacity;
+            _rangeStatus = _ranges + capacity;
+        }
+
+        public static long GetFileSize(int capacity)
+        {
+            return HEADER_SIZE + (long)SAMPLE_SIZE * capacity;
+        }
+
+        public static FlSampleSegment Create(string path, int capacity)
+        {
+            FileStream stream = new FileStream(path, FileMode.CreateNew, FileAccess.ReadWrite, FileShare.ReadWrite | FileShare.Delete);
+            FlSampleSegment segment;
+
+            stream.SetLength(GetFileSize(capacity));
+            segment = new FlSampleSegment(path, stream, capacity, true);
+
+            *(UInt32*)segment._base = MAGIC;
+            *(UInt16*)(segment._base + 4) = VERSION;
+            *(int*)(segment._base + CAPACITY_OFFSET) = capacity;
+
+            return segment;
+        }
+
+        // Read only segments are opened while the store writes them(the active segment).
+        public static FlSampleSegment Open(string path, bool writable)
+        {
+            FileStream stream = new FileStream(path, FileMode.Open,
+                writable ? FileAccess.ReadWrite : FileAccess.Read, FileShare.ReadWrite | FileShare.Delete);
+            byte[] header = new byte[HEADER_SIZE];
+            int capacity;
+
+            try
+            {
+                if ((stream.Read(header, 0, HEADER_SIZE) != HEADER_SIZE) ||
+                    (BitConverter.ToUInt32(header, 0) != MAGIC) ||
+                    (BitConverter.ToUInt16(header, 4) != VERSION))
+                {
+                    throw new InvalidDataException($"{path} : not a sample segment");
+                }
+
+                capacity = BitConverter.ToInt32(header, CAPACITY_OFFSET);
+                if ((capacity <= 0) || (stream.Length < GetFileSize(capacity)) ||
+                    (BitConverter.ToInt32(header, COUNT_OFFSET) > capacity))
+                {
+                    throw new InvalidDataException($"{path} : invalid sample segment header");
+                }
+            }
+            catch
+            {
+                stream.Dispose();
+                throw;
+            }
+
+            return new FlSampleSegment(path, stream, capacity, writable);
+        }
+
+        // The ticks of a sample are not less than the last ticks(ticks are clamped).
+        public bool Append(FlSample sample)
+        {
+            int count = Count;
+            Int64 ticks = sample.Ticks;
+
+            if (count >= Capacity)
+            {
+                return false;
+            }
+
+            if ((count > 0) && (ticks < LastTicks))
+            {
+                ticks = LastTicks;
+            }
+
+            _ticks[count] = ticks;
+            _values[count] = sample.Value;
+            _sensors[count] = sample.Sensor;
+            _kinds[count] = (byte)sample.Kind;
+            _ranges[count] = sample.Range;
+            _rangeStatus[count] = sample.RangeStatus;
+
+            if (count == 0)
+            {
+                *(Int64*)(_base + FIRST_TICKS_OFFSET) = ticks;
+            }
+            *(Int64*)(_base + LAST_TICKS_OFFSET) = ticks;
+            Thread.MemoryBarrier();
+            *(int*)(_base + COUNT_OFFSET) = count + 1;
+
+            return true;
+        }
+
+        public FlSample this[int index]
+        {
+            get
+            {
+                return new FlSample()
+                {
+                    Ticks = _ticks[index],
+                    Value = _values[index],
+                    Sensor = _sensors[index],
+                    Kind = (FlSampleKind)_kinds[index],
+                    Range = _ranges[index],
+                    RangeStatus = _rangeStatus[index]
+                };
+            }
+        }
+
+        public Int64 GetTicks(int index)
+        {
+            return _ticks[index];
+        }
+
+        public byte GetSensor(int index)
+        {
+            return _sensors[index];
+        }
+
+        public FlSampleKind GetKind(int index)
+        {
+            return (FlSampleKind)_kinds[index];
+        }
+
+        public byte GetRange(int index)
+        {
+            return _ranges[index];
+        }
+
+        public byte GetRangeStatus(int index)
+        {
+            return _rangeStatus[index];
+        }
+
+        public UInt32 GetValue(int index)
+        {
+            return _values[index];
+        }
+
+        // First index of a sample at or after ticks(count : none).
+        public int LowerBound(Int64 ticks, int count)
+        {
+            int low = 0;
+            int high = count;
+
+            while (low < high)
+            {
+                int mid = low + (high - low) / 2;
+
+                if (_ticks[mid] < ticks)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+
+            return low;
+        }
+
+        public void Flush()
+        {
+            _view.Flush();
+        }
+
+        public void Dispose()
+        {
+            _view.SafeMemoryMappedViewHandle.ReleasePointer();
+            _view.Dispose();
+            _file.Dispose();
+        }
+    }
+}
@@ -0,0 +1,331 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+
+namespace Fl.Net.Capture
+{
+    // Time series of samples in memory mapped segment files of a directory(FlSampleSegment, 000000.flts, ...).
+    // Samples are appended in time order(a sample older than the last one gets the last time),
+    // queries map only the segments of the time range and read them in place.
+    // Append() is called from one thread(the message thread), queries from any thread.
+    public sealed class FlSampleStore : IDisposable
+    {
+        public const int DEFAULT_SEGMENT_CAPACITY = 256 * 1024;     // 4MB segment files
+        public const string SEGMENT_FILE_EXT = ".flts";
+
+        private class SegmentInfo
+        {
+            public string Path;
+            public Int64 FirstTicks;
+            public Int64 LastTicks;
+            public int Count;
+        }
+
+        private readonly object _lock = new object();
+        private readonly List<SegmentInfo> _segments = new List<SegmentInfo>();
+        private readonly int _segmentCapacity;
+        private FlSampleSegment _active = null;
+        private SegmentInfo _activeInfo = null;
+        private Int64 _lastTicks = 0;
+        private bool _disposed = false;
+
+        public string Directory { get; }
+
+        public long Count
+        {
+            get
+            {
+                lock (_lock)
+                {
+                    return _segments.Sum(s => (long)s.Count);
+                }
+            }
+        }
+
+        // Existing segment files of the directory are kept, new samples are appended after them
+        // (to the last segment if it is not full). Empty segment files(the store stopped before the first sample
+        // of a new segment) are deleted, NewSegment() creates the next segment file again.
+        public FlSampleStore(string directory, int segmentCapacity = DEFAULT_SEGMENT_CAPACITY)
+        {
+            if (segmentCapacity <= 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(segmentCapacity));
+            }
+
+            Directory = directory;
+            _segmentCapacity = segmentCapacity;
+
+            System.IO.Directory.CreateDirectory(directory);
+            foreach (var path in System.IO.Directory.GetFiles(directory, "*" + SEGMENT_FILE_EXT).OrderBy(p => p, StringComparer.Ordinal))
+            {
+                SegmentInfo info = null;
+
+                using (var segment = FlSampleSegment.Open(path, false))
+                {
+                    if (segment.Count > 0)
+                    {
+                        info = new SegmentInfo()
+                        {
+                            Path = path,
+                            FirstTicks = segment.FirstTicks,
+                            LastTicks = segment.LastTicks,
+                            Count = segment.Count
+                        };
+                    }
+                }
+
+                if (info != null)
+                {
+                    _segments.Add(info);
+                }
+                else
+                {
+                    File.Delete(path);
+                }
+            }
+
+            if (_segments.Count > 0)
+            {
+                SegmentInfo last = _segments[_segments.Count - 1];
+                FlSampleSegment segment = FlSampleSegment.Open(last.Path, true);
+
+                _lastTicks = last.LastTicks;
+                if (segment.IsFull)
+                {
+                    segment.Dispose();
+                }
+                else
+                {
+                    _active = segment;
+                    _activeInfo = last;
+                }
+            }
+        }
+
+        public void Append(FlSample sample)
+        {
+            lock (_lock)
+            {
+                if (_disposed)
+                {
+                    throw new ObjectDisposedException(nameof(FlSampleStore));
+                }
+
+                if ((_active == null) || _active.IsFull)
+                {
+                    NewSegment();
+                }
+
+                if ((_segments.Count > 0) && (sample.Ticks < _lastTicks))
+                {
+                    sample.Ticks = _lastTicks;
+                }
+
+                _active.Append(sample);
+                if (_activeInfo.Count == 0)
+                {
+                    _activeInfo.FirstTicks = sample.Ticks;
+                }
+                _activeInfo.LastTicks = sample.Ticks;
+                _activeInfo.Count++;
+                _lastTicks = sample.Ticks;
+            }
+        }
+
+        public void Append(IEnumerable<FlSample> samples)
+        {
+            foreach (var sample in samples)
+            {
+                Append(sample);
+            }
+        }
+
+        // Time range of the samples(false : no samples).
+        public bool GetTimeRange(out DateTime first, out DateTime last)
+        {
+            lock (_lock)
+            {
+                first = last = default(DateTime);
+                if (_segments.Count == 0)
+                {
+                    return false;
+                }
+
+                first = new DateTime(_segments[0].FirstTicks, DateTimeKind.Utc);
+                last = new DateTime(_segments[_segments.Count - 1].LastTicks, DateTimeKind.Utc);
+
+                return true;
+            }
+        }
+
+        // Samples in [from, to], sensor < 0 : all sensors, kind null : all kinds.
+        // Samples are read while enumerating, one segment is mapped at a time.
+        public IEnumerable<FlSample> Query(DateTime from, DateTime to, int sensor = -1, FlSampleKind? kind = null)
+        {
+            Int64 fromTicks = from.ToUniversalTime().Ticks;
+            Int64 toTicks = to.ToUniversalTime().Ticks;
+
+            foreach (var info in GetSegments(fromTicks, toTicks))
+            {
+                using (var segment = FlSampleSegment.Open(info.Path, false))
+                {
+                    int count = info.Count;
+
+                    for (int i = segment.LowerBound(fromTicks, count); (i < count) && (segment.GetTicks(i) <= toTicks); i++)
+                    {
+                        if (((sensor < 0) || (segment.GetSensor(i) == sensor)) &&
+                            ((kind == null) || (segment.GetKind(i) == kind.Value)))
+                        {
+                            yield return segment[i];
+                        }
+                    }
+                }
+            }
+        }
+
+        // Statistics of the samples in [from, to] by interval(buckets without samples are skipped).
+        // Only the ticks, sensor, kind, range and value columns of the time range are read.
+        public List<FlSampleBucket> Downsample(DateTime from, DateTime to, TimeSpan interval, int sensor = -1, FlSampleKind? kind = null)
+        {
+            List<FlSampleBucket> buckets = new List<FlSampleBucket>();
+            Int64 fromTicks = from.ToUniversalTime().Ticks;
+            Int64 toTicks = to.ToUniversalTime().Ticks;
+            FlSampleBucket bucket = null;
+            Int64 bucketEnd = 0;
+            double rangeSum = 0;
+            double valueSum = 0;
+
+            if (interval.Ticks <= 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(interval));
+            }
+
+            foreach (var info in GetSegments(fromTicks, toTicks))
+            {
+                using (var segment = FlSampleSegment.Open(info.Path, false))
+                {
+                    int count = info.Count;
+
+                    for (int i = segment.LowerBound(fromTicks, count); i < count; i++)
+                    {
+                        Int64 ticks = segment.GetTicks(i);
+
+                        if (ticks > toTicks)
+                        {
+                            break;
+                        }
+
+                        if (((sensor >= 0) && (segment.GetSensor(i) != sensor)) ||
+                            ((kind != null) && (segment.GetKind(i) != kind.Value)))
+                        {
+                            continue;
+                        }
+
+                        if ((bucket == null) || (ticks >= bucketEnd))
+                        {
+                            CloseBucket(buckets, bucket, rangeSum, valueSum);
+
+                            Int64 start = fromTicks + ((ticks - fromTicks) / interval.Ticks) * interval.Ticks;
+                            bucket = new FlSampleBucket()
+                            {
+                                Start = new DateTime(start, DateTimeKind.Utc),
+                                MinRange = Byte.MaxValue,
+                                MaxRange = Byte.MinValue
+                            };
+                            bucketEnd = start + interval.Ticks;
+                            rangeSum = 0;
+                            valueSum = 0;
+                        }
+
+                        byte range = segment.GetRange(i);
+
+                        bucket.Count++;
+                        bucket.MinRange = Math.Min(bucket.MinRange, range);
+                        bucket.MaxRange = Math.Max(bucket.MaxRange, range);
+                        if (segment.GetRangeStatus(i) != 0)
+                        {
+                            bucket.ErrorCount++;
+                        }
+                        rangeSum += range;
+                        valueSum += segment.GetValue(i);
+                    }
+                }
+            }
+            CloseBucket(buckets, bucket, rangeSum, valueSum);
+
+            return buckets;
+        }
+
+        public void Flush()
+        {
+            lock (_lock)
+            {
+                _active?.Flush();
+            }
+        }
+
+        public void Dispose()
+        {
+            lock (_lock)
+            {
+                if (_active != null)
+                {
+                    _active.Flush();
+                    _active.Dispose();
+                    _active = null;
+                }
+                _disposed = true;
+            }
+        }
+
+        private static void CloseBucket(List<FlSampleBucket> buckets, FlSampleBucket bucket, double rangeSum, double valueSum)
+        {
+            if ((bucket == null) || (bucket.Count == 0))
+            {
+                return;
+            }
+
+            bucket.MeanRange = rangeSum / bucket.Count;
+            bucket.MeanValue = valueSum / bucket.Count;
+            buckets.Add(bucket);
+        }
+
+        // Copies of the segment infos overlapping [fromTicks, toTicks](counts at the call).
+        private List<SegmentInfo> GetSegments(Int64 fromTicks, Int64 toTicks)
+        {
+            lock (_lock)
+            {
+                return _segments
+                    .Where(s => (s.Count > 0) && (s.LastTicks >= fromTicks) && (s.FirstTicks <= toTicks))
+                    .Select(s => new SegmentInfo() { Path = s.Path, FirstTicks = s.FirstTicks, LastTicks = s.LastTicks, Count = s.Count })
+                    .ToList();
+            }
+        }
+
+        private void NewSegment()
+        {
+            int index = 0;
+
+            if (_active != null)
+            {
+                _active.Flush();
+                _active.Dispose();
+                _active = null;
+            }
+
+            if (_segments.Count > 0)
+            {
+                string name = Path.GetFileNameWithoutExtension(_segments[_segments.Count - 1].Path);
+
+                index = int.TryParse(name, out int last) ? (last + 1) : _segments.Count;
+            }
+
+            string path = Path.Combine(Directory, $"{index:D6}{SEGMENT_FILE_EXT}");
+
+            _active = FlSampleSegment.Create(path, _segmentCapacity);
+            _activeInfo = new SegmentInfo() { Path = path };
+            _segments.Add(_activeInfo);
+        }
+    }
+}
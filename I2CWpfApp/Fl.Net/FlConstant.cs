@@ -35,7 +35,22 @@ namespace Fl.Net
         ReadTempAndHum = 8,
         BootMode = 9,
         Reset = 10,
-        ReadWriteI2C = 11
+        ReadWriteI2C = 11,
+        CaptureControl = 12,
+        ReadCapture = 13,
+        CaptureEvent = 14,
+        ReadPerf = 15,
+        WriteI2CSpeed = 16,
+        ReadSensors = 17,
+        WriteRanging = 18,
+        RangeEvent = 19,
+        MeasurementEvent = 20,
+        WriteConfig = 21,
+        ReadConfig = 22,
+        WriteProfile = 23,
+        ReadyEvent = 24,
+        ReadBurst = 25,
+        UpdateBits = 26
     }
 
     public enum FlParseState
@@ -64,6 +79,27 @@ namespace Fl.Net
         public const byte FL_OK = 0;
         public const byte FL_ERROR = 1;
 
+        // I2C transfer errors(error field of a RWI2C response).
+        public const byte FL_I2C_ERR_ADDR_NACK = (FL_ERROR + 1);   // No acknowledge on the slave address.
+        public const byte FL_I2C_ERR_DATA_NACK = (FL_ERROR + 2);   // No acknowledge on a data byte.
+        public const byte FL_I2C_ERR_TIMEOUT = (FL_ERROR + 3);     // Transfer budget expired(clock stretching, stuck bus).
+        public const byte FL_I2C_ERR_ARB_LOST = (FL_ERROR + 4);    // Arbitration lost.
+        public const byte FL_I2C_ERR_BUS = (FL_ERROR + 5);         // Misplaced START/STOP or the peripheral is busy.
+
+        // Configuration log errors(error field of a WCONF, RCONF and WPROF response).
+        public const byte FL_FLASH_LOG_ERR_NOT_FOUND = (FL_ERROR + 1);  // The item is not stored(default value).
+        public const byte FL_FLASH_LOG_ERR_FULL = (FL_ERROR + 2);       // No room in the configuration sector.
+        public const byte FL_FLASH_LOG_ERR_FLASH = (FL_ERROR + 3);      // Flash erase or program failed.
+
+        // I2C bus number(i2c_num of RWI2C, WCAPT and WI2CS : I2C1, I2C2).
+        public const byte FL_I2C_NUM_MIN = 1;
+        public const byte FL_I2C_NUM_MAX = 2;
+
+        // I2C bus speed(SCL frequency, Hz).
+        public const uint FL_I2C_SPEED_STANDARD = 100000;
+        public const uint FL_I2C_SPEED_FAST = 400000;
+        public const uint FL_I2C_SPEED_FAST_PLUS = 1000000;
+
         public const byte FL_MSG_ID_BASE = 0;
         public const byte FL_MSG_ID_UNKNOWN = 0;
         public const byte FL_MSG_ID_READ_HW_VERSION = (FL_MSG_ID_BASE + 1);
@@ -77,6 +113,19 @@ namespace Fl.Net
         public const byte FL_MSG_ID_BOOT_MODE = (FL_MSG_ID_BASE + 9);
         public const byte FL_MSG_ID_RESET = (FL_MSG_ID_BASE + 10);
         public const byte FL_MSG_ID_READ_WRITE_I2C = (FL_MSG_ID_BASE + 11);
+        public const byte FL_MSG_ID_CAPTURE_CONTROL = (FL_MSG_ID_BASE + 12);
+        public const byte FL_MSG_ID_READ_CAPTURE = (FL_MSG_ID_BASE + 13);
+        public const byte FL_MSG_ID_CAPTURE_EVENT = (FL_MSG_ID_BASE + 14);
+        public const byte FL_MSG_ID_READ_PERF = (FL_MSG_ID_BASE + 15);
+        public const byte FL_MSG_ID_WRITE_I2C_SPEED = (FL_MSG_ID_BASE + 16);
+        public const byte FL_MSG_ID_READ_SENSORS = (FL_MSG_ID_BASE + 17);
+        public const byte FL_MSG_ID_WRITE_RANGING = (FL_MSG_ID_BASE + 18);
+        public const byte FL_MSG_ID_RANGE_EVENT = (FL_MSG_ID_BASE + 19);
+        public const byte FL_MSG_ID_MEASUREMENT_EVENT = (FL_MSG_ID_BASE + 20);
+        public const byte FL_MSG_ID_WRITE_CONFIG = (FL_MSG_ID_BASE + 21);
+        public const byte FL_MSG_ID_READ_CONFIG = (FL_MSG_ID_BASE + 22);
+        public const byte FL_MSG_ID_WRITE_PROFILE = (FL_MSG_ID_BASE + 23);
+        public const byte FL_MSG_ID_READY_EVENT = (FL_MSG_ID_BASE + 24);
 
         public const uint FL_MSG_MAX_STRING_LEN = 32;
         public const UInt32 FL_DEVICE_ID_UNKNOWN = 0;
@@ -92,6 +141,58 @@ namespace Fl.Net
         public const byte FL_BMODE_APP = 0;
         public const byte FL_BMODE_BOOTLOADER = 1;
 
+        public const byte FL_MSG_CAPTURE_STOP = 0;
+        public const byte FL_MSG_CAPTURE_START = 1;
+        public const int FL_CAPTURE_BATCH_SIZE = 32;    // Maximum number of samples in a RCAPT response.
+        public const int FL_MSG_I2C_MAX_BURST_LEN = 64; // Maximum number of bytes of a RBURS command.
+        public const ushort FL_MSG_CAPTURE_ALL_SENSORS = 0; // Capture address : all enumerated sensors(interleaved).
+        public const int FL_MSG_CAPTURE_SENSOR_SHIFT = 4;   // Sensor index in the range status of a sample.
+        public const byte FL_MSG_CAPTURE_ERROR_MASK = 0x0F; // Range error code in the range status of a sample.
+        public const int FL_MSG_SENSOR_MAX_COUNT = 3;       // Sensor address slots in a RSENS response.
+
+        // Ranging mode of a sensor(WRANG), results in range events(ERANG).
+        public const byte FL_MSG_RANGE_STOP = 0;            // Software standby.
+        public const byte FL_MSG_RANGE_SINGLE = 1;          // One range measurement.
+        public const byte FL_MSG_RANGE_CONTINUOUS = 2;      // Range measurement every period.
+        public const byte FL_MSG_RANGE_INTERLEAVED = 3;     // ALS then range measurement every period.
+        public const ushort FL_RANGE_PERIOD_MIN = 10;               // Continuous mode(ms, 10ms resolution).
+        public const ushort FL_RANGE_INTERLEAVED_PERIOD_MIN = 150;  // Interleaved mode(ms).
+        public const ushort FL_RANGE_PERIOD_MAX = 2550;
+        public const int FL_LUX_FRAC_BITS = 16;             // Lux of a measurement event(EMEAS) : Q16.16.
+
+        // Configuration items(WCONF, RCONF) stored in flash and applied at boot, a WCONF value 0 deletes the item.
+        public const byte FL_MSG_CONFIG_DEVICE_ID = 0;
+        public const byte FL_MSG_CONFIG_BAUD_RATE = 1;      // Message UART(bps)
+        public const byte FL_MSG_CONFIG_I2C1_SPEED = 2;     // SCL frequency(Hz)
+        public const byte FL_MSG_CONFIG_I2C2_SPEED = 3;
+        public const byte FL_MSG_CONFIG_PROFILES = 4;       // Mask of the stored profiles(read only)
+
+        // Register init profiles(WPROF) written by the device after each sensor enumeration.
+        public const byte FL_MSG_PROFILE_BEGIN = 0;
+        public const byte FL_MSG_PROFILE_ADD = 1;
+        public const byte FL_MSG_PROFILE_SAVE = 2;
+        public const byte FL_MSG_PROFILE_DELETE = 3;
+        public const byte FL_MSG_PROFILE_COUNT = 4;
+        public const int FL_MSG_PROFILE_MAX_ENTRIES = 32;
+        public const int FL_MSG_PROFILE_NAME_LEN = 12;      // Including the terminating null
+
+        public const byte FL_PERF_STAGE_PARSE = 0;      // First byte of a command to a parsed message.
+        public const byte FL_PERF_STAGE_HANDLER = 1;    // Parsed message to the end of the command handler.
+        public const byte FL_PERF_STAGE_I2C = 2;        // One I2C register transaction.
+        public const byte FL_PERF_STAGE_TX = 3;         // UART transmit of a response/event.
+        public const byte FL_PERF_STAGE_RX_TO_I2C = 4;  // Last byte of a RWI2C command to the start of its I2C transfer.
+        public const byte FL_PERF_STAGE_BOOT_TO_RX = 5;     // Reset to the message receive start(the first command is accepted).
+        public const byte FL_PERF_STAGE_BOOT_TO_READY = 6;  // Reset to the end of the boot sensor enumeration(ready event).
+        public const byte FL_PERF_STAGE_COUNT = 7;
+        public const int FL_PERF_HIST_BUCKETS = 16;
+        public const int FL_PERF_HIST_SHIFT = 9;
+        public const int FL_PERF_CORE_CLOCK_MHZ = 216;  // DWT cycle counter clock(SystemCoreClock).
+
+        // Deferred log records(fl_log.h) on an ITM stimulus port.
+        public const byte FL_LOG_SYNC = 0xA5;
+        public const int FL_LOG_MAX_ARGS = 3;
+        public const int FL_LOG_ITM_PORT = 1;
+
         public const uint FL_VER_STR_MAX_LEN = 32;
 
         public const byte FL_TXT_MSG_ID_MIN_CHAR = (byte)'A';
@@ -103,6 +204,7 @@ namespace Fl.Net
         public const byte FL_TXT_MSG_ARG_DELIMITER = (byte)',';
 
         public const UInt32 FL_TXT_MSG_MAX_LENGTH = 64;
+        public const UInt32 FL_TXT_MSG_MAX_BATCH_LENGTH = 512;    // Batch response(RCAPT, RBURS).
 
         public const byte FL_BIN_MSG_STX = 0x02;
         public const byte FL_BIN_MSG_ETX = 0x03;
@@ -145,9 +247,11 @@ namespace Fl.Net
         public const int FL_DEF_CMD_MAX_TRY_COUNT = 3;
         public const int FL_DEF_CMD_TRY_INTERVAL = 100; // millisecond
         public const int FL_DEF_CMD_RESPONSE_TIMEOUT = 50; // millisecond
+        public const int FL_BCAST_SLOT_GUARD = 2; // millisecond, added to the frame time of a broadcast response slot(FlUtil.BroadcastSlotTime()).
+        public const int FL_MAX_NODE_COUNT = 32; // Device IDs 1 ~ FL_MAX_NODE_COUNT on a multi-drop link.
 
         public const uint TXT_MSG_ID_MAX_LEN = 5;
-        public const uint TXT_DEVICE_ID_MAX_LEN = 2;
+        public const uint TXT_DEVICE_ID_MAX_LEN = 10;
         public const uint TXT_MSG_MAX_ARG_COUNT = 8;
 
         public const string STR_RHVER = "RHVER";    // Read hardware version.
@@ -161,6 +265,21 @@ namespace Fl.Net
         public const string STR_BMODE = "BMODE";    // Set boot mode.
         public const string STR_RESET = "RESET";    // Reset a target device.
         public const string STR_RWI2C = "RWI2C";    // Read/write I2C.
+        public const string STR_WCAPT = "WCAPT";    // Capture mode start/stop.
+        public const string STR_RCAPT = "RCAPT";    // Read captured samples.
+        public const string STR_ECAPT = "ECAPT";    // Capture watermark event.
+        public const string STR_RPERF = "RPERF";    // Read latency statistics.
+        public const string STR_WI2CS = "WI2CS";    // Write I2C bus speed.
+        public const string STR_RSENS = "RSENS";    // Read(enumerate) sensors.
+        public const string STR_WRANG = "WRANG";    // Write ranging mode of a sensor.
+        public const string STR_ERANG = "ERANG";    // Range result event.
+        public const string STR_EMEAS = "EMEAS";    // Range and lux event.
+        public const string STR_WCONF = "WCONF";    // Write a configuration item.
+        public const string STR_RCONF = "RCONF";    // Read a configuration item.
+        public const string STR_WPROF = "WPROF";    // Write a register init profile.
+        public const string STR_EREDY = "EREDY";    // Device ready event.
+        public const string STR_RBURS = "RBURS";    // Read consecutive I2C registers.
+        public const string STR_WBITS = "WBITS";    // Update I2C register bits.
         public const string STR_UNKNOWN = "UNKNOWN";
     }
 }
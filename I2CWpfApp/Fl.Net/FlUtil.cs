@@ -127,5 +127,14 @@ namespace Fl.Net
             return (ulong)(((SwapUInt32((uint)v) & 0xffffffffL) << 0x20) |
                             (SwapUInt32((uint)(v >> 0x20)) & 0xffffffffL));
         }
+
+        // Broadcast response slot(millisecond) of the firmware at a baud rate : a full text message
+        // (10 bits a byte) rounded up + FL_BCAST_SLOT_GUARD. Device N answers (N - 1) slots after the command.
+        public static int BroadcastSlotTime(int baudRate)
+        {
+            int frameBits = (int)FlConstant.FL_TXT_MSG_MAX_LENGTH * 10 * 1000;
+
+            return ((frameBits + baudRate - 1) / baudRate) + FlConstant.FL_BCAST_SLOT_GUARD;
+        }
     }
 }
@@ -0,0 +1,231 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+using System.Text.RegularExpressions;
+
+namespace Fl.Net.Log
+{
+    // Record of the firmware deferred log(fl_log_record_t).
+    public class FlLogRecord
+    {
+        public UInt16 FormatId { get; set; }
+        public string Name { get; set; }
+        public UInt32 Tick { get; set; }        // ms
+        public UInt32[] Arguments { get; set; }
+        public string Text { get; set; }
+
+        public override string ToString()
+        {
+            return $"{Tick,10} {Text}";
+        }
+    }
+
+    // Formats firmware log records with the format strings of fl_log_fmt.h.
+    public class FlLogDecoder
+    {
+        private static readonly Regex _formatRegex =
+            new Regex(@"^\s*FL_LOG_FMT\(\s*(\w+)\s*,\s*""((?:[^""\\]|\\.)*)""\s*\)");
+
+        private readonly List<string> _names = new List<string>();
+        private readonly List<string> _formats = new List<string>();
+
+        public int FormatCount => _formats.Count;
+
+        // Format IDs are the line order of the FL_LOG_FMT() entries.
+        public static FlLogDecoder FromFormatFile(string path)
+        {
+            FlLogDecoder decoder = new FlLogDecoder();
+
+            foreach (string line in File.ReadLines(path))
+            {
+                Match match = _formatRegex.Match(line);
+                if (match.Success)
+                {
+                    decoder._names.Add(match.Groups[1].Value);
+                    decoder._formats.Add(match.Groups[2].Value.Replace("\\\"", "\"").Replace("\\\\", "\\"));
+                }
+            }
+
+            return decoder;
+        }
+
+        // Records in a SWO capture(ITM packets).
+        public List<FlLogRecord> Decode(byte[] swo, int port = FlConstant.FL_LOG_ITM_PORT)
+        {
+            return DecodeRecords(ExtractItmPort(swo, port));
+        }
+
+        // Records in the data written to the stimulus port.
+        // A word without FL_LOG_SYNC is skipped(records cut by an ITM overflow).
+        public List<FlLogRecord> DecodeRecords(byte[] data)
+        {
+            List<FlLogRecord> records = new List<FlLogRecord>();
+            int pos = 0;
+
+            while ((pos + 8) <= data.Length)
+            {
+                UInt32 header = BitConverter.ToUInt32(data, pos);
+                UInt16 formatId = (UInt16)(header & 0xFFFF);
+                int argCount = (int)((header >> 16) & 0xFF);
+
+                if (((header >> 24) != FlConstant.FL_LOG_SYNC) ||
+                    (argCount > FlConstant.FL_LOG_MAX_ARGS) ||
+                    (formatId >= _formats.Count))
+                {
+                    pos += 4;
+                    continue;
+                }
+
+                if ((pos + 8 + argCount * 4) > data.Length)
+                {
+                    break;
+                }
+
+                UInt32[] args = new UInt32[argCount];
+                for (int i = 0; i < argCount; i++)
+                {
+                    args[i] = BitConverter.ToUInt32(data, pos + 8 + i * 4);
+                }
+
+                records.Add(new FlLogRecord()
+                {
+                    FormatId = formatId,
+                    Name = _names[formatId],
+                    Tick = BitConverter.ToUInt32(data, pos + 4),
+                    Arguments = args,
+                    Text = Format(_formats[formatId], args)
+                });
+
+                pos += 8 + argCount * 4;
+            }
+
+            return records;
+        }
+
+        // Payload of the software source packets of a stimulus port.
+        // Sync, overflow, timestamp, extension and hardware source packets are skipped.
+        public static byte[] ExtractItmPort(byte[] swo, int port)
+        {
+            List<byte> data = new List<byte>();
+            int pos = 0;
+
+            while (pos < swo.Length)
+            {
+                byte header = swo[pos++];
+
+                if ((header & 0x03) != 0)
+                {
+                    int size = ((header & 0x03) == 3) ? 4 : (header & 0x03);
+
+                    if ((pos + size) > swo.Length)
+                    {
+                        break;
+                    }
+
+                    if (((header & 0x04) == 0) && ((header >> 3) == port))
+                    {
+                        for (int i = 0; i < size; i++)
+                        {
+                            data.Add(swo[pos + i]);
+                        }
+                    }
+                    pos += size;
+                }
+                else if ((header == 0x00) || (header == 0x80) || (header == 0x70))
+                {
+                    // Sync(zeros, 0x80) or overflow.
+                }
+                else if ((header & 0x80) != 0)
+                {
+                    // Timestamp or extension packet with continuation bytes.
+                    while ((pos < swo.Length) && ((swo[pos++] & 0x80) != 0))
+                    {
+                    }
+                }
+            }
+
+            return data.ToArray();
+        }
+
+        // printf subset of fl_log_fmt.h : %u, %d, %x, %X with an optional 0 flag and width, %%.
+        public static string Format(string format, UInt32[] args)
+        {
+            StringBuilder sb = new StringBuilder();
+            int argIndex = 0;
+            int pos = 0;
+
+            while (pos < format.Length)
+            {
+                char c = format[pos++];
+
+                if ((c != '%') || (pos >= format.Length))
+                {
+                    sb.Append(c);
+                    continue;
+                }
+
+                if (format[pos] == '%')
+                {
+                    sb.Append('%');
+                    pos++;
+                    continue;
+                }
+
+                char pad = ' ';
+                int width = 0;
+
+                if (format[pos] == '0')
+                {
+                    pad = '0';
+                    pos++;
+                }
+                while ((pos < format.Length) && char.IsDigit(format[pos]))
+                {
+                    width = width * 10 + (format[pos++] - '0');
+                }
+                while ((pos < format.Length) && (format[pos] == 'l'))
+                {
+                    pos++;
+                }
+                if (pos >= format.Length)
+                {
+                    break;
+                }
+
+                char conversion = format[pos++];
+                string text;
+
+                if (argIndex >= args.Length)
+                {
+                    text = "?";
+                }
+                else
+                {
+                    UInt32 value = args[argIndex++];
+
+                    switch (conversion)
+                    {
+                        case 'd':
+                        case 'i':
+                            text = ((Int32)value).ToString();
+                            break;
+                        case 'x':
+                            text = value.ToString("x");
+                            break;
+                        case 'X':
+                            text = value.ToString("X");
+                            break;
+                        default:
+                            text = value.ToString();
+                            break;
+                    }
+                }
+
+                sb.Append(text.PadLeft(width, pad));
+            }
+
+            return sb.ToString();
+        }
+    }
+}
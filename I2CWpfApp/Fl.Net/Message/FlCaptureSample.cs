@@ -0,0 +1,44 @@
+﻿using System;
+using System.Collections.Generic;
+
+namespace Fl.Net.Message
+{
+    // A captured sample(fl_capture_sample_t).
+    public class FlCaptureSample
+    {
+        public const int SampleSize = 8;
+
+        public UInt32 Timestamp { get; set; }   // millisecond tick
+        public byte Range { get; set; }         // mm
+        public byte RangeStatus { get; set; }   // Range error code
+        public byte Sensor { get; set; }        // Sensor index(FL_MSG_CAPTURE_ALL_SENSORS capture)
+        public UInt16 Als { get; set; }         // ALS count
+
+        // Decode base64 encoded samples of a RCAPT response(little endian).
+        public static List<FlCaptureSample> Decode(string base64Data)
+        {
+            List<FlCaptureSample> samples = new List<FlCaptureSample>();
+
+            if (string.IsNullOrEmpty(base64Data) == true)
+            {
+                return samples;
+            }
+
+            byte[] data = Convert.FromBase64String(base64Data);
+
+            for (int i = 0; (i + SampleSize) <= data.Length; i += SampleSize)
+            {
+                samples.Add(new FlCaptureSample()
+                {
+                    Timestamp = (UInt32)(data[i] | (data[i + 1] << 8) | (data[i + 2] << 16) | (data[i + 3] << 24)),
+                    Range = data[i + 4],
+                    RangeStatus = (byte)(data[i + 5] & FlConstant.FL_MSG_CAPTURE_ERROR_MASK),
+                    Sensor = (byte)(data[i + 5] >> FlConstant.FL_MSG_CAPTURE_SENSOR_SHIFT),
+                    Als = (UInt16)(data[i + 6] | (data[i + 7] << 8))
+                });
+            }
+
+            return samples;
+        }
+    }
+}
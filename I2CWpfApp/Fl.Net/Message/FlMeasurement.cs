@@ -0,0 +1,43 @@
+﻿using System;
+
+namespace Fl.Net.Message
+{
+    // Range and lux of a sensor in the interleaved ranging mode(EMEAS event).
+    // The device converts the ALS count to lux, no ALS register reads are needed.
+    public class FlMeasurement
+    {
+        public byte Sensor { get; set; }        // Sensor index
+        public byte Range { get; set; }         // mm
+        public byte RangeStatus { get; set; }   // Range error code
+        public UInt32 LuxQ16 { get; set; }      // Lux(Q16.16)
+        public double Lux => (double)LuxQ16 / (1 << FlConstant.FL_LUX_FRAC_BITS);
+        public DateTime ReceiveTime { get; set; }
+
+        // Build from a measurement event(DeviceID, sensor, range, range error code, lux).
+        public static FlMeasurement FromEvent(IFlMessage evt)
+        {
+            if ((evt?.Arguments == null) ||
+                (evt.Arguments.Count != 5))
+            {
+                return null;
+            }
+
+            if ((byte.TryParse((string)evt.Arguments[1], out byte sensor) != true) ||
+                (byte.TryParse((string)evt.Arguments[2], out byte range) != true) ||
+                (byte.TryParse((string)evt.Arguments[3], out byte rangeStatus) != true) ||
+                (UInt32.TryParse((string)evt.Arguments[4], out UInt32 luxQ16) != true))
+            {
+                return null;
+            }
+
+            return new FlMeasurement()
+            {
+                Sensor = sensor,
+                Range = range,
+                RangeStatus = rangeStatus,
+                LuxQ16 = luxQ16,
+                ReceiveTime = (evt as FlTxtMessageEvent)?.ReceiveTime ?? DateTime.UtcNow
+            };
+        }
+    }
+}
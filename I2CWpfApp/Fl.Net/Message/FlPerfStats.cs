@@ -0,0 +1,62 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace Fl.Net.Message
+{
+    // Latency statistics of a firmware stage(fl_perf_stat_t), values are DWT cycles.
+    public class FlPerfStats
+    {
+        public byte Stage { get; set; }
+        public UInt32 Count { get; set; }
+        public UInt32 Min { get; set; }
+        public UInt32 Max { get; set; }
+        public UInt32 Mean { get; set; }
+        public UInt32[] Histogram { get; set; } = new UInt32[FlConstant.FL_PERF_HIST_BUCKETS];
+
+        public double MinMicroseconds => (double)Min / FlConstant.FL_PERF_CORE_CLOCK_MHZ;
+        public double MaxMicroseconds => (double)Max / FlConstant.FL_PERF_CORE_CLOCK_MHZ;
+        public double MeanMicroseconds => (double)Mean / FlConstant.FL_PERF_CORE_CLOCK_MHZ;
+
+        // Build from a RPERF response(DeviceID, error, stage, count, min, max, mean, histogram).
+        public static FlPerfStats FromResponse(IFlMessage response)
+        {
+            if ((response?.Arguments == null) ||
+                (response.Arguments.Count != 8) ||
+                ((string)response.Arguments[1] != $"{FlConstant.FL_OK}"))
+            {
+                return null;
+            }
+
+            FlPerfStats stats = new FlPerfStats()
+            {
+                Stage = byte.Parse((string)response.Arguments[2]),
+                Count = UInt32.Parse((string)response.Arguments[3]),
+                Min = UInt32.Parse((string)response.Arguments[4]),
+                Max = UInt32.Parse((string)response.Arguments[5]),
+                Mean = UInt32.Parse((string)response.Arguments[6])
+            };
+
+            byte[] hist = Convert.FromBase64String((string)response.Arguments[7]);
+            for (int i = 0; (i < stats.Histogram.Length) && ((i * 4 + 3) < hist.Length); i++)
+            {
+                stats.Histogram[i] = (UInt32)(hist[i * 4] | (hist[i * 4 + 1] << 8) | (hist[i * 4 + 2] << 16) | (hist[i * 4 + 3] << 24));
+            }
+
+            return stats;
+        }
+
+        public override string ToString()
+        {
+            StringBuilder sb = new StringBuilder();
+
+            sb.Append($"Stage {Stage} : count {Count}, min {MinMicroseconds:F2}us, max {MaxMicroseconds:F2}us, mean {MeanMicroseconds:F2}us, hist");
+            for (int i = 0; i < Histogram.Length; i++)
+            {
+                sb.Append($" {Histogram[i]}");
+            }
+
+            return sb.ToString();
+        }
+    }
+}
@@ -0,0 +1,41 @@
+﻿using System;
+
+namespace Fl.Net.Message
+{
+    // A range result of a sensor in a ranging mode(ERANG event).
+    public class FlRangeResult
+    {
+        public byte Sensor { get; set; }        // Sensor index
+        public byte Range { get; set; }         // mm
+        public byte RangeStatus { get; set; }   // Range error code
+        public UInt16 Als { get; set; }         // ALS count(interleaved mode)
+        public DateTime ReceiveTime { get; set; }
+
+        // Build from a range event(DeviceID, sensor, range, range error code, ALS count).
+        public static FlRangeResult FromEvent(IFlMessage evt)
+        {
+            if ((evt?.Arguments == null) ||
+                (evt.Arguments.Count != 5))
+            {
+                return null;
+            }
+
+            if ((byte.TryParse((string)evt.Arguments[1], out byte sensor) != true) ||
+                (byte.TryParse((string)evt.Arguments[2], out byte range) != true) ||
+                (byte.TryParse((string)evt.Arguments[3], out byte rangeStatus) != true) ||
+                (UInt16.TryParse((string)evt.Arguments[4], out UInt16 als) != true))
+            {
+                return null;
+            }
+
+            return new FlRangeResult()
+            {
+                Sensor = sensor,
+                Range = range,
+                RangeStatus = rangeStatus,
+                Als = als,
+                ReceiveTime = (evt as FlTxtMessageEvent)?.ReceiveTime ?? DateTime.UtcNow
+            };
+        }
+    }
+}
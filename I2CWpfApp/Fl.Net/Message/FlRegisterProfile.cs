@@ -0,0 +1,23 @@
+﻿using System.Collections.Generic;
+
+namespace Fl.Net.Message
+{
+    // A register write of a register init profile.
+    public class FlProfileEntry
+    {
+        public byte I2cNum { get; set; } = FlConstant.FL_I2C_NUM_MIN;
+        public byte DevAddr { get; set; }       // 8-bit device address
+        public ushort RegAddr { get; set; }
+        public uint Value { get; set; }
+    }
+
+    // Register init profile stored on the device(WPROF), the device writes it after each sensor enumeration.
+    public class FlRegisterProfile
+    {
+        // FL_MSG_PROFILE_NAME_LEN - 1 characters at most, without spaces and commas.
+        public string Name { get; set; }
+
+        // FL_MSG_PROFILE_MAX_ENTRIES at most, written in order.
+        public List<FlProfileEntry> Entries { get; } = new List<FlProfileEntry>();
+    }
+}
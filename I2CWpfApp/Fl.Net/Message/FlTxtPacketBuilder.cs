@@ -19,7 +19,22 @@ namespace Fl.Net.Message
             { FlMessageId.ReadTempAndHum, FlConstant.STR_RTAH },
             { FlMessageId.BootMode, FlConstant.STR_BMODE },
             { FlMessageId.Reset, FlConstant.STR_RESET },
-            { FlMessageId.ReadWriteI2C, FlConstant.STR_RWI2C }
+            { FlMessageId.ReadWriteI2C, FlConstant.STR_RWI2C },
+            { FlMessageId.CaptureControl, FlConstant.STR_WCAPT },
+            { FlMessageId.ReadCapture, FlConstant.STR_RCAPT },
+            { FlMessageId.CaptureEvent, FlConstant.STR_ECAPT },
+            { FlMessageId.ReadPerf, FlConstant.STR_RPERF },
+            { FlMessageId.WriteI2CSpeed, FlConstant.STR_WI2CS },
+            { FlMessageId.ReadSensors, FlConstant.STR_RSENS },
+            { FlMessageId.WriteRanging, FlConstant.STR_WRANG },
+            { FlMessageId.RangeEvent, FlConstant.STR_ERANG },
+            { FlMessageId.MeasurementEvent, FlConstant.STR_EMEAS },
+            { FlMessageId.WriteConfig, FlConstant.STR_WCONF },
+            { FlMessageId.ReadConfig, FlConstant.STR_RCONF },
+            { FlMessageId.WriteProfile, FlConstant.STR_WPROF },
+            { FlMessageId.ReadyEvent, FlConstant.STR_EREDY },
+            { FlMessageId.ReadBurst, FlConstant.STR_RBURS },
+            { FlMessageId.UpdateBits, FlConstant.STR_WBITS }
         };
 
         public static Dictionary<string, FlMessageId> StringToMessageIdTable = new Dictionary<string, FlMessageId>()
@@ -35,7 +50,22 @@ namespace Fl.Net.Message
             { FlConstant.STR_RTAH, FlMessageId.ReadTempAndHum },
             { FlConstant.STR_BMODE, FlMessageId.BootMode },
             { FlConstant.STR_RESET, FlMessageId.Reset },
-            { FlConstant.STR_RWI2C, FlMessageId.ReadWriteI2C }
+            { FlConstant.STR_RWI2C, FlMessageId.ReadWriteI2C },
+            { FlConstant.STR_WCAPT, FlMessageId.CaptureControl },
+            { FlConstant.STR_RCAPT, FlMessageId.ReadCapture },
+            { FlConstant.STR_ECAPT, FlMessageId.CaptureEvent },
+            { FlConstant.STR_RPERF, FlMessageId.ReadPerf },
+            { FlConstant.STR_WI2CS, FlMessageId.WriteI2CSpeed },
+            { FlConstant.STR_RSENS, FlMessageId.ReadSensors },
+            { FlConstant.STR_WRANG, FlMessageId.WriteRanging },
+            { FlConstant.STR_ERANG, FlMessageId.RangeEvent },
+            { FlConstant.STR_EMEAS, FlMessageId.MeasurementEvent },
+            { FlConstant.STR_WCONF, FlMessageId.WriteConfig },
+            { FlConstant.STR_RCONF, FlMessageId.ReadConfig },
+            { FlConstant.STR_WPROF, FlMessageId.WriteProfile },
+            { FlConstant.STR_EREDY, FlMessageId.ReadyEvent },
+            { FlConstant.STR_RBURS, FlMessageId.ReadBurst },
+            { FlConstant.STR_WBITS, FlMessageId.UpdateBits }
         };
 
         public static void BuildMessagePacket(ref IFlMessage txtMessage)
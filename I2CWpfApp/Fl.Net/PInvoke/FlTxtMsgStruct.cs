@@ -50,5 +50,9 @@ namespace Fl.Net.PInvoke
         public fl_msg_cb_on_parsed_t on_parsed_callback;
         public fl_msg_dbg_cb_on_parse_started_t on_parse_started_callback;
         public fl_msg_dbg_cb_on_parse_ended_t on_parse_ended_callback;
+
+        // Command table(fl_txt_msg_cmd_def_t array) indexed by message ID.
+        public IntPtr cmd_table;
+        public byte cmd_count;
     }
 }
@@ -16,9 +16,10 @@ namespace Fl.Net.Parser
         }
 
         #region Private Data
-        private byte[] _buf = new byte[FlConstant.FL_TXT_MSG_MAX_LENGTH];
+        // Batch responses(RCAPT) carry a long base64 argument.
+        private byte[] _buf = new byte[FlConstant.FL_TXT_MSG_MAX_BATCH_LENGTH];
         private int _bufPos = 0;
-        private byte[] _fullPacket = new byte[FlConstant.FL_TXT_MSG_MAX_LENGTH];
+        private byte[] _fullPacket = new byte[FlConstant.FL_TXT_MSG_MAX_BATCH_LENGTH];
         private int _fullPacketLength = 0;
         private ReceiveState _receiveState;
         private StringBuilder _sb = new StringBuilder();
@@ -37,7 +38,7 @@ namespace Fl.Net.Parser
             FlParseState ret = FlParseState.Parsing;
 
             message = null;
-            if (_fullPacketLength < FlConstant.FL_TXT_MSG_MAX_LENGTH)
+            if (_fullPacketLength < _fullPacket.Length)
             {
                 _fullPacket[_fullPacketLength++] = data;
             }
@@ -124,7 +125,7 @@ namespace Fl.Net.Parser
                         if (data != FlConstant.FL_TXT_MSG_ARG_DELIMITER)
                         {
                             _buf[_bufPos++] = data;
-                            if (_bufPos >= FlConstant.FL_TXT_MSG_MAX_LENGTH)
+                            if (_bufPos >= _buf.Length)
                             {
                                 ret = FlParseState.ParseFail;
                             }
@@ -197,7 +198,7 @@ namespace Fl.Net.Parser
             FlParseState ret = FlParseState.Parsing;
 
             message = null;
-            if (_fullPacketLength < FlConstant.FL_TXT_MSG_MAX_LENGTH)
+            if (_fullPacketLength < _fullPacket.Length)
             {
                 _fullPacket[_fullPacketLength++] = data;
             }
@@ -277,7 +278,7 @@ namespace Fl.Net.Parser
                         if (data != FlConstant.FL_TXT_MSG_ARG_DELIMITER)
                         {
                             _buf[_bufPos++] = data;
-                            if (_bufPos >= FlConstant.FL_TXT_MSG_MAX_LENGTH)
+                            if (_bufPos >= _buf.Length)
                             {
                                 ret = FlParseState.ParseFail;
                             }
@@ -324,7 +325,11 @@ namespace Fl.Net.Parser
                     }
                     else
                     {
-                        if (_msgId == FlMessageId.ButtonEvent)
+                        if ((_msgId == FlMessageId.ButtonEvent) ||
+                            (_msgId == FlMessageId.CaptureEvent) ||
+                            (_msgId == FlMessageId.RangeEvent) ||
+                            (_msgId == FlMessageId.MeasurementEvent) ||
+                            (_msgId == FlMessageId.ReadyEvent))
                         {
                             message = new FlTxtMessageEvent()
                             {
@@ -427,6 +432,53 @@ namespace Fl.Net.Parser
                     return AddStringArgument();
                 }
             }
+            else if (_msgId == FlMessageId.CaptureControl)
+            {
+                if (_arguments.Count < 6)
+                {
+                    return AddStringArgument();
+                }
+            }
+            else if ((_msgId == FlMessageId.ReadCapture) ||
+                     (_msgId == FlMessageId.ReadSensors) ||
+                     (_msgId == FlMessageId.ReadConfig))
+            {
+                if (_arguments.Count < 2)
+                {
+                    return AddStringArgument();
+                }
+            }
+            else if ((_msgId == FlMessageId.ReadPerf) ||
+                     (_msgId == FlMessageId.WriteI2CSpeed) ||
+                     (_msgId == FlMessageId.WriteConfig))
+            {
+                if (_arguments.Count < 3)
+                {
+                    return AddStringArgument();
+                }
+            }
+            else if (_msgId == FlMessageId.WriteRanging)
+            {
+                if (_arguments.Count < 4)
+                {
+                    return AddStringArgument();
+                }
+            }
+            else if (_msgId == FlMessageId.ReadBurst)
+            {
+                if (_arguments.Count < 5)
+                {
+                    return AddStringArgument();
+                }
+            }
+            else if ((_msgId == FlMessageId.WriteProfile) ||
+                     (_msgId == FlMessageId.UpdateBits))
+            {
+                if (_arguments.Count < 6)
+                {
+                    return AddStringArgument();
+                }
+            }
 
             return false;
         }
@@ -440,7 +492,9 @@ namespace Fl.Net.Parser
 
             if ((_msgId == FlMessageId.ReadHardwareVersion) ||
                 (_msgId == FlMessageId.ReadFirmwareVersion) ||
-                (_msgId == FlMessageId.ButtonEvent))
+                (_msgId == FlMessageId.ButtonEvent) ||
+                (_msgId == FlMessageId.ReadyEvent) ||
+                (_msgId == FlMessageId.UpdateBits))
             {
                 if (_arguments.Count < 3)
                 {
@@ -449,7 +503,8 @@ namespace Fl.Net.Parser
             }
             else if ((_msgId == FlMessageId.ReadGpio) ||
                      (_msgId == FlMessageId.ReadTemperature) ||
-                     (_msgId == FlMessageId.ReadHumidity))
+                     (_msgId == FlMessageId.ReadHumidity) ||
+                     (_msgId == FlMessageId.ReadConfig))
             {
                 if (_arguments.Count < 4)
                 {
@@ -458,27 +513,51 @@ namespace Fl.Net.Parser
             }
             else if ((_msgId == FlMessageId.WriteGpio) ||
                      (_msgId == FlMessageId.BootMode) ||
-                     (_msgId == FlMessageId.Reset))
+                     (_msgId == FlMessageId.Reset) ||
+                     (_msgId == FlMessageId.CaptureControl) ||
+                     (_msgId == FlMessageId.CaptureEvent) ||
+                     (_msgId == FlMessageId.WriteI2CSpeed) ||
+                     (_msgId == FlMessageId.WriteRanging) ||
+                     (_msgId == FlMessageId.WriteConfig) ||
+                     (_msgId == FlMessageId.WriteProfile))
             {
                 if (_arguments.Count < 2)
                 {
                     return AddStringArgument();
                 }
             }
-            else if (_msgId == FlMessageId.ReadTempAndHum)
+            else if ((_msgId == FlMessageId.ReadTempAndHum) ||
+                     (_msgId == FlMessageId.RangeEvent) ||
+                     (_msgId == FlMessageId.MeasurementEvent))
             {
                 if (_arguments.Count < 5)
                 {
                     return AddStringArgument();
                 }
             }
-            else if (_msgId == FlMessageId.ReadWriteI2C)
+            else if ((_msgId == FlMessageId.ReadWriteI2C) ||
+                     (_msgId == FlMessageId.ReadBurst))
             {
                 if (_arguments.Count < 7)
                 {
                     return AddStringArgument();
                 }
             }
+            else if ((_msgId == FlMessageId.ReadCapture) ||
+                     (_msgId == FlMessageId.ReadSensors))
+            {
+                if (_arguments.Count < 6)
+                {
+                    return AddStringArgument();
+                }
+            }
+            else if (_msgId == FlMessageId.ReadPerf)
+            {
+                if (_arguments.Count < 8)
+                {
+                    return AddStringArgument();
+                }
+            }
 
             return false;
         }
@@ -520,6 +599,17 @@ namespace Fl.Net.Parser
                 case FlMessageId.ReadTempAndHum:
                 case FlMessageId.BootMode:
                 case FlMessageId.ReadWriteI2C:
+                case FlMessageId.CaptureControl:
+                case FlMessageId.ReadCapture:
+                case FlMessageId.ReadPerf:
+                case FlMessageId.WriteI2CSpeed:
+                case FlMessageId.ReadSensors:
+                case FlMessageId.WriteRanging:
+                case FlMessageId.WriteConfig:
+                case FlMessageId.ReadConfig:
+                case FlMessageId.WriteProfile:
+                case FlMessageId.ReadBurst:
+                case FlMessageId.UpdateBits:
                     return true;
             }
             return false;
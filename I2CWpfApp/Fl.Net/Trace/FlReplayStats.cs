@@ -0,0 +1,58 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Fl.Net.Trace
+{
+    // Result of a trace replay(FlTraceReplayer.Run()).
+    public class FlReplayStats
+    {
+        public double Speed { get; set; }
+        public int Records { get; set; }
+        public long Bytes { get; set; }
+        public int Messages { get; set; }
+        public int ParseFailures { get; set; }
+        public TimeSpan TraceDuration { get; set; }     // Time of the last replayed record in the trace
+        public TimeSpan Elapsed { get; set; }
+        public TimeSpan MaxLag { get; set; }            // Latest record hand over behind the replay timing
+
+        // Decode latency of the messages in us.
+        public double LatencyMean { get; set; }
+        public double LatencyP50 { get; set; }
+        public double LatencyP99 { get; set; }
+        public double LatencyMax { get; set; }
+
+        public double BytesPerSecond => (Elapsed.Ticks > 0) ? Bytes / Elapsed.TotalSeconds : 0;
+        public double MessagesPerSecond => (Elapsed.Ticks > 0) ? Messages / Elapsed.TotalSeconds : 0;
+
+        // latencies : Stopwatch ticks.
+        public void SetLatencies(List<long> latencies, long frequency)
+        {
+            double usPerTick = 1000000.0 / frequency;
+
+            if (latencies.Count == 0)
+            {
+                LatencyMean = LatencyP50 = LatencyP99 = LatencyMax = 0;
+                return;
+            }
+
+            long[] sorted = latencies.ToArray();
+            Array.Sort(sorted);
+
+            LatencyMean = sorted.Average() * usPerTick;
+            LatencyP50 = sorted[(sorted.Length - 1) / 2] * usPerTick;
+            LatencyP99 = sorted[(int)((sorted.Length - 1) * 0.99)] * usPerTick;
+            LatencyMax = sorted[sorted.Length - 1] * usPerTick;
+        }
+
+        public override string ToString()
+        {
+            string speed = (Speed > 0) ? $"x{Speed}" : "fast";
+
+            return $"Replay {speed} : {Records} records, {Bytes} bytes, {Messages} messages, {ParseFailures} parse failures, " +
+                $"trace {TraceDuration.TotalSeconds:F3}s, elapsed {Elapsed.TotalSeconds:F3}s, max lag {MaxLag.TotalMilliseconds:F2}ms, " +
+                $"{BytesPerSecond / 1000000:F2}MB/s, {MessagesPerSecond:F0} messages/s, " +
+                $"latency mean {LatencyMean:F2}us, p50 {LatencyP50:F2}us, p99 {LatencyP99:F2}us, max {LatencyMax:F2}us";
+        }
+    }
+}
@@ -0,0 +1,174 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+
+namespace Fl.Net.Trace
+{
+    public enum FlTraceDirection : byte
+    {
+        Rx,     // Device to host
+        Tx      // Host to device
+    }
+
+    // Bytes of a serial read or write in a trace.
+    public class FlTraceRecord
+    {
+        public Int64 Ticks { get; set; }        // Time since the trace start(TimeSpan ticks)
+        public FlTraceDirection Direction { get; set; }
+        public byte[] Data { get; set; }
+    }
+
+    // Trace file of the serial bytes(FlSerialTraceWriter, FlSerialTraceReader).
+    //   Header(16 bytes) : magic("FLTR", 4), version(2), reserved(2), start time(UTC DateTime ticks, 8)
+    //   Record : ticks since the start(8), direction(1), length(2), data
+    public static class FlSerialTrace
+    {
+        public const UInt32 MAGIC = 0x52544C46;     // "FLTR"
+        public const UInt16 VERSION = 1;
+        public const int HEADER_SIZE = 16;
+        public const string FILE_EXT = ".fltr";
+    }
+
+    // Records are written from the message thread(Rx) and the command callers(Tx).
+    public sealed class FlSerialTraceWriter : IDisposable
+    {
+        private const int BUFFER_SIZE = 64 * 1024;
+
+        private readonly object _lock = new object();
+        private readonly BinaryWriter _writer;
+        private readonly Stopwatch _stopwatch = Stopwatch.StartNew();
+
+        public DateTime StartTime { get; }
+
+        public FlSerialTraceWriter(string fileName)
+            : this(new FileStream(fileName, FileMode.Create, FileAccess.Write, FileShare.Read, BUFFER_SIZE))
+        {
+        }
+
+        public FlSerialTraceWriter(Stream stream)
+        {
+            StartTime = DateTime.UtcNow;
+
+            _writer = new BinaryWriter(stream);
+            _writer.Write(FlSerialTrace.MAGIC);
+            _writer.Write(FlSerialTrace.VERSION);
+            _writer.Write((UInt16)0);
+            _writer.Write(StartTime.Ticks);
+        }
+
+        // The time is taken under the lock, the records are in time order across the writing threads.
+        public void Write(FlTraceDirection direction, byte[] buf, int offset, int count)
+        {
+            lock (_lock)
+            {
+                Int64 ticks = (Int64)(_stopwatch.ElapsedTicks * ((double)TimeSpan.TicksPerSecond / Stopwatch.Frequency));
+
+                // Longer writes are split into consecutive records, the length is 16 bits.
+                while (count > 0)
+                {
+                    int length = Math.Min(count, UInt16.MaxValue);
+
+                    _writer.Write(ticks);
+                    _writer.Write((byte)direction);
+                    _writer.Write((UInt16)length);
+                    _writer.Write(buf, offset, length);
+
+                    offset += length;
+                    count -= length;
+                }
+            }
+        }
+
+        public void Flush()
+        {
+            lock (_lock)
+            {
+                _writer.Flush();
+            }
+        }
+
+        public void Dispose()
+        {
+            lock (_lock)
+            {
+                _writer.Dispose();
+            }
+        }
+    }
+
+    public sealed class FlSerialTraceReader : IDisposable
+    {
+        private readonly BinaryReader _reader;
+
+        public DateTime StartTime { get; }
+
+        public FlSerialTraceReader(Stream stream)
+        {
+            _reader = new BinaryReader(stream);
+
+            if ((stream.Length - stream.Position < FlSerialTrace.HEADER_SIZE) ||
+                (_reader.ReadUInt32() != FlSerialTrace.MAGIC) ||
+                (_reader.ReadUInt16() != FlSerialTrace.VERSION))
+            {
+                _reader.Dispose();
+                throw new InvalidDataException("Not a serial trace");
+            }
+
+            _reader.ReadUInt16();
+            StartTime = new DateTime(_reader.ReadInt64(), DateTimeKind.Utc);
+        }
+
+        // Records of a trace file, all in memory so that a replay does not read the file.
+        public static List<FlTraceRecord> Load(string fileName)
+        {
+            List<FlTraceRecord> records = new List<FlTraceRecord>();
+
+            using (var reader = new FlSerialTraceReader(new FileStream(fileName, FileMode.Open, FileAccess.Read, FileShare.ReadWrite)))
+            {
+                while (reader.TryRead(out FlTraceRecord record))
+                {
+                    records.Add(record);
+                }
+            }
+
+            return records;
+        }
+
+        // false : end of the trace(a truncated last record is ignored).
+        public bool TryRead(out FlTraceRecord record)
+        {
+            Stream stream = _reader.BaseStream;
+
+            record = null;
+            if (stream.Length - stream.Position < 11)
+            {
+                return false;
+            }
+
+            Int64 ticks = _reader.ReadInt64();
+            FlTraceDirection direction = (FlTraceDirection)_reader.ReadByte();
+            UInt16 length = _reader.ReadUInt16();
+            byte[] data = _reader.ReadBytes(length);
+
+            if (data.Length != length)
+            {
+                return false;
+            }
+
+            record = new FlTraceRecord()
+            {
+                Ticks = ticks,
+                Direction = direction,
+                Data = data
+            };
+
+            return true;
+        }
+
+        public void Dispose()
+        {
+            _reader.Dispose();
+        }
+    }
+}
@@ -0,0 +1,111 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+
+namespace Fl.Net.Trace
+{
+    // Replays the received bytes of a trace through a receive pipeline(the message thread's parser).
+    // The pipeline calls MessageDecoded()/ParseFailed() while a record is received,
+    // the decode latency of a message is the time from the record hand over to MessageDecoded().
+    public sealed class FlTraceReplayer
+    {
+        public const double SPEED_FAST = 0;     // As fast as possible
+
+        private const long SPIN_TICKS = TimeSpan.TicksPerMillisecond * 2;
+
+        private readonly IList<FlTraceRecord> _records;
+        private readonly Stopwatch _stopwatch = new Stopwatch();
+        private readonly List<long> _latencies = new List<long>();
+        private long _recordStart = 0;
+        private int _parseFailures = 0;
+
+        // 1 : recorded timing, N : N times faster, SPEED_FAST : no waits.
+        public double Speed { get; set; } = 1;
+
+        public FlTraceReplayer(IList<FlTraceRecord> records)
+        {
+            _records = records;
+        }
+
+        // receive : the pipeline(bytes, length), called on the calling thread.
+        public FlReplayStats Run(Action<byte[], int> receive, CancellationToken token = default)
+        {
+            FlReplayStats stats = new FlReplayStats() { Speed = Speed };
+            long maxLagTicks = 0;
+
+            _latencies.Clear();
+            _parseFailures = 0;
+            _stopwatch.Restart();
+
+            foreach (var record in _records)
+            {
+                if (token.IsCancellationRequested)
+                {
+                    break;
+                }
+
+                if (record.Direction != FlTraceDirection.Rx)
+                {
+                    continue;
+                }
+
+                if (Speed > 0)
+                {
+                    long lag = Elapsed - (long)(record.Ticks / Speed);
+
+                    WaitUntil((long)(record.Ticks / Speed), token);
+                    maxLagTicks = Math.Max(maxLagTicks, lag);
+                }
+
+                _recordStart = _stopwatch.ElapsedTicks;
+                receive(record.Data, record.Data.Length);
+
+                stats.Records++;
+                stats.Bytes += record.Data.Length;
+                stats.TraceDuration = TimeSpan.FromTicks(record.Ticks);
+            }
+
+            _stopwatch.Stop();
+
+            stats.Elapsed = TimeSpan.FromTicks(Elapsed);
+            stats.MaxLag = TimeSpan.FromTicks(maxLagTicks);
+            stats.Messages = _latencies.Count;
+            stats.ParseFailures = _parseFailures;
+            stats.SetLatencies(_latencies, Stopwatch.Frequency);
+
+            return stats;
+        }
+
+        public void MessageDecoded()
+        {
+            _latencies.Add(_stopwatch.ElapsedTicks - _recordStart);
+        }
+
+        public void ParseFailed()
+        {
+            _parseFailures++;
+        }
+
+        // Elapsed time of the replay in TimeSpan ticks.
+        private long Elapsed => (long)(_stopwatch.ElapsedTicks * ((double)TimeSpan.TicksPerSecond / Stopwatch.Frequency));
+
+        // Sleeps until 2ms before the time, then spins(Thread.Sleep() resolution).
+        private void WaitUntil(long ticks, CancellationToken token)
+        {
+            long remain;
+
+            while (((remain = ticks - Elapsed) > 0) && !token.IsCancellationRequested)
+            {
+                if (remain > SPIN_TICKS)
+                {
+                    Thread.Sleep((int)((remain - SPIN_TICKS) / TimeSpan.TicksPerMillisecond) + 1);
+                }
+                else
+                {
+                    Thread.SpinWait(100);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+﻿using System;
+using System.IO;
+using Fl.Net;
+using Fl.Net.Log;
+
+namespace FlLogDecode
+{
+    // Prints the firmware log records(fl_log.h) of a SWO capture.
+    // FlLogDecode <fl_log_fmt.h> <capture file> [-port n | -raw]
+    //   capture file : raw SWO(ITM packets, UART/NRZ encoding), or the stimulus port data with -raw.
+    class Program
+    {
+        static int Main(string[] args)
+        {
+            int port = FlConstant.FL_LOG_ITM_PORT;
+            bool raw = false;
+
+            if (args.Length < 2)
+            {
+                Console.Error.WriteLine("Usage : FlLogDecode <fl_log_fmt.h> <capture file> [-port n | -raw]");
+                return 1;
+            }
+
+            for (int i = 2; i < args.Length; i++)
+            {
+                if ((args[i] == "-port") && ((i + 1) < args.Length) && int.TryParse(args[i + 1], out port))
+                {
+                    i++;
+                }
+                else if (args[i] == "-raw")
+                {
+                    raw = true;
+                }
+                else
+                {
+                    Console.Error.WriteLine($"Unknown option : {args[i]}");
+                    return 1;
+                }
+            }
+
+            try
+            {
+                FlLogDecoder decoder = FlLogDecoder.FromFormatFile(args[0]);
+                byte[] capture = File.ReadAllBytes(args[1]);
+
+                if (decoder.FormatCount == 0)
+                {
+                    Console.Error.WriteLine($"No FL_LOG_FMT() entry in {args[0]}");
+                    return 1;
+                }
+
+                foreach (FlLogRecord record in raw ? decoder.DecodeRecords(capture) : decoder.Decode(capture, port))
+                {
+                    Console.WriteLine(record);
+                }
+            }
+            catch (IOException e)
+            {
+                Console.Error.WriteLine(e.Message);
+                return 1;
+            }
+
+            return 0;
+        }
+    }
+}
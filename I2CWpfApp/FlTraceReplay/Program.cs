@@ -0,0 +1,95 @@
+﻿using System;
+using System.IO;
+using Fl.Net;
+using Fl.Net.Message;
+using Fl.Net.Parser;
+using Fl.Net.Trace;
+
+namespace FlTraceReplay
+{
+    // Replays the received bytes of a serial trace(I2CManager.TraceWriter) through the text parser
+    // and the event decoding, and prints the throughput and the decode latency.
+    // FlTraceReplay <trace file> [-speed n] [-repeat n]
+    //   speed : 1 recorded timing, N times faster, 0 as fast as possible(default).
+    class Program
+    {
+        static int Main(string[] args)
+        {
+            double speed = FlTraceReplayer.SPEED_FAST;
+            int repeat = 1;
+
+            if (args.Length < 1)
+            {
+                Console.Error.WriteLine("Usage : FlTraceReplay <trace file> [-speed n] [-repeat n]");
+                return 1;
+            }
+
+            for (int i = 1; i < args.Length; i++)
+            {
+                if ((args[i] == "-speed") && ((i + 1) < args.Length) && double.TryParse(args[i + 1], out speed) && (speed >= 0))
+                {
+                    i++;
+                }
+                else if ((args[i] == "-repeat") && ((i + 1) < args.Length) && int.TryParse(args[i + 1], out repeat) && (repeat > 0))
+                {
+                    i++;
+                }
+                else
+                {
+                    Console.Error.WriteLine($"Unknown option : {args[i]}");
+                    return 1;
+                }
+            }
+
+            try
+            {
+                FlTraceReplayer replayer = new FlTraceReplayer(FlSerialTraceReader.Load(args[0]))
+                {
+                    Speed = speed
+                };
+
+                for (int i = 0; i < repeat; i++)
+                {
+                    FlTxtParser parser = new FlTxtParser();
+
+                    Console.WriteLine(replayer.Run((buf, length) => Receive(replayer, parser, buf, length)));
+                }
+            }
+            catch (IOException e)
+            {
+                Console.Error.WriteLine(e.Message);
+                return 1;
+            }
+
+            return 0;
+        }
+
+        // Same steps as the message thread of I2CManager.
+        static void Receive(FlTraceReplayer replayer, FlTxtParser parser, byte[] buf, int length)
+        {
+            for (int i = 0; i < length; i++)
+            {
+                FlParseState ret = parser.ParseResponseEvent(buf[i], out IFlMessage message);
+                if (ret == FlParseState.ParseOk)
+                {
+                    switch (message.MessageId)
+                    {
+                        case FlMessageId.RangeEvent:
+                            FlRangeResult.FromEvent(message);
+                            break;
+
+                        case FlMessageId.MeasurementEvent:
+                            FlMeasurement.FromEvent(message);
+                            break;
+                    }
+
+                    replayer.MessageDecoded();
+                }
+                else if (ret == FlParseState.ParseFail)
+                {
+                    replayer.ParseFailed();
+                }
+            }
+        }
+    }
+}
@@ -12,8 +12,6 @@ namespace I2CWpfApp
         {
             // https://github.com/serilog/serilog/wiki/AppSettings
             Log.Logger = new LoggerConfiguration().ReadFrom.AppSettings().CreateLogger();
-
-            AppUtil.CreateDefaultDb();
         }
     }
 }
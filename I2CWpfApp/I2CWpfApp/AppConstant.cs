@@ -21,5 +21,12 @@ namespace I2CWpfApp
         public const string STR_READCLEAR1 = "ReadClear1";
         public const string STR_READCLEARBYREAD = "ReadClearByRead";
         public const string STR_READSETBYREAD = "ReadSetByRead";
+
+        public const string STR_REG_SNAPSHOT_FILE_EXT = ".rsnp";
+        public const string STR_REG_VALUE_FILE_FILTER = "Register values (*.txt)|*.txt|Register snapshots (*.rsnp)|*.rsnp|All files (*.*)|*.*";
+
+        public const int HISTORY_MAX_COUNT = 1000;      // Command history lines kept
+        public const int UI_UPDATE_MAX_FPS = 30;        // Batched UI updates of I2C results per second
+        public const int REGISTER_MONITOR_PERIOD = 500; // Register snapshot period of the monitor(ms)
     }
 }
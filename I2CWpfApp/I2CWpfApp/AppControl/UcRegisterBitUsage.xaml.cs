@@ -1,4 +1,5 @@
-﻿using RegisterCore.Net.Models;
+﻿using RegisterCore.Net;
+using RegisterCore.Net.Models;
 using I2CWpfApp.AppConverter;
 using System;
 using System.Collections.Generic;
@@ -13,311 +14,202 @@ namespace I2CWpfApp.AppControl
     /// </summary>
     public partial class UcRegisterBitUsage : UserControl
     {
-        Grid _gridRegister = null;
-        List<UIElement> _dynamicElements = new List<UIElement>();
+        // Grid rows of a bit usage row : bit numbers, bit field names, access types.
+        const int GRID_ROWS_PER_ROW = 3;
+
+        static readonly AccessTypeConverter _atConverter = new AccessTypeConverter();
+        static readonly Thickness _defThick = new Thickness(1);
+        static readonly string[] _bitNumbers = CreateBitNumbers();
+
+        // Cells are created once and reused(hidden when not used), an update only sets the changed properties.
+        Grid _gridRegister = new Grid() { Margin = new Thickness(5) };
+        List<Label> _bitLabels = new List<Label>();
+        List<TextBlock> _nameCells = new List<TextBlock>();
+        List<Label> _accessCells = new List<Label>();
+        int _columnCount = 0;
+        int _rowCount = 0;
 
         public UcRegisterBitUsage()
         {
             InitializeComponent();
+
+            gridMain.Children.Add(_gridRegister);
         }
 
-        internal void UpdateRegBitUsage(int bitFieldBits, List<BitFieldTemplate> bfTemplates)
+        // bitFields : BitField values are shown in the tool tips.
+        internal void UpdateRegBitUsage(int bitFieldBits, IReadOnlyList<BitFieldTemplate> bitFields)
         {
-            if (gridMain.Children.Count > 0)
-            {
-                if (_dynamicElements?.Count > 0)
-                {
-                    foreach (UIElement element in _dynamicElements)
-                    {
-                        if (_gridRegister.Children.Contains(element) == true)
-                        {
-                            _gridRegister.Children.Remove(element);
-                        }
-                    }
+            BitUsageLayout layout = new BitUsageLayout(bitFieldBits, bitFields);
+            int i;
 
-                    _dynamicElements.Clear();
-                }
+            UpdateGrid(layout.ColumnCount, layout.RowCount);
 
-                gridMain.Children.Clear();
-            }
+            // Bit numbers.
+            for (i = 0; i < layout.Bits; i++)
+            {
+                int bit = layout.Bits - 1 - i;
+                Label lbl = GetCell(_bitLabels, i, NewBitLabel);
 
-            int colIndex, rowIndex;
-            int columnCount = 8, rowCount = 1;
-            int i = 0;
+                SetCell(lbl, layout.GetRow(bit) * GRID_ROWS_PER_ROW, layout.GetColumn(bit), 1);
+                SetContent(lbl, GetBitNumber(bit));
+            }
+            HideCells(_bitLabels, layout.Bits);
 
-            _gridRegister = new Grid();
-            if (bitFieldBits >= 16)
+            // Bit fields.
+            for (i = 0; i < layout.Segments.Count; i++)
             {
-                columnCount = 16;
-                if (bitFieldBits > 16)
+                BitUsageSegment seg = layout.Segments[i];
+                BitFieldTemplate bf = bitFields[seg.Field];
+                TextBlock tb = GetCell(_nameCells, i, NewNameCell);
+                Label lbl = GetCell(_accessCells, i, NewAccessCell);
+                string toolTip = (bf is BitField field) ?
+                    $"{bf.Name}[{seg.HighBit}:{seg.LowBit}] = 0x{field.Value:X}" :
+                    $"{bf.Name}[{seg.HighBit}:{seg.LowBit}]";
+
+                SetCell(tb, seg.Row * GRID_ROWS_PER_ROW + 1, seg.Column, seg.ColumnSpan);
+                if (tb.Text != bf.Name)
                 {
-                    rowCount = 2;
+                    tb.Text = bf.Name;
                 }
-            }
-            
-            // Add columns.
-            for (colIndex = 0; colIndex < columnCount; colIndex++)
-            {
-                _gridRegister.ColumnDefinitions.Add(new ColumnDefinition());
-            }
-
-            // Add rows.
-            for (rowIndex = 0; rowIndex < rowCount; rowIndex++)
-            {
-                RowDefinition rd = new RowDefinition()
+                if ((tb.ToolTip as string) != toolTip)
                 {
-                    //MinHeight = 10,
-                    Height = new GridLength(0.2, GridUnitType.Star)
-                };
-                _gridRegister.RowDefinitions.Add(rd);
-
-                //_gridRegister.RowDefinitions.Add(new RowDefinition());
-                _gridRegister.RowDefinitions.Add(new RowDefinition());
-                //_gridRegister.RowDefinitions.Add(new RowDefinition());
+                    tb.ToolTip = toolTip;
+                }
 
-                rd = new RowDefinition()
-                {
-                    //MinHeight = 10,
-                    Height = new GridLength(0.2, GridUnitType.Star)
-                };
-                _gridRegister.RowDefinitions.Add(rd);
+                SetCell(lbl, seg.Row * GRID_ROWS_PER_ROW + 2, seg.Column, seg.ColumnSpan);
+                SetContent(lbl, (string)_atConverter.Convert(bf.AccessType, typeof(string), null, null));
             }
+            HideCells(_nameCells, layout.Segments.Count);
+            HideCells(_accessCells, layout.Segments.Count);
+        }
 
-            // Add bit numbers.
-            i = bitFieldBits;
-            List<Label> labels = new List<Label>();
-
-            for (rowIndex = 0; rowIndex < rowCount; rowIndex++)
+        // Rows and columns are rebuilt only when the register size changes.
+        private void UpdateGrid(int columnCount, int rowCount)
+        {
+            if ((columnCount == _columnCount) && (rowCount == _rowCount))
             {
-                for (colIndex = 0; colIndex < columnCount; colIndex++)
-                {
-                    Label lbl = new Label()
-                    {
-                        Content = $"{i-1}",
-                        HorizontalAlignment = HorizontalAlignment.Right
-                    };
-                    Grid.SetRow(lbl, rowIndex*3);
-                    Grid.SetColumn(lbl, colIndex);
-                    labels.Add(lbl);
-
-                    i--;
-                }
+                return;
             }
 
-            // Add bit fields.
-            foreach (var bf in bfTemplates)
+            _gridRegister.ColumnDefinitions.Clear();
+            _gridRegister.RowDefinitions.Clear();
+
+            for (int colIndex = 0; colIndex < columnCount; colIndex++)
             {
-                UpdateBitFieldInfo(bf, columnCount);
+                _gridRegister.ColumnDefinitions.Add(new ColumnDefinition());
             }
 
-            // Add access type labels.
-            foreach (var l in labels)
+            for (int rowIndex = 0; rowIndex < rowCount; rowIndex++)
             {
-                _gridRegister.Children.Add(l);
+                _gridRegister.RowDefinitions.Add(new RowDefinition() { Height = new GridLength(0.2, GridUnitType.Star) });
+                _gridRegister.RowDefinitions.Add(new RowDefinition());
+                _gridRegister.RowDefinitions.Add(new RowDefinition() { Height = new GridLength(0.2, GridUnitType.Star) });
             }
-            _gridRegister.Margin = new Thickness(5);
 
-            gridMain.Children.Add(_gridRegister);
+            _columnCount = columnCount;
+            _rowCount = rowCount;
         }
 
-        internal void UpdateRegBitUsage(int bitFieldBits, List<BitField> bfTemplates)
+        private T GetCell<T>(List<T> cells, int index, Func<T> newCell) where T : UIElement
         {
-            if (gridMain.Children.Count > 0)
+            T cell;
+
+            if (index < cells.Count)
             {
-                if (_dynamicElements?.Count > 0)
+                cell = cells[index];
+                if (cell.Visibility != Visibility.Visible)
                 {
-                    foreach (UIElement element in _dynamicElements)
-                    {
-                        if (_gridRegister.Children.Contains(element) == true)
-                        {
-                            _gridRegister.Children.Remove(element);
-                        }
-                    }
-
-                    _dynamicElements.Clear();
+                    cell.Visibility = Visibility.Visible;
                 }
-
-                gridMain.Children.Clear();
+            }
+            else
+            {
+                cell = newCell();
+                cells.Add(cell);
+                _gridRegister.Children.Add(cell);
             }
 
-            int colIndex, rowIndex;
-            int columnCount = 8, rowCount = 1;
-            int i = 0;
+            return cell;
+        }
 
-            _gridRegister = new Grid();
-            if (bitFieldBits >= 16)
+        private static void HideCells<T>(List<T> cells, int start) where T : UIElement
+        {
+            for (int i = start; i < cells.Count; i++)
             {
-                columnCount = 16;
-                if (bitFieldBits > 16)
+                if (cells[i].Visibility != Visibility.Collapsed)
                 {
-                    rowCount = 2;
+                    cells[i].Visibility = Visibility.Collapsed;
                 }
             }
+        }
 
-            // Add columns.
-            for (colIndex = 0; colIndex < columnCount; colIndex++)
+        private static void SetCell(UIElement element, int row, int column, int columnSpan)
+        {
+            if (Grid.GetRow(element) != row)
             {
-                _gridRegister.ColumnDefinitions.Add(new ColumnDefinition());
+                Grid.SetRow(element, row);
             }
-
-            // Add rows.
-            for (rowIndex = 0; rowIndex < rowCount; rowIndex++)
+            if (Grid.GetColumn(element) != column)
             {
-                RowDefinition rd = new RowDefinition()
-                {
-                    //MinHeight = 10,
-                    Height = new GridLength(0.2, GridUnitType.Star)
-                };
-                _gridRegister.RowDefinitions.Add(rd);
-
-                //_gridRegister.RowDefinitions.Add(new RowDefinition());
-                _gridRegister.RowDefinitions.Add(new RowDefinition());
-                //_gridRegister.RowDefinitions.Add(new RowDefinition());
-
-                rd = new RowDefinition()
-                {
-                    //MinHeight = 10,
-                    Height = new GridLength(0.2, GridUnitType.Star)
-                };
-                _gridRegister.RowDefinitions.Add(rd);
+                Grid.SetColumn(element, column);
             }
-
-            // Add bit numbers.
-            i = bitFieldBits;
-            List<Label> labels = new List<Label>();
-
-            for (rowIndex = 0; rowIndex < rowCount; rowIndex++)
+            if (Grid.GetColumnSpan(element) != columnSpan)
             {
-                for (colIndex = 0; colIndex < columnCount; colIndex++)
-                {
-                    Label lbl = new Label()
-                    {
-                        Content = $"{i - 1}",
-                        HorizontalAlignment = HorizontalAlignment.Right
-                    };
-                    Grid.SetRow(lbl, rowIndex * 3);
-                    Grid.SetColumn(lbl, colIndex);
-                    labels.Add(lbl);
-
-                    i--;
-                }
+                Grid.SetColumnSpan(element, columnSpan);
             }
+        }
 
-            // Add bit fields.
-            foreach (var bf in bfTemplates)
+        private static void SetContent(Label label, string content)
+        {
+            if ((label.Content as string) != content)
             {
-                UpdateBitFieldInfo(bf, columnCount);
+                label.Content = content;
             }
+        }
+
+        private static string[] CreateBitNumbers()
+        {
+            string[] numbers = new string[64];
 
-            // Add access type labels.
-            foreach (var l in labels)
+            for (int i = 0; i < numbers.Length; i++)
             {
-                _gridRegister.Children.Add(l);
+                numbers[i] = $"{i}";
             }
-            _gridRegister.Margin = new Thickness(5);
 
-            gridMain.Children.Add(_gridRegister);
+            return numbers;
         }
 
-        private void UpdateBitFieldInfo(BitFieldTemplate bf, int columnCount)
+        private static string GetBitNumber(int bit)
         {
-            TextBlock[] textBlocks = null;
-            Label[] labels = null;
-            int endIndex = bf.Offset + bf.Bits - 1;
-            int columnStart = bf.Offset % columnCount;
-            int row = (bf.Offset / columnCount);
-            AccessTypeConverter atConverter = new AccessTypeConverter();
-            Type stringType = typeof(string);
-            Thickness defThick = new Thickness(1);
+            return (bit < _bitNumbers.Length) ? _bitNumbers[bit] : $"{bit}";
+        }
 
-            if ((bf.Offset >= 0 && bf.Offset <= 15) &&
-                (endIndex >= 16 && endIndex <= 31))
+        private static Label NewBitLabel()
+        {
+            return new Label()
             {
-                textBlocks = new TextBlock[2];
-                labels = new Label[2];
-
-                textBlocks[0] = new TextBlock();
-                textBlocks[0].Text = bf.Name;
-                textBlocks[0].Background = Brushes.Gray;
-                textBlocks[0].Margin = defThick;
-
-                Grid.SetRow(textBlocks[0], 1);
-                Grid.SetColumn(textBlocks[0], bf.Offset);
-                Grid.SetColumnSpan(textBlocks[0], 15 - columnStart + 1);
-
-                labels[0] = new Label();
-                labels[0].Content = atConverter.Convert(bf.AccessType, stringType, null, null);
-                labels[0].Margin = defThick;
-                labels[0].HorizontalContentAlignment = HorizontalAlignment.Center;
-                labels[0].BorderBrush = Brushes.Gray;
-                labels[0].BorderThickness = new Thickness(1);
-
-                Grid.SetRow(labels[0], 2);
-                Grid.SetColumn(labels[0], bf.Offset);
-                Grid.SetColumnSpan(labels[0], 15 - columnStart + 1);
-
-                textBlocks[1] = new TextBlock();
-                textBlocks[1].Text = bf.Name;
-                textBlocks[1].Background = Brushes.Gray;
-                textBlocks[1].Margin = defThick;
-
-                Grid.SetRow(textBlocks[1], 4);
-                Grid.SetColumn(textBlocks[1], 16 - (endIndex - 15));
-                Grid.SetColumnSpan(textBlocks[1], endIndex - 15);
-
-                labels[1] = new Label();
-                labels[1].Content = atConverter.Convert(bf.AccessType, stringType, null, null);
-                labels[1].Margin = defThick;
-                labels[1].HorizontalContentAlignment = HorizontalAlignment.Center;
-                labels[1].BorderBrush = Brushes.Gray;
-                labels[1].BorderThickness = defThick;
-
-                Grid.SetRow(labels[1], 5);
-                Grid.SetColumn(labels[1], bf.Offset);
-                Grid.SetColumnSpan(labels[1], 15 - columnStart + 1);
+                HorizontalAlignment = HorizontalAlignment.Right
+            };
+        }
 
-                _gridRegister.Children.Add(textBlocks[0]);
-                _gridRegister.Children.Add(textBlocks[1]);
-                _gridRegister.Children.Add(labels[0]);
-                _gridRegister.Children.Add(labels[1]);
-            }
-            else
+        private static TextBlock NewNameCell()
+        {
+            return new TextBlock()
             {
-                int rowIndex = 1;
-                textBlocks = new TextBlock[1];
-                labels = new Label[1];
-
-                textBlocks[0] = new TextBlock();
-                textBlocks[0].Text = bf.Name;
-                textBlocks[0].Background = Brushes.Gray;
-                textBlocks[0].Margin = defThick;
-
-                if (bf.Offset > 15)
-                {
-                    rowIndex = 4;
-                }
-                
-                Grid.SetRow(textBlocks[0], rowIndex);
-                Grid.SetColumn(textBlocks[0], columnCount - columnStart - bf.Bits);
-                Grid.SetColumnSpan(textBlocks[0], bf.Bits);
-
-                labels[0] = new Label();
-                labels[0].Content = atConverter.Convert(bf.AccessType, stringType, null, null);
-                labels[0].Margin = defThick;
-                labels[0].HorizontalContentAlignment = HorizontalAlignment.Center;
-                labels[0].BorderBrush = Brushes.Gray;
-                labels[0].BorderThickness = defThick;
-
-                Grid.SetRow(labels[0], rowIndex+1);
-                Grid.SetColumn(labels[0], columnCount - columnStart - bf.Bits);
-                Grid.SetColumnSpan(labels[0], bf.Bits);
-
-                _gridRegister.Children.Add(textBlocks[0]);
-                _gridRegister.Children.Add(labels[0]);
-            }
+                Background = Brushes.Gray,
+                Margin = _defThick
+            };
+        }
 
-            _dynamicElements.AddRange(textBlocks);
-            _dynamicElements.AddRange(labels);
+        private static Label NewAccessCell()
+        {
+            return new Label()
+            {
+                Margin = _defThick,
+                HorizontalContentAlignment = HorizontalAlignment.Center,
+                BorderBrush = Brushes.Gray,
+                BorderThickness = _defThick
+            };
         }
 
         private void UserControl_Loaded(object sender, RoutedEventArgs e)
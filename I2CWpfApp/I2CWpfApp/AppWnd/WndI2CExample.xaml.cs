@@ -1,16 +1,19 @@
-﻿using Fl.Net.Message;
+﻿using Fl.Net;
+using Fl.Net.Message;
 using I2CWpfApp.AppControl;
 using Microsoft.Win32;
 using RegisterCore.Net;
 using RegisterCore.Net.Models;
-using RegisterSqlite.Net;
 using System;
 using System.Collections.Generic;
 using System.Collections.ObjectModel;
 using System.Globalization;
 using System.Linq;
+using System.Threading.Tasks;
 using System.Windows;
 using System.Windows.Controls;
+using System.Windows.Data;
+using System.Windows.Threading;
 
 namespace I2CWpfApp.AppWnd
 {
@@ -21,12 +24,19 @@ namespace I2CWpfApp.AppWnd
     {
         private const string STR_VL6180X_REG_VALUE_FILE_NAME = "def_vl6180x_reg_values.txt";
 
-        long _currentChipId = -1;
+        RegisterCatalog _catalog = null;
         int _bitFieldBits = 0;
         ObservableCollection<Register> _registers = new ObservableCollection<Register>();
         UcRegisterBitUsage _regBitUsage = new UcRegisterBitUsage();
         I2CManager _i2cMgr = new I2CManager();
         ushort _i2cAddr = 0x52;
+        // I2C results are applied in batches(UI_UPDATE_MAX_FPS), the history keeps HISTORY_MAX_COUNT lines.
+        UiUpdateBatcher _uiUpdates = null;
+        ObservableCollection<string> _history = new ObservableCollection<string>();
+        HashSet<Register> _updatedRegisters = new HashSet<Register>();
+        // Monitor : a register snapshot every REGISTER_MONITOR_PERIOD, only the changed registers are updated.
+        DispatcherTimer _monitorTimer = null;
+        bool _snapshotPending = false;
 
         public WndI2CExample()
         {
@@ -36,25 +46,31 @@ namespace I2CWpfApp.AppWnd
         private void Window_Loaded(object sender, RoutedEventArgs e)
         {
             // Use VL6180x chip for I2C read/write test.
-            using (var ctx = new RegisterContext())
-            {
-                var chip = ctx.Chips.Where(c => c.Name == "VL6180x").SingleOrDefault();
-                if (chip != null)
-                {
-                    _currentChipId = chip.Id;
-                }
-            }
+            _catalog = AppUtil.LoadRegisterCatalog();
 
             BtnRegisterRead.IsEnabled = false;
+            BtnRegisterReadAll.IsEnabled = false;
             BtnRegisterWrite.IsEnabled = false;
+            CbRegisterMonitor.IsEnabled = false;
+
+            _uiUpdates = new UiUpdateBatcher(Dispatcher, AppConstant.UI_UPDATE_MAX_FPS, RefreshUpdatedRegisters);
+            LbHistory.ItemsSource = _history;
+
+            _i2cMgr.OnRegistersChanged = OnRegistersChanged;
+            _monitorTimer = new DispatcherTimer()
+            {
+                Interval = TimeSpan.FromMilliseconds(AppConstant.REGISTER_MONITOR_PERIOD)
+            };
+            _monitorTimer.Tick += MonitorTimer_Tick;
 
             // Load VL6180x register values and update register data grid.
-            var regValues = AppUtil.ReadRegisterValuesFromFile(STR_VL6180X_REG_VALUE_FILE_NAME);
-            UpdateRegisterDataGrid(regValues);
+            UpdateRegisterDataGrid(STR_VL6180X_REG_VALUE_FILE_NAME);
         }
 
         private void Window_Closed(object sender, EventArgs e)
         {
+            _monitorTimer?.Stop();
+
             if (_i2cMgr.IsStarted())
             {
                 _i2cMgr.Stop();
@@ -70,9 +86,7 @@ namespace I2CWpfApp.AppWnd
             if (openFileDialog.ShowDialog() == true)
             {
                 TbFIleName.Text = openFileDialog.SafeFileName;
-                var regValues = AppUtil.ReadRegisterValuesFromFile(openFileDialog.FileName);
-
-                UpdateRegisterDataGrid(regValues);
+                UpdateRegisterDataGrid(openFileDialog.FileName);
             }
         }
 
@@ -87,6 +101,7 @@ namespace I2CWpfApp.AppWnd
             }
 
             SaveFileDialog saveFileDialog = new SaveFileDialog();
+            saveFileDialog.Filter = AppConstant.STR_REG_VALUE_FILE_FILTER;
             if (saveFileDialog.ShowDialog() == true)
             {
                 try
@@ -118,7 +133,7 @@ namespace I2CWpfApp.AppWnd
 
                 _bitFieldBits = reg.Bits;
                 //_regBitUsage.UpdateRegBitUsage(_bitFieldBits, reg.BitFields.OrderBy(bf => bf.Offset).ToList());
-                _regBitUsage.UpdateRegBitUsage(_bitFieldBits, reg.BitFields.ToList());
+                _regBitUsage.UpdateRegBitUsage(_bitFieldBits, reg.BitFields);
                 BitFieldPlaceHolder.Content = _regBitUsage;
 
                 TbRegisterName.Text = reg.Name;
@@ -135,11 +150,7 @@ namespace I2CWpfApp.AppWnd
         // Add a new register value.
         private void BtnAddRegisterValue_Click(object sender, RoutedEventArgs e)
         {
-            List<RegisterTemplate> regTemplates = null;
-            using (var ctx = new RegisterContext())
-            {
-                regTemplates = ctx.RegisterTemplates.Where(r => r.ChipId == _currentChipId).ToList();
-            }
+            List<RegisterTemplate> regTemplates = _catalog?.Registers.ToList() ?? new List<RegisterTemplate>();
 
             if (_registers?.Count > 0)
             {
@@ -215,13 +226,7 @@ namespace I2CWpfApp.AppWnd
             if (ulong.TryParse(TbRegisterValue.Text, System.Globalization.NumberStyles.HexNumber, null, out ulong regValue) == true)
             {
                 reg.Value = regValue;
-
-                foreach (var bf in reg.BitFields)
-                {
-                    var val = GeneralUtil.GetBitFieldValue(reg.Value, bf);
-
-                    bf.Value = val;
-                }
+                _catalog.UpdateBitFields(reg);
 
                 DgRegister.ItemsSource = null;
                 DgRegister.ItemsSource = _registers;
@@ -233,7 +238,8 @@ namespace I2CWpfApp.AppWnd
 
         // Apply a new bit field value for a selected bit field of the selected register.
         // - Parent register value will be updated.
-        private void BtnBitFieldValueApply_Click(object sender, RoutedEventArgs e)
+        // - The COM port is open : the device updates the bits(read-modify-write), the register shows the value written.
+        private async void BtnBitFieldValueApply_Click(object sender, RoutedEventArgs e)
         {
             int selectedRegIndex = DgRegister.SelectedIndex;
             int selectedBfIndex = DgRegisterBitField.SelectedIndex;
@@ -258,11 +264,15 @@ namespace I2CWpfApp.AppWnd
                     MessageBox.Show("Check maximum value.");
                     return;
                 }
-                bf.Value = bfValue;
 
-                UInt64 calculatedVal = GeneralUtil.GetRegisterValueFromBitFields(reg.BitFields);
+                if (_i2cMgr.IsStarted() == true)
+                {
+                    await UpdateBitFieldAsync(reg, bf, bfValue);
+                    return;
+                }
 
-                reg.Value = calculatedVal;
+                bf.Value = bfValue;
+                _catalog.UpdateValue(reg);
 
                 DgRegister.ItemsSource = null;
                 DgRegister.ItemsSource = _registers;
@@ -274,7 +284,7 @@ namespace I2CWpfApp.AppWnd
         }
 
         // Open/close COM port.
-        private void BtnComPortOpenClose_Click(object sender, RoutedEventArgs e)
+        private async void BtnComPortOpenClose_Click(object sender, RoutedEventArgs e)
         {
             if (string.IsNullOrEmpty(TbComPortName.Text))
             {
@@ -292,21 +302,34 @@ namespace I2CWpfApp.AppWnd
                         break;
 
                     case "Close":
+                        CbRegisterMonitor.IsChecked = false;
                         _i2cMgr.Stop();
                         break;
                 }
 
                 if (_i2cMgr.IsStarted() == true)
                 {
+                    // The device moves the sensors from the default address at boot.
+                    ushort[] sensorAddrs = await _i2cMgr.RunAsync(mgr => mgr.ReadSensors());
+                    ushort sensorAddr = sensorAddrs?.FirstOrDefault(a => a != 0) ?? 0;
+                    if (sensorAddr != 0)
+                    {
+                        _i2cAddr = sensorAddr;
+                    }
+
                     BtnComPortOpenClose.Content = "Close";
                     BtnRegisterRead.IsEnabled = true;
+                    BtnRegisterReadAll.IsEnabled = true;
                     BtnRegisterWrite.IsEnabled = true;
+                    CbRegisterMonitor.IsEnabled = true;
                 }
                 else
                 {
                     BtnComPortOpenClose.Content = "Open";
                     BtnRegisterRead.IsEnabled = false;
+                    BtnRegisterReadAll.IsEnabled = false;
                     BtnRegisterWrite.IsEnabled = false;
+                    CbRegisterMonitor.IsEnabled = false;
                 }
             }
             catch (Exception ex)
@@ -316,7 +339,7 @@ namespace I2CWpfApp.AppWnd
         }
 
         // Read a value from the selected VL6180x register.
-        private void BtnRegisterRead_Click(object sender, RoutedEventArgs e)
+        private async void BtnRegisterRead_Click(object sender, RoutedEventArgs e)
         {
             if (DgRegister.SelectedIndex < 0)
             {
@@ -325,10 +348,153 @@ namespace I2CWpfApp.AppWnd
             }
 
             Register reg = (Register)DgRegister.SelectedItem;
-            IFlMessage response = _i2cMgr.ReadRegister(_i2cAddr, (ushort)reg.Address);
-            LbHistory.Items.Insert(0, "ReadRegister command sent");
+            AddHistory("ReadRegister command sent");
+
+            await ReadRegisterAsync(reg);
+        }
+
+        // Read all registers with burst reads of consecutive registers, only the changed registers are updated.
+        private async void BtnRegisterReadAll_Click(object sender, RoutedEventArgs e)
+        {
+            AddHistory("SnapshotRegisters command sent");
+
+            await SnapshotRegistersAsync(true);
+        }
+
+        private void CbRegisterMonitor_Changed(object sender, RoutedEventArgs e)
+        {
+            _monitorTimer.IsEnabled = (CbRegisterMonitor.IsChecked == true);
+        }
+
+        private async void MonitorTimer_Tick(object sender, EventArgs e)
+        {
+            await SnapshotRegistersAsync(false);
+        }
+
+        // The changed registers are applied by OnRegistersChanged(), a monitor tick is skipped while a snapshot is pending.
+        // history false : only snapshots with changed registers or a failure are added to the history.
+        private async Task SnapshotRegistersAsync(bool history)
+        {
+            string strResp = null;
+
+            if ((_catalog == null) || (_snapshotPending == true))
+            {
+                return;
+            }
+
+            _snapshotPending = true;
+            try
+            {
+                RegisterMapSnapshot snapshot = await _i2cMgr.RunAsync(mgr => mgr.SnapshotRegisters(_catalog, _i2cAddr));
+                if ((history == true) || (snapshot.Changed.Count > 0) || (snapshot.ReadCount < snapshot.Count))
+                {
+                    strResp = $"Snapshot : {snapshot.ReadCount}/{snapshot.Count} registers read, {snapshot.Changed.Count} changed";
+                }
+            }
+            catch (TaskCanceledException)
+            {
+                strResp = "SnapshotRegisters canceled";
+            }
+            catch (Exception ex)
+            {
+                strResp = ex.Message;
+            }
+            finally
+            {
+                _snapshotPending = false;
+            }
+
+            if (strResp != null)
+            {
+                _uiUpdates.Post(() => AddHistory(strResp));
+            }
+        }
+
+        // Command thread : the changed registers shown in the grid are posted, the other rows are not updated.
+        private void OnRegistersChanged(RegisterMapSnapshot snapshot, byte i2cNum, ushort address)
+        {
+            foreach (int index in snapshot.Changed)
+            {
+                ulong regAddr = snapshot.Catalog.Registers[index].Address;
+                ulong value = snapshot.GetValue(index);
+
+                _uiUpdates.Post(regAddr, () =>
+                {
+                    Register reg = _registers.FirstOrDefault(r => r.Address == regAddr);
+                    if (reg != null)
+                    {
+                        UpdateRegisterValue(reg, value);
+                    }
+                });
+            }
+        }
+
+        // The command runs on the I2C manager command thread, the results are posted to the UI thread.
+        private async Task ReadRegisterAsync(Register reg)
+        {
+            string strResp = "No response";
+            ulong? regValue = null;
+
+            try
+            {
+                IFlMessage response = await _i2cMgr.ReadRegisterAsync(_i2cAddr, (ushort)reg.Address).ConfigureAwait(false);
+                strResp = GetReadResponseString(reg, response, out regValue);
+            }
+            catch (TaskCanceledException)
+            {
+                strResp = "ReadRegister canceled";
+            }
+            catch (Exception ex)
+            {
+                strResp = ex.Message;
+            }
 
+            if (regValue.HasValue == true)
+            {
+                _uiUpdates.Post(reg, () => UpdateRegisterValue(reg, regValue.Value));
+            }
+            _uiUpdates.Post(() => AddHistory(strResp));
+        }
+
+        private async Task UpdateBitFieldAsync(Register reg, BitField bf, ulong value)
+        {
             string strResp = "No response";
+            uint? regValue = null;
+
+            AddHistory("UpdateBitField command sent");
+            try
+            {
+                regValue = await _i2cMgr.RunAsync(mgr => mgr.UpdateBitField(_i2cAddr, reg, bf, value)).ConfigureAwait(false);
+                if (regValue.HasValue == true)
+                {
+                    strResp = string.Format("Resp : 0x{0:X4}, {1} = 0x{2:X}, 0x{3:X4}", reg.Address, bf.Name, value, regValue.Value);
+                }
+                else
+                {
+                    strResp = "Bit field update fail";
+                }
+            }
+            catch (TaskCanceledException)
+            {
+                strResp = "UpdateBitField canceled";
+            }
+            catch (Exception ex)
+            {
+                strResp = ex.Message;
+            }
+
+            if (regValue.HasValue == true)
+            {
+                _uiUpdates.Post(reg, () => UpdateRegisterValue(reg, regValue.Value));
+            }
+            _uiUpdates.Post(() => AddHistory(strResp));
+        }
+
+        private static string GetReadResponseString(Register reg, IFlMessage response, out ulong? value)
+        {
+            string strResp = "No response";
+
+            value = null;
             if (response != null)
             {
                 if ((response.Arguments?.Count > 0) &&
@@ -340,6 +506,7 @@ namespace I2CWpfApp.AppWnd
                         if (byte.TryParse((string)response.Arguments[6], out byte regValue))
                         {
                             strResp = string.Format("Resp : 0x{0:X4}, 0x{1:X2}", reg.Address, regValue);
+                            value = regValue;
                         }
                     }
                     else if (reg.Bits <= 16)
@@ -347,6 +514,7 @@ namespace I2CWpfApp.AppWnd
                         if (ushort.TryParse((string)response.Arguments[6], out ushort regValue))
                         {
                             strResp = string.Format("Resp : 0x{0:X4}, 0x{1:X4}", reg.Address, regValue);
+                            value = regValue;
                         }
                     }
                     else if (reg.Bits <= 32)
@@ -354,20 +522,25 @@ namespace I2CWpfApp.AppWnd
                         if (uint.TryParse((string)response.Arguments[6], out uint regValue))
                         {
                             strResp = string.Format("Resp : 0x{0:X4}, 0x{1:X8}", reg.Address, regValue);
+                            value = regValue;
                         }
                     }
                 }
+                else if (response.Arguments?.Count == 2)
+                {
+                    strResp = $"Register read fail({AppUtil.I2CErrorToString((string)response.Arguments[1])})";
+                }
                 else
                 {
                     strResp = "Invalid response(argument error)";
                 }
             }
 
-            LbHistory.Items.Insert(0, strResp);
+            return strResp;
         }
 
         // Write a value to the selected VL6180x register.
-        private void BtnRegisterWrite_Click(object sender, RoutedEventArgs e)
+        private async void BtnRegisterWrite_Click(object sender, RoutedEventArgs e)
         {
             if (DgRegister.SelectedIndex < 0)
             {
@@ -386,66 +559,109 @@ namespace I2CWpfApp.AppWnd
             }
 
             Register reg = (Register)DgRegister.SelectedItem;
-            IFlMessage response = _i2cMgr.WriteRegister(_i2cAddr, (ushort)reg.Address, regValue);
-            LbHistory.Items.Insert(0, "WriteRegister command sent");
+            AddHistory("WriteRegister command sent");
 
             string strResp = "No response";
-            if (response != null)
+            try
             {
-                if ((response.Arguments?.Count > 0) &&
-                    (response.Arguments?.Count == 2))
+                IFlMessage response = await _i2cMgr.WriteRegisterAsync(_i2cAddr, (ushort)reg.Address, regValue).ConfigureAwait(false);
+                if (response != null)
                 {
-                    strResp = "Register write OK";
-                    if ((string)response.Arguments[1] == "1")
+                    if ((response.Arguments?.Count > 0) &&
+                        (response.Arguments?.Count == 2))
                     {
-                        strResp = "Register write fail";
+                        strResp = "Register write OK";
+                        if ((string)response.Arguments[1] != $"{FlConstant.FL_OK}")
+                        {
+                            strResp = $"Register write fail({AppUtil.I2CErrorToString((string)response.Arguments[1])})";
+                        }
+                    }
+                    else
+                    {
+                        strResp = "Invalid response(argument error)";
                     }
-                }
-                else
-                {
-                    strResp = "Invalid response(argument error)";
                 }
             }
+            catch (TaskCanceledException)
+            {
+                strResp = "WriteRegister canceled";
+            }
+            catch (Exception ex)
+            {
+                strResp = ex.Message;
+            }
 
-            LbHistory.Items.Insert(0, strResp);
+            _uiUpdates.Post(() => AddHistory(strResp));
         }
 
         private void BtnHistoryClear_Click(object sender, RoutedEventArgs e)
         {
-            LbHistory.Items.Clear();
+            _history.Clear();
         }
 
-        private void UpdateRegisterDataGrid(List<(ulong address, uint value)> regValues)
+        // Newest first, the oldest lines are dropped.
+        private void AddHistory(string text)
         {
-            _registers.Clear();
+            _history.Insert(0, text);
+            while (_history.Count > AppConstant.HISTORY_MAX_COUNT)
+            {
+                _history.RemoveAt(_history.Count - 1);
+            }
+        }
+
+        private void UpdateRegisterValue(Register reg, ulong value)
+        {
+            reg.Value = value;
+            _catalog?.UpdateBitFields(reg);
+            _updatedRegisters.Add(reg);
+        }
 
-            using (var ctx = new RegisterContext())
+        // After a batch of UI updates : the rows of the updated registers, the selected register views if updated.
+        private void RefreshUpdatedRegisters()
+        {
+            if (_updatedRegisters.Count == 0)
             {
-                foreach (var item in regValues)
-                {
-                    var reg = ctx.RegisterTemplates.Where(r => r.Address == item.address).FirstOrDefault();
+                return;
+            }
 
-                    if (reg != null)
-                    {
-                        var bitFields = new ObservableCollection<BitFieldTemplate>(ctx.BitFieldTemplates.Where(bf => bf.RegisterTemplateId == reg.Id).OrderBy(bf => bf.Offset).ToList());
-                        reg.BitFields = bitFields;
-                        Register regValue = new Register(reg);
-                        regValue.Value = item.value;
+            foreach (var updated in _updatedRegisters)
+            {
+                RefreshRegisterRow(updated);
+            }
 
-                        foreach (var bf in reg.BitFields)
-                        {
-                            BitField b = new BitField(bf);
-                            var val = GeneralUtil.GetBitFieldValue(item.value, bf);
+            if ((DgRegister.SelectedItem is Register reg) && (_updatedRegisters.Contains(reg) == true))
+            {
+                DgRegisterBitField.Items.Refresh();
+                _regBitUsage.UpdateRegBitUsage(reg.Bits, reg.BitFields);
+                TbRegisterValue.Text = $"{reg.Value:X4}";
+            }
 
-                            b.Value = val;
-                            regValue.BitFields.Add(b);
-                        }
-                        _registers.Add(regValue);
-                    }
-                }
+            _updatedRegisters.Clear();
+        }
 
-                DgRegister.ItemsSource = _registers;
+        // The value cell of a shown row(a row scrolled into view later binds the current value).
+        private void RefreshRegisterRow(Register reg)
+        {
+            if ((DgRegister.ItemContainerGenerator.ContainerFromItem(reg) is DataGridRow row) &&
+                (registerValue.GetCellContent(row) is TextBlock text))
+            {
+                BindingOperations.GetBindingExpression(text, TextBlock.TextProperty)?.UpdateTarget();
             }
         }
+
+        private void UpdateRegisterDataGrid(string fileName)
+        {
+            _registers.Clear();
+
+            if (_catalog != null)
+            {
+                foreach (var reg in AppUtil.LoadRegisterValues(_catalog, fileName))
+                {
+                    _registers.Add(reg);
+                }
+            }
+
+            DgRegister.ItemsSource = _registers;
+        }
     }
 }
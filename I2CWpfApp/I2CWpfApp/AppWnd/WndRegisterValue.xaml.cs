@@ -1,11 +1,9 @@
 ﻿using Microsoft.Win32;
 using RegisterCore.Net;
 using RegisterCore.Net.Models;
-using RegisterSqlite.Net;
 using System;
 using System.Collections.Generic;
 using System.Collections.ObjectModel;
-using System.IO;
 using System.Linq;
 using System.Windows;
 using I2CWpfApp.AppControl;
@@ -17,7 +15,7 @@ namespace I2CWpfApp.AppWnd
     /// </summary>
     public partial class WndRegisterValue : Window
     {
-        long _currentChipId = -1;
+        RegisterCatalog _catalog = null;
         int _bitFieldBits = 0;
         ObservableCollection<Register> _registers = new ObservableCollection<Register>();
         List<BitField> _bfTemplates = new List<BitField>();
@@ -30,14 +28,7 @@ namespace I2CWpfApp.AppWnd
 
         private void Window_Loaded(object sender, RoutedEventArgs e)
         {
-            using (var ctx = new RegisterContext())
-            {
-                var chip = ctx.Chips.Where(c => c.Name == "VL6180x").SingleOrDefault();
-                if (chip != null)
-                {
-                    _currentChipId = chip.Id;
-                }
-            }
+            _catalog = AppUtil.LoadRegisterCatalog();
         }
 
         private void BtnRegisterValueLoad_Click(object sender, RoutedEventArgs e)
@@ -46,37 +37,17 @@ namespace I2CWpfApp.AppWnd
             if (openFileDialog.ShowDialog() == true)
             {
                 TbFIleName.Text = openFileDialog.SafeFileName;
-                var regValues = AppUtil.ReadRegisterValuesFromFile(openFileDialog.FileName);
-
                 _registers.Clear();
 
-                using (var ctx = new RegisterContext())
+                if (_catalog != null)
                 {
-                    foreach (var item in regValues)
+                    foreach (var reg in AppUtil.LoadRegisterValues(_catalog, openFileDialog.FileName))
                     {
-                        var reg = ctx.RegisterTemplates.Where(r => r.Address == item.address).FirstOrDefault();
-
-                        if (reg != null)
-                        {
-                            var bitFields = new ObservableCollection<BitFieldTemplate>(ctx.BitFieldTemplates.Where(bf => bf.RegisterTemplateId == reg.Id).OrderBy(bf => bf.Offset).ToList());
-                            reg.BitFields = bitFields;
-                            Register regValue = new Register(reg);
-                            regValue.Value = item.value;
-
-                            foreach (var bf in reg.BitFields)
-                            {
-                                BitField b = new BitField(bf);
-                                var val = GeneralUtil.GetBitFieldValue(item.value, bf);
-
-                                b.Value = val;
-                                regValue.BitFields.Add(b);
-                            }
-                            _registers.Add(regValue);
-                        }
+                        _registers.Add(reg);
                     }
-
-                    DgRegister.ItemsSource = _registers;
                 }
+
+                DgRegister.ItemsSource = _registers;
             }
         }
 
@@ -90,9 +61,17 @@ namespace I2CWpfApp.AppWnd
             }
 
             SaveFileDialog saveFileDialog = new SaveFileDialog();
+            saveFileDialog.Filter = AppConstant.STR_REG_VALUE_FILE_FILTER;
             if (saveFileDialog.ShowDialog() == true)
             {
-                SaveRegisterValues(saveFileDialog.FileName, _registers);
+                try
+                {
+                    AppUtil.SaveRegisterValues(saveFileDialog.FileName, _registers);
+                }
+                catch (Exception ex)
+                {
+                    MessageBox.Show(ex.ToString());
+                }
             }
         }
 
@@ -115,7 +94,7 @@ namespace I2CWpfApp.AppWnd
 
                 _bitFieldBits = reg.Bits;
                 //_regBitUsage.UpdateRegBitUsage(_bitFieldBits, reg.BitFields.OrderBy(bf => bf.Offset).ToList());
-                _regBitUsage.UpdateRegBitUsage(_bitFieldBits, reg.BitFields.ToList());
+                _regBitUsage.UpdateRegBitUsage(_bitFieldBits, reg.BitFields);
                 BitFieldPlaceHolder.Content = _regBitUsage;
 
                 TbRegisterName.Text = reg.Name;
@@ -133,11 +112,7 @@ namespace I2CWpfApp.AppWnd
 
         private void BtnAddRegisterValue_Click(object sender, RoutedEventArgs e)
         {
-            List<RegisterTemplate> regTemplates = null;
-            using (var ctx = new RegisterContext())
-            {
-                regTemplates = ctx.RegisterTemplates.Where(r => r.ChipId == _currentChipId).ToList();
-            }
+            List<RegisterTemplate> regTemplates = _catalog?.Registers.ToList() ?? new List<RegisterTemplate>();
 
             if (_registers?.Count > 0)
             {
@@ -216,13 +191,7 @@ namespace I2CWpfApp.AppWnd
             if (ulong.TryParse(TbRegisterValue.Text, System.Globalization.NumberStyles.HexNumber, null, out ulong regValue) == true)
             {
                 reg.Value = regValue;
-
-                foreach (var bf in reg.BitFields)
-                {
-                    var val = GeneralUtil.GetBitFieldValue(reg.Value, bf);
-
-                    bf.Value = val;
-                }
+                _catalog.UpdateBitFields(reg);
 
                 DgRegister.ItemsSource = null;
                 DgRegister.ItemsSource = _registers;
@@ -258,10 +227,7 @@ namespace I2CWpfApp.AppWnd
                     return;
                 }
                 bf.Value = bfValue;
-
-                UInt64 calculatedVal = GeneralUtil.GetRegisterValueFromBitFields(reg.BitFields);
-
-                reg.Value = calculatedVal;
+                _catalog.UpdateValue(reg);
 
                 DgRegister.ItemsSource = null;
                 DgRegister.ItemsSource = _registers;
@@ -271,39 +237,5 @@ namespace I2CWpfApp.AppWnd
                 DgRegisterBitField.SelectedIndex = selectedBfIndex;
             }
         }
-
-        private void SaveRegisterValues(string fileName, ObservableCollection<Register> registers)
-        {
-            try
-            {
-                StreamWriter sw = new StreamWriter(fileName);
-
-                foreach (var reg in registers)
-                {
-                    if (reg.Bits <= 8)
-                    {
-                        sw.WriteLine($"{reg.Address:X8},{reg.Value:X2}");
-                    }
-                    else if (reg.Bits <= 16)
-                    {
-                        sw.WriteLine($"{reg.Address:X8},{reg.Value:X4}");
-                    }
-                    else if (reg.Bits <= 32)
-                    {
-                        sw.WriteLine($"{reg.Address:X8},{reg.Value:X8}");
-                    }
-                    else
-                    {
-                        sw.WriteLine($"{reg.Address:X8},{reg.Value:X}");
-                    }
-                }
-
-                sw.Close();
-            }
-            catch (Exception ex)
-            {
-                MessageBox.Show(ex.ToString());
-            }
-        }
     }
 }
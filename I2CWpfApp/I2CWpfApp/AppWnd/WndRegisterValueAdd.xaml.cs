@@ -1,6 +1,5 @@
 ﻿using RegisterCore.Net;
 using RegisterCore.Net.Models;
-using RegisterSqlite.Net;
 using System.Collections.Generic;
 using System.Collections.ObjectModel;
 using System.Linq;
@@ -56,21 +55,7 @@ namespace I2CWpfApp.AppWnd
                 return;
             }
 
-            _registerValue = new Register(regTemplate);
-            _registerValue.Value = regValue;
-            using (var ctx = new RegisterContext())
-            {
-                var bitFields = new ObservableCollection<BitFieldTemplate>(ctx.BitFieldTemplates.Where(bf => bf.RegisterTemplateId == _registerValue.Id).OrderBy(bf => bf.Offset).ToList());
-
-                foreach (var bf in bitFields)
-                {
-                    BitField b = new BitField(bf);
-                    var val = GeneralUtil.GetBitFieldValue(_registerValue.Value, bf);
-
-                    b.Value = val;
-                    _registerValue.BitFields.Add(b);
-                }
-            }
+            _registerValue = RegisterCatalog.CreateRegister(regTemplate, regValue);
 
             DialogResult = true;
         }
@@ -1,17 +1,27 @@
 ﻿using Fl.Net;
+using Fl.Net.Capture;
 using Fl.Net.Message;
 using Fl.Net.Parser;
+using Fl.Net.Trace;
+using RegisterCore.Net;
+using RegisterCore.Net.Models;
 using Serilog;
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.IO.Ports;
 using System.Threading;
+using System.Threading.Tasks;
 
 namespace I2CWpfApp
 {
     public class I2CManager
     {
         const int MAX_BUF_LEN = 2048;
+        const int RESPONSE_WAIT_COUNT = 10;         // 100ms each
+        const int RESPONSE_WAIT_UNIT = 100;         // ms
+        // A configuration write may compact the configuration sector(128KB flash erase) first.
+        const int CONFIG_RESPONSE_WAIT_COUNT = 30;
 
         #region Private Fields
         byte[] _rx_buf = new byte[MAX_BUF_LEN];
@@ -23,7 +33,18 @@ namespace I2CWpfApp
         EventWaitHandle _serialEvent;
         FlTxtParser _appTxtParser = new FlTxtParser();
         IFlMessage _response = null;
+        AutoResetEvent _responseEvent = new AutoResetEvent(false);
+        // Commands of RunAsync(), run one at a time on the command thread.
+        BlockingCollection<Action> _commandQueue = null;
+        Thread _commandThread = null;
+        volatile bool _commandLoop = false;
         uint _deviceId = 1;
+        FlTraceReplayer _replayer = null;
+        List<IFlMessage> _broadcastResponses = null;
+        object _broadcastLock = new object();
+        // SnapshotRegisters() : burst plan of a catalog, the last snapshot of a device(catalog, I2C number, address).
+        Dictionary<RegisterCatalog, RegisterBurstPlan> _burstPlans = new Dictionary<RegisterCatalog, RegisterBurstPlan>();
+        Dictionary<(RegisterCatalog, byte, ushort), RegisterMapSnapshot> _snapshots = new Dictionary<(RegisterCatalog, byte, ushort), RegisterMapSnapshot>();
         #endregion
 
         #region Public Properties
@@ -31,6 +52,22 @@ namespace I2CWpfApp
         public bool ResponseReceived { get; set; }
         public string ComPortName { get; set; }
         public FlTxtParser AppTxtParser => _appTxtParser;
+        // Called from the message thread with the number of captured samples on the device.
+        public Action<uint> OnCaptureWatermark { get; set; }
+        // Called from the message thread with each result of a sensor in a ranging mode.
+        public Action<FlRangeResult> OnRangeResult { get; set; }
+        // Called from the message thread with each result of a sensor in the interleaved mode.
+        public Action<FlMeasurement> OnMeasurement { get; set; }
+        // Called from the message thread when the device has enumerated its sensors after a reset
+        // (sensor mask, boot time in ms). Sensor and I2C commands report FL_I2C_ERR_BUS before.
+        public Action<byte, uint> OnDeviceReady { get; set; }
+        // Range, measurement and drained capture samples are appended to the store if set(null : not stored).
+        public FlSampleStore SampleStore { get; set; }
+        // Received and sent serial bytes are recorded if set(Replay() feeds the received bytes back).
+        public FlSerialTraceWriter TraceWriter { get; set; }
+        // Called from the thread of SnapshotRegisters() when registers changed since the previous snapshot
+        // of the device(snapshot, I2C number, address), RegisterMapSnapshot.Changed has the changed registers.
+        public Action<RegisterMapSnapshot, byte, ushort> OnRegistersChanged { get; set; }
         #endregion
 
         public void Start(string strComPortName)
@@ -47,6 +84,12 @@ namespace I2CWpfApp
 
             _serialPort.Open();
 
+            // The device may have been reset, the first snapshot reports all registers.
+            lock (_snapshots)
+            {
+                _snapshots.Clear();
+            }
+
             _messageLoop = true;
             _messageThread = new Thread(new ThreadStart(InternalMessageProc))
             {
@@ -55,10 +98,25 @@ namespace I2CWpfApp
             _messageThread.Start();
 
             _isStarted = true;
+
+            _commandQueue = new BlockingCollection<Action>();
+            _commandLoop = true;
+            _commandThread = new Thread(new ThreadStart(InternalCommandProc))
+            {
+                IsBackground = true
+            };
+            _commandThread.Start();
         }
 
         public void Stop()
         {
+            // Queued commands are canceled, a running command finishes(or times out) first.
+            _commandLoop = false;
+            _commandQueue.CompleteAdding();
+            _commandThread.Join();
+            _commandQueue.Dispose();
+            _commandQueue = null;
+
             _serialEvent.Set();
             _messageLoop = false;
             _messageThread.Join();
@@ -70,7 +128,67 @@ namespace I2CWpfApp
             _isStarted = false;
         }
 
-        public IFlMessage ReadRegister(ushort address, ushort regAddr)
+        // Runs a command(a blocking method of the manager) on the command thread, commands run in the queued order.
+        // The task is canceled if the manager stops before the command runs.
+        // Blocking methods must not be called from other threads while commands are queued(one pending response).
+        public Task<T> RunAsync<T>(Func<I2CManager, T> command)
+        {
+            TaskCompletionSource<T> tcs = new TaskCompletionSource<T>(TaskCreationOptions.RunContinuationsAsynchronously);
+            BlockingCollection<Action> queue = _commandQueue;
+
+            Action run = () =>
+            {
+                if (_commandLoop != true)
+                {
+                    tcs.TrySetCanceled();
+                    return;
+                }
+
+                try
+                {
+                    tcs.TrySetResult(command(this));
+                }
+                catch (OperationCanceledException)
+                {
+                    // The command gave up because the manager stopped(SnapshotRegisters()).
+                    tcs.TrySetCanceled();
+                }
+                catch (Exception ex)
+                {
+                    tcs.TrySetException(ex);
+                }
+            };
+
+            bool queued = false;
+            try
+            {
+                queued = (queue != null) && queue.TryAdd(run);
+            }
+            catch (InvalidOperationException)
+            {
+                // Stopped(completed or disposed queue).
+            }
+
+            if (queued != true)
+            {
+                tcs.TrySetException(new InvalidOperationException("I2C manager is not started"));
+            }
+
+            return tcs.Task;
+        }
+
+        public Task<IFlMessage> ReadRegisterAsync(ushort address, ushort regAddr, byte i2cNum = FlConstant.FL_I2C_NUM_MIN)
+        {
+            return RunAsync(mgr => mgr.ReadRegister(address, regAddr, i2cNum));
+        }
+
+        public Task<IFlMessage> WriteRegisterAsync(ushort address, ushort regAddr, UInt32 regValue, byte i2cNum = FlConstant.FL_I2C_NUM_MIN)
+        {
+            return RunAsync(mgr => mgr.WriteRegister(address, regAddr, regValue, i2cNum));
+        }
+
+        // i2cNum : FL_I2C_NUM_MIN ~ FL_I2C_NUM_MAX, transfers on different buses run concurrently on the device.
+        public IFlMessage ReadRegister(ushort address, ushort regAddr, byte i2cNum = FlConstant.FL_I2C_NUM_MIN)
         {
             IFlMessage message = null;
 
@@ -81,7 +199,7 @@ namespace I2CWpfApp
                 {
                     _deviceId.ToString(),   // DeviceID
                     "0",                    // Read mode
-                    "1",                    // I2C number
+                    $"{i2cNum}",            // I2C number
                     $"{address}",           // Target I2C device address
                     $"{regAddr}"            // Register address
                 }
@@ -99,7 +217,7 @@ namespace I2CWpfApp
             return null;
         }
 
-        public IFlMessage WriteRegister(ushort address, ushort regAddr, UInt32 regValue)
+        public IFlMessage WriteRegister(ushort address, ushort regAddr, UInt32 regValue, byte i2cNum = FlConstant.FL_I2C_NUM_MIN)
         {
             IFlMessage message = null;
 
@@ -110,7 +228,7 @@ namespace I2CWpfApp
                 {
                     _deviceId.ToString(),   // DeviceID
                     "1",                    // Write mode
-                    "1",                    // I2C number
+                    $"{i2cNum}",            // I2C number
                     $"{address}",           // Target I2C device address
                     $"{regAddr}",           // Register address
                     $"{regValue}"           // Register value
@@ -129,11 +247,648 @@ namespace I2CWpfApp
             return null;
         }
 
+        // count bytes of consecutive registers from regAddr in one I2C transfer(1 ~ FL_MSG_I2C_MAX_BURST_LEN),
+        // null : no response or the transfer failed.
+        // A response of another command(a late response of a timed out command) is discarded, the registers of
+        // a successful response must be the requested ones(I2C number, address and register address are echoed).
+        public byte[] ReadBurst(ushort address, ushort regAddr, int count, byte i2cNum = FlConstant.FL_I2C_NUM_MIN)
+        {
+            IFlMessage message = new FlTxtMessageCommand()
+            {
+                MessageId = FlMessageId.ReadBurst,
+                Arguments = new List<object>()
+                {
+                    _deviceId.ToString(),   // DeviceID
+                    $"{i2cNum}",            // I2C number
+                    $"{address}",           // Target I2C device address
+                    $"{regAddr}",           // First register address
+                    $"{count}"              // Number of bytes
+                }
+            };
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            ResponseReceived = false;
+            SendPacket(message.Buffer);
+
+            // DeviceID, error(the error response has no other argument), I2C number, address, register address, count, bytes
+            bool isBurstResponse(IFlMessage resp) =>
+                (resp.MessageId == FlMessageId.ReadBurst) &&
+                ((resp.Arguments?.Count == 2) ||
+                 ((resp.Arguments?.Count == 7) &&
+                  ((string)resp.Arguments[2] == $"{i2cNum}") &&
+                  ((string)resp.Arguments[3] == $"{address}") &&
+                  ((string)resp.Arguments[4] == $"{regAddr}")));
+
+            if (WaitForResponse(isBurstResponse) != true)
+            {
+                return null;
+            }
+
+            IFlMessage response = _response;
+            if ((response.Arguments?.Count != 7) ||
+                ((string)response.Arguments[1] != $"{FlConstant.FL_OK}"))
+            {
+                Log.Warning($"Burst read failed : 0x{regAddr:X4}, {count} bytes, error {response.Arguments?[1]}");
+                return null;
+            }
+
+            try
+            {
+                byte[] data = Convert.FromBase64String((string)response.Arguments[6]);
+                return (data.Length == count) ? data : null;
+            }
+            catch (FormatException)
+            {
+                return null;
+            }
+        }
+
+        // Register read-modify-write on the device : the bits of mask are set to value, the other bits are kept.
+        // No other transfer runs on the bus between the read and the write.
+        // Register value written, null : no response or the transfer failed.
+        public uint? UpdateBits(ushort address, ushort regAddr, UInt32 mask, UInt32 value, byte i2cNum = FlConstant.FL_I2C_NUM_MIN)
+        {
+            IFlMessage message = new FlTxtMessageCommand()
+            {
+                MessageId = FlMessageId.UpdateBits,
+                Arguments = new List<object>()
+                {
+                    _deviceId.ToString(),   // DeviceID
+                    $"{i2cNum}",            // I2C number
+                    $"{address}",           // Target I2C device address
+                    $"{regAddr}",           // Register address
+                    $"{mask}",              // Bits to update
+                    $"{value & mask}"       // New value of the bits
+                }
+            };
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            ResponseReceived = false;
+            SendPacket(message.Buffer);
+
+            if (WaitForResponse() != true)
+            {
+                return null;
+            }
+
+            // DeviceID, error, register value
+            IFlMessage response = _response;
+            if ((response.Arguments?.Count == 3) &&
+                ((string)response.Arguments[1] == $"{FlConstant.FL_OK}") &&
+                (uint.TryParse((string)response.Arguments[2], out uint regValue) == true))
+            {
+                return regValue;
+            }
+
+            Log.Warning($"Bits update failed : 0x{regAddr:X4}, mask 0x{mask:X8}, error {response.Arguments?[1]}");
+            return null;
+        }
+
+        // Write a bit field value of a register with one UpdateBits command(no register read on the host).
+        // Register value written, null : no response or the transfer failed.
+        public uint? UpdateBitField(ushort address, Register reg, BitField bitField, UInt64 value, byte i2cNum = FlConstant.FL_I2C_NUM_MIN)
+        {
+            if ((bitField.Offset < 0) || ((bitField.Offset + bitField.Bits) > 32))
+            {
+                throw new ArgumentOutOfRangeException(nameof(bitField), $"{bitField.Name} : bits {bitField.Offset} ~ {bitField.Offset + bitField.Bits - 1}");
+            }
+
+            if (value > GeneralUtil.GetBitFieldMaxValue(bitField))
+            {
+                throw new ArgumentOutOfRangeException(nameof(value), $"{bitField.Name} : 0x{value:X}");
+            }
+
+            UInt32 mask = (UInt32)(GeneralUtil.GetBitFieldMaxValue(bitField) << bitField.Offset);
+
+            return UpdateBits(address, (ushort)reg.Address, mask, (UInt32)(value << bitField.Offset), i2cNum);
+        }
+
+        // Read all registers of the catalog from a device with the fewest burst reads(RegisterBurstPlan) and
+        // compare them with the previous snapshot of the device. OnRegistersChanged is called if registers changed
+        // (all registers of the first snapshot). Registers of a failed burst are not read(RegisterMapSnapshot.IsRead()).
+        // The snapshot is abandoned(OperationCanceledException, the last snapshot is kept) if the manager stops
+        // between bursts, so Stop() waits for one burst at most.
+        public RegisterMapSnapshot SnapshotRegisters(RegisterCatalog catalog, ushort address, byte i2cNum = FlConstant.FL_I2C_NUM_MIN)
+        {
+            RegisterBurstPlan plan;
+            RegisterMapSnapshot previous;
+            RegisterMapSnapshot snapshot = new RegisterMapSnapshot(catalog);
+            int failed = 0;
+
+            lock (_snapshots)
+            {
+                if (_burstPlans.TryGetValue(catalog, out plan) != true)
+                {
+                    plan = new RegisterBurstPlan(catalog, FlConstant.FL_MSG_I2C_MAX_BURST_LEN);
+                    _burstPlans.Add(catalog, plan);
+                }
+                _snapshots.TryGetValue((catalog, i2cNum, address), out previous);
+            }
+
+            for (int i = 0; i < plan.Bursts.Count; i++)
+            {
+                if (_commandLoop != true)
+                {
+                    Log.Debug($"Register snapshot abandoned : {i}/{plan.Bursts.Count} bursts read");
+                    throw new OperationCanceledException("I2C manager stopped");
+                }
+
+                RegisterBurst burst = plan.Bursts[i];
+                byte[] data = ReadBurst(address, (ushort)burst.Address, burst.Length, i2cNum);
+
+                if (data != null)
+                {
+                    plan.Decode(i, data, snapshot);
+                }
+                else
+                {
+                    failed++;
+                }
+            }
+
+            snapshot.Timestamp = DateTime.UtcNow;
+            snapshot.CompareWith(previous);
+
+            // Registers of a failed burst are compared with their last known values next time.
+            lock (_snapshots)
+            {
+                _snapshots[(catalog, i2cNum, address)] = (failed > 0) ? snapshot.MergeWith(previous) : snapshot;
+            }
+
+            Log.Debug($"Register snapshot : {plan.Bursts.Count} bursts({failed} failed), {snapshot.Changed.Count} changed");
+
+            if (snapshot.Changed.Count > 0)
+            {
+                OnRegistersChanged?.Invoke(snapshot, i2cNum, address);
+            }
+
+            return snapshot;
+        }
+
+        // Send a command to all devices(FL_DEVICE_ID_ALL) and collect the responses.
+        // Each device answers in its own time slot(FlUtil.BroadcastSlotTime() x (device ID - 1)),
+        // so one command polls deviceCount devices(device IDs 1 ~ FL_MAX_NODE_COUNT).
+        public List<IFlMessage> SendBroadcast(FlMessageId messageId, int deviceCount, params object[] arguments)
+        {
+            IFlMessage message = null;
+            List<IFlMessage> responses = new List<IFlMessage>();
+
+            if ((deviceCount <= 0) || (deviceCount > FlConstant.FL_MAX_NODE_COUNT))
+            {
+                throw new ArgumentOutOfRangeException(nameof(deviceCount));
+            }
+
+            message = new FlTxtMessageCommand()
+            {
+                MessageId = messageId,
+                Arguments = new List<object>()
+                {
+                    FlConstant.FL_DEVICE_ID_ALL.ToString()  // DeviceID
+                }
+            };
+            message.Arguments.AddRange(arguments);
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            lock (_broadcastLock)
+            {
+                _broadcastResponses = responses;
+            }
+
+            SendPacket(message.Buffer);
+
+            // The last slot + response timeout.
+            int timeout = (deviceCount * FlUtil.BroadcastSlotTime(_serialPort.BaudRate)) + FlConstant.FL_DEF_CMD_RESPONSE_TIMEOUT;
+            DateTime endTime = DateTime.UtcNow.AddMilliseconds(timeout);
+
+            while (DateTime.UtcNow < endTime)
+            {
+                lock (_broadcastLock)
+                {
+                    if (responses.Count >= deviceCount)
+                    {
+                        break;
+                    }
+                }
+                Thread.Sleep(1);
+            }
+
+            lock (_broadcastLock)
+            {
+                _broadcastResponses = null;
+            }
+
+            Log.Information($"Broadcast responses : {responses.Count}/{deviceCount}");
+
+            return responses;
+        }
+
+        public List<IFlMessage> ReadFirmwareVersionAll(int deviceCount)
+        {
+            return SendBroadcast(FlMessageId.ReadFirmwareVersion, deviceCount);
+        }
+
+        // Start periodic sampling on the device. Samples are kept in the device ring buffer
+        // until DrainCapture() reads them.
+        // address FL_MSG_CAPTURE_ALL_SENSORS : the enumerated sensors range in turn(FlCaptureSample.Sensor),
+        // 1000 / periodMs samples per second in total.
+        public bool StartCapture(ushort address, ushort periodMs, ushort watermark, byte i2cNum = FlConstant.FL_I2C_NUM_MIN)
+        {
+            return SendCaptureControl(FlConstant.FL_MSG_CAPTURE_START, i2cNum, address, periodMs, watermark);
+        }
+
+        public bool StopCapture()
+        {
+            return SendCaptureControl(FlConstant.FL_MSG_CAPTURE_STOP, FlConstant.FL_I2C_NUM_MIN, 0, 0, 0);
+        }
+
+        // Read all captured samples(FL_CAPTURE_BATCH_SIZE samples per round trip).
+        public List<FlCaptureSample> DrainCapture()
+        {
+            List<FlCaptureSample> samples = new List<FlCaptureSample>();
+            uint remaining;
+
+            do
+            {
+                IFlMessage message = new FlTxtMessageCommand()
+                {
+                    MessageId = FlMessageId.ReadCapture,
+                    Arguments = new List<object>()
+                    {
+                        _deviceId.ToString(),                   // DeviceID
+                        $"{FlConstant.FL_CAPTURE_BATCH_SIZE}"   // Maximum number of samples
+                    }
+                };
+                FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+                ResponseReceived = false;
+                SendPacket(message.Buffer);
+
+                if (WaitForResponse() != true)
+                {
+                    break;
+                }
+
+                // DeviceID, error, remaining, overrun, count[, samples]
+                IFlMessage response = _response;
+                if ((response.Arguments == null) ||
+                    (response.Arguments.Count < 5) ||
+                    ((string)response.Arguments[1] != $"{FlConstant.FL_OK}"))
+                {
+                    Log.Warning("Read capture failed");
+                    break;
+                }
+
+                remaining = uint.Parse((string)response.Arguments[2]);
+                uint overrun = uint.Parse((string)response.Arguments[3]);
+                if (overrun > 0)
+                {
+                    Log.Warning($"Capture overrun : {overrun} samples dropped");
+                }
+
+                if (response.Arguments.Count == 6)
+                {
+                    samples.AddRange(FlCaptureSample.Decode((string)response.Arguments[5]));
+                }
+            } while (remaining > 0);
+
+            Log.Information($"Captured samples : {samples.Count}");
+
+            if (SampleStore != null)
+            {
+                DateTime now = DateTime.UtcNow;
+
+                foreach (var sample in samples)
+                {
+                    SampleStore.Append(FlSample.FromCaptureSample(sample, now));
+                }
+            }
+
+            return samples;
+        }
+
+        // Feeds the received bytes of a trace file to the parser and the event handlers without the serial port
+        // (speed 1 : recorded timing, N : N times faster, FlTraceReplayer.SPEED_FAST : no waits).
+        // Callbacks are called on the calling thread. Commands are not sent, the recorded responses are received.
+        public FlReplayStats Replay(string fileName, double speed, CancellationToken token = default)
+        {
+            FlReplayStats stats;
+
+            if (_isStarted == true)
+            {
+                throw new InvalidOperationException("I2C manager is started");
+            }
+
+            _replayer = new FlTraceReplayer(FlSerialTraceReader.Load(fileName))
+            {
+                Speed = speed
+            };
+            _appTxtParser.Clear();
+
+            try
+            {
+                stats = _replayer.Run(ProcessAppTxtMessage, token);
+            }
+            finally
+            {
+                _replayer = null;
+            }
+
+            Log.Information($"{fileName} : {stats}");
+
+            return stats;
+        }
+
+        // Read latency statistics of a firmware stage(FL_PERF_STAGE_XXX).
+        public FlPerfStats GetPerfStats(byte stage, bool clear = false)
+        {
+            IFlMessage message = new FlTxtMessageCommand()
+            {
+                MessageId = FlMessageId.ReadPerf,
+                Arguments = new List<object>()
+                {
+                    _deviceId.ToString(),   // DeviceID
+                    $"{stage}",             // Stage
+                    clear ? "1" : "0"       // Clear after reading
+                }
+            };
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            ResponseReceived = false;
+            SendPacket(message.Buffer);
+
+            if (WaitForResponse() == true)
+            {
+                FlPerfStats stats = FlPerfStats.FromResponse(_response);
+                if (stats != null)
+                {
+                    Log.Information(stats.ToString());
+                }
+                return stats;
+            }
+
+            return null;
+        }
+
+        // Addresses(8-bit) of the sensors on the device, 0 for a sensor not found.
+        // enumerate : the device resets the sensors and assigns the addresses again(capture must be stopped).
+        public ushort[] ReadSensors(bool enumerate = false)
+        {
+            IFlMessage message = new FlTxtMessageCommand()
+            {
+                MessageId = FlMessageId.ReadSensors,
+                Arguments = new List<object>()
+                {
+                    _deviceId.ToString(),   // DeviceID
+                    enumerate ? "1" : "0"   // Enumerate
+                }
+            };
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            ResponseReceived = false;
+            SendPacket(message.Buffer);
+
+            if ((WaitForResponse() == true) &&
+                ((string)_response.Arguments?[1] == $"{FlConstant.FL_OK}") &&
+                (_response.Arguments.Count >= (3 + FlConstant.FL_MSG_SENSOR_MAX_COUNT)))
+            {
+                ushort[] addresses = new ushort[FlConstant.FL_MSG_SENSOR_MAX_COUNT];
+                for (int i = 0; i < addresses.Length; i++)
+                {
+                    addresses[i] = ushort.Parse((string)_response.Arguments[3 + i]);
+                }
+                return addresses;
+            }
+
+            return null;
+        }
+
+        // Start a ranging mode(FL_MSG_RANGE_XXX) of an enumerated sensor(ReadSensors()), the device reads
+        // the results at the sensor rate and sends them in range events(OnRangeResult), interleaved mode
+        // results with the lux computed on the device in measurement events(OnMeasurement).
+        // periodMs : FL_RANGE_PERIOD_MIN ~ FL_RANGE_PERIOD_MAX(continuous),
+        //            FL_RANGE_INTERLEAVED_PERIOD_MIN ~ FL_RANGE_PERIOD_MAX(interleaved range + ALS).
+        // The device reports FL_I2C_ERR_BUS while capture is started.
+        public bool SetRangingMode(byte sensor, byte mode, ushort periodMs = 0)
+        {
+            IFlMessage message = new FlTxtMessageCommand()
+            {
+                MessageId = FlMessageId.WriteRanging,
+                Arguments = new List<object>()
+                {
+                    _deviceId.ToString(),   // DeviceID
+                    $"{sensor}",            // Sensor index
+                    $"{mode}",              // Ranging mode
+                    $"{periodMs}"           // Intermeasurement period
+                }
+            };
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            ResponseReceived = false;
+            SendPacket(message.Buffer);
+
+            if (WaitForResponse() == true)
+            {
+                return (string)_response.Arguments?[1] == $"{FlConstant.FL_OK}";
+            }
+
+            return false;
+        }
+
+        public bool StartContinuousRanging(byte sensor, ushort periodMs)
+        {
+            return SetRangingMode(sensor, FlConstant.FL_MSG_RANGE_CONTINUOUS, periodMs);
+        }
+
+        public bool StopRanging(byte sensor)
+        {
+            return SetRangingMode(sensor, FlConstant.FL_MSG_RANGE_STOP);
+        }
+
+        // Change the I2C bus speed(SCL frequency, FL_I2C_SPEED_XXX).
+        // The device recomputes the timing register and reinitializes the bus between transfers.
+        // The device reports FL_I2C_ERR_BUS while capture transfers are queued on the bus.
+        public bool SetBusSpeed(uint speedHz, byte i2cNum = FlConstant.FL_I2C_NUM_MIN)
+        {
+            IFlMessage message = new FlTxtMessageCommand()
+            {
+                MessageId = FlMessageId.WriteI2CSpeed,
+                Arguments = new List<object>()
+                {
+                    _deviceId.ToString(),   // DeviceID
+                    $"{i2cNum}",            // I2C number
+                    $"{speedHz}"            // SCL frequency
+                }
+            };
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            ResponseReceived = false;
+            SendPacket(message.Buffer);
+
+            if (WaitForResponse() == true)
+            {
+                return (string)_response.Arguments?[1] == $"{FlConstant.FL_OK}";
+            }
+
+            return false;
+        }
+
+        // Store a configuration item(FL_MSG_CONFIG_XXX) in the device flash, applied at the next device reset.
+        // value 0 deletes the item(the device default is used).
+        public bool WriteConfig(byte item, uint value)
+        {
+            IFlMessage message = new FlTxtMessageCommand()
+            {
+                MessageId = FlMessageId.WriteConfig,
+                Arguments = new List<object>()
+                {
+                    _deviceId.ToString(),   // DeviceID
+                    $"{item}",              // Configuration item
+                    $"{value}"              // Value
+                }
+            };
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            ResponseReceived = false;
+            SendPacket(message.Buffer);
+
+            if (WaitForResponse(CONFIG_RESPONSE_WAIT_COUNT) == true)
+            {
+                return (string)_response.Arguments?[1] == $"{FlConstant.FL_OK}";
+            }
+
+            return false;
+        }
+
+        // Stored value of a configuration item, null : not stored(default value) or no response.
+        public uint? ReadConfig(byte item)
+        {
+            IFlMessage message = new FlTxtMessageCommand()
+            {
+                MessageId = FlMessageId.ReadConfig,
+                Arguments = new List<object>()
+                {
+                    _deviceId.ToString(),   // DeviceID
+                    $"{item}"               // Configuration item
+                }
+            };
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            ResponseReceived = false;
+            SendPacket(message.Buffer);
+
+            if ((WaitForResponse() == true) &&
+                (_response.Arguments?.Count == 4) &&
+                ((string)_response.Arguments[1] == $"{FlConstant.FL_OK}") &&
+                (uint.TryParse((string)_response.Arguments[3], out uint value) == true))
+            {
+                return value;
+            }
+
+            return null;
+        }
+
+        // Store a register init profile in a slot(0 ~ FL_MSG_PROFILE_COUNT - 1).
+        // The device writes the stored profiles after each sensor enumeration(boot, ReadSensors(true)),
+        // so the register init sequence is not sent after a power cycle.
+        public bool SaveRegisterProfile(byte slot, FlRegisterProfile profile)
+        {
+            if ((profile.Entries.Count > FlConstant.FL_MSG_PROFILE_MAX_ENTRIES) ||
+                (SendProfileCommand(FlConstant.FL_MSG_PROFILE_BEGIN, $"{slot}", profile.Name) != true))
+            {
+                return false;
+            }
+
+            foreach (FlProfileEntry entry in profile.Entries)
+            {
+                if (SendProfileCommand(FlConstant.FL_MSG_PROFILE_ADD,
+                                       $"{entry.I2cNum}", $"{entry.DevAddr}", $"{entry.RegAddr}", $"{entry.Value}") != true)
+                {
+                    return false;
+                }
+            }
+
+            return SendProfileCommand(FlConstant.FL_MSG_PROFILE_SAVE);
+        }
+
+        public bool DeleteRegisterProfile(byte slot)
+        {
+            return SendProfileCommand(FlConstant.FL_MSG_PROFILE_DELETE, $"{slot}");
+        }
+
+        public List<FlPerfStats> GetPerfStats(bool clear = false)
+        {
+            List<FlPerfStats> statsList = new List<FlPerfStats>();
+
+            for (byte stage = 0; stage < FlConstant.FL_PERF_STAGE_COUNT; stage++)
+            {
+                FlPerfStats stats = GetPerfStats(stage, clear);
+                if (stats != null)
+                {
+                    statsList.Add(stats);
+                }
+            }
+
+            return statsList;
+        }
+
         public bool IsStarted()
         {
             return _isStarted;
         }
 
+        private bool SendCaptureControl(byte start, byte i2cNum, ushort address, ushort periodMs, ushort watermark)
+        {
+            IFlMessage message = new FlTxtMessageCommand()
+            {
+                MessageId = FlMessageId.CaptureControl,
+                Arguments = new List<object>()
+                {
+                    _deviceId.ToString(),   // DeviceID
+                    $"{start}",             // Start/stop
+                    $"{i2cNum}",            // I2C number
+                    $"{address}",           // Target I2C device address
+                    $"{periodMs}",          // Sampling period
+                    $"{watermark}"          // Capture event threshold
+                }
+            };
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            ResponseReceived = false;
+            SendPacket(message.Buffer);
+
+            if (WaitForResponse() == true)
+            {
+                return (string)_response.Arguments?[1] == $"{FlConstant.FL_OK}";
+            }
+
+            return false;
+        }
+
+        private bool SendProfileCommand(byte op, params string[] args)
+        {
+            IFlMessage message = new FlTxtMessageCommand()
+            {
+                MessageId = FlMessageId.WriteProfile,
+                Arguments = new List<object>()
+                {
+                    _deviceId.ToString(),   // DeviceID
+                    $"{op}"                 // FL_MSG_PROFILE_XXX
+                }
+            };
+            message.Arguments.AddRange(args);
+            FlTxtPacketBuilder.BuildMessagePacket(ref message);
+
+            ResponseReceived = false;
+            SendPacket(message.Buffer);
+
+            if (WaitForResponse(CONFIG_RESPONSE_WAIT_COUNT) == true)
+            {
+                return (string)_response.Arguments?[1] == $"{FlConstant.FL_OK}";
+            }
+
+            return false;
+        }
+
         private void OnSerialPortDataReceived(object sender, SerialDataReceivedEventArgs e)
         {
             _serialEvent.Set();
@@ -183,20 +938,51 @@ namespace I2CWpfApp
                     }
 
                     _serialPort.Read(_rx_buf, 0, _rx_len);
+                    TraceWriter?.Write(FlTraceDirection.Rx, _rx_buf, 0, _rx_len);
+
+                    ProcessAppTxtMessage(_rx_buf, _rx_len);
+                }
+            }
+        }
 
-                    ProcessAppTxtMessage(_rx_len);
+        private void InternalCommandProc()
+        {
+            try
+            {
+                foreach (Action command in _commandQueue.GetConsumingEnumerable())
+                {
+                    command();
                 }
             }
+            catch (ObjectDisposedException)
+            {
+            }
         }
 
-        private void ProcessAppTxtMessage(int bytesToRead)
+        private void ProcessAppTxtMessage(byte[] buf, int bytesToRead)
         {
             for (int i = 0; i < bytesToRead; i++)
             {
-                FlParseState ret = _appTxtParser.ParseResponseEvent(_rx_buf[i], out _response);
+                FlParseState ret = _appTxtParser.ParseResponseEvent(buf[i], out IFlMessage message);
                 if (ret == FlParseState.ParseOk)
                 {
+                    // Events are not responses to a pending command.
+                    if (message.MessageCategory == FlMessageCategory.Event)
+                    {
+                        ProcessAppTxtEvent(message);
+                        _replayer?.MessageDecoded();
+                        continue;
+                    }
+
+                    _response = message;
+
+                    lock (_broadcastLock)
+                    {
+                        _broadcastResponses?.Add(_response);
+                    }
+
                     ResponseReceived = true;
+                    _responseEvent.Set();
 
                     switch (_response.MessageId)
                     {
@@ -204,14 +990,60 @@ namespace I2CWpfApp
                             ProcessAppTxtFwVerResponse(_response);
                             break;
                     }
+
+                    _replayer?.MessageDecoded();
                 }
                 else if (ret == FlParseState.ParseFail)
                 {
                     Log.Debug("Application text response parser fail");
+                    _replayer?.ParseFailed();
                 }
             }
         }
 
+        private void ProcessAppTxtEvent(IFlMessage evt)
+        {
+            switch (evt.MessageId)
+            {
+                case FlMessageId.CaptureEvent:
+                    if ((evt.Arguments?.Count == 2) &&
+                        (uint.TryParse((string)evt.Arguments[1], out uint count) == true))
+                    {
+                        Log.Information($"Capture watermark : {count} samples");
+                        OnCaptureWatermark?.Invoke(count);
+                    }
+                    break;
+
+                case FlMessageId.RangeEvent:
+                    FlRangeResult result = FlRangeResult.FromEvent(evt);
+                    if (result != null)
+                    {
+                        SampleStore?.Append(FlSample.FromRangeResult(result));
+                        OnRangeResult?.Invoke(result);
+                    }
+                    break;
+
+                case FlMessageId.MeasurementEvent:
+                    FlMeasurement measurement = FlMeasurement.FromEvent(evt);
+                    if (measurement != null)
+                    {
+                        SampleStore?.Append(FlSample.FromMeasurement(measurement));
+                        OnMeasurement?.Invoke(measurement);
+                    }
+                    break;
+
+                case FlMessageId.ReadyEvent:
+                    if ((evt.Arguments?.Count == 3) &&
+                        (byte.TryParse((string)evt.Arguments[1], out byte sensorMask) == true) &&
+                        (uint.TryParse((string)evt.Arguments[2], out uint bootTime) == true))
+                    {
+                        Log.Information($"Device ready : sensors 0x{sensorMask:X}, boot {bootTime}ms");
+                        OnDeviceReady?.Invoke(sensorMask, bootTime);
+                    }
+                    break;
+            }
+        }
+
         private void ProcessAppTxtFwVerResponse(IFlMessage response)
         {
             if (response.Arguments?.Count == 3)
@@ -233,30 +1065,60 @@ namespace I2CWpfApp
             }
 
             _serialPort.Write(buf, 0, buf.Length);
-            Log.Information("Message sent");
+            TraceWriter?.Write(FlTraceDirection.Tx, buf, 0, buf.Length);
+            Log.Debug("Message sent");
         }
 
-        private bool WaitForResponse()
+        // The message thread signals the response, no polling delay.
+        private bool WaitForResponse(int waitCount = RESPONSE_WAIT_COUNT)
         {
-            int i = 0;
+            return WaitForResponse(null, waitCount);
+        }
+
+        // isResponse : false for a response of another command, the response is discarded and the wait goes on
+        // (in the same timeout).
+        private bool WaitForResponse(Func<IFlMessage, bool> isResponse, int waitCount = RESPONSE_WAIT_COUNT)
+        {
+            int timeout = waitCount * RESPONSE_WAIT_UNIT;
+            int startTick = Environment.TickCount;
+            int remain;
 
             while (true)
             {
-                if (ResponseReceived == true)
+                // A response of a previous command may have set the event, ResponseReceived is checked again.
+                while (ResponseReceived != true)
                 {
-                    Log.Information("Response received");
-                    return true;
+                    remain = timeout - (Environment.TickCount - startTick);
+                    if ((remain <= 0) || (_responseEvent.WaitOne(remain) != true))
+                    {
+                        if (ResponseReceived == true)
+                        {
+                            break;
+                        }
+
+                        Log.Information("No response");
+                        return false;
+                    }
                 }
-                Thread.Sleep(100);
-                i++;
-                if (i == 10)
+
+                IFlMessage response = _response;
+                if ((isResponse == null) || (isResponse(response) == true))
                 {
-                    Log.Information("No response");
                     break;
                 }
+
+                Log.Warning($"Unexpected response discarded : {response.MessageId}");
+                ResponseReceived = false;
+                // The next response arrived before ResponseReceived was cleared.
+                if (_response != response)
+                {
+                    ResponseReceived = true;
+                }
             }
 
-            return false;
+            Log.Debug("Response received");
+
+            return true;
         }
     }
 }
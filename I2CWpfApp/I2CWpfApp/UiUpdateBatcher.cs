@@ -0,0 +1,107 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading.Tasks;
+using System.Windows.Threading;
+
+namespace I2CWpfApp
+{
+    // Collects UI updates posted from any thread and applies them on the UI thread in one dispatcher call,
+    // at most maxFps times a second. An update posted with a key replaces the pending update of the key
+    // (e.g. the last value of a register), updates without a key are applied in the posted order after them.
+    // applied is called after each batch(e.g. one data grid refresh for all updated rows).
+    public sealed class UiUpdateBatcher
+    {
+        private readonly object _lock = new object();
+        private readonly Dispatcher _dispatcher;
+        private readonly long _intervalMs;
+        private readonly Action _applied;
+        private readonly Stopwatch _stopwatch = Stopwatch.StartNew();
+        private Dictionary<object, Action> _keyedUpdates = new Dictionary<object, Action>();
+        private List<object> _keys = new List<object>();
+        private List<Action> _updates = new List<Action>();
+        private bool _scheduled = false;
+        private long _lastApplyMs = long.MinValue / 2;
+
+        public UiUpdateBatcher(Dispatcher dispatcher, int maxFps, Action applied = null)
+        {
+            _dispatcher = dispatcher;
+            _intervalMs = 1000 / Math.Max(maxFps, 1);
+            _applied = applied;
+        }
+
+        public void Post(Action update)
+        {
+            lock (_lock)
+            {
+                _updates.Add(update);
+                Schedule();
+            }
+        }
+
+        public void Post(object key, Action update)
+        {
+            lock (_lock)
+            {
+                if (_keyedUpdates.ContainsKey(key) != true)
+                {
+                    _keys.Add(key);
+                }
+                _keyedUpdates[key] = update;
+                Schedule();
+            }
+        }
+
+        // Called in the lock.
+        private void Schedule()
+        {
+            if (_scheduled == true)
+            {
+                return;
+            }
+            _scheduled = true;
+
+            long delay = _lastApplyMs + _intervalMs - _stopwatch.ElapsedMilliseconds;
+            if (delay <= 0)
+            {
+                _dispatcher.BeginInvoke(new Action(Apply), DispatcherPriority.Background);
+            }
+            else
+            {
+                Task.Delay((int)delay).ContinueWith(_ => _dispatcher.BeginInvoke(new Action(Apply), DispatcherPriority.Background));
+            }
+        }
+
+        private void Apply()
+        {
+            Dictionary<object, Action> keyedUpdates;
+            List<object> keys;
+            List<Action> updates;
+
+            lock (_lock)
+            {
+                keyedUpdates = _keyedUpdates;
+                keys = _keys;
+                updates = _updates;
+
+                _keyedUpdates = new Dictionary<object, Action>();
+                _keys = new List<object>();
+                _updates = new List<Action>();
+                _scheduled = false;
+                _lastApplyMs = _stopwatch.ElapsedMilliseconds;
+            }
+
+            foreach (var key in keys)
+            {
+                keyedUpdates[key]();
+            }
+
+            foreach (var update in updates)
+            {
+                update();
+            }
+
+            _applied?.Invoke();
+        }
+    }
+}
@@ -0,0 +1,123 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text.Json;
+using RegisterCore.Net.Models;
+
+namespace RegisterCatalogGen
+{
+    public class ChipSource
+    {
+        public string Name { get; set; }
+        public string ChipType { get; set; }
+        public string Description { get; set; }
+    }
+
+    public class BitFieldSource
+    {
+        public string Name { get; set; }
+        public int Offset { get; set; }
+        public int Bits { get; set; }
+        public string Access { get; set; }
+        public string ResetValue { get; set; }
+        public string Description { get; set; }
+
+        public BitAccessType AccessType => Enum.Parse<BitAccessType>(Access);
+    }
+
+    public class RegisterSource
+    {
+        public string Name { get; set; }
+        public string Address { get; set; }     // Hex("0x2A3")
+        public int Bits { get; set; }
+        public string ResetValue { get; set; }
+        public string Description { get; set; }
+        public List<BitFieldSource> BitFields { get; set; } = new List<BitFieldSource>();
+
+        public UInt64 AddressValue { get; set; }
+    }
+
+    // Register catalog source file(JSON) : a chip and its registers.
+    public class CatalogSource
+    {
+        public ChipSource Chip { get; set; }
+        public List<RegisterSource> Registers { get; set; } = new List<RegisterSource>();
+
+        // Registers are sorted by address, bit fields by offset.
+        public static CatalogSource Load(string path)
+        {
+            JsonSerializerOptions options = new JsonSerializerOptions()
+            {
+                PropertyNameCaseInsensitive = true,
+                ReadCommentHandling = JsonCommentHandling.Skip
+            };
+            CatalogSource catalog = JsonSerializer.Deserialize<CatalogSource>(File.ReadAllText(path), options);
+
+            if (string.IsNullOrEmpty(catalog?.Chip?.Name))
+            {
+                throw new InvalidDataException($"{path} : no chip name");
+            }
+
+            foreach (var reg in catalog.Registers)
+            {
+                reg.AddressValue = ParseAddress(reg);
+                reg.BitFields = reg.BitFields.OrderBy(bf => bf.Offset).ToList();
+                Validate(reg);
+            }
+            catalog.Registers = catalog.Registers.OrderBy(r => r.AddressValue).ToList();
+
+            for (int i = 1; i < catalog.Registers.Count; i++)
+            {
+                if (catalog.Registers[i].AddressValue == catalog.Registers[i - 1].AddressValue)
+                {
+                    throw new InvalidDataException($"{catalog.Registers[i].Name} : address {catalog.Registers[i].Address} is used by {catalog.Registers[i - 1].Name}");
+                }
+            }
+
+            return catalog;
+        }
+
+        private static UInt64 ParseAddress(RegisterSource reg)
+        {
+            string text = reg.Address ?? "";
+
+            if (text.StartsWith("0x", StringComparison.OrdinalIgnoreCase))
+            {
+                text = text.Substring(2);
+            }
+
+            if (!UInt64.TryParse(text, NumberStyles.HexNumber, null, out UInt64 address))
+            {
+                throw new InvalidDataException($"{reg.Name} : invalid address {reg.Address}");
+            }
+
+            return address;
+        }
+
+        private static void Validate(RegisterSource reg)
+        {
+            int end = 0;
+
+            if ((reg.Bits <= 0) || (reg.Bits > 64))
+            {
+                throw new InvalidDataException($"{reg.Name} : invalid register bits {reg.Bits}");
+            }
+
+            foreach (var bf in reg.BitFields)
+            {
+                if (!Enum.TryParse<BitAccessType>(bf.Access, out _))
+                {
+                    throw new InvalidDataException($"{reg.Name}.{bf.Name} : unknown access type {bf.Access}");
+                }
+
+                if ((bf.Bits <= 0) || (bf.Offset < end) || ((bf.Offset + bf.Bits) > reg.Bits))
+                {
+                    throw new InvalidDataException($"{reg.Name}.{bf.Name} : invalid bit range {bf.Offset}, {bf.Bits}");
+                }
+                end = bf.Offset + bf.Bits;
+            }
+        }
+    }
+}
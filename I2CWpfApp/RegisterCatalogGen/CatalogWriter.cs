@@ -0,0 +1,196 @@
+﻿using System;
+using System.Text;
+
+namespace RegisterCatalogGen
+{
+    // Writes the static tables of a register catalog : C# for RegisterCore.Net and
+    // the register size X-macro file of the firmware.
+    public static class CatalogWriter
+    {
+        // Class name from the chip name("VL6180x" : "Vl6180xCatalog").
+        public static string GetClassName(CatalogSource catalog)
+        {
+            string name = catalog.Chip.Name;
+
+            return char.ToUpperInvariant(name[0]) + name.Substring(1).ToLowerInvariant() + "Catalog";
+        }
+
+        // Macro name from the chip name("VL6180x" : "FL_VL6180X_REG").
+        public static string GetMacroName(CatalogSource catalog)
+        {
+            return $"FL_{catalog.Chip.Name.ToUpperInvariant()}_REG";
+        }
+
+        public static string WriteCSharp(CatalogSource catalog, string sourceName, string nameSpace)
+        {
+            StringBuilder sb = new StringBuilder();
+            string className = GetClassName(catalog);
+            int bitFieldIndex = 0;
+
+            sb.Append("// <auto-generated>\n");
+            sb.Append($"// Generated by RegisterCatalogGen from {sourceName}, do not edit.\n");
+            sb.Append("// </auto-generated>\n");
+            sb.Append("using System;\n");
+            sb.Append("using RegisterCore.Net.Models;\n");
+            sb.Append("\n");
+            sb.Append($"namespace {nameSpace}\n");
+            sb.Append("{\n");
+            sb.Append($"    // {catalog.Chip.Name} register catalog.\n");
+            sb.Append($"    public static class {className}\n");
+            sb.Append("    {\n");
+            sb.Append($"        public const string ChipName = {Quote(catalog.Chip.Name)};\n");
+            sb.Append("\n");
+            sb.Append("        // Address order, bit fields of a register are _bitFields[bitField .. bitField + bitFieldCount - 1].\n");
+            sb.Append("        private static readonly (UInt64 address, int bits, string resetValue, string name, string description, int bitField, int bitFieldCount)[] _registers =\n");
+            sb.Append("        {\n");
+            foreach (var reg in catalog.Registers)
+            {
+                sb.Append($"            (0x{reg.AddressValue:X3}, {reg.Bits}, {Quote(reg.ResetValue)}, {Quote(reg.Name)}, {Quote(reg.Description)}, {bitFieldIndex}, {reg.BitFields.Count}),\n");
+                bitFieldIndex += reg.BitFields.Count;
+            }
+            sb.Append("        };\n");
+            sb.Append("\n");
+            sb.Append("        private static readonly (string name, int offset, int bits, BitAccessType access, string resetValue, string description)[] _bitFields =\n");
+            sb.Append("        {\n");
+            foreach (var reg in catalog.Registers)
+            {
+                foreach (var bf in reg.BitFields)
+                {
+                    sb.Append($"            ({Quote(bf.Name)}, {bf.Offset}, {bf.Bits}, BitAccessType.{bf.AccessType}, {Quote(bf.ResetValue)}, {Quote(bf.Description)}),\n");
+                }
+            }
+            sb.Append("        };\n");
+            sb.Append("\n");
+            sb.Append("        private static readonly Lazy<RegisterCatalog> _catalog = new Lazy<RegisterCatalog>(Create);\n");
+            sb.Append("\n");
+            sb.Append("        public static RegisterCatalog Catalog => _catalog.Value;\n");
+            sb.Append("\n");
+            sb.Append("        // Template IDs are the table indexes + 1.\n");
+            sb.Append("        private static RegisterCatalog Create()\n");
+            sb.Append("        {\n");
+            sb.Append("            Chip chip = new Chip()\n");
+            sb.Append("            {\n");
+            sb.Append("                Id = 1,\n");
+            sb.Append("                Name = ChipName,\n");
+            sb.Append($"                ChipType = {Quote(catalog.Chip.ChipType)},\n");
+            sb.Append($"                Description = {Quote(catalog.Chip.Description)}\n");
+            sb.Append("            };\n");
+            sb.Append("\n");
+            sb.Append("            for (int i = 0; i < _registers.Length; i++)\n");
+            sb.Append("            {\n");
+            sb.Append("                var r = _registers[i];\n");
+            sb.Append("                RegisterTemplate reg = new RegisterTemplate()\n");
+            sb.Append("                {\n");
+            sb.Append("                    Id = i + 1,\n");
+            sb.Append("                    Name = r.name,\n");
+            sb.Append("                    Address = r.address,\n");
+            sb.Append("                    Bits = r.bits,\n");
+            sb.Append("                    ResetValue = r.resetValue,\n");
+            sb.Append("                    Description = r.description,\n");
+            sb.Append("                    ChipId = chip.Id\n");
+            sb.Append("                };\n");
+            sb.Append("\n");
+            sb.Append("                for (int j = r.bitField; j < (r.bitField + r.bitFieldCount); j++)\n");
+            sb.Append("                {\n");
+            sb.Append("                    var bf = _bitFields[j];\n");
+            sb.Append("                    reg.BitFields.Add(new BitFieldTemplate()\n");
+            sb.Append("                    {\n");
+            sb.Append("                        Id = j + 1,\n");
+            sb.Append("                        Name = bf.name,\n");
+            sb.Append("                        Offset = bf.offset,\n");
+            sb.Append("                        Bits = bf.bits,\n");
+            sb.Append("                        AccessType = bf.access,\n");
+            sb.Append("                        ResetValue = bf.resetValue,\n");
+            sb.Append("                        Description = bf.description,\n");
+            sb.Append("                        RegisterTemplateId = reg.Id\n");
+            sb.Append("                    });\n");
+            sb.Append("                }\n");
+            sb.Append("\n");
+            sb.Append("                chip.Registers.Add(reg);\n");
+            sb.Append("            }\n");
+            sb.Append("\n");
+            sb.Append("            return new RegisterCatalog(chip, chip.Registers);\n");
+            sb.Append("        }\n");
+            sb.Append("    }\n");
+            sb.Append("}\n");
+
+            return sb.ToString();
+        }
+
+        public static string WriteC(CatalogSource catalog, string sourceName, string fileName)
+        {
+            StringBuilder sb = new StringBuilder();
+            string macro = GetMacroName(catalog);
+            int nameWidth = 0;
+
+            foreach (var reg in catalog.Registers)
+            {
+                nameWidth = Math.Max(nameWidth, $"{macro}(0x{reg.AddressValue:X4}, {GetSize(reg)})".Length);
+            }
+
+            sb.Append($"// Firmware library {catalog.Chip.Name.ToUpperInvariant()} register sizes\n");
+            sb.Append($"// {fileName}\n");
+            sb.Append("//\n");
+            sb.Append($"// Generated by RegisterCatalogGen from {sourceName}, do not edit.\n");
+            sb.Append($"// {macro}(register address, size(bytes)) in address order(no include guard).\n");
+            sb.Append("\n");
+            foreach (var reg in catalog.Registers)
+            {
+                string entry = $"{macro}(0x{reg.AddressValue:X4}, {GetSize(reg)})";
+
+                sb.Append($"{entry.PadRight(nameWidth)}  // {reg.Name}\n");
+            }
+
+            return sb.ToString();
+        }
+
+        private static int GetSize(RegisterSource reg)
+        {
+            return (reg.Bits + 7) / 8;
+        }
+
+        private static string Quote(string text)
+        {
+            if (text == null)
+            {
+                return "null";
+            }
+
+            StringBuilder sb = new StringBuilder("\"");
+
+            foreach (char c in text)
+            {
+                switch (c)
+                {
+                    case '\\':
+                        sb.Append("\\\\");
+                        break;
+                    case '"':
+                        sb.Append("\\\"");
+                        break;
+                    case '\n':
+                        sb.Append("\\n");
+                        break;
+                    case '\r':
+                        break;
+                    case '\t':
+                        sb.Append("\\t");
+                        break;
+                    default:
+                        if (c < ' ')
+                        {
+                            sb.Append($"\\u{(int)c:X4}");
+                        }
+                        else
+                        {
+                            sb.Append(c);
+                        }
+                        break;
+                }
+            }
+            sb.Append('"');
+
+            return sb.ToString();
+        }
+    }
+}
@@ -0,0 +1,76 @@
+﻿using System;
+using System.IO;
+using System.Text;
+using System.Text.Json;
+
+namespace RegisterCatalogGen
+{
+    // Generates the static register tables of a register catalog(JSON).
+    // RegisterCatalogGen <catalog.json> [-cs <C# file>] [-c <C file>] [-namespace ns]
+    //   VL6180x(from I2CWpfApp) :
+    //   RegisterCatalogGen RegisterCore.Net/Catalogs/vl6180x.json -cs RegisterCore.Net/Catalogs/Vl6180xCatalog.g.cs
+    //                      -c ../F722ZE_I2C/Inc/fl_vl6180x_reg_def.h
+    class Program
+    {
+        private const string DEFAULT_NAMESPACE = "RegisterCore.Net.Catalogs";
+
+        static int Main(string[] args)
+        {
+            string csFile = null;
+            string cFile = null;
+            string nameSpace = DEFAULT_NAMESPACE;
+
+            if (args.Length < 1)
+            {
+                Console.Error.WriteLine("Usage : RegisterCatalogGen <catalog.json> [-cs <C# file>] [-c <C file>] [-namespace ns]");
+                return 1;
+            }
+
+            for (int i = 1; i < args.Length; i++)
+            {
+                if (((i + 1) < args.Length) && (args[i] == "-cs"))
+                {
+                    csFile = args[++i];
+                }
+                else if (((i + 1) < args.Length) && (args[i] == "-c"))
+                {
+                    cFile = args[++i];
+                }
+                else if (((i + 1) < args.Length) && (args[i] == "-namespace"))
+                {
+                    nameSpace = args[++i];
+                }
+                else
+                {
+                    Console.Error.WriteLine($"Unknown option : {args[i]}");
+                    return 1;
+                }
+            }
+
+            try
+            {
+                CatalogSource catalog = CatalogSource.Load(args[0]);
+                string sourceName = Path.GetFileName(args[0]);
+
+                if (csFile != null)
+                {
+                    File.WriteAllText(csFile, CatalogWriter.WriteCSharp(catalog, sourceName, nameSpace), new UTF8Encoding(true));
+                    Console.WriteLine($"{csFile} : {catalog.Registers.Count} registers");
+                }
+
+                if (cFile != null)
+                {
+                    File.WriteAllText(cFile, CatalogWriter.WriteC(catalog, sourceName, Path.GetFileName(cFile)));
+                    Console.WriteLine($"{cFile} : {catalog.Registers.Count} registers");
+                }
+            }
+            catch (Exception e) when ((e is IOException) || (e is JsonException))
+            {
+                Console.Error.WriteLine(e.Message);
+                return 1;
+            }
+
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,14 @@
+﻿using BenchmarkDotNet.Running;
+
+namespace RegisterCore.Net.Benchmarks
+{
+    // Release build only :
+    //   dotnet run -c Release --project RegisterCore.Net.Benchmarks [-- --filter *RegisterLayout*]
+    class Program
+    {
+        static void Main(string[] args)
+        {
+            BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args);
+        }
+    }
+}
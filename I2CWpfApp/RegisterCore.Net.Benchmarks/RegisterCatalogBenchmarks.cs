@@ -0,0 +1,126 @@
+﻿using BenchmarkDotNet.Attributes;
+using RegisterCore.Net.Catalogs;
+using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Linq;
+
+namespace RegisterCore.Net.Benchmarks
+{
+    // Register values of a dump built into Register/BitField values(the register value windows).
+    // The templates are held as the two flat tables of the database(register and bit field templates) :
+    // the lookup of both per line as the windows did, and the catalog loaded once from the tables then
+    // reused(CreateRegisters()). The SQLite round trips of the per line queries are not included.
+    [MemoryDiagnoser]
+    public class RegisterCatalogBenchmarks
+    {
+        private Chip _chip;
+        private RegisterTemplate[] _registerTemplates;
+        private BitFieldTemplate[] _bitFieldTemplates;
+        private RegisterCatalog _catalog;
+        private RegisterValue[] _values;
+
+        // A dump of the sensor and a long register value file.
+        [Params(300, 100_000)]
+        public int LineCount { get; set; }
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            Random random = new Random(1);
+            RegisterCatalog catalog = Vl6180xCatalog.Catalog;
+
+            _chip = catalog.Chip;
+            _registerTemplates = catalog.Registers.Select(r => new RegisterTemplate()
+            {
+                Id = r.Id,
+                Name = r.Name,
+                Address = r.Address,
+                Bits = r.Bits,
+                ResetValue = r.ResetValue,
+                Description = r.Description,
+                ChipId = r.ChipId
+            }).ToArray();
+            _bitFieldTemplates = catalog.Registers.SelectMany(r => r.BitFields).OrderBy(bf => bf.Id).ToArray();
+            _catalog = LoadCatalog();
+
+            // Every 16th address is not in the catalog(skipped).
+            _values = new RegisterValue[LineCount];
+            for (int i = 0; i < _values.Length; i++)
+            {
+                UInt64 address = ((i % 16) == 15) ? 0xFFFF : catalog.Registers[i % catalog.Registers.Count].Address;
+
+                _values[i] = new RegisterValue(address, (UInt64)random.Next(0x100));
+            }
+        }
+
+        // The chip's registers with their bit fields in one pass over the tables.
+        private RegisterCatalog LoadCatalog()
+        {
+            ILookup<Int64, BitFieldTemplate> bitFields = _bitFieldTemplates.ToLookup(bf => bf.RegisterTemplateId);
+            List<RegisterTemplate> registers = new List<RegisterTemplate>(_registerTemplates.Length);
+
+            foreach (var template in _registerTemplates)
+            {
+                RegisterTemplate reg = new RegisterTemplate()
+                {
+                    Id = template.Id,
+                    Name = template.Name,
+                    Address = template.Address,
+                    Bits = template.Bits,
+                    ResetValue = template.ResetValue,
+                    Description = template.Description,
+                    ChipId = template.ChipId,
+                    BitFields = new ObservableCollection<BitFieldTemplate>(bitFields[template.Id])
+                };
+                registers.Add(reg);
+            }
+
+            return new RegisterCatalog(_chip, registers);
+        }
+
+        [Benchmark(Baseline = true)]
+        public int PerLineLookup()
+        {
+            List<Register> registers = new List<Register>();
+
+            foreach (var item in _values)
+            {
+                var template = _registerTemplates.Where(r => r.Address == item.Address).FirstOrDefault();
+
+                if (template != null)
+                {
+                    var bitFields = _bitFieldTemplates.Where(bf => bf.RegisterTemplateId == template.Id).OrderBy(bf => bf.Offset).ToList();
+                    Register reg = new Register(template);
+
+                    reg.Value = item.Value;
+                    foreach (var bf in bitFields)
+                    {
+                        BitField b = new BitField(bf);
+
+                        b.Value = GeneralUtil.GetBitFieldValue(item.Value, bf);
+                        reg.BitFields.Add(b);
+                    }
+                    registers.Add(reg);
+                }
+            }
+
+            return registers.Count;
+        }
+
+        // First window open : the catalog is loaded.
+        [Benchmark]
+        public int LoadCatalogCreateRegisters()
+        {
+            return LoadCatalog().CreateRegisters(_values).Count;
+        }
+
+        // Shared catalog.
+        [Benchmark]
+        public int CreateRegisters()
+        {
+            return _catalog.CreateRegisters(_values).Count;
+        }
+    }
+}
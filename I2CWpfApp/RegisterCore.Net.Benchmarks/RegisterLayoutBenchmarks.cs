@@ -0,0 +1,84 @@
+﻿using BenchmarkDotNet.Attributes;
+using RegisterCore.Net.Catalogs;
+using RegisterCore.Net.Models;
+using System;
+
+namespace RegisterCore.Net.Benchmarks
+{
+    // A full VL6180x register snapshot(61 registers, 109 bit fields) decoded and encoded
+    // per field(GeneralUtil) and with the precomputed layout(RegisterLayout).
+    [MemoryDiagnoser]
+    public class RegisterLayoutBenchmarks
+    {
+        private RegisterCatalog _catalog;
+        private UInt64[] _values;
+        private UInt64[] _fields;
+        private BitField[][] _bitFields;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            Random random = new Random(1);
+
+            _catalog = Vl6180xCatalog.Catalog;
+            _values = new UInt64[_catalog.Layout.RegisterCount];
+            _fields = new UInt64[_catalog.Layout.FieldCount];
+            _bitFields = new BitField[_values.Length][];
+
+            for (int i = 0; i < _values.Length; i++)
+            {
+                _values[i] = (UInt64)random.Next() & GeneralUtil.GetMaxValueOfBits(_catalog.Registers[i].Bits);
+
+                Register reg = _catalog.CreateRegister(_catalog.Registers[i].Address, _values[i]);
+                _bitFields[i] = new BitField[reg.BitFields.Count];
+                reg.BitFields.CopyTo(_bitFields[i], 0);
+            }
+            _catalog.Layout.Decode(_values, _fields);
+        }
+
+        [Benchmark(Baseline = true)]
+        public UInt64 DecodeGeneralUtil()
+        {
+            UInt64 sum = 0;
+
+            for (int i = 0; i < _values.Length; i++)
+            {
+                foreach (var bf in _catalog.Registers[i].BitFields)
+                {
+                    sum += GeneralUtil.GetBitFieldValue(_values[i], bf);
+                }
+            }
+
+            return sum;
+        }
+
+        [Benchmark]
+        public UInt64 DecodeLayout()
+        {
+            _catalog.Layout.Decode(_values, _fields);
+
+            return _fields[_fields.Length - 1];
+        }
+
+        [Benchmark]
+        public UInt64 EncodeGeneralUtil()
+        {
+            UInt64 sum = 0;
+
+            for (int i = 0; i < _bitFields.Length; i++)
+            {
+                sum += GeneralUtil.GetRegisterValueFromBitFields(_bitFields[i]);
+            }
+
+            return sum;
+        }
+
+        [Benchmark]
+        public UInt64 EncodeLayout()
+        {
+            _catalog.Layout.Encode(_fields, _values);
+
+            return _values[_values.Length - 1];
+        }
+    }
+}
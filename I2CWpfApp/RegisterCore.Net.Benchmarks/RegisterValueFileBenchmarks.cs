@@ -0,0 +1,147 @@
+﻿using BenchmarkDotNet.Attributes;
+using RegisterCore.Net.IO;
+using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+
+namespace RegisterCore.Net.Benchmarks
+{
+    // Register value files of 5M lines(about 66MB, in the page cache after the first run) :
+    // the StreamReader.ReadLine/string.Split reader and StreamWriter writer replaced by RegisterCore.Net.IO,
+    // the streaming text reader/writer and the binary snapshot of the same values.
+    [MemoryDiagnoser]
+    public class RegisterValueFileBenchmarks
+    {
+        private const int LINE_COUNT = 5_000_000;
+
+        private RegisterValue[] _values;
+        private string _csvFile;
+        private string _snapshotFile;
+        private string _outFile;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            Random random = new Random(1);
+
+            _values = new RegisterValue[LINE_COUNT];
+            for (int i = 0; i < _values.Length; i++)
+            {
+                _values[i] = new RegisterValue((UInt64)(i & 0xFFF), (UInt64)random.Next(0x100));
+            }
+
+            _csvFile = Path.GetTempFileName();
+            _snapshotFile = Path.GetTempFileName();
+            _outFile = Path.GetTempFileName();
+
+            using (var writer = new RegisterValueCsvWriter(new FileStream(_csvFile, FileMode.Create)))
+            {
+                foreach (var item in _values)
+                {
+                    writer.Write(item.Address, item.Value, 8);
+                }
+            }
+
+            using (var writer = new RegisterSnapshotWriter(new FileStream(_snapshotFile, FileMode.Create)))
+            {
+                writer.Write(1, DateTime.UtcNow, _values);
+            }
+        }
+
+        [GlobalCleanup]
+        public void Cleanup()
+        {
+            File.Delete(_csvFile);
+            File.Delete(_snapshotFile);
+            File.Delete(_outFile);
+        }
+
+        [Benchmark(Baseline = true)]
+        public int ReadCsvStreamReader()
+        {
+            string line;
+            char[] seperator = new char[] { ',' };
+            List<(ulong address, uint value)> regValues = new List<(ulong address, uint value)>();
+
+            using (StreamReader sr = new StreamReader(_csvFile))
+            {
+                while ((line = sr.ReadLine()) != null)
+                {
+                    string[] args = line.Split(seperator);
+                    if ((args.Length == 2) &&
+                        (ulong.TryParse(args[0], NumberStyles.HexNumber, null, out ulong addr) == true) &&
+                        (uint.TryParse(args[1], NumberStyles.HexNumber, null, out uint val) == true))
+                    {
+                        regValues.Add((addr, val));
+                    }
+                }
+            }
+
+            return regValues.Count;
+        }
+
+        [Benchmark]
+        public int ReadCsv()
+        {
+            int count = 0;
+
+            using (var reader = new RegisterValueCsvReader(new FileStream(_csvFile, FileMode.Open, FileAccess.Read, FileShare.Read, 1, FileOptions.SequentialScan)))
+            {
+                while (reader.TryRead(out RegisterValue value))
+                {
+                    count++;
+                }
+            }
+
+            return count;
+        }
+
+        [Benchmark]
+        public int ReadSnapshot()
+        {
+            List<RegisterValue> values = new List<RegisterValue>();
+
+            using (var reader = new RegisterSnapshotReader(new FileStream(_snapshotFile, FileMode.Open, FileAccess.Read)))
+            {
+                reader.Read(values);
+            }
+
+            return values.Count;
+        }
+
+        [Benchmark]
+        public void WriteCsvStreamWriter()
+        {
+            using (StreamWriter sw = new StreamWriter(_outFile))
+            {
+                foreach (var item in _values)
+                {
+                    sw.WriteLine($"{item.Address:X8},{item.Value:X2}");
+                }
+            }
+        }
+
+        [Benchmark]
+        public void WriteCsv()
+        {
+            using (var writer = new RegisterValueCsvWriter(new FileStream(_outFile, FileMode.Create)))
+            {
+                foreach (var item in _values)
+                {
+                    writer.Write(item.Address, item.Value, 8);
+                }
+            }
+        }
+
+        [Benchmark]
+        public void WriteSnapshot()
+        {
+            using (var writer = new RegisterSnapshotWriter(new FileStream(_outFile, FileMode.Create)))
+            {
+                writer.Write(1, DateTime.UtcNow, _values);
+            }
+        }
+    }
+}
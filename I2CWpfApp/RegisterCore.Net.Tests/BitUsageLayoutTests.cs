@@ -0,0 +1,166 @@
+﻿using RegisterCore.Net.Catalogs;
+using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Xunit;
+
+namespace RegisterCore.Net.Tests
+{
+    // Bit usage grid of UcRegisterBitUsage : the most significant bit first, rows of 8 or 16 bits.
+    public class BitUsageLayoutTests
+    {
+        private static List<BitFieldTemplate> CreateBitFields(params (int offset, int bits)[] bitFields)
+        {
+            return bitFields.Select(bf => new BitFieldTemplate() { Name = $"BF{bf.offset}", Offset = bf.offset, Bits = bf.bits }).ToList();
+        }
+
+        private static BitUsageSegment Segment(int field, int row, int column, int columnSpan, int highBit, int lowBit)
+        {
+            return new BitUsageSegment()
+            {
+                Field = field,
+                Row = row,
+                Column = column,
+                ColumnSpan = columnSpan,
+                HighBit = highBit,
+                LowBit = lowBit
+            };
+        }
+
+        [Theory]
+        [InlineData(0, 1, 8, 1)]
+        [InlineData(5, 5, 8, 1)]
+        [InlineData(8, 8, 8, 1)]
+        [InlineData(12, 12, 8, 2)]
+        [InlineData(16, 16, 16, 1)]
+        [InlineData(24, 24, 16, 2)]
+        [InlineData(32, 32, 16, 2)]
+        [InlineData(40, 40, 16, 3)]
+        public void GridSize(int bits, int layoutBits, int columnCount, int rowCount)
+        {
+            BitUsageLayout layout = new BitUsageLayout(bits, new List<BitFieldTemplate>());
+
+            Assert.Equal(layoutBits, layout.Bits);
+            Assert.Equal(columnCount, layout.ColumnCount);
+            Assert.Equal(rowCount, layout.RowCount);
+            Assert.Empty(layout.Segments);
+        }
+
+        // Every bit has its own cell, bit Bits - 1 first and bit 0 last.
+        [Theory]
+        [InlineData(5)]
+        [InlineData(8)]
+        [InlineData(12)]
+        [InlineData(16)]
+        [InlineData(20)]
+        [InlineData(32)]
+        public void BitCells(int bits)
+        {
+            BitUsageLayout layout = new BitUsageLayout(bits, new List<BitFieldTemplate>());
+
+            for (int bit = 0; bit < bits; bit++)
+            {
+                int cell = bits - 1 - bit;
+
+                Assert.Equal(cell / layout.ColumnCount, layout.GetRow(bit));
+                Assert.Equal(cell % layout.ColumnCount, layout.GetColumn(bit));
+                Assert.InRange(layout.GetRow(bit), 0, layout.RowCount - 1);
+            }
+        }
+
+        [Fact]
+        public void UpperHalfFieldsInFirstRow()
+        {
+            BitUsageLayout layout = new BitUsageLayout(32, CreateBitFields((16, 16), (0, 16), (28, 4), (20, 1)));
+
+            Assert.Equal(new BitUsageSegment[]
+            {
+                Segment(0, 0, 0, 16, 31, 16),
+                Segment(1, 1, 0, 16, 15, 0),
+                Segment(2, 0, 0, 4, 31, 28),
+                Segment(3, 0, 11, 1, 20, 20)
+            }, layout.Segments);
+        }
+
+        [Fact]
+        public void FieldCrossingRows()
+        {
+            BitUsageLayout layout = new BitUsageLayout(32, CreateBitFields((12, 8), (0, 32)));
+
+            Assert.Equal(new BitUsageSegment[]
+            {
+                Segment(0, 0, 12, 4, 19, 16),
+                Segment(0, 1, 0, 4, 15, 12),
+                Segment(1, 0, 0, 16, 31, 16),
+                Segment(1, 1, 0, 16, 15, 0)
+            }, layout.Segments);
+        }
+
+        [Fact]
+        public void WidthNotMultipleOf8()
+        {
+            BitUsageLayout layout = new BitUsageLayout(12, CreateBitFields((0, 12), (10, 2), (2, 3)));
+
+            Assert.Equal(new BitUsageSegment[]
+            {
+                Segment(0, 0, 0, 8, 11, 4),
+                Segment(0, 1, 0, 4, 3, 0),
+                Segment(1, 0, 0, 2, 11, 10),
+                Segment(2, 0, 7, 1, 4, 4),
+                Segment(2, 1, 0, 2, 3, 2)
+            }, layout.Segments);
+
+            layout = new BitUsageLayout(5, CreateBitFields((0, 5), (4, 1)));
+
+            Assert.Equal(new BitUsageSegment[]
+            {
+                Segment(0, 0, 0, 5, 4, 0),
+                Segment(1, 0, 0, 1, 4, 4)
+            }, layout.Segments);
+        }
+
+        // Bits out of the register are not shown, a field with no bit in the register has no segment.
+        [Fact]
+        public void FieldsClippedToRegister()
+        {
+            BitUsageLayout layout = new BitUsageLayout(8, CreateBitFields((6, 4), (-2, 3), (8, 2), (3, 0)));
+
+            Assert.Equal(new BitUsageSegment[]
+            {
+                Segment(0, 0, 0, 2, 7, 6),
+                Segment(1, 0, 7, 1, 0, 0)
+            }, layout.Segments);
+        }
+
+        // The segments of every VL6180x register cover the cells of their field bits once, in the bit order.
+        [Fact]
+        public void CatalogSegmentsMatchBitCells()
+        {
+            foreach (var reg in Vl6180xCatalog.Catalog.Registers)
+            {
+                BitUsageLayout layout = new BitUsageLayout(reg.Bits, reg.BitFields);
+
+                for (int i = 0; i < reg.BitFields.Count; i++)
+                {
+                    BitFieldTemplate bf = reg.BitFields[i];
+                    List<BitUsageSegment> segments = layout.Segments.Where(s => s.Field == i).ToList();
+                    int bit = bf.Offset + bf.Bits - 1;
+
+                    Assert.Equal(bf.Bits, segments.Sum(s => s.ColumnSpan));
+                    foreach (var segment in segments)
+                    {
+                        Assert.Equal(segment.HighBit - segment.LowBit + 1, segment.ColumnSpan);
+                        Assert.InRange(segment.Column + segment.ColumnSpan, 1, layout.ColumnCount);
+                        for (int column = segment.Column; column < (segment.Column + segment.ColumnSpan); column++, bit--)
+                        {
+                            Assert.Equal(segment.Row, layout.GetRow(bit));
+                            Assert.Equal(column, layout.GetColumn(bit));
+                        }
+                    }
+                    Assert.Equal(bf.Offset - 1, bit);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,181 @@
+﻿using RegisterCore.Net.Catalogs;
+using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+using Xunit;
+
+namespace RegisterCore.Net.Tests
+{
+    // Burst grouping of RegisterBurstPlan and the big endian decode of the bytes read.
+    public class RegisterBurstPlanTests
+    {
+        internal static RegisterCatalog CreateCatalog(params (UInt64 address, int bits)[] registers)
+        {
+            List<RegisterTemplate> templates = new List<RegisterTemplate>();
+
+            foreach (var (address, bits) in registers)
+            {
+                templates.Add(new RegisterTemplate() { Name = $"R{address:X}", Address = address, Bits = bits });
+            }
+
+            return new RegisterCatalog(new Chip() { Name = "TEST" }, templates);
+        }
+
+        // count registers of bits each from address 0, no gap.
+        private static RegisterCatalog CreateContiguous(int count, int bits)
+        {
+            var registers = new (UInt64 address, int bits)[count];
+            int length = RegisterBurstPlan.GetByteCount(new RegisterTemplate() { Bits = bits });
+
+            for (int i = 0; i < count; i++)
+            {
+                registers[i] = ((UInt64)(i * length), bits);
+            }
+
+            return CreateCatalog(registers);
+        }
+
+        private static void AssertBurst(RegisterBurst burst, UInt64 address, int length, int first, int count)
+        {
+            Assert.Equal(address, burst.Address);
+            Assert.Equal(length, burst.Length);
+            Assert.Equal(first, burst.First);
+            Assert.Equal(count, burst.Count);
+        }
+
+        [Fact]
+        public void GroupsContiguousRegisters()
+        {
+            // 0x00 ~ 0x03 : 8, 16(12 bits), 8 bits. 0x05 : 32 bits after a gap. 0x09 : 0 bits(1 byte).
+            RegisterCatalog catalog = CreateCatalog((0x05, 32), (0x00, 8), (0x01, 12), (0x03, 8), (0x09, 0));
+            RegisterBurstPlan plan = new RegisterBurstPlan(catalog, 64);
+
+            Assert.Equal(2, plan.Bursts.Count);
+            AssertBurst(plan.Bursts[0], 0x00, 4, 0, 3);
+            AssertBurst(plan.Bursts[1], 0x05, 5, 3, 2);
+        }
+
+        // Bursts of maxLength bytes at most, a register is never split between two bursts.
+        [Theory]
+        [InlineData(64, 8, 64, new[] { 64 })]
+        [InlineData(65, 8, 64, new[] { 64, 1 })]
+        [InlineData(130, 8, 64, new[] { 64, 64, 2 })]
+        [InlineData(40, 16, 64, new[] { 64, 16 })]
+        [InlineData(22, 24, 64, new[] { 63, 3 })]
+        [InlineData(9, 64, 64, new[] { 64, 8 })]
+        [InlineData(10, 8, 1, new[] { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 })]
+        public void SplitsAtMaxLength(int count, int bits, int maxLength, int[] lengths)
+        {
+            RegisterBurstPlan plan = new RegisterBurstPlan(CreateContiguous(count, bits), maxLength);
+            int first = 0;
+            UInt64 address = 0;
+
+            Assert.Equal(lengths.Length, plan.Bursts.Count);
+            for (int i = 0; i < lengths.Length; i++)
+            {
+                int registers = lengths[i] / ((bits + 7) / 8);
+
+                AssertBurst(plan.Bursts[i], address, lengths[i], first, registers);
+                first += registers;
+                address += (UInt64)lengths[i];
+            }
+            Assert.Equal(count, first);
+        }
+
+        // 63 bytes of 1-byte registers then a 2-byte register : the 2-byte register starts the next burst.
+        [Fact]
+        public void RegisterAcrossTheLimitStartsNextBurst()
+        {
+            var registers = new List<(UInt64 address, int bits)>();
+
+            for (int i = 0; i < 63; i++)
+            {
+                registers.Add(((UInt64)i, 8));
+            }
+            registers.Add((63, 16));
+            registers.Add((65, 8));
+
+            RegisterBurstPlan plan = new RegisterBurstPlan(CreateCatalog(registers.ToArray()), 64);
+
+            Assert.Equal(2, plan.Bursts.Count);
+            AssertBurst(plan.Bursts[0], 0, 63, 0, 63);
+            AssertBurst(plan.Bursts[1], 63, 3, 63, 2);
+        }
+
+        [Fact]
+        public void RegisterLongerThanBurstThrows()
+        {
+            Assert.Throws<ArgumentException>(() => new RegisterBurstPlan(CreateCatalog((0x00, 8), (0x01, 64)), 4));
+        }
+
+        // Each register of the catalog in exactly one burst, in register order.
+        [Fact]
+        public void Vl6180xCatalogCovered()
+        {
+            RegisterCatalog catalog = Vl6180xCatalog.Catalog;
+            RegisterBurstPlan plan = new RegisterBurstPlan(catalog, 64);
+            int next = 0;
+
+            foreach (var burst in plan.Bursts)
+            {
+                int length = 0;
+
+                Assert.Equal(next, burst.First);
+                Assert.Equal(catalog.Registers[burst.First].Address, burst.Address);
+                for (int i = burst.First; i < burst.First + burst.Count; i++)
+                {
+                    Assert.Equal(burst.Address + (UInt64)length, catalog.Registers[i].Address);
+                    length += RegisterBurstPlan.GetByteCount(catalog.Registers[i]);
+                }
+                Assert.Equal(burst.Length, length);
+                Assert.True(burst.Length <= 64);
+                next += burst.Count;
+            }
+            Assert.Equal(catalog.Registers.Count, next);
+        }
+
+        // Most significant byte first, at the byte address of the register.
+        [Fact]
+        public void DecodeBigEndian()
+        {
+            RegisterCatalog catalog = CreateCatalog((0x10, 8), (0x11, 16), (0x13, 12), (0x15, 32), (0x19, 64), (0x30, 24));
+            RegisterBurstPlan plan = new RegisterBurstPlan(catalog, 64);
+            RegisterMapSnapshot snapshot = new RegisterMapSnapshot(catalog);
+            byte[] data =
+            {
+                0xA5,
+                0x12, 0x34,
+                0x0F, 0xFF,
+                0x89, 0xAB, 0xCD, 0xEF,
+                0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF,
+                0xFF
+            };
+
+            Assert.Equal(2, plan.Bursts.Count);
+            plan.Decode(0, data, snapshot);
+
+            Assert.Equal(5, snapshot.ReadCount);
+            Assert.Equal(0xA5UL, snapshot.GetValue(0));
+            Assert.Equal(0x1234UL, snapshot.GetValue(1));
+            Assert.Equal(0x0FFFUL, snapshot.GetValue(2));
+            Assert.Equal(0x89ABCDEFUL, snapshot.GetValue(3));
+            Assert.Equal(0x0123456789ABCDEFUL, snapshot.GetValue(4));
+            Assert.False(snapshot.IsRead(5));
+
+            plan.Decode(1, new byte[] { 0x00, 0x80, 0x01 }, snapshot);
+            Assert.Equal(0x008001UL, snapshot.GetValue(5));
+            Assert.Equal(6, snapshot.ReadCount);
+        }
+
+        [Fact]
+        public void DecodeShortDataThrows()
+        {
+            RegisterCatalog catalog = CreateCatalog((0x00, 8), (0x01, 16));
+            RegisterBurstPlan plan = new RegisterBurstPlan(catalog, 64);
+            RegisterMapSnapshot snapshot = new RegisterMapSnapshot(catalog);
+
+            Assert.Throws<ArgumentException>(() => plan.Decode(0, new byte[2], snapshot));
+            Assert.Equal(0, snapshot.ReadCount);
+        }
+    }
+}
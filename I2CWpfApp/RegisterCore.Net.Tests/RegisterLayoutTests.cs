@@ -0,0 +1,163 @@
+﻿using RegisterCore.Net.Catalogs;
+using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+using Xunit;
+
+namespace RegisterCore.Net.Tests
+{
+    // RegisterLayout against the per-field GeneralUtil functions.
+    public class RegisterLayoutTests
+    {
+        private static RegisterTemplate CreateTemplate(int bits, params (int offset, int bits)[] bitFields)
+        {
+            RegisterTemplate template = new RegisterTemplate() { Name = "REG", Bits = bits };
+
+            foreach (var (offset, fieldBits) in bitFields)
+            {
+                template.BitFields.Add(new BitFieldTemplate() { Name = $"BF{offset}", Offset = offset, Bits = fieldBits });
+            }
+
+            return template;
+        }
+
+        private static UInt64 NextValue(Random random)
+        {
+            return ((UInt64)(UInt32)random.Next() << 32) ^ ((UInt64)(UInt32)random.Next() << 1) ^ (UInt64)random.Next(2);
+        }
+
+        // Register bits covered by the bit fields of a template.
+        private static UInt64 GetCoveredBits(RegisterTemplate template)
+        {
+            UInt64 mask = 0;
+
+            foreach (var bf in template.BitFields)
+            {
+                mask |= GeneralUtil.GetBitFieldMaxValue(bf) << bf.Offset;
+            }
+
+            return mask;
+        }
+
+        [Fact]
+        public void DecodeSnapshotMatchesGeneralUtil()
+        {
+            RegisterCatalog catalog = Vl6180xCatalog.Catalog;
+            RegisterLayout layout = catalog.Layout;
+            UInt64[] values = new UInt64[layout.RegisterCount];
+            UInt64[] fields = new UInt64[layout.FieldCount];
+            Random random = new Random(1);
+
+            Assert.Equal(catalog.Registers.Count, layout.RegisterCount);
+
+            for (int n = 0; n < 100; n++)
+            {
+                for (int i = 0; i < values.Length; i++)
+                {
+                    values[i] = NextValue(random);
+                }
+
+                layout.Decode(values, fields);
+
+                for (int i = 0; i < values.Length; i++)
+                {
+                    IList<BitFieldTemplate> bitFields = catalog.Registers[i].BitFields;
+
+                    Assert.Equal(bitFields.Count, layout.GetFieldCount(i));
+                    for (int j = 0; j < bitFields.Count; j++)
+                    {
+                        int field = layout.GetFieldStart(i) + j;
+
+                        Assert.Equal(GeneralUtil.GetBitFieldValue(values[i], bitFields[j]), fields[field]);
+                        Assert.Equal(GeneralUtil.GetBitFieldMaxValue(bitFields[j]), layout.GetFieldMaxValue(field));
+                    }
+                }
+            }
+        }
+
+        [Fact]
+        public void EncodeSnapshotRoundTrip()
+        {
+            RegisterCatalog catalog = Vl6180xCatalog.Catalog;
+            RegisterLayout layout = catalog.Layout;
+            UInt64[] values = new UInt64[layout.RegisterCount];
+            UInt64[] encoded = new UInt64[layout.RegisterCount];
+            UInt64[] fields = new UInt64[layout.FieldCount];
+            Random random = new Random(2);
+
+            for (int n = 0; n < 100; n++)
+            {
+                for (int i = 0; i < values.Length; i++)
+                {
+                    values[i] = NextValue(random);
+                    encoded[i] = NextValue(random);
+                }
+
+                layout.Decode(values, fields);
+                layout.Encode(fields, encoded);
+
+                for (int i = 0; i < values.Length; i++)
+                {
+                    RegisterTemplate template = catalog.Registers[i];
+                    UInt64 covered = GetCoveredBits(template);
+                    Register reg = catalog.CreateRegister(template.Address, values[i]);
+
+                    // Fields from the values, the other bits of the encoded registers are kept.
+                    Assert.Equal(values[i] & covered, encoded[i] & covered);
+                    Assert.Equal(GeneralUtil.GetRegisterValueFromBitFields(reg.BitFields), encoded[i] & covered);
+                }
+            }
+        }
+
+        [Fact]
+        public void EncodeKeepsUncoveredBits()
+        {
+            RegisterLayout layout = new RegisterLayout(CreateTemplate(16, (0, 3), (8, 4)));
+            UInt64[] fields = { 0x5, 0xA };
+
+            Assert.Equal(0xFAFDUL, layout.Encode(0, fields, 0xFFFF));
+            Assert.Equal(0x0A05UL, layout.Encode(0, fields, 0));
+        }
+
+        [Fact]
+        public void EncodeTruncatesFieldValues()
+        {
+            RegisterLayout layout = new RegisterLayout(CreateTemplate(8, (0, 2), (2, 2)));
+            UInt64[] fields = { 0x7, 0x6 };
+
+            Assert.Equal(0x0BUL, layout.Encode(0, fields, 0));
+        }
+
+        [Theory]
+        [InlineData(0, 64)]
+        [InlineData(63, 1)]
+        [InlineData(32, 32)]
+        [InlineData(0, 0)]
+        public void DecodeEdgeFields(int offset, int bits)
+        {
+            RegisterTemplate template = CreateTemplate(64, (offset, bits));
+            RegisterLayout layout = new RegisterLayout(template);
+            UInt64[] fields = new UInt64[1];
+            Random random = new Random(offset * 64 + bits);
+
+            for (int n = 0; n < 100; n++)
+            {
+                UInt64 value = NextValue(random);
+
+                layout.Decode(0, value, fields);
+                Assert.Equal(GeneralUtil.GetBitFieldValue(value, template.BitFields[0]), fields[0]);
+                Assert.Equal(value, layout.Encode(0, fields, value));
+            }
+        }
+
+        [Fact]
+        public void LengthMismatchThrows()
+        {
+            RegisterLayout layout = Vl6180xCatalog.Catalog.Layout;
+
+            Assert.Throws<ArgumentException>(() => layout.Decode(new UInt64[layout.RegisterCount - 1], new UInt64[layout.FieldCount]));
+            Assert.Throws<ArgumentException>(() => layout.Encode(new UInt64[layout.FieldCount + 1], new UInt64[layout.RegisterCount]));
+            Assert.Throws<ArgumentException>(() => layout.Decode(0, 0, new UInt64[layout.GetFieldCount(0) + 1]));
+        }
+    }
+}
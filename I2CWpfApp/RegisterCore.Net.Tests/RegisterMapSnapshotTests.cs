@@ -0,0 +1,113 @@
+﻿using RegisterCore.Net.Models;
+using System;
+using Xunit;
+
+namespace RegisterCore.Net.Tests
+{
+    // Changed registers of RegisterMapSnapshot.CompareWith() and the last known values of MergeWith()
+    // with snapshots read in part(failed bursts).
+    public class RegisterMapSnapshotTests
+    {
+        // 2 bursts : 0x00 ~ 0x03, 0x10 ~ 0x11.
+        private static readonly RegisterCatalog _catalog =
+            RegisterBurstPlanTests.CreateCatalog((0x00, 8), (0x01, 16), (0x03, 8), (0x10, 8), (0x11, 8));
+
+        private static RegisterMapSnapshot Create(params UInt64?[] values)
+        {
+            RegisterMapSnapshot snapshot = new RegisterMapSnapshot(_catalog);
+
+            for (int i = 0; i < values.Length; i++)
+            {
+                if (values[i].HasValue)
+                {
+                    snapshot.SetValue(i, values[i].Value);
+                }
+            }
+
+            return snapshot;
+        }
+
+        [Fact]
+        public void CompareWithNullChangesReadRegisters()
+        {
+            RegisterMapSnapshot snapshot = Create(1, null, 3, 0, null);
+
+            snapshot.CompareWith(null);
+
+            Assert.Equal(new[] { 0, 2, 3 }, snapshot.Changed);
+        }
+
+        [Fact]
+        public void CompareWithPartialPrevious()
+        {
+            RegisterMapSnapshot previous = Create(1, 2, null, null, 5);
+            RegisterMapSnapshot snapshot = Create(1, 0x0202, 3, null, null);
+
+            snapshot.CompareWith(previous);
+
+            // 1 : value changed, 2 : read only now, 3 : read in neither, 4 : read only before.
+            Assert.Equal(new[] { 1, 2 }, snapshot.Changed);
+
+            // A new comparison replaces the list.
+            snapshot.CompareWith(snapshot);
+            Assert.Empty(snapshot.Changed);
+        }
+
+        [Fact]
+        public void CompareWithOtherCatalogThrows()
+        {
+            RegisterMapSnapshot snapshot = Create(1);
+            RegisterMapSnapshot other = new RegisterMapSnapshot(RegisterBurstPlanTests.CreateCatalog((0x00, 8)));
+
+            Assert.Throws<ArgumentException>(() => snapshot.CompareWith(other));
+        }
+
+        // The second burst failed : its registers keep the values of the previous snapshot.
+        [Fact]
+        public void MergeWithAfterFailedBurst()
+        {
+            RegisterBurstPlan plan = new RegisterBurstPlan(_catalog, 64);
+            RegisterMapSnapshot previous = Create(0x11, 0x2222, 0x33, 0x44, null);
+            RegisterMapSnapshot snapshot = new RegisterMapSnapshot(_catalog)
+            {
+                Timestamp = new DateTime(2021, 6, 1, 0, 0, 0, DateTimeKind.Utc)
+            };
+
+            Assert.Equal(2, plan.Bursts.Count);
+            plan.Decode(0, new byte[] { 0x10, 0x20, 0x20, 0x30 }, snapshot);
+            snapshot.CompareWith(previous);
+            Assert.Equal(new[] { 0, 1, 2 }, snapshot.Changed);
+
+            RegisterMapSnapshot merged = snapshot.MergeWith(previous);
+
+            Assert.Equal(snapshot.Timestamp, merged.Timestamp);
+            Assert.Equal(4, merged.ReadCount);
+            Assert.Equal(0x10UL, merged.GetValue(0));
+            Assert.Equal(0x2020UL, merged.GetValue(1));
+            Assert.Equal(0x30UL, merged.GetValue(2));
+            Assert.Equal(0x44UL, merged.GetValue(3));
+            Assert.False(merged.IsRead(4));
+
+            // The snapshot read is not changed.
+            Assert.Equal(3, snapshot.ReadCount);
+            Assert.False(snapshot.IsRead(3));
+
+            // The next read compares with the merged values.
+            RegisterMapSnapshot next = Create(0x10, 0x2020, 0x30, 0x44, 0x55);
+
+            next.CompareWith(merged);
+            Assert.Equal(new[] { 4 }, next.Changed);
+        }
+
+        [Fact]
+        public void MergeWithNullKeepsReadRegisters()
+        {
+            RegisterMapSnapshot merged = Create(null, 2, null, 4, null).MergeWith(null);
+
+            Assert.Equal(2, merged.ReadCount);
+            Assert.Equal(2UL, merged.GetValue(1));
+            Assert.Equal(4UL, merged.GetValue(3));
+            Assert.Equal(new[] { new RegisterValue(0x01, 2), new RegisterValue(0x10, 4) }, merged.ToRegisterValues());
+        }
+    }
+}
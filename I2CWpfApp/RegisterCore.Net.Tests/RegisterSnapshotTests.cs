@@ -0,0 +1,143 @@
+﻿using RegisterCore.Net.IO;
+using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using Xunit;
+
+namespace RegisterCore.Net.Tests
+{
+    // Register snapshot files written by RegisterSnapshotWriter and read back by RegisterSnapshotReader.
+    public class RegisterSnapshotTests
+    {
+        private static byte[] Write(params (Int64 chipId, DateTime timestamp, RegisterValue[] values)[] snapshots)
+        {
+            MemoryStream stream = new MemoryStream();
+
+            using (var writer = new RegisterSnapshotWriter(stream, true))
+            {
+                foreach (var (chipId, timestamp, values) in snapshots)
+                {
+                    writer.Write(chipId, timestamp, values);
+                }
+            }
+
+            return stream.ToArray();
+        }
+
+        private static RegisterValue[] CreateValues(int count, UInt64 maxAddress, UInt64 maxValue, int seed)
+        {
+            RegisterValue[] values = new RegisterValue[count];
+            Random random = new Random(seed);
+
+            for (int i = 0; i < count; i++)
+            {
+                UInt64 address = ((UInt64)(UInt32)random.Next() << 32) | (UInt32)random.Next();
+                UInt64 value = ((UInt64)(UInt32)random.Next() << 32) | (UInt32)random.Next();
+
+                values[i] = new RegisterValue(address & maxAddress, value & maxValue);
+            }
+            // The largest values set the byte widths.
+            values[count - 1] = new RegisterValue(maxAddress, maxValue);
+
+            return values;
+        }
+
+        [Theory]
+        [InlineData(0xFFUL, 0xFFUL, 1, 1)]
+        [InlineData(0xFFFUL, 0xFFUL, 2, 1)]
+        [InlineData(0xFFFFUL, 0x1FFFFUL, 2, 4)]
+        [InlineData(0xFFFFFFFFUL, 0xFFFFFFFFUL, 4, 4)]
+        [InlineData(0x100000000UL, UInt64.MaxValue, 8, 8)]
+        public void WriteReadRoundTrip(UInt64 maxAddress, UInt64 maxValue, int addressBytes, int valueBytes)
+        {
+            RegisterValue[] expected = CreateValues(1000, maxAddress, maxValue, addressBytes * 8 + valueBytes);
+            DateTime timestamp = new DateTime(2021, 5, 1, 12, 34, 56, DateTimeKind.Utc).AddTicks(1234567);
+            byte[] data = Write((0x1234567890, timestamp, expected));
+            List<RegisterValue> values = new List<RegisterValue>();
+
+            Assert.Equal(RegisterSnapshotHeader.SIZE + expected.Length * (addressBytes + valueBytes), data.Length);
+
+            using (var reader = new RegisterSnapshotReader(new MemoryStream(data)))
+            {
+                RegisterSnapshotHeader header = reader.Read(values);
+
+                Assert.NotNull(header);
+                Assert.Equal(0x1234567890, header.ChipId);
+                Assert.Equal(timestamp, header.Timestamp);
+                Assert.Equal(DateTimeKind.Utc, header.Timestamp.Kind);
+                Assert.Equal(addressBytes, header.AddressBytes);
+                Assert.Equal(valueBytes, header.ValueBytes);
+                Assert.Equal(expected, values);
+                Assert.Null(reader.Read(values));
+            }
+        }
+
+        [Fact]
+        public void ReadAppendedSnapshots()
+        {
+            RegisterValue[] first = CreateValues(61, 0x2FF, 0xFFFF, 1);
+            RegisterValue[] second = CreateValues(3, 0xFF, 0xFF, 2);
+            DateTime local = new DateTime(2021, 5, 1, 9, 0, 0, DateTimeKind.Local);
+            byte[] data = Write((1, local, first), (2, DateTime.MinValue, new RegisterValue[0]), (3, DateTime.MaxValue, second));
+            List<RegisterValue> values = new List<RegisterValue>();
+
+            using (var reader = new RegisterSnapshotReader(new MemoryStream(data)))
+            {
+                Assert.Equal(local.ToUniversalTime(), reader.Read(values).Timestamp);
+                Assert.Equal(first, values);
+
+                RegisterSnapshotHeader header = reader.Read(values);
+                Assert.Equal(2, header.ChipId);
+                Assert.Equal(0, header.Count);
+                Assert.Empty(values);
+
+                Assert.Equal(DateTime.MaxValue.Ticks, reader.Read(values).Timestamp.Ticks);
+                Assert.Equal(second, values);
+
+                Assert.Null(reader.Read(values));
+            }
+        }
+
+        [Fact]
+        public void ReadInvalidData()
+        {
+            byte[] data = Write((1, DateTime.UtcNow, CreateValues(10, 0xFF, 0xFF, 1)));
+            List<RegisterValue> values = new List<RegisterValue>();
+
+            // Truncated header, truncated values.
+            Assert.Throws<InvalidDataException>(() => new RegisterSnapshotReader(new MemoryStream(data, 0, 16)).Read(values));
+            Assert.Throws<InvalidDataException>(() => new RegisterSnapshotReader(new MemoryStream(data, 0, data.Length - 1)).Read(values));
+
+            // Magic, version, address bytes, count.
+            foreach (var (offset, value) in new (int, byte)[] { (0, (byte)'X'), (4, 2), (5, 3), (27, 0x80) })
+            {
+                byte[] invalid = (byte[])data.Clone();
+
+                invalid[offset] = value;
+                Assert.Throws<InvalidDataException>(() => new RegisterSnapshotReader(new MemoryStream(invalid)).Read(values));
+            }
+        }
+
+        [Fact]
+        public void DetectSnapshotFile()
+        {
+            string snapshotFile = Path.GetTempFileName();
+            string textFile = Path.GetTempFileName();
+
+            try
+            {
+                File.WriteAllBytes(snapshotFile, Write((1, DateTime.UtcNow, CreateValues(2, 0xFF, 0xFF, 1))));
+                File.WriteAllText(textFile, "00000000,B4\n");
+
+                Assert.True(RegisterSnapshotReader.IsSnapshotFile(snapshotFile));
+                Assert.False(RegisterSnapshotReader.IsSnapshotFile(textFile));
+            }
+            finally
+            {
+                File.Delete(snapshotFile);
+                File.Delete(textFile);
+            }
+        }
+    }
+}
@@ -0,0 +1,163 @@
+﻿using RegisterCore.Net.IO;
+using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+using Xunit;
+
+namespace RegisterCore.Net.Tests
+{
+    // Register value files(text) written by RegisterValueCsvWriter and read back by RegisterValueCsvReader.
+    public class RegisterValueCsvTests
+    {
+        // Returns at most chunkSize bytes a read, lines are split across the reader buffer fills.
+        private sealed class ChunkedStream : MemoryStream
+        {
+            private readonly int _chunkSize;
+
+            public ChunkedStream(byte[] buffer, int chunkSize)
+                : base(buffer)
+            {
+                _chunkSize = chunkSize;
+            }
+
+            public override int Read(byte[] buffer, int offset, int count)
+            {
+                return base.Read(buffer, offset, Math.Min(count, _chunkSize));
+            }
+        }
+
+        private static List<RegisterValue> ReadAll(Stream stream)
+        {
+            List<RegisterValue> values = new List<RegisterValue>();
+
+            using (var reader = new RegisterValueCsvReader(stream))
+            {
+                while (reader.TryRead(out RegisterValue value))
+                {
+                    values.Add(value);
+                }
+            }
+
+            return values;
+        }
+
+        private static List<RegisterValue> ReadAll(string text, int chunkSize = int.MaxValue)
+        {
+            return ReadAll(new ChunkedStream(Encoding.UTF8.GetBytes(text), chunkSize));
+        }
+
+        private static byte[] Write(IEnumerable<(UInt64 address, UInt64 value, int bits)> values)
+        {
+            MemoryStream stream = new MemoryStream();
+
+            using (var writer = new RegisterValueCsvWriter(stream, true))
+            {
+                foreach (var (address, value, bits) in values)
+                {
+                    writer.Write(address, value, bits);
+                }
+            }
+
+            return stream.ToArray();
+        }
+
+        [Theory]
+        [InlineData(int.MaxValue)]
+        [InlineData(7)]
+        [InlineData(1)]
+        public void WriteReadRoundTrip(int chunkSize)
+        {
+            List<(UInt64 address, UInt64 value, int bits)> expected = new List<(UInt64 address, UInt64 value, int bits)>();
+            Random random = new Random(chunkSize);
+            int[] bits = { 8, 16, 32, 64 };
+
+            // Several reader buffers(64KB) of lines.
+            for (int i = 0; i < 20000; i++)
+            {
+                int valueBits = bits[i % bits.Length];
+                UInt64 value = (((UInt64)(UInt32)random.Next() << 32) | (UInt32)random.Next()) & GeneralUtil.GetMaxValueOfBits(valueBits);
+
+                expected.Add(((UInt64)random.Next(), value, valueBits));
+            }
+
+            List<RegisterValue> values = ReadAll(new ChunkedStream(Write(expected), chunkSize));
+
+            Assert.Equal(expected.Count, values.Count);
+            for (int i = 0; i < values.Count; i++)
+            {
+                Assert.Equal(expected[i].address, values[i].Address);
+                Assert.Equal(expected[i].value, values[i].Value);
+            }
+        }
+
+        [Fact]
+        public void WriteValueWidths()
+        {
+            byte[] data = Write(new (UInt64, UInt64, int)[]
+            {
+                (0x10, 0x5, 8),
+                (0x11, 0x5, 16),
+                (0x12, 0x5, 32),
+                (0x13, 0x5, 64),
+                (0x14, 0x123456789, 64)
+            });
+            string nl = Environment.NewLine;
+
+            Assert.Equal($"00000010,05{nl}00000011,0005{nl}00000012,00000005{nl}00000013,5{nl}00000014,123456789{nl}",
+                         Encoding.ASCII.GetString(data));
+        }
+
+        [Fact]
+        public void ReadSkipsInvalidLines()
+        {
+            List<RegisterValue> values = ReadAll("\uFEFFaddress,value\r\n" +
+                                                 " 00000010 , 0A \r\n" +
+                                                 "\r\n" +
+                                                 "00000011\r\n" +
+                                                 "00000012,0G\r\n" +
+                                                 ",01\r\n" +
+                                                 "00000013,\r\n" +
+                                                 "00000014,1,2\r\n" +
+                                                 "\t00000015,ff\n" +
+                                                 "00000016,FFFFFFFFFFFFFFFF");
+
+            Assert.Equal(3, values.Count);
+            Assert.Equal(new RegisterValue(0x10, 0x0A), values[0]);
+            Assert.Equal(new RegisterValue(0x15, 0xFF), values[1]);
+            Assert.Equal(new RegisterValue(0x16, UInt64.MaxValue), values[2]);
+        }
+
+        [Fact]
+        public void ReadLineLongerThanBuffer()
+        {
+            string padding = new string(' ', 200 * 1024);
+            List<RegisterValue> values = ReadAll($"00000001,01\n{padding}00000002,02{padding}\n00000003,03\n", 4096);
+
+            Assert.Equal(new RegisterValue[] { new RegisterValue(1, 1), new RegisterValue(2, 2), new RegisterValue(3, 3) }, values);
+        }
+
+        [Fact]
+        public void ReadIntoSpan()
+        {
+            RegisterValue[] values = new RegisterValue[4];
+
+            using (var reader = new RegisterValueCsvReader(new MemoryStream(Encoding.ASCII.GetBytes("1,1\n2,2\nx\n3,3\n4,4\n5,5\n"))))
+            {
+                Assert.Equal(4, reader.Read(values));
+                Assert.Equal(new RegisterValue(4, 4), values[3]);
+                Assert.Equal(1, reader.Read(values));
+                Assert.Equal(new RegisterValue(5, 5), values[0]);
+                Assert.Equal(0, reader.Read(values));
+            }
+        }
+
+        [Fact]
+        public void ReadEmpty()
+        {
+            Assert.Empty(ReadAll(""));
+            Assert.Empty(ReadAll("\uFEFF"));
+        }
+    }
+}
@@ -0,0 +1,76 @@
+﻿using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+
+namespace RegisterCore.Net
+{
+    // A cell run of a bit field in a bit usage row, a field crossing rows has a segment per row.
+    public struct BitUsageSegment
+    {
+        public int Field { get; set; }          // Index in the bit fields of the layout
+        public int Row { get; set; }
+        public int Column { get; set; }
+        public int ColumnSpan { get; set; }
+        public int HighBit { get; set; }
+        public int LowBit { get; set; }
+    }
+
+    // Bit usage grid of a register(UcRegisterBitUsage) : the most significant bit first,
+    // 8 bits per row below 16 bits, 16 bits per row otherwise.
+    public sealed class BitUsageLayout
+    {
+        private readonly List<BitUsageSegment> _segments = new List<BitUsageSegment>();
+
+        public int Bits { get; }
+        public int ColumnCount { get; }
+        public int RowCount { get; }
+        public IReadOnlyList<BitUsageSegment> Segments => _segments;
+
+        public BitUsageLayout(int bits, IReadOnlyList<BitFieldTemplate> bitFields)
+        {
+            Bits = Math.Max(bits, 1);
+            ColumnCount = (Bits >= 16) ? 16 : 8;
+            RowCount = (Bits + ColumnCount - 1) / ColumnCount;
+
+            for (int i = 0; i < bitFields.Count; i++)
+            {
+                AddSegments(i, bitFields[i].Offset, bitFields[i].Bits);
+            }
+        }
+
+        public int GetRow(int bit)
+        {
+            return (Bits - 1 - bit) / ColumnCount;
+        }
+
+        public int GetColumn(int bit)
+        {
+            return (Bits - 1 - bit) % ColumnCount;
+        }
+
+        // Bits out of the register are not shown.
+        private void AddSegments(int field, int offset, int bits)
+        {
+            int low = Math.Max(offset, 0);
+            int high = Math.Min(offset + bits, Bits) - 1;
+
+            while (high >= low)
+            {
+                int row = GetRow(high);
+                int rowLow = Math.Max(low, Bits - (row + 1) * ColumnCount);
+
+                _segments.Add(new BitUsageSegment()
+                {
+                    Field = field,
+                    Row = row,
+                    Column = GetColumn(high),
+                    ColumnSpan = high - rowLow + 1,
+                    HighBit = high,
+                    LowBit = rowLow
+                });
+
+                high = rowLow - 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,244 @@
+﻿// <auto-generated>
+// Generated by RegisterCatalogGen from vl6180x.json, do not edit.
+// </auto-generated>
+using System;
+using RegisterCore.Net.Models;
+
+namespace RegisterCore.Net.Catalogs
+{
+    // VL6180x register catalog.
+    public static class Vl6180xCatalog
+    {
+        public const string ChipName = "VL6180x";
+
+        // Address order, bit fields of a register are _bitFields[bitField .. bitField + bitFieldCount - 1].
+        private static readonly (UInt64 address, int bits, string resetValue, string name, string description, int bitField, int bitFieldCount)[] _registers =
+        {
+            (0x000, 8, "0xB4", "IDENTIFICATION__MODEL_ID", null, 0, 1),
+            (0x001, 8, "0x1", "IDENTIFICATION__MODEL_REV_MAJOR", "register default overwritten at boot-up by NVM contents", 1, 2),
+            (0x002, 8, "0x3", "IDENTIFICATION__MODEL_REV_MINOR", "register default overwritten at boot-up by NVM contents.", 3, 2),
+            (0x003, 8, "0x1", "IDENTIFICATION__MODULE_REV_MAJOR", "register default overwritten at boot-up by NVM contents.", 5, 2),
+            (0x004, 8, "0x2", "IDENTIFICATION__MODULE_REV_MINOR", "register default overwritten at boot-up by NVM contents.", 7, 2),
+            (0x006, 8, "0xYY", "IDENTIFICATION__DATE_HI", "register default overwritten at boot-up by NVM contents.\nPart of the register set that can be used to uniquely identify a module.", 9, 2),
+            (0x007, 8, "0xYY", "IDENTIFICATION__DATE_LO", "register default overwritten at boot-up by NVM contents.\nPart of the register set that can be used to uniquely identify a module.", 11, 2),
+            (0x008, 16, "0xYYYY", "IDENTIFICATION__TIME", "register default overwritten at boot-up by NVM contents.\nPart of the register set that can be used to uniquely identify a module.", 13, 1),
+            (0x010, 8, "0x60", "SYSTEM__MODE_GPIO0", null, 14, 5),
+            (0x011, 8, "0x20", "SYSTEM__MODE_GPIO1", null, 19, 4),
+            (0x012, 8, "0x0", "SYSTEM__HISTORY_CTRL", null, 23, 4),
+            (0x014, 8, "0x0", "SYSTEM__INTERRUPT_CONFIG_GPIO", null, 27, 3),
+            (0x015, 8, "0x0", "SYSTEM__INTERRUPT_CLEAR", null, 30, 2),
+            (0x016, 8, "0x1", "SYSTEM__FRESH_OUT_OF_RESET", null, 32, 2),
+            (0x017, 8, "0x0", "SYSTEM__GROUPED_PARAMETER_HOLD", null, 34, 2),
+            (0x018, 8, "0x0", "SYSRANGE__START", null, 36, 3),
+            (0x019, 8, "0xFF", "SYSRANGE__THRESH_HIGH", null, 39, 1),
+            (0x01A, 8, "0x0", "SYSRANGE__THRESH_LOW", null, 40, 1),
+            (0x01B, 8, "0xFF", "SYSRANGE__INTERMEASUREMENT_PERIOD", null, 41, 1),
+            (0x01C, 8, "0x31", "SYSRANGE__MAX_CONVERGENCE_TIME", null, 42, 2),
+            (0x01E, 16, "0x0", "SYSRANGE__CROSSTALK_COMPENSATION_RATE", null, 44, 1),
+            (0x021, 8, "0x14", "SYSRANGE__CROSSTALK_VALID_HEIGHT", null, 45, 1),
+            (0x022, 16, "0x0", "SYSRANGE__EARLY_CONVERGENCE_ESTIMATE", null, 46, 1),
+            (0x024, 8, "0xYY", "SYSRANGE__PART_TO_PART_RANGE_OFFSET", "register default overwritten at boot-up by NVM contents.", 47, 1),
+            (0x025, 8, "0x0", "SYSRANGE__RANGE_IGNORE_VALID_HEIGHT", "register default overwritten at boot-up by NVM contents.", 48, 1),
+            (0x026, 16, "0x0", "SYSRANGE__RANGE_IGNORE_THRESHOLD", null, 49, 1),
+            (0x02C, 8, "0xA0", "SYSRANGE__MAX_AMBIENT_LEVEL_MULT", "register default overwritten at boot-up by NVM contents.", 50, 1),
+            (0x02D, 8, "0x11", "SYSRANGE__RANGE_CHECK_ENABLES", "register default overwritten at boot-up by NVM contents.", 51, 6),
+            (0x02E, 8, "0x0", "SYSRANGE__VHV_RECALIBRATE", null, 57, 3),
+            (0x031, 8, "0x0", "SYSRANGE__VHV_REPEAT_RATE", null, 60, 1),
+            (0x038, 8, "0x0", "SYSALS__START", null, 61, 3),
+            (0x03A, 16, "0xFFFF", "SYSALS__THRESH_HIGH", null, 64, 1),
+            (0x03C, 16, "0x0", "SYSALS__THRESH_LOW", null, 65, 1),
+            (0x03E, 8, "0xFF", "SYSALS__INTERMEASUREMENT_PERIOD", null, 66, 1),
+            (0x03F, 8, "0x06", "SYSALS__ANALOGUE_GAIN", null, 67, 2),
+            (0x040, 16, "0x0", "SYSALS__INTEGRATION_PERIOD", null, 69, 2),
+            (0x04D, 8, "0x1", "RESULT__RANGE_STATUS", null, 71, 5),
+            (0x04E, 8, "0x1", "RESULT__ALS_STATUS", null, 76, 5),
+            (0x04F, 8, "0x0", "RESULT__INTERRUPT_STATUS_GPIO", null, 81, 3),
+            (0x050, 16, "0x0", "RESULT__ALS_VAL", null, 84, 1),
+            (0x052, 16, "0x0", "RESULT__HISTORY_BUFFER_0", null, 85, 1),
+            (0x054, 16, "0x0", "RESULT__HISTORY_BUFFER_1", null, 86, 1),
+            (0x056, 16, "0x0", "RESULT__HISTORY_BUFFER_2", null, 87, 1),
+            (0x058, 16, "0x0", "RESULT__HISTORY_BUFFER_3", null, 88, 1),
+            (0x05A, 16, "0x0", "RESULT__HISTORY_BUFFER_4", null, 89, 1),
+            (0x05C, 16, "0x0", "RESULT__HISTORY_BUFFER_5", null, 90, 1),
+            (0x05E, 16, "0x0", "RESULT__HISTORY_BUFFER_6", null, 91, 1),
+            (0x060, 16, "0x0", "RESULT__HISTORY_BUFFER_7", null, 92, 1),
+            (0x062, 8, "0x0", "RESULT__RANGE_VAL", null, 93, 1),
+            (0x066, 16, "0x0", "RESULT__RANGE_RETURN_RATE", null, 94, 1),
+            (0x068, 16, "0x0", "RESULT__RANGE_REFERENCE_RATE", null, 95, 1),
+            (0x06C, 32, "0x0", "RESULT__RANGE_RETURN_SIGNAL_COUNT", null, 96, 1),
+            (0x070, 32, "0x0", "RESULT__RANGE_REFERENCE_SIGNAL_COUNT", null, 97, 1),
+            (0x074, 32, "0x0", "RESULT__RANGE_RETURN_AMB_COUNT", null, 98, 1),
+            (0x078, 32, "0x0", "RESULT__RANGE_REFERENCE_AMB_COUNT", null, 99, 1),
+            (0x07C, 32, "0x0", "RESULT__RANGE_RETURN_CONV_TIME", null, 100, 1),
+            (0x10A, 8, "0x30", "READOUT__AVERAGING_SAMPLE_PERIOD", null, 101, 1),
+            (0x119, 8, "0x1", "FIRMWARE__BOOTUP", null, 102, 2),
+            (0x120, 8, "0x1", "FIRMWARE__RESULT_SCALER", null, 104, 2),
+            (0x212, 8, "0x29", "I2C_SLAVE__DEVICE_ADDRESS", null, 106, 2),
+            (0x2A3, 8, "0x0", "INTERLEAVED_MODE__ENABLE", null, 108, 1),
+        };
+
+        private static readonly (string name, int offset, int bits, BitAccessType access, string resetValue, string description)[] _bitFields =
+        {
+            ("identification__model_id", 0, 8, BitAccessType.ReadWrite, "0xB4", null),
+            ("identification__model_rev_major", 0, 3, BitAccessType.ReadWrite, "0x1", "Revision identifier of the Device for major change."),
+            ("RESERVED", 3, 5, BitAccessType.ReadOnly, "0x0", null),
+            ("identification__model_rev_minor", 0, 3, BitAccessType.ReadWrite, "0x1", "Revision identifier of the Device for minor change.\nIDENTIFICATION__MODEL_REV_MINOR = 3 for latest ROM revision"),
+            ("RESERVED", 3, 5, BitAccessType.ReadOnly, "0x0", null),
+            ("identification__module_rev_major", 0, 3, BitAccessType.ReadWrite, "0x1", "Revision identifier of the Module Package for major change.\nUsed to store NVM content version. Contact ST for current information."),
+            ("RESERVED", 3, 5, BitAccessType.ReadOnly, "0x0", null),
+            ("identification__module_rev_minor", 0, 3, BitAccessType.ReadWrite, "0x2", "Revision identifier of the Module Package for minor change.\nUsed to store NVM content version. Contact ST for current information."),
+            ("RESERVED", 3, 5, BitAccessType.ReadOnly, "0x0", null),
+            ("identification__month", 0, 4, BitAccessType.ReadWrite, null, "Manufacturing month (bits[3:0])."),
+            ("identification__year", 4, 4, BitAccessType.ReadWrite, null, "Last digit of manufacturing year (bits[3:0])."),
+            ("identification__phase", 0, 3, BitAccessType.ReadWrite, null, "Manufacturing phase identification (bits[2:0])."),
+            ("identification__day", 3, 5, BitAccessType.ReadWrite, null, "Manufacturing day (bits[4:0])."),
+            ("identification__time", 0, 16, BitAccessType.ReadWrite, null, "Time since midnight (in seconds) = register_value * 2"),
+            ("RESERVED", 0, 1, BitAccessType.ReadWrite, null, "Reserved. Write 0."),
+            ("system__gpio0_select", 1, 4, BitAccessType.ReadWrite, null, "Functional configuration options.\n0000: OFF (Hi-Z)\n1000: GPIO Interrupt output"),
+            ("system__gpio0_polarity", 5, 1, BitAccessType.ReadWrite, null, "Signal Polarity Selection.\n0: Active-low\n1: Active-high"),
+            ("system__gpio0_is_xshutdown", 6, 1, BitAccessType.ReadWrite, null, "Priority mode - when enabled, other bits of the register are ignored.GPIO0 is main XSHUTDOWN input.\n0: Disabled\n1: Enabled - GPIO0 is main XSHUTDOWN input."),
+            ("RESERVED", 7, 1, BitAccessType.ReadOnly, null, null),
+            ("RESERVED", 0, 1, BitAccessType.ReadWrite, null, "Reserved. Write 0."),
+            ("system__gpio1_select", 1, 4, BitAccessType.ReadWrite, null, "Functional configuration options.\n0000: OFF (Hi-Z)\n1000: GPIO Interrupt output"),
+            ("system__gpio1_polarity", 5, 1, BitAccessType.ReadWrite, null, "Signal Polarity Selection.\n0: Active-low\n1: Active-high"),
+            ("RESERVED", 6, 2, BitAccessType.ReadOnly, null, null),
+            ("system__history_buffer_enable", 0, 1, BitAccessType.ReadWrite, null, "Enable History buffering.\n0: Disabled\n1: Enabled"),
+            ("system__history_buffer_mode", 1, 1, BitAccessType.ReadWrite, null, "Select mode buffer results for:\n0: Ranging (stores the last 8 ranging values (8-bit)\n1: ALS (stores the last 8 ALS values (16-bit)"),
+            ("system__history_buffer_clear", 2, 1, BitAccessType.ReadWrite, null, "User-command to clear history (FW will auto-clear this bit when clear has completed).\n0: Disabled\n1: Clear all history buffers"),
+            ("RESERVED", 3, 5, BitAccessType.ReadOnly, null, null),
+            ("range_int_mode", 0, 3, BitAccessType.ReadWrite, null, "Interrupt mode source for Range readings:\n0: Disabled\n1: Level Low (value < thresh_low)\n2: Level High (value > thresh_high)\n3: Out Of Window (value < thresh_low OR value > thresh_high)\n4: New sample ready"),
+            ("als_int_mode", 3, 3, BitAccessType.ReadWrite, null, "Interrupt mode source for ALS readings:\n0: Disabled\n1: Level Low (value < thresh_low)\n2: Level High (value > thresh_high)\n3: Out Of Window (value < thresh_low OR value > thresh_high)\n4: New sample ready"),
+            ("RESERVED", 6, 2, BitAccessType.ReadOnly, null, null),
+            ("int_clear_sig", 0, 3, BitAccessType.ReadWrite, null, "Interrupt clear bits. Writing a 1 to each bit will clear the intended interrupt.\nBit [0] - Clear Range Int\nBit [1] - Clear ALS Int\nBit [2] - Clear Error Int."),
+            ("RESERVED", 3, 5, BitAccessType.ReadOnly, null, null),
+            ("fresh_out_of_reset", 0, 1, BitAccessType.ReadWrite, null, "Fresh out of reset bit, default of 1, user can set this to 0 after initial boot and can therefore use this to check for a reset condition"),
+            ("RESERVED", 1, 7, BitAccessType.ReadOnly, null, null),
+            ("grouped_parameter_hold", 0, 1, BitAccessType.ReadWrite, null, "Flag set over I2C to indicate that data is being updated\n0: Data is stable - FW is safe to copy\n1: Data being updated - FW not safe to copy\nUsage: set to 0x01 first, write any of the registers listed below, then set to 0x00 so that the\nsettings are used by the firmware at the start of the next measurement.\nSYSTEM__INTERRUPT_CONFIG_GPIO\nSYSRANGE__THRESH_HIGH\nSYSRANGE__THRESH_LOW\nSYSALS__INTEGRATION_PERIOD\nSYSALS__ANALOGUE_GAIN\nSYSALS__THRESH_HIGH\nSYSALS__THRESH_LOW"),
+            ("RESERVED", 1, 7, BitAccessType.ReadOnly, null, null),
+            ("sysrange__startstop", 0, 1, BitAccessType.ReadWrite, null, "StartStop trigger based on current mode and system configuration of\ndevice_ready. FW clears register automatically.\nSetting this bit to 1 in single-shot mode starts a single measurement.\nSetting this bit to 1 in continuous mode will either start continuous operation (if stopped) or halt\ncontinuous operation (if started).\nThis bit is auto-cleared in both modes of operation."),
+            ("sysrange__mode_select", 1, 1, BitAccessType.ReadWrite, null, "Device Mode select\n0: Ranging Mode Single-Shot\n1: Ranging Mode Continuous"),
+            ("RESERVED", 2, 6, BitAccessType.ReadOnly, null, null),
+            ("sysrange__thresh_high", 0, 8, BitAccessType.ReadWrite, null, "High Threshold value for ranging comparison. Range 0-255mm."),
+            ("sysrange__thresh_low", 0, 8, BitAccessType.ReadWrite, null, "Low Threshold value for ranging comparison. Range 0-255mm."),
+            ("sysrange__intermeasurement_period", 0, 8, BitAccessType.ReadWrite, null, "Time delay between measurements in Ranging continuous mode. Range 0-254 (0 = 10ms). Step size = 10ms."),
+            ("sysrange__max_convergence_time", 0, 6, BitAccessType.ReadWrite, null, "Maximum time to run measurement in Ranging modes.\nRange 1 - 63 ms (1 code = 1 ms); Measurement aborted when limit reached to aid power reduction. \nFor example, 0x01 = 1ms, 0x0a = 10ms.\nNote: Effective max_convergence_time depends on readout_averaging_sample_period\nsetting."),
+            ("RESERVED", 6, 2, BitAccessType.ReadOnly, null, null),
+            ("sysrange__crosstalk_compensation_rate", 0, 16, BitAccessType.ReadWrite, null, "User-controlled crosstalk compensation in Mcps (9.7 format)."),
+            ("sysrange__crosstalk_valid_height", 0, 8, BitAccessType.ReadWrite, null, "Minimum range value in mm to qualify for cross-talk compensation."),
+            ("sysrange__early_convergence_estimate", 0, 8, BitAccessType.ReadWrite, null, "FW carries out an estimate of convergence rate 0.5ms into each new range measurement. If\nconvergence rate is below user input value, the operation aborts to save power.\nNote: This register must be configured otherwise ECE should be disabled via\nSYSRANGE__RANGE_CHECK_ENABLES."),
+            ("sysrange__part_to_part_range_offset", 0, 8, BitAccessType.ReadWrite, null, "2s complement format."),
+            ("sysrange__range_ignore_valid_height", 0, 8, BitAccessType.ReadWrite, null, "Range below which ignore threshold is applied. Aim is\nto ignore the cover glass i.e. low signal rate at near distance. Should not be applied to low\nreflectance target at far distance. Range in mm.\nNote: It is recommended to set this register to 255 if the range ignore feature is used."),
+            ("sysrange__range_ignore_threshold", 0, 16, BitAccessType.ReadWrite, null, "User configurable min threshold signal return rate. \nUsed to filter out ranging due to cover glass when there is no target above the device. Mcps 9.7 format.\nNote: Register must be initialized if this feature is used."),
+            ("sysrange__max_ambient_level_mult", 0, 8, BitAccessType.ReadWrite, null, "User input value to multiply return_signal_count for AMB:signal ratio check. \nIf (amb counts * 6) > return_signal_count * mult then abandon measurement due to high ambient (4.4 format)."),
+            ("sysrange__early_convergence_enable", 0, 1, BitAccessType.ReadWrite, null, "Measurement enable/disable"),
+            ("sysrange__range_ignore_enable", 1, 1, BitAccessType.ReadWrite, null, "Measurement enable/disable"),
+            ("0", 2, 1, BitAccessType.ReadOnly, null, null),
+            ("0", 3, 1, BitAccessType.ReadWrite, null, null),
+            ("sysrange__signal_to_noise_enab", 4, 1, BitAccessType.ReadWrite, null, "Measurement enable/disable"),
+            ("RESERVED", 5, 3, BitAccessType.ReadOnly, null, null),
+            ("sysrange__vhv_recalibrate", 0, 1, BitAccessType.ReadWrite, null, "User-Controlled enable bit to force FW to carry out recalibration of\nthe VHV setting for sensor array. FW clears bit after operation carried out.\n0: Disabled\n1: Manual trigger for VHV recalibration. Can only be called when ALS and ranging are in STOP\nmode"),
+            ("sysrange__vhv_status", 1, 1, BitAccessType.ReadWrite, null, "FW controlled status bit showing when FW has completed auto-vhv process.\n0: FW has finished autoVHV operation\n1: During autoVHV operation"),
+            ("RESERVED", 2, 6, BitAccessType.ReadOnly, null, null),
+            ("sysrange__vhv_repeat_rate", 0, 8, BitAccessType.ReadWrite, null, "User entered repeat rate of auto VHV task (0 = off, 255 = after every 255 measurements)"),
+            ("sysals__startstop", 0, 1, BitAccessType.ReadWrite, null, "Start/Stop trigger based on current mode and system configuration of\ndevice_ready. FW clears register automatically.\nSetting this bit to 1 in single-shot mode starts a single measurement.\nSetting this bit to 1 in continuous mode will either start continuous operation (if stopped) or halt\ncontinuous operation (if started).\nThis bit is auto-cleared in both modes of operation.\nSee 6.2.56: INTERLEAVED_MODE__ENABLE for combined ALS and Range operation."),
+            ("sysals__mode_select", 1, 1, BitAccessType.ReadWrite, null, "Device Mode select\n0: ALS Mode Single-Shot\n1: ALS Mode Continuous"),
+            ("RESERVED", 2, 6, BitAccessType.ReadOnly, null, null),
+            ("sysals__thresh_high", 0, 16, BitAccessType.ReadWrite, null, "High Threshold value for ALS comparison. Range 0-65535 codes."),
+            ("sysals__thresh_low", 0, 16, BitAccessType.ReadWrite, null, "Low Threshold value for ALS comparison. Range 0-65535 codes."),
+            ("sysals__intermeasurement_period", 0, 8, BitAccessType.ReadWrite, null, "Time delay between measurements in ALS continuous mode. Range 0-254 (0 = 10ms). Step size = 10ms."),
+            ("sysals__analogue_gain_light", 0, 3, BitAccessType.ReadWrite, null, "ALS analogue gain (light channel)\n0: ALS Gain = 20\n1: ALS Gain = 10\n2: ALS Gain = 5.0\n3: ALS Gain = 2.5\n4: ALS Gain = 1.67\n5: ALS Gain = 1.25\n6: ALS Gain = 1.0\n7: ALS Gain = 40\nControls the “light” channel gain.\nNote: Upper nibble should be set to 0x4 i.e. For ALS gain of 1.0 write 0x46."),
+            ("RESERVED", 3, 5, BitAccessType.ReadOnly, null, null),
+            ("sysals__integration_period", 0, 9, BitAccessType.ReadWrite, null, "Integration period for ALS mode. 1 code = 1 ms (0 = 1 ms).\nRecommended setting is 100 ms (0x63)."),
+            ("RESERVED", 9, 7, BitAccessType.ReadOnly, null, null),
+            ("result__range_device_ready", 0, 1, BitAccessType.ReadOnly, null, "Device Ready. When set to 1, indicates the device mode and\nconfiguration can be changed and a new start command will be accepted. When 0, indicates\nthe device is busy"),
+            ("result__range_measurement_ready", 1, 1, BitAccessType.ReadOnly, null, "Legacy register - DO NOT USE\nUse instead 6.2.39: RESULT__INTERRUPT_STATUS_GPIO"),
+            ("result__range_max_threshold_hit", 2, 1, BitAccessType.ReadOnly, null, "Legacy register - DO NOT USE\nUse instead 6.2.39: RESULT__INTERRUPT_STATUS_GPIO"),
+            ("result__range_min_threshold_hit", 3, 1, BitAccessType.ReadOnly, null, "Legacy register - DO NOT USE\nUse instead 6.2.39: RESULT__INTERRUPT_STATUS_GPIO"),
+            ("result__range_error_code", 4, 4, BitAccessType.ReadOnly, null, "Specific error codes\n0000: No error\n0001: VCSEL Continuity Test\n0010: VCSEL Watchdog Test\n0011: VCSEL Watchdog\n0100: PLL1 Lock\n0101: PLL2 Lock\n0110: Early Convergence Estimate\n0111: Max Convergence\n1000: No Target Ignore\n1001: Not used\n1010: Not used\n1011: Max Signal To Noise Ratio\n1100: Raw Ranging Algo Underflow\n1101: Raw Ranging Algo Overflow\n1110: Ranging Algo Underflow\n1111: Ranging Algo Overflow"),
+            ("result__als_device_ready", 0, 1, BitAccessType.ReadOnly, null, "Device Ready. When set to 1, indicates the device mode and\nconfiguration can be changed and a new start command will be accepted. When 0, indicates\nthe device is busy."),
+            ("result__als_measurement_ready", 1, 1, BitAccessType.ReadOnly, null, "Legacy register - DO NOT USE\nUse instead 6.2.39: RESULT__INTERRUPT_STATUS_GPIO"),
+            ("result__als_max_threshold_hit", 2, 1, BitAccessType.ReadOnly, null, "Legacy register - DO NOT USE\nUse instead 6.2.39: RESULT__INTERRUPT_STATUS_GPIO"),
+            ("result__als_min_threshold_hit", 3, 1, BitAccessType.ReadOnly, null, "Legacy register - DO NOT USE\nUse instead 6.2.39: RESULT__INTERRUPT_STATUS_GPIO"),
+            ("result__als_error_code", 4, 4, BitAccessType.ReadOnly, null, "Specific error and debug codes\n0000: No error\n0001: Overflow error\n0002: Underflow error"),
+            ("result_int_range_gpio", 0, 3, BitAccessType.ReadOnly, null, "result_int_range_gpio: Interrupt bits for Range:\n0: No threshold events reported\n1: Level Low threshold event\n2: Level High threshold event\n3: Out Of Window threshold event\n4: New Sample Ready threshold event"),
+            ("result_int_als_gpio", 3, 3, BitAccessType.ReadOnly, null, "Interrupt bits for ALS:\n0: No threshold events reported\n1: Level Low threshold event\n2: Level High threshold event\n3: Out Of Window threshold event\n4: New Sample Ready threshold event"),
+            ("result_int_error_gpio", 6, 2, BitAccessType.ReadOnly, null, "Interrupt bits for Error:\n0: No error reported\n1: Laser Safety Error\n2: PLL error (either PLL1 or PLL2)"),
+            ("result__als_ambient_light", 0, 16, BitAccessType.ReadOnly, null, "16 Bit ALS count output value. Lux value depends on Gain and\nintegration settings and calibrated lux/count setting."),
+            ("result__history_buffer_0", 0, 16, BitAccessType.ReadOnly, null, "Range/ALS result value.\nRange mode; Bits[15:8] range_val_latest; Bits[7:0] range_val_d1;\nALS mode; Bits[15:0] als_val_latest"),
+            ("result__history_buffer_1", 0, 16, BitAccessType.ReadOnly, null, "Range/ALS result value.\nRange mode; Bits[15:8] range_val_latest; Bits[7:0] range_val_d3;\nALS mode; Bits[15:0] als_val_d1"),
+            ("result__history_buffer_2", 0, 16, BitAccessType.ReadOnly, null, "Range/ALS result value.\nRange mode; Bits[15:8] range_val_latest; Bits[7:0] range_val_d5;\nALS mode; Bits[15:0] als_val_d2"),
+            ("result__history_buffer_3", 0, 16, BitAccessType.ReadOnly, null, "Range/ALS result value.\nRange mode; Bits[15:8] range_val_latest; Bits[7:0] range_val_d7;\nALS mode; Bits[15:0] als_val_d3"),
+            ("result__history_buffer_4", 0, 16, BitAccessType.ReadOnly, null, "Range/ALS result value.\nRange mode; Bits[15:8] range_val_latest; Bits[7:0] range_val_d9;\nALS mode; Bits[15:0] als_val_d4"),
+            ("result__history_buffer_5", 0, 16, BitAccessType.ReadOnly, null, "Range/ALS result value.\nRange mode; Bits[15:8] range_val_latest; Bits[7:0] range_val_d11;\nALS mode; Bits[15:0] als_val_d5"),
+            ("result__history_buffer_6", 0, 16, BitAccessType.ReadOnly, null, "Range/ALS result value.\nRange mode; Bits[15:8] range_val_latest; Bits[7:0] range_val_d13;\nALS mode; Bits[15:0] als_val_d6"),
+            ("result__history_buffer_7", 0, 16, BitAccessType.ReadOnly, null, "Range/ALS result value.\nRange mode; Bits[15:8] range_val_latest; Bits[7:0] range_val_d15;\nALS mode; Bits[15:0] als_val_d7"),
+            ("result__range_val", 0, 8, BitAccessType.ReadOnly, null, "Final range result value presented to the user for use. Unit is in mm."),
+            ("result__range_return_rate", 0, 16, BitAccessType.ReadOnly, null, "sensor count rate of signal returns correlated to IR emitter.\nComputed from RETURN_SIGNAL_COUNT / RETURN_CONV_TIME. Mcps 9.7 format"),
+            ("result__range_reference_rate", 0, 16, BitAccessType.ReadOnly, null, "sensor count rate of reference signal returns. Computed from\nREFERENCE_SIGNAL_COUNT / RETURN_CONV_TIME. Mcps 9.7 format\nNote: Both arrays converge at the same time, so using the return array convergence time is\ncorrect."),
+            ("result__range_return_signal_count", 0, 32, BitAccessType.ReadOnly, null, "sensor count output value attributed to signal correlated to IR emitter on the Return array."),
+            ("result__range_reference_signal_count", 0, 32, BitAccessType.ReadOnly, null, "sensor count output value attributed to signal correlated to IR emitter on the Reference array."),
+            ("result__range_return_amb_count", 0, 32, BitAccessType.ReadOnly, null, "sensor count output value attributed to uncorrelated ambient\nsignal on the Return array. Must be multiplied by 6 if used to calculate the ambient to signal\nthreshold."),
+            ("result__range_reference_amb_coun", 0, 32, BitAccessType.ReadOnly, null, "sensor count output value attributed to uncorrelated\nambient signal on the Reference array."),
+            ("result__range_return_conv_time", 0, 32, BitAccessType.ReadOnly, null, "sensor count output value attributed to signal on the Return array."),
+            ("readout__averaging_sample_period", 0, 8, BitAccessType.ReadWrite, null, "The internal readout averaging sample period can be\nadjusted from 0 to 255. Increasing the sampling period decreases noise but also reduces the\neffective max convergence time and increases power consumption:\nEffective max convergence time = max convergence time - readout averaging period (see\nSection 2.7.1: Range timing). Each unit sample period corresponds to around 64.5 μs\nadditional processing time. The recommended setting is 48 which equates to around 4.3 ms."),
+            ("firmware__bootup", 0, 1, BitAccessType.ReadWrite, null, "FW must set bit once initial boot has been completed."),
+            ("RESERVED", 1, 7, BitAccessType.ReadOnly, null, null),
+            ("firmware__als_result_scaler", 0, 4, BitAccessType.ReadWrite, null, "Bits [3:0] analogue gain 1 to 16x"),
+            ("RESERVED", 4, 4, BitAccessType.ReadOnly, null, null),
+            ("super_i2c_slave__device_address", 0, 7, BitAccessType.ReadWrite, null, "User programmable I2C address (7-bit). Device address can be re-designated after power-up."),
+            ("RESERVED", 7, 1, BitAccessType.ReadOnly, null, null),
+            ("interleaved_mode__enable", 0, 8, BitAccessType.ReadWrite, null, "Write 0x1 to this register to select ALS+Range interleaved mode.\nUse SYSALS__START and SYSALS__INTERMEASUREMENT_PERIOD to control this mode.\nA range measurement is automatically performed immediately after each ALS measurement."),
+        };
+
+        private static readonly Lazy<RegisterCatalog> _catalog = new Lazy<RegisterCatalog>(Create);
+
+        public static RegisterCatalog Catalog => _catalog.Value;
+
+        // Template IDs are the table indexes + 1.
+        private static RegisterCatalog Create()
+        {
+            Chip chip = new Chip()
+            {
+                Id = 1,
+                Name = ChipName,
+                ChipType = "Sensor",
+                Description = "Distance sensor"
+            };
+
+            for (int i = 0; i < _registers.Length; i++)
+            {
+                var r = _registers[i];
+                RegisterTemplate reg = new RegisterTemplate()
+                {
+                    Id = i + 1,
+                    Name = r.name,
+                    Address = r.address,
+                    Bits = r.bits,
+                    ResetValue = r.resetValue,
+                    Description = r.description,
+                    ChipId = chip.Id
+                };
+
+                for (int j = r.bitField; j < (r.bitField + r.bitFieldCount); j++)
+                {
+                    var bf = _bitFields[j];
+                    reg.BitFields.Add(new BitFieldTemplate()
+                    {
+                        Id = j + 1,
+                        Name = bf.name,
+                        Offset = bf.offset,
+                        Bits = bf.bits,
+                        AccessType = bf.access,
+                        ResetValue = bf.resetValue,
+                        Description = bf.description,
+                        RegisterTemplateId = reg.Id
+                    });
+                }
+
+                chip.Registers.Add(reg);
+            }
+
+            return new RegisterCatalog(chip, chip.Registers);
+        }
+    }
+}
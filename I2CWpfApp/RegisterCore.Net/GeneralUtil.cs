@@ -8,19 +8,7 @@ namespace RegisterCore.Net
     {
         public static UInt64 GetBitFieldValue(UInt64 regValue, BitFieldTemplate bitField)
         {
-            UInt64 val = 0;
-            UInt64 mask = 0;
-            int i = 0;
-
-            for (i = 0; i < bitField.Bits; i++)
-            {
-                mask |= ((UInt64)1 << i);
-            }
-            mask <<= bitField.Offset;
-
-            val = (regValue & mask) >> bitField.Offset;
-            
-            return val;
+            return (regValue >> bitField.Offset) & GetMaxValueOfBits(bitField.Bits);
         }
 
         public static UInt64 GetRegisterValueFromBitFields(IList<BitField> bitFields)
@@ -39,28 +27,17 @@ namespace RegisterCore.Net
 
         public static ulong GetBitFieldMaxValue(BitFieldTemplate bfTemplate)
         {
-            UInt64 val = 0;
-            int i = 0;
-
-            for (i = 0; i < bfTemplate.Bits; i++)
-            {
-                val |= ((UInt64)1 << i);
-            }
-
-            return val;
+            return GetMaxValueOfBits(bfTemplate.Bits);
         }
 
         public static ulong GetMaxValueOfBits(int bits)
         {
-            UInt64 val = 0;
-            int i = 0;
-
-            for (i = 0; i < bits; i++)
+            if (bits <= 0)
             {
-                val |= ((UInt64)1 << i);
+                return 0;
             }
 
-            return val;
+            return (bits >= 64) ? UInt64.MaxValue : (((UInt64)1 << bits) - 1);
         }
     }
 }
@@ -0,0 +1,292 @@
+﻿using RegisterCore.Net.Models;
+using System;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.IO;
+
+namespace RegisterCore.Net.IO
+{
+    // Register snapshot file : snapshots appended one after another, little endian.
+    //   Header(32 bytes)
+    //     magic("RSNP", 4), version(1), address bytes(1), value bytes(1), reserved(1),
+    //     chip ID(8), timestamp(8, UTC DateTime ticks), value count(4), reserved(4)
+    //   Address/value pairs(address bytes + value bytes each)
+    // Address/value bytes(1, 2, 4, 8) are the smallest for the values of the snapshot.
+    public class RegisterSnapshotHeader
+    {
+        public const UInt32 MAGIC = 0x504E5352;     // "RSNP"
+        public const byte VERSION = 1;
+        public const int SIZE = 32;
+
+        public Int64 ChipId { get; set; }
+        public DateTime Timestamp { get; set; }     // UTC
+        public int Count { get; set; }
+        public int AddressBytes { get; set; }
+        public int ValueBytes { get; set; }
+
+        public int PairSize => AddressBytes + ValueBytes;
+    }
+
+    public sealed class RegisterSnapshotWriter : IDisposable
+    {
+        private readonly Stream _stream;
+        private readonly bool _leaveOpen;
+        private byte[] _buffer = new byte[RegisterSnapshotHeader.SIZE];
+
+        public RegisterSnapshotWriter(Stream stream, bool leaveOpen = false)
+        {
+            _stream = stream;
+            _leaveOpen = leaveOpen;
+        }
+
+        public void Write(Int64 chipId, DateTime timestamp, ReadOnlySpan<RegisterValue> values)
+        {
+            UInt64 maxAddress = 0;
+            UInt64 maxValue = 0;
+            int addressBytes;
+            int valueBytes;
+            int size;
+            int pos;
+
+            foreach (var item in values)
+            {
+                maxAddress |= item.Address;
+                maxValue |= item.Value;
+            }
+            addressBytes = GetByteCount(maxAddress);
+            valueBytes = GetByteCount(maxValue);
+
+            size = RegisterSnapshotHeader.SIZE + values.Length * (addressBytes + valueBytes);
+            if (_buffer.Length < size)
+            {
+                _buffer = new byte[size];
+            }
+
+            Span<byte> buffer = new Span<byte>(_buffer, 0, size);
+
+            buffer.Slice(0, RegisterSnapshotHeader.SIZE).Clear();
+            BinaryPrimitives.WriteUInt32LittleEndian(buffer, RegisterSnapshotHeader.MAGIC);
+            buffer[4] = RegisterSnapshotHeader.VERSION;
+            buffer[5] = (byte)addressBytes;
+            buffer[6] = (byte)valueBytes;
+            BinaryPrimitives.WriteInt64LittleEndian(buffer.Slice(8), chipId);
+            BinaryPrimitives.WriteInt64LittleEndian(buffer.Slice(16), timestamp.ToUniversalTime().Ticks);
+            BinaryPrimitives.WriteInt32LittleEndian(buffer.Slice(24), values.Length);
+
+            pos = RegisterSnapshotHeader.SIZE;
+            foreach (var item in values)
+            {
+                WriteUInt(buffer.Slice(pos, addressBytes), item.Address);
+                pos += addressBytes;
+                WriteUInt(buffer.Slice(pos, valueBytes), item.Value);
+                pos += valueBytes;
+            }
+
+            _stream.Write(_buffer, 0, size);
+        }
+
+        public void Flush()
+        {
+            _stream.Flush();
+        }
+
+        public void Dispose()
+        {
+            _stream.Flush();
+            if (!_leaveOpen)
+            {
+                _stream.Dispose();
+            }
+        }
+
+        private static int GetByteCount(UInt64 value)
+        {
+            if (value <= Byte.MaxValue)
+            {
+                return 1;
+            }
+            else if (value <= UInt16.MaxValue)
+            {
+                return 2;
+            }
+            else if (value <= UInt32.MaxValue)
+            {
+                return 4;
+            }
+
+            return 8;
+        }
+
+        private static void WriteUInt(Span<byte> buffer, UInt64 value)
+        {
+            switch (buffer.Length)
+            {
+                case 1:
+                    buffer[0] = (byte)value;
+                    break;
+                case 2:
+                    BinaryPrimitives.WriteUInt16LittleEndian(buffer, (UInt16)value);
+                    break;
+                case 4:
+                    BinaryPrimitives.WriteUInt32LittleEndian(buffer, (UInt32)value);
+                    break;
+                default:
+                    BinaryPrimitives.WriteUInt64LittleEndian(buffer, value);
+                    break;
+            }
+        }
+    }
+
+    public sealed class RegisterSnapshotReader : IDisposable
+    {
+        private readonly Stream _stream;
+        private readonly bool _leaveOpen;
+        private readonly byte[] _header = new byte[RegisterSnapshotHeader.SIZE];
+        private byte[] _buffer = new byte[4096];
+
+        public RegisterSnapshotReader(Stream stream, bool leaveOpen = false)
+        {
+            _stream = stream;
+            _leaveOpen = leaveOpen;
+        }
+
+        // true : the file starts with a snapshot header.
+        public static bool IsSnapshotFile(string fileName)
+        {
+            byte[] magic = new byte[4];
+
+            using (var stream = new FileStream(fileName, FileMode.Open, FileAccess.Read, FileShare.Read))
+            {
+                return (ReadFully(stream, magic, magic.Length) == magic.Length) &&
+                    (BinaryPrimitives.ReadUInt32LittleEndian(magic) == RegisterSnapshotHeader.MAGIC);
+            }
+        }
+
+        // Values of the next snapshot(values is cleared and reused), null : end of the file.
+        public RegisterSnapshotHeader Read(List<RegisterValue> values)
+        {
+            RegisterSnapshotHeader header;
+            int size;
+            int pos = 0;
+
+            int read = ReadFully(_stream, _header, _header.Length);
+            if (read == 0)
+            {
+                return null;
+            }
+
+            header = ParseHeader(read);
+            if (((long)header.Count * header.PairSize) > int.MaxValue)
+            {
+                throw new InvalidDataException($"Register snapshot of {header.Count} values");
+            }
+
+            size = header.Count * header.PairSize;
+            if (_buffer.Length < size)
+            {
+                _buffer = new byte[size];
+            }
+
+            if (ReadFully(_stream, _buffer, size) != size)
+            {
+                throw new InvalidDataException("Truncated register snapshot");
+            }
+
+            values.Clear();
+            if (values.Capacity < header.Count)
+            {
+                values.Capacity = header.Count;
+            }
+            for (int i = 0; i < header.Count; i++)
+            {
+                UInt64 address = ReadUInt(new ReadOnlySpan<byte>(_buffer, pos, header.AddressBytes));
+                pos += header.AddressBytes;
+                UInt64 value = ReadUInt(new ReadOnlySpan<byte>(_buffer, pos, header.ValueBytes));
+                pos += header.ValueBytes;
+
+                values.Add(new RegisterValue(address, value));
+            }
+
+            return header;
+        }
+
+        public void Dispose()
+        {
+            if (!_leaveOpen)
+            {
+                _stream.Dispose();
+            }
+        }
+
+        private RegisterSnapshotHeader ParseHeader(int read)
+        {
+            ReadOnlySpan<byte> header = _header;
+
+            if ((read != RegisterSnapshotHeader.SIZE) ||
+                (BinaryPrimitives.ReadUInt32LittleEndian(header) != RegisterSnapshotHeader.MAGIC))
+            {
+                throw new InvalidDataException("Not a register snapshot");
+            }
+
+            if (header[4] != RegisterSnapshotHeader.VERSION)
+            {
+                throw new InvalidDataException($"Register snapshot version {header[4]} is not supported");
+            }
+
+            Int64 ticks = BinaryPrimitives.ReadInt64LittleEndian(header.Slice(16));
+
+            if (!IsValidByteCount(header[5]) || !IsValidByteCount(header[6]) ||
+                (ticks < DateTime.MinValue.Ticks) || (ticks > DateTime.MaxValue.Ticks) ||
+                (BinaryPrimitives.ReadInt32LittleEndian(header.Slice(24)) < 0))
+            {
+                throw new InvalidDataException("Invalid register snapshot header");
+            }
+
+            return new RegisterSnapshotHeader()
+            {
+                AddressBytes = header[5],
+                ValueBytes = header[6],
+                ChipId = BinaryPrimitives.ReadInt64LittleEndian(header.Slice(8)),
+                Timestamp = new DateTime(ticks, DateTimeKind.Utc),
+                Count = BinaryPrimitives.ReadInt32LittleEndian(header.Slice(24))
+            };
+        }
+
+        private static bool IsValidByteCount(byte count)
+        {
+            return (count == 1) || (count == 2) || (count == 4) || (count == 8);
+        }
+
+        private static UInt64 ReadUInt(ReadOnlySpan<byte> buffer)
+        {
+            switch (buffer.Length)
+            {
+                case 1:
+                    return buffer[0];
+                case 2:
+                    return BinaryPrimitives.ReadUInt16LittleEndian(buffer);
+                case 4:
+                    return BinaryPrimitives.ReadUInt32LittleEndian(buffer);
+                default:
+                    return BinaryPrimitives.ReadUInt64LittleEndian(buffer);
+            }
+        }
+
+        private static int ReadFully(Stream stream, byte[] buffer, int count)
+        {
+            int total = 0;
+
+            while (total < count)
+            {
+                int read = stream.Read(buffer, total, count - total);
+                if (read <= 0)
+                {
+                    break;
+                }
+                total += read;
+            }
+
+            return total;
+        }
+    }
+}
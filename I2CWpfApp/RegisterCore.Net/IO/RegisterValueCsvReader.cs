@@ -0,0 +1,191 @@
+﻿using RegisterCore.Net.Models;
+using System;
+using System.Buffers.Text;
+using System.Collections.Generic;
+using System.IO;
+
+namespace RegisterCore.Net.IO
+{
+    // Streaming reader of register value files(text) : "address,value" in hex per line.
+    // Lines are parsed in place in the read buffer(no string per line),
+    // lines that are not an address/value pair are skipped.
+    public sealed class RegisterValueCsvReader : IDisposable
+    {
+        private const int BUFFER_SIZE = 64 * 1024;
+
+        private readonly Stream _stream;
+        private readonly bool _leaveOpen;
+        private byte[] _buffer = new byte[BUFFER_SIZE];
+        private int _start = 0;
+        private int _end = 0;
+        private bool _eof = false;
+        private bool _bomChecked = false;
+
+        public RegisterValueCsvReader(Stream stream, bool leaveOpen = false)
+        {
+            _stream = stream;
+            _leaveOpen = leaveOpen;
+        }
+
+        public static IEnumerable<RegisterValue> ReadAll(string fileName)
+        {
+            using (var reader = new RegisterValueCsvReader(new FileStream(fileName, FileMode.Open, FileAccess.Read, FileShare.Read, 1, FileOptions.SequentialScan)))
+            {
+                while (reader.TryRead(out RegisterValue value))
+                {
+                    yield return value;
+                }
+            }
+        }
+
+        // false : end of the stream.
+        public bool TryRead(out RegisterValue value)
+        {
+            while (true)
+            {
+                int newLine = Array.IndexOf(_buffer, (byte)'\n', _start, _end - _start);
+                ReadOnlySpan<byte> line;
+
+                if (newLine >= 0)
+                {
+                    line = new ReadOnlySpan<byte>(_buffer, _start, newLine - _start);
+                    _start = newLine + 1;
+                }
+                else if (!_eof)
+                {
+                    Fill();
+                    continue;
+                }
+                else if (_start < _end)
+                {
+                    // Last line without a new line.
+                    line = new ReadOnlySpan<byte>(_buffer, _start, _end - _start);
+                    _start = _end;
+                }
+                else
+                {
+                    value = default;
+                    return false;
+                }
+
+                if (TryParseLine(line, out value))
+                {
+                    return true;
+                }
+            }
+        }
+
+        // Number of values read(0 : end of the stream).
+        public int Read(Span<RegisterValue> values)
+        {
+            int count = 0;
+
+            while ((count < values.Length) && TryRead(out RegisterValue value))
+            {
+                values[count++] = value;
+            }
+
+            return count;
+        }
+
+        public static bool TryParseLine(ReadOnlySpan<byte> line, out RegisterValue value)
+        {
+            int comma = line.IndexOf((byte)',');
+
+            value = default;
+            if (comma < 0)
+            {
+                return false;
+            }
+
+            if (!TryParseHex(line.Slice(0, comma), out UInt64 address) ||
+                !TryParseHex(line.Slice(comma + 1), out UInt64 regValue))
+            {
+                return false;
+            }
+
+            value = new RegisterValue(address, regValue);
+
+            return true;
+        }
+
+        public void Dispose()
+        {
+            if (!_leaveOpen)
+            {
+                _stream.Dispose();
+            }
+        }
+
+        private static bool TryParseHex(ReadOnlySpan<byte> text, out UInt64 value)
+        {
+            text = Trim(text);
+
+            value = 0;
+            if (text.IsEmpty)
+            {
+                return false;
+            }
+
+            return Utf8Parser.TryParse(text, out value, out int consumed, 'X') && (consumed == text.Length);
+        }
+
+        private static ReadOnlySpan<byte> Trim(ReadOnlySpan<byte> text)
+        {
+            int start = 0;
+            int end = text.Length;
+
+            while ((start < end) && IsSpace(text[start]))
+            {
+                start++;
+            }
+            while ((end > start) && IsSpace(text[end - 1]))
+            {
+                end--;
+            }
+
+            return text.Slice(start, end - start);
+        }
+
+        private static bool IsSpace(byte c)
+        {
+            return (c == ' ') || (c == '\t') || (c == '\r');
+        }
+
+        // Unread bytes are moved to the buffer start, the buffer grows for a line longer than the buffer.
+        private void Fill()
+        {
+            int remain = _end - _start;
+            int read;
+
+            if (_start > 0)
+            {
+                Buffer.BlockCopy(_buffer, _start, _buffer, 0, remain);
+                _start = 0;
+                _end = remain;
+            }
+            else if (_end == _buffer.Length)
+            {
+                Array.Resize(ref _buffer, _buffer.Length * 2);
+            }
+
+            read = _stream.Read(_buffer, _end, _buffer.Length - _end);
+            if (read <= 0)
+            {
+                _eof = true;
+                return;
+            }
+            _end += read;
+
+            // UTF-8 BOM
+            if (!_bomChecked && (_end >= 3))
+            {
+                _bomChecked = true;
+                if ((_buffer[0] == 0xEF) && (_buffer[1] == 0xBB) && (_buffer[2] == 0xBF))
+                {
+                    _start = 3;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,92 @@
+﻿using RegisterCore.Net.Models;
+using System;
+using System.Buffers;
+using System.Buffers.Text;
+using System.IO;
+using System.Text;
+
+namespace RegisterCore.Net.IO
+{
+    // Streaming writer of register value files(text) : "address,value" in hex per line,
+    // the value has 2, 4 or 8 digits by the register bits.
+    public sealed class RegisterValueCsvWriter : IDisposable
+    {
+        private const int BUFFER_SIZE = 64 * 1024;
+        private const int MAX_LINE_LENGTH = 64;
+
+        private static readonly StandardFormat _addressFormat = new StandardFormat('X', 8);
+        private static readonly byte[] _newLine = Encoding.ASCII.GetBytes(Environment.NewLine);
+
+        private readonly Stream _stream;
+        private readonly bool _leaveOpen;
+        private readonly byte[] _buffer = new byte[BUFFER_SIZE];
+        private int _length = 0;
+
+        public RegisterValueCsvWriter(Stream stream, bool leaveOpen = false)
+        {
+            _stream = stream;
+            _leaveOpen = leaveOpen;
+        }
+
+        public void Write(Register reg)
+        {
+            Write(reg.Address, reg.Value, reg.Bits);
+        }
+
+        public void Write(UInt64 address, UInt64 value, int bits)
+        {
+            Span<byte> line;
+            int written;
+            int length;
+
+            if ((_length + MAX_LINE_LENGTH) > _buffer.Length)
+            {
+                Flush();
+            }
+
+            line = new Span<byte>(_buffer, _length, MAX_LINE_LENGTH);
+            Utf8Formatter.TryFormat(address, line, out length, _addressFormat);
+            line[length++] = (byte)',';
+            Utf8Formatter.TryFormat(value, line.Slice(length), out written, GetValueFormat(bits));
+            length += written;
+            _newLine.CopyTo(line.Slice(length));
+            length += _newLine.Length;
+
+            _length += length;
+        }
+
+        public void Flush()
+        {
+            _stream.Write(_buffer, 0, _length);
+            _length = 0;
+            _stream.Flush();
+        }
+
+        public void Dispose()
+        {
+            Flush();
+            if (!_leaveOpen)
+            {
+                _stream.Dispose();
+            }
+        }
+
+        private static StandardFormat GetValueFormat(int bits)
+        {
+            if (bits <= 8)
+            {
+                return new StandardFormat('X', 2);
+            }
+            else if (bits <= 16)
+            {
+                return new StandardFormat('X', 4);
+            }
+            else if (bits <= 32)
+            {
+                return new StandardFormat('X', 8);
+            }
+
+            return new StandardFormat('X');
+        }
+    }
+}
@@ -0,0 +1,158 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Linq;
+
+namespace RegisterCore.Net.Models
+{
+    // Register templates of a chip indexed by address(bit fields in offset order).
+    // The catalog is not changed after construction and is shared by every window,
+    // register values are Register/BitField copies(CreateRegister()).
+    // Layout has the bit field masks of Registers(register index : Registers index).
+    public sealed class RegisterCatalog
+    {
+        private readonly Dictionary<UInt64, int> _indexes = new Dictionary<UInt64, int>();
+
+        public Chip Chip { get; }
+
+        // Address order.
+        public IReadOnlyList<RegisterTemplate> Registers { get; }
+
+        public RegisterLayout Layout { get; }
+
+        public RegisterCatalog(Chip chip, IEnumerable<RegisterTemplate> registers)
+        {
+            List<RegisterTemplate> list = new List<RegisterTemplate>();
+
+            Chip = chip;
+
+            foreach (var reg in registers.OrderBy(r => r.Address))
+            {
+                // The first template of an address is used.
+                if (_indexes.TryAdd(reg.Address, list.Count))
+                {
+                    reg.BitFields = new ObservableCollection<BitFieldTemplate>(reg.BitFields.OrderBy(bf => bf.Offset));
+                    list.Add(reg);
+                }
+            }
+
+            Registers = list.AsReadOnly();
+            Layout = new RegisterLayout(Registers);
+        }
+
+        // -1 : no register at the address.
+        public int IndexOf(UInt64 address)
+        {
+            return _indexes.TryGetValue(address, out int index) ? index : -1;
+        }
+
+        // null : no register at the address.
+        public RegisterTemplate Find(UInt64 address)
+        {
+            int index = IndexOf(address);
+
+            return (index >= 0) ? Registers[index] : null;
+        }
+
+        // null : no register at the address.
+        public Register CreateRegister(UInt64 address, UInt64 value)
+        {
+            int index = IndexOf(address);
+
+            return (index >= 0) ? CreateRegister(index, value) : null;
+        }
+
+        // Register values of a register value file, addresses not in the catalog are skipped.
+        public List<Register> CreateRegisters(IEnumerable<RegisterValue> regValues)
+        {
+            List<Register> registers = new List<Register>();
+
+            foreach (var item in regValues)
+            {
+                Register reg = CreateRegister(item.Address, item.Value);
+                if (reg != null)
+                {
+                    registers.Add(reg);
+                }
+            }
+
+            return registers;
+        }
+
+        // Bit field values from the register value.
+        public void UpdateBitFields(Register reg)
+        {
+            int index = IndexOf(reg.Address);
+            Span<UInt64> fields = stackalloc UInt64[reg.BitFields.Count];
+
+            if ((index < 0) || (Layout.GetFieldCount(index) != reg.BitFields.Count))
+            {
+                foreach (var bf in reg.BitFields)
+                {
+                    bf.Value = GeneralUtil.GetBitFieldValue(reg.Value, bf);
+                }
+                return;
+            }
+
+            Layout.Decode(index, reg.Value, fields);
+            for (int i = 0; i < fields.Length; i++)
+            {
+                reg.BitFields[i].Value = fields[i];
+            }
+        }
+
+        // Register value from the bit field values(bits not in a bit field are kept).
+        public void UpdateValue(Register reg)
+        {
+            int index = IndexOf(reg.Address);
+            Span<UInt64> fields = stackalloc UInt64[reg.BitFields.Count];
+
+            if ((index < 0) || (Layout.GetFieldCount(index) != reg.BitFields.Count))
+            {
+                reg.Value = GeneralUtil.GetRegisterValueFromBitFields(reg.BitFields);
+                return;
+            }
+
+            for (int i = 0; i < fields.Length; i++)
+            {
+                fields[i] = reg.BitFields[i].Value;
+            }
+            reg.Value = Layout.Encode(index, fields, reg.Value);
+        }
+
+        public static Register CreateRegister(RegisterTemplate template, UInt64 value)
+        {
+            Register reg = new Register(template);
+
+            reg.Value = value;
+            foreach (var bf in template.BitFields)
+            {
+                BitField b = new BitField(bf);
+
+                b.Value = GeneralUtil.GetBitFieldValue(value, bf);
+                reg.BitFields.Add(b);
+            }
+
+            return reg;
+        }
+
+        private Register CreateRegister(int index, UInt64 value)
+        {
+            RegisterTemplate template = Registers[index];
+            Register reg = new Register(template);
+            Span<UInt64> fields = stackalloc UInt64[Layout.GetFieldCount(index)];
+
+            Layout.Decode(index, value, fields);
+            reg.Value = value;
+            for (int i = 0; i < fields.Length; i++)
+            {
+                BitField b = new BitField(template.BitFields[i]);
+
+                b.Value = fields[i];
+                reg.BitFields.Add(b);
+            }
+
+            return reg;
+        }
+    }
+}
@@ -0,0 +1,22 @@
+﻿using System;
+
+namespace RegisterCore.Net.Models
+{
+    // Register value of a register dump(file, snapshot).
+    public readonly struct RegisterValue
+    {
+        public UInt64 Address { get; }
+        public UInt64 Value { get; }
+
+        public RegisterValue(UInt64 address, UInt64 value)
+        {
+            Address = address;
+            Value = value;
+        }
+
+        public override string ToString()
+        {
+            return $"{Address:X8},{Value:X}";
+        }
+    }
+}
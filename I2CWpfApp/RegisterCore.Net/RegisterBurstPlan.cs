@@ -0,0 +1,98 @@
+﻿using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+
+namespace RegisterCore.Net
+{
+    // Registers read in one burst transaction : Length bytes from Address,
+    // catalog registers First .. First + Count - 1.
+    public struct RegisterBurst
+    {
+        public UInt64 Address { get; set; }
+        public int Length { get; set; }
+        public int First { get; set; }
+        public int Count { get; set; }
+    }
+
+    // Burst reads covering all registers of a catalog with the fewest transactions.
+    // Registers whose bytes follow each other(byte addresses, Bits / 8 bytes per register) are read together,
+    // at most maxLength bytes per burst. Registers are big endian(the device increments the byte address).
+    public sealed class RegisterBurstPlan
+    {
+        private readonly List<RegisterBurst> _bursts = new List<RegisterBurst>();
+
+        public RegisterCatalog Catalog { get; }
+        public int MaxLength { get; }
+        public IReadOnlyList<RegisterBurst> Bursts => _bursts;
+
+        public RegisterBurstPlan(RegisterCatalog catalog, int maxLength)
+        {
+            Catalog = catalog;
+            MaxLength = maxLength;
+
+            for (int i = 0; i < catalog.Registers.Count; i++)
+            {
+                RegisterTemplate reg = catalog.Registers[i];
+                int length = GetByteCount(reg);
+
+                if (length > maxLength)
+                {
+                    throw new ArgumentException($"{reg.Name} : {length} bytes, burst of {maxLength} bytes");
+                }
+
+                if (_bursts.Count > 0)
+                {
+                    RegisterBurst last = _bursts[_bursts.Count - 1];
+
+                    if ((reg.Address == last.Address + (UInt64)last.Length) &&
+                        ((last.Length + length) <= maxLength))
+                    {
+                        last.Length += length;
+                        last.Count++;
+                        _bursts[_bursts.Count - 1] = last;
+                        continue;
+                    }
+                }
+
+                _bursts.Add(new RegisterBurst()
+                {
+                    Address = reg.Address,
+                    Length = length,
+                    First = i,
+                    Count = 1
+                });
+            }
+        }
+
+        public static int GetByteCount(RegisterTemplate reg)
+        {
+            return Math.Max((reg.Bits + 7) / 8, 1);
+        }
+
+        // Register values of a burst from the bytes read(burst Length bytes) into the snapshot.
+        public void Decode(int burst, ReadOnlySpan<byte> data, RegisterMapSnapshot snapshot)
+        {
+            RegisterBurst b = _bursts[burst];
+            int pos = 0;
+
+            if (data.Length < b.Length)
+            {
+                throw new ArgumentException($"{data.Length} bytes, burst of {b.Length} bytes");
+            }
+
+            for (int i = b.First; i < b.First + b.Count; i++)
+            {
+                int length = GetByteCount(Catalog.Registers[i]);
+                UInt64 value = 0;
+
+                for (int j = 0; j < length; j++)
+                {
+                    value = (value << 8) | data[pos + j];
+                }
+                pos += length;
+
+                snapshot.SetValue(i, value);
+            }
+        }
+    }
+}
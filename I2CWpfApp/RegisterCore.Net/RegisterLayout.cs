@@ -0,0 +1,141 @@
+﻿using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+
+namespace RegisterCore.Net
+{
+    // Bit field masks and shifts of registers(RegisterTemplate.BitFields order), computed once
+    // so register values are decoded/encoded without per-bit work.
+    // The fields of register i are fields[GetFieldStart(i) .. GetFieldStart(i) + GetFieldCount(i) - 1].
+    public sealed class RegisterLayout
+    {
+        private readonly UInt64[] _masks;           // Field masks(not shifted), also the field maximum values.
+        private readonly int[] _shifts;
+        private readonly int[] _fieldStarts;        // Register count + 1
+        private readonly UInt64[] _registerMasks;   // Bits of a register covered by its fields.
+
+        public int RegisterCount => _registerMasks.Length;
+        public int FieldCount => _masks.Length;
+
+        public RegisterLayout(RegisterTemplate template)
+            : this(new RegisterTemplate[] { template })
+        {
+        }
+
+        public RegisterLayout(IReadOnlyList<RegisterTemplate> templates)
+        {
+            int fieldCount = 0;
+            int field = 0;
+
+            foreach (var reg in templates)
+            {
+                fieldCount += reg.BitFields.Count;
+            }
+
+            _masks = new UInt64[fieldCount];
+            _shifts = new int[fieldCount];
+            _fieldStarts = new int[templates.Count + 1];
+            _registerMasks = new UInt64[templates.Count];
+
+            for (int i = 0; i < templates.Count; i++)
+            {
+                _fieldStarts[i] = field;
+                foreach (var bf in templates[i].BitFields)
+                {
+                    _masks[field] = GeneralUtil.GetMaxValueOfBits(bf.Bits);
+                    _shifts[field] = bf.Offset;
+                    _registerMasks[i] |= _masks[field] << bf.Offset;
+                    field++;
+                }
+            }
+            _fieldStarts[templates.Count] = field;
+        }
+
+        public int GetFieldStart(int register)
+        {
+            return _fieldStarts[register];
+        }
+
+        public int GetFieldCount(int register)
+        {
+            return _fieldStarts[register + 1] - _fieldStarts[register];
+        }
+
+        public UInt64 GetFieldMaxValue(int field)
+        {
+            return _masks[field];
+        }
+
+        // Fields of all registers(values : RegisterCount, fields : FieldCount).
+        public void Decode(ReadOnlySpan<UInt64> values, Span<UInt64> fields)
+        {
+            CheckLength(values.Length, fields.Length);
+
+            for (int i = 0; i < values.Length; i++)
+            {
+                UInt64 value = values[i];
+                int end = _fieldStarts[i + 1];
+
+                for (int j = _fieldStarts[i]; j < end; j++)
+                {
+                    fields[j] = (value >> _shifts[j]) & _masks[j];
+                }
+            }
+        }
+
+        // Register values of all registers(fields : FieldCount, values : RegisterCount).
+        // Bits not covered by fields are kept, field values are truncated to the field bits.
+        public void Encode(ReadOnlySpan<UInt64> fields, Span<UInt64> values)
+        {
+            CheckLength(values.Length, fields.Length);
+
+            for (int i = 0; i < values.Length; i++)
+            {
+                values[i] = Encode(i, fields.Slice(_fieldStarts[i], GetFieldCount(i)), values[i]);
+            }
+        }
+
+        // Fields of a register(fields : GetFieldCount(register)).
+        public void Decode(int register, UInt64 value, Span<UInt64> fields)
+        {
+            int start = _fieldStarts[register];
+
+            CheckFieldCount(register, fields.Length);
+            for (int j = 0; j < fields.Length; j++)
+            {
+                fields[j] = (value >> _shifts[start + j]) & _masks[start + j];
+            }
+        }
+
+        // Value of a register from its fields(fields : GetFieldCount(register)), bits not covered by fields are taken from value.
+        public UInt64 Encode(int register, ReadOnlySpan<UInt64> fields, UInt64 value)
+        {
+            int start = _fieldStarts[register];
+
+            CheckFieldCount(register, fields.Length);
+            value &= ~_registerMasks[register];
+            for (int j = 0; j < fields.Length; j++)
+            {
+                value |= (fields[j] & _masks[start + j]) << _shifts[start + j];
+            }
+
+            return value;
+        }
+
+        private void CheckLength(int valueCount, int fieldCount)
+        {
+            if ((valueCount != RegisterCount) || (fieldCount != FieldCount))
+            {
+                throw new ArgumentException($"{valueCount} values, {fieldCount} fields : layout of {RegisterCount} registers, {FieldCount} fields");
+            }
+        }
+
+        private void CheckFieldCount(int register, int fieldCount)
+        {
+            if (fieldCount != GetFieldCount(register))
+            {
+                throw new ArgumentException($"{fieldCount} fields : register {register} has {GetFieldCount(register)} fields");
+            }
+        }
+    }
+}
@@ -0,0 +1,110 @@
+﻿using RegisterCore.Net.Models;
+using System;
+using System.Collections.Generic;
+
+namespace RegisterCore.Net
+{
+    // Values of the registers of a catalog read at one time(register index : RegisterCatalog.Registers index).
+    // Registers of a failed read are not read, they are not compared.
+    public sealed class RegisterMapSnapshot
+    {
+        private readonly UInt64[] _values;
+        private readonly bool[] _read;
+        private readonly List<int> _changed = new List<int>();
+
+        public RegisterCatalog Catalog { get; }
+        public DateTime Timestamp { get; set; }     // UTC
+        public int Count => _values.Length;
+        public int ReadCount { get; private set; }
+
+        // Registers changed since the previous snapshot(CompareWith()), register index order.
+        public IReadOnlyList<int> Changed => _changed;
+
+        public RegisterMapSnapshot(RegisterCatalog catalog)
+        {
+            Catalog = catalog;
+            Timestamp = DateTime.UtcNow;
+            _values = new UInt64[catalog.Registers.Count];
+            _read = new bool[catalog.Registers.Count];
+        }
+
+        public bool IsRead(int register)
+        {
+            return _read[register];
+        }
+
+        public UInt64 GetValue(int register)
+        {
+            return _values[register];
+        }
+
+        public void SetValue(int register, UInt64 value)
+        {
+            if (_read[register] != true)
+            {
+                _read[register] = true;
+                ReadCount++;
+            }
+            _values[register] = value;
+        }
+
+        // Changed : registers read in both snapshots with different values and registers read only in this one
+        // (all registers read if previous is null).
+        public void CompareWith(RegisterMapSnapshot previous)
+        {
+            if ((previous != null) && (previous.Count != Count))
+            {
+                throw new ArgumentException($"Snapshot of {previous.Count} registers, {Count} registers");
+            }
+
+            _changed.Clear();
+            for (int i = 0; i < _values.Length; i++)
+            {
+                if ((_read[i] == true) &&
+                    ((previous == null) || (previous._read[i] != true) || (previous._values[i] != _values[i])))
+                {
+                    _changed.Add(i);
+                }
+            }
+        }
+
+        // Copy of the snapshot with the registers not read taken from previous(the last known values).
+        public RegisterMapSnapshot MergeWith(RegisterMapSnapshot previous)
+        {
+            RegisterMapSnapshot merged = new RegisterMapSnapshot(Catalog)
+            {
+                Timestamp = Timestamp
+            };
+
+            for (int i = 0; i < _values.Length; i++)
+            {
+                if (_read[i] == true)
+                {
+                    merged.SetValue(i, _values[i]);
+                }
+                else if ((previous != null) && (previous._read[i] == true))
+                {
+                    merged.SetValue(i, previous._values[i]);
+                }
+            }
+
+            return merged;
+        }
+
+        // Values of the read registers in address order(RegisterSnapshotWriter, RegisterValueCsvWriter).
+        public List<RegisterValue> ToRegisterValues()
+        {
+            List<RegisterValue> values = new List<RegisterValue>(ReadCount);
+
+            for (int i = 0; i < _values.Length; i++)
+            {
+                if (_read[i] == true)
+                {
+                    values.Add(new RegisterValue(Catalog.Registers[i].Address, _values[i]));
+                }
+            }
+
+            return values;
+        }
+    }
+}